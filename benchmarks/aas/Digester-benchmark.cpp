@@ -0,0 +1,87 @@
+/*
+ * Digester-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/aas/AminoAcidSequence.hpp>
+#include <MSTK/aas/tools/Digester.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <sstream>
+#include <vector>
+
+using namespace mstk::aas;
+using namespace mstk;
+
+namespace {
+
+struct Digestion
+{
+    const std::vector<AminoAcidSequence>& proteins;
+    const tools::Digester& digester;
+    UnsignedInt missedCleavages;
+    Digestion(const std::vector<AminoAcidSequence>& ps,
+        const tools::Digester& d, const UnsignedInt mc) :
+        proteins(ps), digester(d), missedCleavages(mc)
+    {
+    }
+    void operator()() const
+    {
+        tools::Digester::AminoAcidSequences peptides;
+        for (Size i = 0; i < proteins.size(); ++i) {
+            peptides.clear();
+            digester(proteins[i], peptides, missedCleavages);
+            benchmark::doNotOptimize(peptides);
+        }
+    }
+};
+
+}
+
+int main()
+{
+    // 1000 synthetic proteins
+    const Size nProteins = 1000;
+    benchmark::ProteomeParameters p;
+    benchmark::Random rnd(p.seed);
+    std::vector<AminoAcidSequence> proteins;
+    Size nResidues = 0;
+    for (Size i = 0; i < nProteins; ++i) {
+        String seq = benchmark::makeProteinSequence(p.medianLength, rnd);
+        proteins.push_back(AminoAcidSequence(seq));
+        nResidues += seq.size();
+    }
+    std::cout << "Digesting " << nProteins << " proteins, " << nResidues
+            << " residues (throughput in residues)" << std::endl;
+    tools::Digester trypsin(tools::Digester::TRYPSIN);
+    for (UnsignedInt mc = 0; mc <= 2; ++mc) {
+        std::ostringstream name;
+        name << "Digester, trypsin, " << mc << " missed cleavage(s)";
+        benchmark::run(name.str(), Digestion(proteins, trypsin, mc),
+            nResidues, 5);
+    }
+    tools::Digester lysc(tools::Digester::LYSC);
+    benchmark::run("Digester, Lys-C", Digestion(proteins, lysc, 0), nResidues,
+        5);
+    return 0;
+}
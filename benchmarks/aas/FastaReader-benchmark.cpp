@@ -0,0 +1,71 @@
+/*
+ * FastaReader-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/aas/tools/Digester.hpp>
+#include <MSTK/aas/tools/FastaReader.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace mstk::aas;
+using namespace mstk;
+
+namespace {
+
+struct Reading
+{
+    const tools::FastaReader& reader;
+    explicit Reading(const tools::FastaReader& r) :
+        reader(r)
+    {
+    }
+    void operator()() const
+    {
+        tools::FastaReader::AminoAcidSequences sequences;
+        reader.read(sequences);
+        benchmark::doNotOptimize(sequences);
+    }
+};
+
+}
+
+int main()
+{
+    // a synthetic proteome of 2000 proteins
+    const String filename("FastaReader-benchmark.fasta");
+    benchmark::ProteomeParameters p;
+    p.nProteins = 2000;
+    Size nResidues = benchmark::writeFastaProteome(p, filename);
+    std::cout << "Reading " << p.nProteins << " proteins, " << nResidues
+            << " residues (throughput in residues)" << std::endl;
+    tools::FastaReader plain(filename);
+    benchmark::run("FastaReader, no digestion", Reading(plain), nResidues, 3);
+    tools::FastaReader tryptic(filename,
+        tools::Digester(tools::Digester::TRYPSIN));
+    benchmark::run("FastaReader, trypsin", Reading(tryptic), nResidues, 3);
+    std::remove(filename.c_str());
+    return 0;
+}
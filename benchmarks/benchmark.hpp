@@ -0,0 +1,164 @@
+/*
+ * benchmark.hpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_BENCHMARKS_BENCHMARK_HPP__
+#define __MSTK_BENCHMARKS_BENCHMARK_HPP__
+
+#include <MSTK/common/Instrumentation.hpp>
+#include <MSTK/common/Types.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* The name of the benchmark suite, i.e. the executable; set by the
+ * ADD_MSTK_BENCHMARK CMake macro.
+ */
+#ifndef MSTK_BENCHMARK_SUITE
+#define MSTK_BENCHMARK_SUITE ""
+#endif
+
+#if defined(__GNUC__)
+#define MSTK_BENCHMARK_NOINLINE __attribute__((noinline))
+#else
+#define MSTK_BENCHMARK_NOINLINE
+#endif
+
+namespace mstk {
+
+namespace benchmark {
+
+/** Prevents the compiler from optimizing away the computation of \c value.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/** Wall clock time in seconds, measured on a monotonic clock.
+ */
+inline double now()
+{
+    typedef std::chrono::steady_clock Clock;
+    return std::chrono::duration<double>(
+        Clock::now().time_since_epoch()).count();
+}
+
+/** Appends a benchmark result to the results file.
+ *
+ * If the environment variable \c MSTK_BENCHMARK_OUTPUT names a file, one
+ * JSON object per benchmark is appended to it (JSON Lines format), which
+ * allows to collect the results of all benchmark executables into a single
+ * file and to compare runs across commits (see \c benchmarks/compare.py).
+ * The optional environment variable \c MSTK_BENCHMARK_TAG (e.g. a commit
+ * hash) is stored with each record, as is the suite name (see
+ * \c MSTK_BENCHMARK_SUITE): several executables may report benchmarks of
+ * the same name, e.g. the two builds of the logging benchmark.
+ * @param[in] name The name of the benchmark.
+ * @param[in] best The fastest run, in seconds.
+ * @param[in] median The median run time, in seconds.
+ * @param[in] items The number of items processed per run.
+ * @param[in] repetitions The number of timed runs.
+ */
+inline void writeResult(const std::string& name, const double best,
+    const double median, const Size items, const Size repetitions)
+{
+    const char* filename = std::getenv("MSTK_BENCHMARK_OUTPUT");
+    if (filename == 0 || *filename == '\0') {
+        return;
+    }
+    std::ofstream ofs(filename, std::ios::app);
+    if (!ofs) {
+        std::cerr << "Could not open benchmark output file " << filename
+                << "." << std::endl;
+        return;
+    }
+    const char* tag = std::getenv("MSTK_BENCHMARK_TAG");
+    ofs << std::setprecision(9) << "{\"suite\":";
+    Instrumentation::writeJsonString(ofs, MSTK_BENCHMARK_SUITE);
+    ofs << ",\"name\":";
+    Instrumentation::writeJsonString(ofs, name);
+    ofs << ",\"tag\":";
+    Instrumentation::writeJsonString(ofs, tag ? tag : "");
+    ofs << ",\"seconds\":" << best << ",\"median_seconds\":" << median
+            << ",\"items\":" << items << ",\"items_per_second\":"
+            << static_cast<double> (items) / best << ",\"repetitions\":"
+            << repetitions << "}\n";
+}
+
+/** Runs \c f \c repetitions times and reports the fastest run.
+ *
+ * The result is printed to \c std::cout and, if requested, appended to the
+ * machine-readable results file (see \c writeResult()).
+ * @param[in] name The name of the benchmark.
+ * @param[in] f A nullary function object; the code under test.
+ * @param[in] items The number of items processed by a single call to
+ *                  \c f; used to report the throughput.
+ * @param[in] repetitions The number of timed runs.
+ * @return The best wall clock time for a single call to \c f, in seconds.
+ */
+template<typename Function>
+double run(const std::string& name, Function f, Size items,
+    Size repetitions = 10)
+{
+    // warm up caches and branch predictors
+    f();
+    std::vector<double> times;
+    times.reserve(repetitions);
+    for (Size i = 0; i < repetitions; ++i) {
+        double start = now();
+        f();
+        times.push_back(now() - start);
+    }
+    if (times.empty()) {
+        return 0.0;
+    }
+    std::sort(times.begin(), times.end());
+    double best = times.front();
+    double median = times[times.size() / 2];
+    std::cout << std::left << std::setw(48) << name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(3)
+            << best * 1e3 << " ms" << std::setw(12) << std::setprecision(1)
+            << static_cast<double> (items) / best * 1e-6 << " M/s"
+            << std::endl;
+    writeResult(name, best, median, items, repetitions);
+    return best;
+}
+
+} // namespace benchmark
+
+} // namespace mstk
+
+#endif /* __MSTK_BENCHMARKS_BENCHMARK_HPP__ */
@@ -0,0 +1,76 @@
+#!/usr/bin/python
+# compare two sets of MSTK benchmark results.
+#
+# The benchmark executables append their results to the file named by the
+# MSTK_BENCHMARK_OUTPUT environment variable (one JSON object per line).
+# Usage:
+#   MSTK_BENCHMARK_OUTPUT=old.jsonl make benchmark   (on the old commit)
+#   MSTK_BENCHMARK_OUTPUT=new.jsonl make benchmark   (on the new commit)
+#   compare.py old.jsonl new.jsonl [threshold]
+# The script prints the change in throughput for every benchmark and exits
+# with a non-zero status if any benchmark slowed down by more than
+# threshold (default: 0.1, i.e. 10%).
+#
+
+from __future__ import print_function
+import json
+from sys import argv, exit
+
+
+def load(filename):
+    ''' read a results file. return {(suite, name): best time in seconds}.
+    If a benchmark was run several times, keep the fastest result. Results
+    without a suite (older files) get an empty suite name. '''
+    results = {}
+    for line in open(filename):
+        line = line.strip()
+        if not line:
+            continue
+        r = json.loads(line)
+        key = (r.get('suite', ''), r['name'])
+        if key not in results or r['seconds'] < results[key]:
+            results[key] = r['seconds']
+    return results
+
+
+def label(key):
+    ''' the printable name of a (suite, name) key. '''
+    suite, name = key
+    return "%s: %s" % (suite, name) if suite else name
+
+
+def main():
+    if len(argv) < 3:
+        print("usage: %s old.jsonl new.jsonl [threshold]" % argv[0])
+        exit(2)
+    old = load(argv[1])
+    new = load(argv[2])
+    threshold = float(argv[3]) if len(argv) > 3 else 0.1
+    regressions = 0
+    width = max([len(label(k)) for k in new] + [9])
+    print("%-*s %12s %12s %9s" % (width, "benchmark", "old [ms]",
+        "new [ms]", "change"))
+    for key in sorted(new):
+        if key not in old:
+            print("%-*s %12s %12.3f %9s" % (width, label(key), "-",
+                new[key] * 1e3, "new"))
+            continue
+        # positive: faster
+        change = old[key] / new[key] - 1.0
+        flag = ""
+        if change < -threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-*s %12.3f %12.3f %+8.1f%%%s" % (width, label(key),
+            old[key] * 1e3, new[key] * 1e3, change * 100.0, flag))
+    for key in sorted(set(old) - set(new)):
+        print("%-*s %12.3f %12s %9s" % (width, label(key), old[key] * 1e3,
+            "-", "removed"))
+    if regressions:
+        print("%d benchmark(s) slowed down by more than %.0f%%." %
+            (regressions, threshold * 100.0))
+        exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,99 @@
+/*
+ * Centroider-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/Centroider.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+        SumAbundanceAccumulator> MyCentroider;
+
+struct CentroidRun
+{
+    const std::vector<Spectrum>& run;
+    explicit CentroidRun(const std::vector<Spectrum>& r) :
+        run(r)
+    {
+    }
+    void operator()() const
+    {
+        MyCentroider c;
+        std::vector<Centroid> cs;
+        for (std::vector<Spectrum>::const_iterator i = run.begin(); i
+                != run.end(); ++i) {
+            c(i->begin(), i->end(), i->getRetentionTime(), i->getScanNumber(),
+                std::back_inserter(cs));
+        }
+        benchmark::doNotOptimize(cs);
+    }
+};
+
+}
+
+int main()
+{
+    // synthetic profile mode runs with increasing peptide density
+    Size nPeptides[] = { 100, 400, 1600 };
+    for (Size k = 0; k < 3; ++k) {
+        benchmark::LcMsRunParameters p;
+        p.nScans = 100;
+        p.nPeptides = nPeptides[k];
+        benchmark::SyntheticRun synthetic;
+        benchmark::makeLcMsRun(p, true, synthetic);
+        std::vector<Spectrum> run(synthetic.size());
+        Size nPoints = 0;
+        for (Size i = 0; i < synthetic.size(); ++i) {
+            const benchmark::SyntheticScan& scan = synthetic[i];
+            run[i].setRetentionTime(scan.retentionTime);
+            run[i].setScanNumber(scan.scanNumber);
+            run[i].reserve(scan.peaks.size());
+            for (Size j = 0; j < scan.peaks.size(); ++j) {
+                run[i].push_back(SpectrumElement(scan.peaks[j].mz,
+                    scan.peaks[j].abundance));
+            }
+            nPoints += scan.peaks.size();
+        }
+        std::cout << "Centroiding " << run.size() << " profile spectra, "
+                << p.nPeptides << " peptides, " << nPoints
+                << " points (throughput in points)" << std::endl;
+        std::ostringstream name;
+        name << "Centroider, " << p.nPeptides << " peptides";
+        benchmark::run(name.str(), CentroidRun(run), nPoints, 5);
+    }
+    return 0;
+}
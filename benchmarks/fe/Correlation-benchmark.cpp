@@ -0,0 +1,232 @@
+/*
+ * Correlation-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/InstructionSet.hpp>
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/DenseUncenteredCorrelation.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/UncenteredCorrelation.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/DenseXicProfile.hpp>
+#include <MSTK/fe/types/ProfileKernels.hpp>
+#include <MSTK/fe/types/XicFbiTraits.hpp>
+#include <MSTK/fe/types/XicProfile.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef XicExtractor<CentroidWeightedMeanDisambiguator, RunningMeanSmoother,
+        XicLocalMinSplitter<Xic> > MyXicExtractor;
+typedef std::vector<std::pair<Size, Size> > Pairs;
+
+class MergeCorrelator : public UncenteredCorrelation
+{
+public:
+    template<class IT>
+    ThresholdType run(IT lhsFirst, IT lhsLast, IT rhsFirst, IT rhsLast)
+    {
+        return correlate(lhsFirst, lhsLast, rhsFirst, rhsLast);
+    }
+};
+
+class DenseCorrelator : public DenseUncenteredCorrelation
+{
+public:
+    ThresholdType run(const DenseXicProfileArena& profiles, Size i, Size j)
+    {
+        return correlate(profiles, i, j);
+    }
+};
+
+/** The merge walk over the XICs' centroid objects.
+ */
+struct MergeOnXics
+{
+    const std::vector<Xic>& xics;
+    const Pairs& pairs;
+    MergeOnXics(const std::vector<Xic>& xs, const Pairs& ps) :
+        xics(xs), pairs(ps)
+    {
+    }
+    void operator()() const
+    {
+        MergeCorrelator c;
+        double sum = 0.0;
+        for (Pairs::const_iterator p = pairs.begin(); p != pairs.end(); ++p) {
+            sum += c.run(xics[p->first].begin(), xics[p->first].end(),
+                xics[p->second].begin(), xics[p->second].end());
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+/** The merge walk over packed (rt, abundance) profiles.
+ */
+struct MergeOnArena
+{
+    const XicProfileArena& profiles;
+    const Pairs& pairs;
+    MergeOnArena(const XicProfileArena& a, const Pairs& ps) :
+        profiles(a), pairs(ps)
+    {
+    }
+    void operator()() const
+    {
+        MergeCorrelator c;
+        double sum = 0.0;
+        for (Pairs::const_iterator p = pairs.begin(); p != pairs.end(); ++p) {
+            sum += c.run(profiles.begin(p->first), profiles.end(p->first),
+                profiles.begin(p->second), profiles.end(p->second));
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+/** The dot product on dense profiles with the kernels of one level.
+ */
+struct DotOnDense
+{
+    const DenseXicProfileArena& profiles;
+    const Pairs& pairs;
+    const ProfileKernels& k;
+    DotOnDense(const DenseXicProfileArena& a, const Pairs& ps,
+        const ProfileKernels& k_) :
+        profiles(a), pairs(ps), k(k_)
+    {
+    }
+    void operator()() const
+    {
+        double sum = 0.0;
+        for (Pairs::const_iterator p = pairs.begin(); p != pairs.end(); ++p) {
+            const Size i = p->first, j = p->second;
+            const Size fi = profiles.getFirstScan(i);
+            const Size fj = profiles.getFirstScan(j);
+            const Size lo = std::max(fi, fj);
+            const Size hi = std::min(fi + profiles.getLength(i),
+                fj + profiles.getLength(j));
+            if (hi > lo) {
+                sum += k.dotProduct(profiles.data(i) + (lo - fi),
+                    profiles.data(j) + (lo - fj), hi - lo);
+            }
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+/** The complete dense correlator, as used by IsotopePatternExtractor.
+ */
+struct DenseCorrelation
+{
+    const DenseXicProfileArena& profiles;
+    const Pairs& pairs;
+    DenseCorrelation(const DenseXicProfileArena& a, const Pairs& ps) :
+        profiles(a), pairs(ps)
+    {
+    }
+    void operator()() const
+    {
+        DenseCorrelator c;
+        double sum = 0.0;
+        for (Pairs::const_iterator p = pairs.begin(); p != pairs.end(); ++p) {
+            sum += c.run(profiles, p->first, p->second);
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+}
+
+int main()
+{
+    // XICs from a synthetic centroided LC-MS run
+    benchmark::LcMsRunParameters p;
+    p.nScans = 400;
+    p.nPeptides = 400;
+    benchmark::SyntheticRun run;
+    benchmark::makeLcMsRun(p, false, run);
+    Spectrum raw;
+    std::vector<Centroid> cs;
+    for (benchmark::SyntheticRun::const_iterator s = run.begin(); s
+            != run.end(); ++s) {
+        for (Size i = 0; i < s->peaks.size(); ++i) {
+            cs.push_back(Centroid(s->retentionTime, s->peaks[i].mz,
+                s->scanNumber, s->peaks[i].abundance, raw.begin(),
+                raw.end()));
+        }
+    }
+    MyXicExtractor xe;
+    std::vector<Xic> xics;
+    xe(cs, CentroidBoxGenerator(3, 5.0), 3, 0.76, xics);
+    // candidate pairs as produced by the box intersection: co-eluting XICs
+    std::vector<XicBoxGenerator> boxGenerators;
+    for (Size i = 0; i < p.charges.size(); ++i) {
+        boxGenerators.push_back(XicBoxGenerator(1.00286864,
+            std::make_pair(2.0, 20.0), std::make_pair(2.0, 10.0),
+            p.charges[i]));
+    }
+    fbi::SetA<Xic, 0, 1>::ResultType adjList = fbi::SetA<Xic, 0, 1>::intersect(
+        xics, boxGenerators[0], boxGenerators);
+    Pairs pairs;
+    for (Size i = 0; i < adjList.size(); ++i) {
+        for (Size k = 0; k < adjList[i].size(); ++k) {
+            if (adjList[i][k] < i) {
+                pairs.push_back(std::make_pair(i, Size(adjList[i][k])));
+            }
+        }
+    }
+    XicProfileArena sparse;
+    sparse.assign(xics);
+    DenseXicProfileArena dense;
+    dense.assign(xics);
+    std::cout << "Correlating " << pairs.size() << " candidate pairs of "
+            << xics.size() << " XICs" << std::endl;
+    benchmark::run("merge walk on XICs", MergeOnXics(xics, pairs),
+        pairs.size(), 20);
+    benchmark::run("merge walk on packed profiles", MergeOnArena(sparse,
+        pairs), pairs.size(), 20);
+    benchmark::run("DenseUncenteredCorrelation", DenseCorrelation(dense,
+        pairs), pairs.size(), 20);
+    const int supported = InstructionSet::getSupported();
+    for (int l = InstructionSet::SCALAR; l <= supported; ++l) {
+        const ProfileKernels& k = ProfileKernels::get(
+            static_cast<InstructionSet::Level> (l));
+        if (k.level != l) {
+            continue; // no dedicated kernels for this level
+        }
+        benchmark::run(std::string(InstructionSet::getName(k.level))
+                + " dotProduct", DotOnDense(dense, pairs, k), pairs.size(), 20);
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*
+ * FeatureFinder-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/Centroider.hpp>
+#include <MSTK/fe/FeatureFinder.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/IsotopePatternExtractor.hpp>
+#include <MSTK/fe/NopSplitter.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/StreamingXicExtractor.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/fe/UncenteredCorrelation.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/IsotopePattern.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/XicFbiTraits.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+        SumAbundanceAccumulator> MyCentroider;
+typedef XicExtractor<CentroidWeightedMeanDisambiguator, RunningMeanSmoother,
+        XicLocalMinSplitter<Xic> > MyXicExtractor;
+typedef StreamingXicExtractor<CentroidWeightedMeanDisambiguator,
+        RunningMeanSmoother, XicLocalMinSplitter<Xic> , Xic,
+        CentroidBoxGenerator> MyStreamingXicExtractor;
+typedef IsotopePatternExtractor<UncenteredCorrelation, NopSplitter>
+        MyIsotopePatternExtractor;
+typedef FeatureFinder<MyCentroider, MyStreamingXicExtractor,
+        MyIsotopePatternExtractor, IsotopePattern, XicBoxGenerator>
+        MyFeatureFinder;
+
+/** The hand-wired pipeline: every stage materializes its full output.
+ */
+struct BatchRun
+{
+    const std::vector<Spectrum>& run;
+    const std::vector<XicBoxGenerator>& boxGenerators;
+    BatchRun(const std::vector<Spectrum>& r,
+        const std::vector<XicBoxGenerator>& bgs) :
+        run(r), boxGenerators(bgs)
+    {
+    }
+    void operator()() const
+    {
+        MyCentroider c;
+        std::vector<Centroid> cs;
+        for (std::vector<Spectrum>::const_iterator i = run.begin(); i
+                != run.end(); ++i) {
+            c(i->begin(), i->end(), i->getRetentionTime(), i->getScanNumber(),
+                std::back_inserter(cs));
+        }
+        MyXicExtractor xe;
+        std::vector<Xic> xics;
+        xe(cs, CentroidBoxGenerator(3, 5.0), 3, 0.76, xics);
+        MyIsotopePatternExtractor ipe;
+        std::vector<IsotopePattern> ips;
+        ipe(xics, boxGenerators, 0.6, 2, ips);
+        benchmark::doNotOptimize(ips);
+    }
+};
+
+struct StreamingRun
+{
+    const std::vector<Spectrum>& run;
+    const std::vector<XicBoxGenerator>& boxGenerators;
+    MyFeatureFinder::Mode mode;
+    StreamingRun(const std::vector<Spectrum>& r,
+        const std::vector<XicBoxGenerator>& bgs,
+        const MyFeatureFinder::Mode m) :
+        run(r), boxGenerators(bgs), mode(m)
+    {
+    }
+    void operator()() const
+    {
+        Size n = 0;
+        MyFeatureFinder ff(MyCentroider(), CentroidBoxGenerator(3, 5.0), 3,
+            0.76, boxGenerators, 0.6, 2, [&n](IsotopePattern&&) {++n;}, mode);
+        for (std::vector<Spectrum>::const_iterator i = run.begin(); i
+                != run.end(); ++i) {
+            ff.addScan(*i);
+        }
+        ff.flush();
+        benchmark::doNotOptimize(n);
+    }
+};
+
+}
+
+int main()
+{
+    benchmark::LcMsRunParameters p;
+    p.nScans = 200;
+    std::vector<XicBoxGenerator> boxGenerators;
+    for (Size i = 0; i < p.charges.size(); ++i) {
+        boxGenerators.push_back(XicBoxGenerator(1.00286864,
+            std::make_pair(2.0, 20.0), std::make_pair(2.0, 10.0),
+            p.charges[i]));
+    }
+    Size nPeptides[] = { 100, 400 };
+    for (Size k = 0; k < 2; ++k) {
+        p.nPeptides = nPeptides[k];
+        benchmark::SyntheticRun synthetic;
+        benchmark::makeLcMsRun(p, true, synthetic);
+        std::vector<Spectrum> run(synthetic.size());
+        Size nPoints = 0;
+        for (Size i = 0; i < synthetic.size(); ++i) {
+            const benchmark::SyntheticScan& scan = synthetic[i];
+            run[i].setRetentionTime(scan.retentionTime);
+            run[i].setScanNumber(scan.scanNumber);
+            run[i].reserve(scan.peaks.size());
+            for (Size j = 0; j < scan.peaks.size(); ++j) {
+                run[i].push_back(SpectrumElement(scan.peaks[j].mz,
+                    scan.peaks[j].abundance));
+            }
+            nPoints += scan.peaks.size();
+        }
+        std::cout << "Feature finding on " << run.size()
+                << " profile spectra, " << p.nPeptides
+                << " peptides, " << nPoints << " points (throughput in points)"
+                << std::endl;
+        std::ostringstream name;
+        name << "FeatureFinder, " << p.nPeptides << " peptides, ";
+        benchmark::run(name.str() + "batch", BatchRun(run, boxGenerators),
+            nPoints, 3);
+        benchmark::run(name.str() + "sequential", StreamingRun(run,
+            boxGenerators, MyFeatureFinder::SEQUENTIAL), nPoints, 3);
+        benchmark::run(name.str() + "pipelined", StreamingRun(run,
+            boxGenerators, MyFeatureFinder::PIPELINED), nPoints, 3);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * IsotopePatternExtractor-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/IsotopePatternExtractor.hpp>
+#include <MSTK/fe/NopSplitter.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/UncenteredCorrelation.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/IsotopePattern.hpp>
+#include <MSTK/fe/types/XicFbiTraits.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <sstream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef XicExtractor<CentroidWeightedMeanDisambiguator, RunningMeanSmoother,
+        XicLocalMinSplitter<Xic> > MyXicExtractor;
+typedef IsotopePatternExtractor<UncenteredCorrelation, NopSplitter>
+        MyIsotopePatternExtractor;
+
+struct Extraction
+{
+    const std::vector<Xic>& xics;
+    const std::vector<XicBoxGenerator>& boxGenerators;
+    UnsignedInt nThreads;
+    Extraction(const std::vector<Xic>& xs,
+        const std::vector<XicBoxGenerator>& bgs, const UnsignedInt n) :
+        xics(xs), boxGenerators(bgs), nThreads(n)
+    {
+    }
+    void operator()() const
+    {
+        MyIsotopePatternExtractor ipe(nThreads);
+        std::vector<IsotopePattern> ips;
+        ipe(xics, boxGenerators, 0.6, 2, ips);
+        benchmark::doNotOptimize(ips);
+    }
+};
+
+}
+
+int main()
+{
+    // XICs from a synthetic centroided LC-MS run
+    benchmark::LcMsRunParameters p;
+    p.nScans = 400;
+    benchmark::SyntheticRun run;
+    Spectrum raw;
+    std::vector<XicBoxGenerator> boxGenerators;
+    for (Size i = 0; i < p.charges.size(); ++i) {
+        boxGenerators.push_back(XicBoxGenerator(1.00286864,
+            std::make_pair(2.0, 20.0), std::make_pair(2.0, 10.0),
+            p.charges[i]));
+    }
+    Size nPeptides[] = { 100, 400 };
+    for (Size k = 0; k < 2; ++k) {
+        p.nPeptides = nPeptides[k];
+        benchmark::makeLcMsRun(p, false, run);
+        std::vector<Centroid> cs;
+        for (benchmark::SyntheticRun::const_iterator s = run.begin(); s
+                != run.end(); ++s) {
+            for (Size i = 0; i < s->peaks.size(); ++i) {
+                cs.push_back(Centroid(s->retentionTime, s->peaks[i].mz,
+                    s->scanNumber, s->peaks[i].abundance, raw.begin(),
+                    raw.end()));
+            }
+        }
+        MyXicExtractor xe;
+        CentroidBoxGenerator bg(3, 5.0);
+        std::vector<Xic> xics;
+        xe(cs, bg, 3, 0.76, xics);
+        std::cout << "Isotope pattern extraction from " << xics.size()
+                << " XICs (" << p.nPeptides << " peptides, "
+                << p.charges.size() << " charge states)" << std::endl;
+        std::ostringstream name;
+        name << "IsotopePatternExtractor, " << p.nPeptides << " peptides";
+        benchmark::run(name.str(), Extraction(xics, boxGenerators, 1),
+            xics.size(), 5);
+        benchmark::run(name.str() + ", all threads", Extraction(xics,
+            boxGenerators, 0), xics.size(), 5);
+    }
+    return 0;
+}
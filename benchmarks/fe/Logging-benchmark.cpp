@@ -0,0 +1,183 @@
+/*
+ * Logging-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// Compile all logging statements into this benchmark, independent of the
+// global MSTK_LOG_MAX_LEVEL. The LoggingCompiledOut variant removes them.
+#undef MSTK_LOG_MAX_LEVEL
+#ifdef MSTK_BENCHMARK_LOG_COMPILED_OUT
+#define MSTK_LOG_MAX_LEVEL mstk::logNO_LOGGING
+#else
+#define MSTK_LOG_MAX_LEVEL mstk::logDEBUG4
+#endif
+
+#include <MSTK/common/Log.hpp>
+#include <MSTK/common/Output2Async.hpp>
+#include <MSTK/common/parallelFor.hpp>
+#include <MSTK/fe/Centroider.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include "benchmark.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+        SumAbundanceAccumulator> MyCentroider;
+
+struct CentroidRun
+{
+    const std::vector<Spectrum>& run;
+    explicit CentroidRun(const std::vector<Spectrum>& r) :
+        run(r)
+    {
+    }
+    void operator()() const
+    {
+        MyCentroider c;
+        std::vector<Centroid> cs;
+        for (std::vector<Spectrum>::const_iterator i = run.begin(); i
+                != run.end(); ++i) {
+            cs.clear();
+            c(i->begin(), i->end(), i->getRetentionTime(), i->getScanNumber(),
+                std::back_inserter(cs));
+            benchmark::doNotOptimize(cs);
+        }
+    }
+};
+
+template<typename LogType>
+struct LogMessage
+{
+    void operator()(const Size i, const UnsignedInt) const
+    {
+        LogType().get(logDEBUG) << "message " << i << ", m/z " << 500.0 + i;
+    }
+};
+
+template<typename LogType>
+struct LogRun
+{
+    Size n;
+    UnsignedInt nThreads;
+    LogRun(const Size nMessages, const UnsignedInt nt) :
+        n(nMessages), nThreads(nt)
+    {
+    }
+    void operator()() const
+    {
+        parallelFor(0, n, LogMessage<LogType>(), nThreads, 64);
+    }
+};
+
+}
+
+int main()
+{
+    // 200 profile spectra with 500 peaks each
+    const Size nSpectra = 200;
+    const Size nPeaks = 500;
+    std::vector<Spectrum> run(nSpectra);
+    std::srand(42);
+    for (Size k = 0; k < nSpectra; ++k) {
+        Spectrum& s = run[k];
+        s.setRetentionTime(1.0 * k);
+        s.setScanNumber(static_cast<unsigned int>(k + 1));
+        for (Size p = 0; p < nPeaks; ++p) {
+            double center = 300.0 + 3.0 * p + std::rand() / (RAND_MAX + 1.0);
+            double height = 1e3 + 1e6 * std::rand() / (RAND_MAX + 1.0);
+            for (int j = -6; j <= 6; ++j) {
+                double d = 0.004 * j;
+                s.push_back(SpectrumElement(center + d,
+                    height * std::exp(-d * d / 1e-4)));
+            }
+        }
+    }
+
+    std::cout << "Centroiding " << nSpectra << " spectra with " << nPeaks
+            << " peaks each (throughput in centroids)" << std::endl;
+#ifdef MSTK_BENCHMARK_LOG_COMPILED_OUT
+    std::cout << "Logging compiled out (MSTK_LOG_MAX_LEVEL = NO_LOGGING)"
+            << std::endl;
+#else
+    std::cout << "Logging compiled in (MSTK_LOG_MAX_LEVEL = DEBUG4)"
+            << std::endl;
+#endif
+
+    LogLevel reportingLevel = FILELog::getReportingLevel();
+    FILE* redirect = Output2FILE::getRedirect();
+
+    // compiled in, disabled through the runtime reporting level
+    FILELog::getReportingLevel() = logINFO;
+    double disabled = benchmark::run("Centroider, runtime level INFO",
+        CentroidRun(run), nSpectra * nPeaks, 3);
+
+#ifndef MSTK_BENCHMARK_LOG_COMPILED_OUT
+    // compiled in and enabled; formatting cost only, output is discarded
+    FILE* devNull = std::fopen("/dev/null", "w");
+    if (devNull) {
+        FILELog::getReportingLevel() = logDEBUG4;
+        Output2FILE::getRedirect() = devNull;
+        double enabled = benchmark::run(
+            "Centroider, runtime level DEBUG4 (to /dev/null)",
+            CentroidRun(run), nSpectra * nPeaks, 1);
+        Output2FILE::getRedirect() = redirect;
+        std::cout << "    slowdown: " << enabled / disabled << std::endl;
+
+        // message throughput of the synchronous and asynchronous sinks
+        const Size nMessages = 200000;
+        Output2FILE::getRedirect() = devNull;
+        Output2Async::getRedirect() = devNull;
+        Output2Async::start(1 << 14, Output2Async::BLOCK);
+        for (UnsignedInt nt = 1; nt <= getNumberOfThreads(); nt *= 2) {
+            std::ostringstream name;
+            name << nt << " thread(s), ";
+            benchmark::run(name.str() + "Output2FILE",
+                LogRun<FILELog>(nMessages, nt), nMessages, 3);
+            benchmark::run(name.str() + "Output2Async",
+                LogRun<AsyncLog>(nMessages, nt), nMessages, 3);
+            Output2Async::flush();
+        }
+        Output2Async::stop();
+        Output2FILE::getRedirect() = redirect;
+        Output2Async::getRedirect() = redirect;
+        std::fclose(devNull);
+    }
+#endif
+
+    FILELog::getReportingLevel() = reportingLevel;
+    Output2FILE::getRedirect() = redirect;
+    return 0;
+}
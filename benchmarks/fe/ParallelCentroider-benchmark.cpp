@@ -0,0 +1,104 @@
+/*
+ * ParallelCentroider-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/parallelFor.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/ParallelCentroider.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include "benchmark.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef ParallelCentroider<Centroid, SimpleBumpFinder,
+        GaussianMeanAccumulator, SumAbundanceAccumulator> MyParallelCentroider;
+
+struct CentroidRun
+{
+    const std::vector<Spectrum>& run;
+    UnsignedInt nThreads;
+    CentroidRun(const std::vector<Spectrum>& r, UnsignedInt nt) :
+        run(r), nThreads(nt)
+    {
+    }
+    void operator()() const
+    {
+        std::vector<Centroid> cs;
+        MyParallelCentroider pc(nThreads);
+        pc(run.begin(), run.end(), std::back_inserter(cs));
+        benchmark::doNotOptimize(cs);
+    }
+};
+
+}
+
+int main()
+{
+    // 2000 profile spectra with 500 peaks each
+    const Size nSpectra = 2000;
+    const Size nPeaks = 500;
+    std::vector<Spectrum> run(nSpectra);
+    std::srand(42);
+    for (Size k = 0; k < nSpectra; ++k) {
+        Spectrum& s = run[k];
+        s.setRetentionTime(1.0 * k);
+        s.setScanNumber(static_cast<unsigned int>(k + 1));
+        for (Size p = 0; p < nPeaks; ++p) {
+            double center = 300.0 + 3.0 * p + std::rand() / (RAND_MAX + 1.0);
+            double height = 1e3 + 1e6 * std::rand() / (RAND_MAX + 1.0);
+            for (int j = -6; j <= 6; ++j) {
+                double d = 0.004 * j;
+                s.push_back(SpectrumElement(center + d,
+                    height * std::exp(-d * d / 1e-4)));
+            }
+        }
+    }
+
+    std::cout << "Centroiding " << nSpectra << " spectra with " << nPeaks
+            << " peaks each (throughput in centroids)" << std::endl;
+    const UnsignedInt maxThreads = getNumberOfThreads();
+    double serial = 0.0;
+    for (UnsignedInt nt = 1; nt <= maxThreads; nt *= 2) {
+        std::ostringstream name;
+        name << "ParallelCentroider, " << nt << " thread(s)";
+        double t = benchmark::run(name.str(), CentroidRun(run, nt),
+            nSpectra * nPeaks, 3);
+        if (nt == 1) {
+            serial = t;
+        }
+        std::cout << "    speedup: " << serial / t << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * QuickCharge-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/parallelFor.hpp>
+#include <MSTK/fe/QuickCharge.hpp>
+#include <MSTK/fe/types/IsotopePattern.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+struct SerialCharges
+{
+    const std::vector<IsotopePattern>& ips;
+    const QuickCharge& qc;
+    SerialCharges(const std::vector<IsotopePattern>& i, const QuickCharge& q) :
+        ips(i), qc(q)
+    {
+    }
+    void operator()() const
+    {
+        std::vector<int> charges;
+        Size n = 0;
+        for (Size i = 0; i < ips.size(); ++i) {
+            charges.clear();
+            qc(ips[i].begin(), ips[i].end(), std::back_inserter(charges));
+            n += charges.size();
+        }
+        benchmark::doNotOptimize(n);
+    }
+};
+
+struct BatchCharges
+{
+    const std::vector<IsotopePattern>& ips;
+    const QuickCharge& qc;
+    UnsignedInt nThreads;
+    BatchCharges(const std::vector<IsotopePattern>& i, const QuickCharge& q,
+        const UnsignedInt n) :
+        ips(i), qc(q), nThreads(n)
+    {
+    }
+    void operator()() const
+    {
+        std::vector<ChargeSet> charges;
+        qc.getCharges(ips, charges, nThreads);
+        benchmark::doNotOptimize(charges);
+    }
+};
+
+}
+
+int main()
+{
+    // isotope patterns of 2 to 8 XICs with charges 1 to 6 and the odd
+    // contaminant
+    std::srand(42);
+    std::vector<IsotopePattern> ips;
+    for (Size p = 0; p < 100000; ++p) {
+        const int z = 1 + std::rand() % 6;
+        const int n = 2 + std::rand() % 7;
+        const double mz0 = 300.0 + 1500.0 * std::rand() / RAND_MAX;
+        IsotopePattern ip;
+        for (int k = 0; k < n; ++k) {
+            double mz = mz0 + k * 1.00286864 / z;
+            if (std::rand() % 10 == 0) {
+                mz += 0.1 * std::rand() / RAND_MAX;
+            }
+            Xic x;
+            for (unsigned int s = 0; s < 3; ++s) {
+                Centroid c;
+                c.setMz(mz);
+                c.setRetentionTime(2.0 * s);
+                c.setScanNumber(s);
+                c.setAbundance(1000.0);
+                x.push_back(c);
+            }
+            x.recalculate();
+            ip.push_back(x);
+        }
+        ips.push_back(ip);
+    }
+    std::cout << "QuickCharge on " << ips.size() << " isotope patterns"
+            << std::endl;
+    QuickCharge qc;
+    benchmark::run("QuickCharge, serial", SerialCharges(ips, qc), ips.size());
+    QuickCharge filtered(0.01, 2);
+    benchmark::run("QuickCharge, serial, filtered",
+        SerialCharges(ips, filtered), ips.size());
+    const UnsignedInt maxThreads = getNumberOfThreads();
+    for (UnsignedInt n = 1; n <= maxThreads; n *= 2) {
+        std::ostringstream name;
+        name << "QuickCharge, batch, " << n << " threads";
+        benchmark::run(name.str(), BatchCharges(ips, qc, n), ips.size());
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * ScanTable-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/ScanTable.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include "benchmark.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+// Restores the acquisition order after each repetition.
+struct LessThanScanNumber
+{
+    template<typename S>
+    bool operator()(const S& lhs, const S& rhs) const
+    {
+        return lhs.getScanNumber() < rhs.getScanNumber();
+    }
+};
+
+// Both functors sort by retention time and back into acquisition order.
+struct SortSpectra
+{
+    std::vector<Spectrum>& run;
+    SortSpectra(std::vector<Spectrum>& r) :
+        run(r)
+    {
+    }
+    void operator()() const
+    {
+        std::stable_sort(run.begin(), run.end(),
+            Spectrum::LessThanRt<Spectrum, Spectrum>());
+        std::stable_sort(run.begin(), run.end(), LessThanScanNumber());
+        benchmark::doNotOptimize(run);
+    }
+};
+
+struct SortTable
+{
+    ScanTable& table;
+    SortTable(ScanTable& t) :
+        table(t)
+    {
+    }
+    void operator()() const
+    {
+        table.sort(Spectrum::LessThanRt<ScanTable::Row, ScanTable::Row>());
+        table.sort(LessThanScanNumber());
+        benchmark::doNotOptimize(table);
+    }
+};
+
+// Both functors move the MS1 scans to the front and restore the
+// acquisition order.
+struct PartitionSpectra
+{
+    std::vector<Spectrum>& run;
+    PartitionSpectra(std::vector<Spectrum>& r) :
+        run(r)
+    {
+    }
+    void operator()() const
+    {
+        std::stable_partition(run.begin(), run.end(),
+            Spectrum::EqualMsLevel(1));
+        std::stable_sort(run.begin(), run.end(), LessThanScanNumber());
+        benchmark::doNotOptimize(run);
+    }
+};
+
+struct PartitionTable
+{
+    ScanTable& table;
+    PartitionTable(ScanTable& t) :
+        table(t)
+    {
+    }
+    void operator()() const
+    {
+        table.partition(Spectrum::EqualMsLevel(1));
+        table.sort(LessThanScanNumber());
+        benchmark::doNotOptimize(table);
+    }
+};
+
+}
+
+int main()
+{
+    // a DDA run: one MS1 scan per ten MS2 scans, acquired out of order
+    const Size nScans = 100000;
+    const Size nPeaks = 100;
+    std::vector<Spectrum> run;
+    std::srand(42);
+    for (Size i = 0; i < nScans; ++i) {
+        Spectrum s;
+        s.setScanNumber(i + 1);
+        s.setRetentionTime(std::rand() / (RAND_MAX + 1.0) * 3600.0);
+        s.setMsLevel(i % 10 == 0 ? 1 : 2);
+        for (Size j = 0; j < nPeaks; ++j) {
+            s.push_back(SpectrumElement(100.0 + 10.0 * j, 1.0));
+        }
+        run.push_back(s);
+    }
+    ScanTable table;
+    table.reserve(nScans, nScans * nPeaks);
+    for (Size i = 0; i < nScans; ++i) {
+        table.add(run[i]);
+    }
+
+    std::cout << "Reordering " << nScans << " scans with " << nPeaks
+            << " peaks each" << std::endl;
+    benchmark::run("vector<Spectrum>, sort by rt", SortSpectra(run), nScans,
+        3);
+    benchmark::run("ScanTable, sort by rt", SortTable(table), nScans, 3);
+    benchmark::run("vector<Spectrum>, partition by MS level",
+        PartitionSpectra(run), nScans, 3);
+    benchmark::run("ScanTable, partition by MS level", PartitionTable(table),
+        nScans, 3);
+    return 0;
+}
@@ -0,0 +1,277 @@
+/*
+ * Spectrum-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/Collection.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+// The pre-StaticCollection layout of Spectrum: all element access goes
+// through the virtual Collection<T> interface.
+class VirtualSpectrum : public Collection<SpectrumElement>
+{
+};
+
+// Keep the loops out of line so that the compiler cannot see the
+// dynamic type of the container at the call site.
+template<typename C>
+MSTK_BENCHMARK_NOINLINE double sumByIterator(const C& c)
+{
+    double sum = 0.0;
+    for (typename C::const_iterator i = c.begin(); i != c.end(); ++i) {
+        sum += i->abundance;
+    }
+    return sum;
+}
+
+template<typename C>
+MSTK_BENCHMARK_NOINLINE double sumByIndex(const C& c)
+{
+    double sum = 0.0;
+    for (typename C::size_type i = 0; i < c.size(); ++i) {
+        sum += c[i].abundance;
+    }
+    return sum;
+}
+
+template<typename C>
+struct IteratorLoop
+{
+    const C& c;
+    IteratorLoop(const C& c_) :
+        c(c_)
+    {
+    }
+    void operator()() const
+    {
+        double s = sumByIterator(c);
+        benchmark::doNotOptimize(s);
+    }
+};
+
+template<typename C>
+struct IndexLoop
+{
+    const C& c;
+    IndexLoop(const C& c_) :
+        c(c_)
+    {
+    }
+    void operator()() const
+    {
+        double s = sumByIndex(c);
+        benchmark::doNotOptimize(s);
+    }
+};
+
+struct PairwiseMerge
+{
+    const std::vector<Spectrum>& spectra;
+    PairwiseMerge(const std::vector<Spectrum>& s) :
+        spectra(s)
+    {
+    }
+    void operator()() const
+    {
+        Spectrum merged;
+        for (Size k = 0; k < spectra.size(); ++k) {
+            merged.merge(spectra[k]);
+        }
+        benchmark::doNotOptimize(merged);
+    }
+};
+
+struct KWayMerge
+{
+    const std::vector<Spectrum>& spectra;
+    KWayMerge(const std::vector<Spectrum>& s) :
+        spectra(s)
+    {
+    }
+    void operator()() const
+    {
+        Spectrum merged = mergeSpectra(spectra.begin(), spectra.end());
+        benchmark::doNotOptimize(merged);
+    }
+};
+
+// The allocating removeDuplicates() of earlier releases: builds a new
+// spectrum element by element.
+MSTK_BENCHMARK_NOINLINE Spectrum legacyRemoveDuplicates(const Spectrum& s,
+    const double tol)
+{
+    Spectrum r;
+    Spectrum::const_iterator i = s.begin();
+    while (i != s.end()) {
+        double ab = i->abundance;
+        double mzAb = i->mz * i->abundance;
+        Spectrum::const_iterator j = i + 1;
+        for (; j != s.end() && j->mz - i->mz < tol; ++j) {
+            ab += j->abundance;
+            mzAb += j->mz * j->abundance;
+        }
+        r.push_back(SpectrumElement(ab > 0.0 ? mzAb / ab : i->mz, ab));
+        i = j;
+    }
+    return r;
+}
+
+struct LegacyRemoveDuplicates
+{
+    const Spectrum& s;
+    LegacyRemoveDuplicates(const Spectrum& s_) :
+        s(s_)
+    {
+    }
+    void operator()() const
+    {
+        Spectrum r = legacyRemoveDuplicates(s, 0.0016);
+        benchmark::doNotOptimize(r);
+    }
+};
+
+struct RemoveDuplicates
+{
+    const Spectrum& s;
+    RemoveDuplicates(const Spectrum& s_) :
+        s(s_)
+    {
+    }
+    void operator()() const
+    {
+        Spectrum r = s.removeDuplicates(0.0016);
+        benchmark::doNotOptimize(r);
+    }
+};
+
+// Refills a preallocated working spectrum and compacts it in place; the
+// copy is included in the timing.
+struct CompactDuplicates
+{
+    const Spectrum& s;
+    Spectrum& work;
+    CompactDuplicates(const Spectrum& s_, Spectrum& w) :
+        s(s_), work(w)
+    {
+    }
+    void operator()() const
+    {
+        work.assign(s.begin(), s.end());
+        Spectrum::size_type n = work.compactDuplicates(0.0016);
+        benchmark::doNotOptimize(n);
+    }
+};
+
+// Compacts a spectrum in place; only meaningful for spectra without
+// duplicates, which are left unchanged.
+struct CompactDuplicatesInPlace
+{
+    Spectrum& s;
+    CompactDuplicatesInPlace(Spectrum& s_) :
+        s(s_)
+    {
+    }
+    void operator()() const
+    {
+        Spectrum::size_type n = s.compactDuplicates(0.0016);
+        benchmark::doNotOptimize(n);
+    }
+};
+
+}
+
+int main()
+{
+    const Size n = 1000000;
+    Spectrum s;
+    VirtualSpectrum v;
+    s.reserve(n);
+    v.reserve(n);
+    std::srand(42);
+    for (Size i = 0; i < n; ++i) {
+        SpectrumElement e(300.0 + 0.001 * i, std::rand() / (RAND_MAX + 1.0));
+        s.push_back(e);
+        v.push_back(e);
+    }
+    // access the legacy object through its base class, as client code does
+    const Collection<SpectrumElement>& vc = v;
+
+    std::cout << "Iteration over a " << n << "-element spectrum" << std::endl;
+    benchmark::run("Collection (virtual), iterator loop",
+        IteratorLoop<Collection<SpectrumElement> >(vc), n);
+    benchmark::run("StaticCollection, iterator loop",
+        IteratorLoop<Spectrum>(s), n);
+    benchmark::run("Collection (virtual), index loop",
+        IndexLoop<Collection<SpectrumElement> >(vc), n);
+    benchmark::run("StaticCollection, index loop", IndexLoop<Spectrum>(s), n);
+
+    // summing MS1 scans
+    const Size nScans = 200;
+    const Size nPeaks = 5000;
+    std::vector<Spectrum> scans(nScans);
+    for (Size k = 0; k < nScans; ++k) {
+        for (Size i = 0; i < nPeaks; ++i) {
+            scans[k].push_back(SpectrumElement(300.0 + 0.1 * i + std::rand()
+                    / (RAND_MAX + 1.0) * 0.01, 1.0));
+        }
+    }
+    std::cout << "Merging " << nScans << " spectra with " << nPeaks
+            << " peaks each" << std::endl;
+    benchmark::run("Spectrum::merge, pairwise", PairwiseMerge(scans),
+        nScans * nPeaks, 3);
+    benchmark::run("mergeSpectra, k-way", KWayMerge(scans), nScans * nPeaks,
+        3);
+
+    // removing duplicates: a profile spectrum with closely spaced samples
+    // and a centroided spectrum without any duplicates
+    Spectrum profile, centroids, work;
+    for (Size i = 0; i < n; ++i) {
+        profile.push_back(SpectrumElement(300.0 + 0.0005 * i, 1.0));
+        centroids.push_back(SpectrumElement(300.0 + 0.01 * i, 1.0));
+    }
+    work.reserve(n);
+    std::cout << "Removing duplicates from " << n << "-element spectra"
+            << std::endl;
+    benchmark::run("profile, legacy removeDuplicates",
+        LegacyRemoveDuplicates(profile), n);
+    benchmark::run("profile, removeDuplicates", RemoveDuplicates(profile), n);
+    benchmark::run("profile, copy + compactDuplicates",
+        CompactDuplicates(profile, work), n);
+    benchmark::run("centroids, legacy removeDuplicates",
+        LegacyRemoveDuplicates(centroids), n);
+    benchmark::run("centroids, removeDuplicates", RemoveDuplicates(centroids),
+        n);
+    benchmark::run("centroids, copy + compactDuplicates",
+        CompactDuplicates(centroids, work), n);
+    benchmark::run("centroids, compactDuplicates in place",
+        CompactDuplicatesInPlace(centroids), n);
+    return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ * SpectrumKernels-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/InstructionSet.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumKernels.hpp>
+#include "benchmark.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef std::vector<SpectrumElement> Elements;
+
+// The std::algorithm implementations the kernels replace.
+struct LegacySum
+{
+    const Elements& e;
+    LegacySum(const Elements& e_) :
+        e(e_)
+    {
+    }
+    void operator()() const
+    {
+        double s = std::accumulate(e.begin(), e.end(), 0.0,
+            Spectrum::SumAbundance());
+        benchmark::doNotOptimize(s);
+    }
+};
+
+struct LegacyMax
+{
+    const Elements& e;
+    LegacyMax(const Elements& e_) :
+        e(e_)
+    {
+    }
+    void operator()() const
+    {
+        Elements::const_iterator m = std::max_element(e.begin(), e.end(),
+            Spectrum::LessThanAbundance<SpectrumElement, SpectrumElement>());
+        benchmark::doNotOptimize(m);
+    }
+};
+
+struct LegacyShift
+{
+    Elements& e;
+    LegacyShift(Elements& e_) :
+        e(e_)
+    {
+    }
+    void operator()() const
+    {
+        std::transform(e.begin(), e.end(), e.begin(), Spectrum::ShiftMz(1e-9));
+        benchmark::doNotOptimize(e[0]);
+    }
+};
+
+struct KernelSum
+{
+    const SpectrumKernels& k;
+    const Elements& e;
+    KernelSum(const SpectrumKernels& k_, const Elements& e_) :
+        k(k_), e(e_)
+    {
+    }
+    void operator()() const
+    {
+        double s = k.sumAbundances(&e[0], e.size());
+        benchmark::doNotOptimize(s);
+    }
+};
+
+struct KernelMax
+{
+    const SpectrumKernels& k;
+    const Elements& e;
+    KernelMax(const SpectrumKernels& k_, const Elements& e_) :
+        k(k_), e(e_)
+    {
+    }
+    void operator()() const
+    {
+        Size m = k.findMaxAbundance(&e[0], e.size());
+        benchmark::doNotOptimize(m);
+    }
+};
+
+struct KernelShift
+{
+    const SpectrumKernels& k;
+    Elements& e;
+    KernelShift(const SpectrumKernels& k_, Elements& e_) :
+        k(k_), e(e_)
+    {
+    }
+    void operator()() const
+    {
+        k.transformMz(&e[0], e.size(), 1.0, 1e-9);
+        benchmark::doNotOptimize(e[0]);
+    }
+};
+
+struct KernelScale
+{
+    const SpectrumKernels& k;
+    Elements& e;
+    KernelScale(const SpectrumKernels& k_, Elements& e_) :
+        k(k_), e(e_)
+    {
+    }
+    void operator()() const
+    {
+        k.scaleAbundances(&e[0], e.size(), 1.0 + 1e-9);
+        benchmark::doNotOptimize(e[0]);
+    }
+};
+
+}
+
+int main()
+{
+    // a profile scan that fits into L2
+    const Size n = 16384;
+    Elements e;
+    std::srand(42);
+    for (Size i = 0; i < n; ++i) {
+        e.push_back(SpectrumElement(300.0 + 0.01 * i, std::rand()
+                / (RAND_MAX + 1.0)));
+    }
+    std::cout << "Spectrum kernels on " << n << " peaks" << std::endl;
+    benchmark::run("std::accumulate", LegacySum(e), n, 200);
+    benchmark::run("std::max_element", LegacyMax(e), n, 200);
+    benchmark::run("std::transform (shift)", LegacyShift(e), n, 200);
+    const int supported = InstructionSet::getSupported();
+    for (int l = InstructionSet::SCALAR; l <= supported; ++l) {
+        const SpectrumKernels& k = SpectrumKernels::get(
+            static_cast<InstructionSet::Level> (l));
+        const std::string name = InstructionSet::getName(k.level);
+        benchmark::run(name + " sumAbundances", KernelSum(k, e), n, 200);
+        benchmark::run(name + " findMaxAbundance", KernelMax(k, e), n, 200);
+        benchmark::run(name + " transformMz", KernelShift(k, e), n, 200);
+        benchmark::run(name + " scaleAbundances", KernelScale(k, e), n, 200);
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * SpectrumRangeIndex-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumRangeIndex.hpp>
+#include "benchmark.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+typedef std::vector<SpectrumRangeIndex::MzWindow> Windows;
+
+// Copies every window with Spectrum::subset() and sums its abundances.
+struct SubsetWindows
+{
+    const Spectrum& s;
+    const Windows& windows;
+    SubsetWindows(const Spectrum& s_, const Windows& w) :
+        s(s_), windows(w)
+    {
+    }
+    void operator()() const
+    {
+        double sum = 0.0;
+        for (Size i = 0; i < windows.size(); ++i) {
+            sum += s.subset(windows[i].first,
+                windows[i].second).getTotalIonCurrent();
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+// Builds the abundance prefix sums.
+struct BuildIndex
+{
+    const Spectrum& s;
+    BuildIndex(const Spectrum& s_) :
+        s(s_)
+    {
+    }
+    void operator()() const
+    {
+        SpectrumRangeIndex index(s);
+        index.buildAbundanceIndex();
+        benchmark::doNotOptimize(index);
+    }
+};
+
+// Queries every window separately.
+struct IndexedWindows
+{
+    const SpectrumRangeIndex& index;
+    const Windows& windows;
+    IndexedWindows(const SpectrumRangeIndex& i, const Windows& w) :
+        index(i), windows(w)
+    {
+    }
+    void operator()() const
+    {
+        double sum = 0.0;
+        for (Size i = 0; i < windows.size(); ++i) {
+            sum += index.getAbundance(windows[i].first, windows[i].second);
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+// Answers all windows in one sweep.
+struct BatchedWindows
+{
+    const SpectrumRangeIndex& index;
+    const Windows& windows;
+    std::vector<double>& abundances;
+    BatchedWindows(const SpectrumRangeIndex& i, const Windows& w,
+        std::vector<double>& a) :
+        index(i), windows(w), abundances(a)
+    {
+    }
+    void operator()() const
+    {
+        index.getAbundances(windows.begin(), windows.end(),
+            abundances.begin());
+        benchmark::doNotOptimize(abundances);
+    }
+};
+
+}
+
+int main()
+{
+    // a profile MS1 scan and a 10ppm inclusion list
+    const Size nPeaks = 200000;
+    const Size nWindows = 5000;
+    Spectrum s;
+    s.reserve(nPeaks);
+    std::srand(42);
+    for (Size i = 0; i < nPeaks; ++i) {
+        s.push_back(SpectrumElement(300.0 + 0.008 * i, std::rand()
+                / (RAND_MAX + 1.0)));
+    }
+    Windows windows;
+    for (Size i = 0; i < nWindows; ++i) {
+        double mz = 300.0 + 1600.0 * std::rand() / (RAND_MAX + 1.0);
+        windows.push_back(std::make_pair(mz - mz * 1e-5, mz + mz * 1e-5));
+    }
+    std::sort(windows.begin(), windows.end());
+    std::vector<double> abundances(nWindows);
+
+    std::cout << "Abundances in " << nWindows << " windows of a " << nPeaks
+            << "-peak spectrum" << std::endl;
+    benchmark::run("Spectrum::subset", SubsetWindows(s, windows), nWindows);
+    SpectrumRangeIndex index(s);
+    index.buildAbundanceIndex();
+    benchmark::run("SpectrumRangeIndex, building (per peak)", BuildIndex(s),
+        nPeaks);
+    benchmark::run("SpectrumRangeIndex, single windows",
+        IndexedWindows(index, windows), nWindows);
+    benchmark::run("SpectrumRangeIndex, batched", BatchedWindows(index,
+        windows, abundances), nWindows);
+    return 0;
+}
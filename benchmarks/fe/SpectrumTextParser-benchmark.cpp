@@ -0,0 +1,106 @@
+/*
+ * SpectrumTextParser-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/SpectrumTextParser.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+struct StreamExtraction
+{
+    const std::string& text;
+    StreamExtraction(const std::string& t) :
+        text(t)
+    {
+    }
+    void operator()() const
+    {
+        std::istringstream iss(text);
+        Spectrum s;
+        iss >> s;
+        benchmark::doNotOptimize(s);
+    }
+};
+
+struct BulkParser
+{
+    const std::string& text;
+    BulkParser(const std::string& t) :
+        text(t)
+    {
+    }
+    void operator()() const
+    {
+        std::vector<Spectrum> spectra;
+        SpectrumTextParser parser;
+        parser.parse(text.data(), text.data() + text.size(), spectra);
+        benchmark::doNotOptimize(spectra);
+    }
+};
+
+}
+
+int main()
+{
+    const Size nScans = 100;
+    const Size nPeaks = 10000;
+    std::ostringstream plain;
+    std::ostringstream scans;
+    plain.precision(10);
+    scans.precision(10);
+    std::srand(42);
+    for (Size k = 0; k < nScans; ++k) {
+        scans << "# scanNumber=" << k + 1 << " rt=" << 0.5 * k
+                << " msLevel=1\n";
+        for (Size i = 0; i < nPeaks; ++i) {
+            const double mz = 300.0 + 0.1 * i + std::rand() / (RAND_MAX
+                    + 1.0) * 0.01;
+            const double ab = 1.0 + std::rand() % 100000;
+            plain << mz << " " << ab << "\n";
+            scans << mz << " " << ab << "\n";
+        }
+    }
+    const std::string plainText = plain.str();
+    const std::string scanText = scans.str();
+    const Size n = nScans * nPeaks;
+
+    std::cout << "Parsing " << n << " peaks (" << plainText.size() / 1024
+            << " KiB peak list)" << std::endl;
+    benchmark::run("operator>>(std::istream&, Spectrum&)",
+        StreamExtraction(plainText), n, 3);
+    benchmark::run("SpectrumTextParser, single scan", BulkParser(plainText),
+        n, 3);
+    benchmark::run("SpectrumTextParser, 100 scans with headers",
+        BulkParser(scanText), n, 3);
+    return 0;
+}
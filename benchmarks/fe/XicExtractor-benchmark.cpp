@@ -0,0 +1,109 @@
+/*
+ * XicExtractor-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <sstream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+// XIC type for compact centroids
+struct CompactXic : public std::vector<CompactCentroid>
+{
+    typedef CompactCentroid::MzAccessor MzAccessor;
+    typedef CompactCentroid::AbundanceAccessor AbundanceAccessor;
+    typedef CompactCentroid::RtAccessor RtAccessor;
+    typedef CompactCentroid::LessThanRt LessThanRt;
+    typedef CompactCentroid::LessThanMz LessThanMz;
+
+    explicit CompactXic(std::vector<CompactCentroid>&& cs) :
+        std::vector<CompactCentroid>(std::move(cs))
+    {
+    }
+};
+
+typedef XicExtractor<CentroidWeightedMeanDisambiguator, RunningMeanSmoother,
+        XicLocalMinSplitter<CompactXic> > MyXicExtractor;
+
+struct Extraction
+{
+    const std::vector<CompactCentroid>& centroids;
+    UnsignedInt nThreads;
+    Extraction(const std::vector<CompactCentroid>& cs, UnsignedInt nt) :
+        centroids(cs), nThreads(nt)
+    {
+    }
+    void operator()() const
+    {
+        MyXicExtractor xe(nThreads);
+        CentroidBoxGenerator bg(3, 5.0);
+        std::vector<CompactXic> xics;
+        xe(centroids, bg, 3, 0.76, xics);
+        benchmark::doNotOptimize(xics);
+    }
+};
+
+}
+
+int main()
+{
+    // a synthetic centroided LC-MS run over 1000 scans
+    benchmark::LcMsRunParameters p;
+    p.nScans = 1000;
+    p.nPeptides = 600;
+    benchmark::SyntheticRun run;
+    benchmark::makeLcMsRun(p, false, run);
+    std::vector<CompactCentroid> cs;
+    for (benchmark::SyntheticRun::const_iterator s = run.begin(); s
+            != run.end(); ++s) {
+        for (Size i = 0; i < s->peaks.size(); ++i) {
+            cs.push_back(CompactCentroid(s->retentionTime, s->peaks[i].mz,
+                s->scanNumber, s->peaks[i].abundance));
+        }
+    }
+
+    std::cout << "XIC extraction from " << cs.size() << " centroids"
+            << std::endl;
+    double serial = benchmark::run("XicExtractor, serial path",
+        Extraction(cs, 1), cs.size(), 3);
+    for (UnsignedInt nt = 2; nt <= 16; nt *= 2) {
+        std::ostringstream name;
+        name << "XicExtractor, " << nt << " threads";
+        double t = benchmark::run(name.str(), Extraction(cs, nt), cs.size(),
+            3);
+        std::cout << "    speedup: " << serial / t << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,322 @@
+/*
+ * generators.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "generators.hpp"
+#include <MSTK/common/Error.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <ostream>
+
+namespace mstk {
+
+namespace benchmark {
+
+namespace {
+
+const double protonMass = 1.00727646688;
+const double isotopeSpacing = 1.0033548378;
+// Poisson approximation of the averagine isotope distribution: the mean
+// number of heavy isotopes per Da
+const double heavyIsotopesPerDa = 5.94e-4;
+const Size maxIsotopes = 8;
+
+struct LessThanMz
+{
+    bool operator()(const SyntheticPeak& lhs, const SyntheticPeak& rhs) const
+    {
+        return lhs.mz < rhs.mz;
+    }
+};
+
+// the (relative) isotope abundances of a peptide of the given mass
+void isotopeDistribution(const double mass, std::vector<double>& ab)
+{
+    ab.clear();
+    double lambda = heavyIsotopesPerDa * mass;
+    double p = std::exp(-lambda);
+    double maxP = 0.0;
+    for (Size k = 0; k < maxIsotopes; ++k) {
+        if (k > 0) {
+            p *= lambda / static_cast<double> (k);
+        }
+        maxP = std::max(maxP, p);
+        if (p < 1e-3 * maxP) {
+            break;
+        }
+        ab.push_back(p);
+    }
+}
+
+void addPeak(const double mz, const double abundance,
+    const LcMsRunParameters& p, const bool profile, SyntheticScan& scan)
+{
+    if (!profile) {
+        SyntheticPeak peak = { mz, abundance };
+        scan.peaks.push_back(peak);
+        return;
+    }
+    // sample the peak over +/- 3 standard deviations
+    double step = p.pointsPerPeak > 1 ? 6.0 * p.peakWidth
+            / static_cast<double> (p.pointsPerPeak - 1) : 0.0;
+    double first = mz - 0.5 * step * static_cast<double> (p.pointsPerPeak - 1);
+    for (Size i = 0; i < p.pointsPerPeak; ++i) {
+        double x = first + step * static_cast<double> (i);
+        double d = (x - mz) / p.peakWidth;
+        SyntheticPeak peak = { x, abundance * std::exp(-0.5 * d * d) };
+        scan.peaks.push_back(peak);
+    }
+}
+
+}
+
+//
+// Random
+//
+
+Random::Random(const UnsignedInt seed) :
+    engine_(seed), hasSpare_(false), spare_(0.0)
+{
+}
+
+double Random::uniform()
+{
+    // 53 random bits from two 32 bit draws
+    double hi = static_cast<double> (engine_() >> 5);
+    double lo = static_cast<double> (engine_() >> 6);
+    return (hi * 67108864.0 + lo) / 9007199254740992.0;
+}
+
+double Random::uniform(const double lo, const double hi)
+{
+    return lo + (hi - lo) * uniform();
+}
+
+double Random::normal()
+{
+    if (hasSpare_) {
+        hasSpare_ = false;
+        return spare_;
+    }
+    double u1 = 1.0 - uniform(); // (0, 1]
+    double u2 = uniform();
+    double r = std::sqrt(-2.0 * std::log(u1));
+    double phi = 6.283185307179586 * u2;
+    spare_ = r * std::sin(phi);
+    hasSpare_ = true;
+    return r * std::cos(phi);
+}
+
+Size Random::index(const Size n)
+{
+    Size i = static_cast<Size> (uniform() * static_cast<double> (n));
+    return std::min(i, n - 1);
+}
+
+//
+// LC-MS runs
+//
+
+LcMsRunParameters::LcMsRunParameters() :
+    nPeptides(2000), nScans(2400), scanRate(2.0), elutionWidth(10.0),
+            minMass(600.0), maxMass(4000.0), minMz(300.0), maxMz(2000.0),
+            minAbundance(1e4), maxAbundance(1e8), noisePeaksPerScan(200),
+            noiseLevel(500.0), mzError(2.0), peakWidth(0.004),
+            pointsPerPeak(11), seed(42)
+{
+    charges.push_back(1);
+    charges.push_back(2);
+    charges.push_back(3);
+}
+
+void makePeptides(const LcMsRunParameters& p,
+    std::vector<SyntheticPeptide>& peptides)
+{
+    mstk_precondition(p.scanRate > 0.0, "makePeptides: scan rate must be positive.");
+    mstk_precondition(p.minMass <= p.maxMass && p.minAbundance > 0.0
+            && p.minAbundance <= p.maxAbundance,
+        "makePeptides: invalid mass or abundance range.");
+    Random rnd(p.seed);
+    double duration = static_cast<double> (p.nScans) / p.scanRate;
+    double logMin = std::log(p.minAbundance);
+    double logMax = std::log(p.maxAbundance);
+    peptides.resize(p.nPeptides);
+    for (Size i = 0; i < p.nPeptides; ++i) {
+        peptides[i].mass = rnd.uniform(p.minMass, p.maxMass);
+        peptides[i].retentionTime = rnd.uniform(0.0, duration);
+        peptides[i].abundance = std::exp(rnd.uniform(logMin, logMax));
+    }
+}
+
+void makeLcMsRun(const LcMsRunParameters& p, const bool profile,
+    SyntheticRun& run)
+{
+    mstk_precondition(p.nScans > 0, "makeLcMsRun: need at least one scan.");
+    mstk_precondition(p.minMz < p.maxMz, "makeLcMsRun: invalid m/z range.");
+    mstk_precondition(p.elutionWidth > 0.0,
+        "makeLcMsRun: elution width must be positive.");
+    mstk_precondition(!profile || (p.pointsPerPeak > 0 && p.peakWidth > 0.0),
+        "makeLcMsRun: invalid profile peak parameters.");
+    for (std::vector<Int>::const_iterator z = p.charges.begin(); z
+            != p.charges.end(); ++z) {
+        mstk_precondition(*z > 0, "makeLcMsRun: charges must be positive.");
+    }
+
+    std::vector<SyntheticPeptide> peptides;
+    makePeptides(p, peptides);
+
+    run.clear();
+    run.resize(p.nScans);
+    for (Size s = 0; s < p.nScans; ++s) {
+        run[s].scanNumber = static_cast<UnsignedInt> (s + 1);
+        run[s].retentionTime = static_cast<double> (s) / p.scanRate;
+    }
+
+    // the peptide signals; a separate generator keeps the peptide list
+    // independent of the noise and m/z error settings
+    Random rnd(p.seed + 1);
+    std::vector<double> isotopes;
+    const double window = 4.0 * p.elutionWidth * p.scanRate;
+    for (std::vector<SyntheticPeptide>::const_iterator pep = peptides.begin(); pep
+            != peptides.end(); ++pep) {
+        isotopeDistribution(pep->mass, isotopes);
+        double apex = pep->retentionTime * p.scanRate;
+        Size first = static_cast<Size> (std::max(0.0, std::ceil(apex - window)));
+        Size last = std::min(p.nScans,
+            static_cast<Size> (std::max(0.0, std::floor(apex + window))) + 1);
+        for (std::vector<Int>::const_iterator z = p.charges.begin(); z
+                != p.charges.end(); ++z) {
+            double charge = static_cast<double> (*z);
+            double mz0 = (pep->mass + charge * protonMass) / charge;
+            for (Size s = first; s < last; ++s) {
+                double d = (run[s].retentionTime - pep->retentionTime)
+                        / p.elutionWidth;
+                double elution = pep->abundance * std::exp(-0.5 * d * d);
+                for (Size k = 0; k < isotopes.size(); ++k) {
+                    double ab = elution * isotopes[k];
+                    double mz = mz0 + static_cast<double> (k) * isotopeSpacing
+                            / charge;
+                    if (ab < 0.1 * p.noiseLevel || mz < p.minMz || mz
+                            > p.maxMz) {
+                        continue;
+                    }
+                    mz *= 1.0 + 1e-6 * p.mzError * rnd.normal();
+                    addPeak(mz, ab, p, profile, run[s]);
+                }
+            }
+        }
+    }
+
+    // noise
+    for (Size s = 0; s < p.nScans; ++s) {
+        SyntheticScan& scan = run[s];
+        for (Size i = 0; i < p.noisePeaksPerScan; ++i) {
+            double mz = rnd.uniform(p.minMz, p.maxMz);
+            double ab = -p.noiseLevel * std::log(1.0 - rnd.uniform());
+            addPeak(mz, ab, p, profile, scan);
+        }
+        std::sort(scan.peaks.begin(), scan.peaks.end(), LessThanMz());
+    }
+}
+
+//
+// proteomes
+//
+
+ProteomeParameters::ProteomeParameters() :
+    nProteins(20000), medianLength(450), seed(42)
+{
+}
+
+String makeProteinSequence(const Size length, Random& rnd)
+{
+    // amino acid background frequencies in UniProtKB/Swiss-Prot, in percent
+    static const char residues[] = "ARNDCQEGHILKMFPSTWYV";
+    static const double frequencies[] = { 8.25, 5.53, 4.06, 5.45, 1.37,
+            3.93, 6.75, 7.07, 2.27, 5.96, 9.66, 5.84, 2.42, 3.86, 4.70,
+            6.56, 5.34, 1.08, 2.92, 6.87 };
+    static const Size nResidues = 20;
+    double cumulative[nResidues];
+    double total = 0.0;
+    for (Size i = 0; i < nResidues; ++i) {
+        total += frequencies[i];
+        cumulative[i] = total;
+    }
+    String seq;
+    seq.reserve(length);
+    if (length > 0) {
+        seq.push_back('M');
+    }
+    while (seq.size() < length) {
+        double u = rnd.uniform(0.0, total);
+        Size i = static_cast<Size> (std::upper_bound(cumulative, cumulative
+                + nResidues, u) - cumulative);
+        seq.push_back(residues[std::min(i, nResidues - 1)]);
+    }
+    return seq;
+}
+
+Size writeFastaProteome(const ProteomeParameters& p, std::ostream& os)
+{
+    Random rnd(p.seed);
+    Size nResidues = 0;
+    for (Size i = 0; i < p.nProteins; ++i) {
+        // log-normal lengths (sigma 0.6), at least 30 residues
+        double l = static_cast<double> (p.medianLength) * std::exp(0.6
+                * rnd.normal());
+        Size length = std::max(static_cast<Size> (30),
+            static_cast<Size> (l));
+        String seq = makeProteinSequence(length, rnd);
+        os << ">sp|SYN" << (i + 1) << "|SYN" << (i + 1)
+                << "_SYNTH Synthetic protein " << (i + 1) << '\n';
+        for (Size j = 0; j < seq.size(); j += 60) {
+            os.write(seq.data() + j,
+                static_cast<std::streamsize> (std::min(static_cast<Size> (60),
+                    seq.size() - j)));
+            os << '\n';
+        }
+        nResidues += seq.size();
+    }
+    return nResidues;
+}
+
+Size writeFastaProteome(const ProteomeParameters& p,
+    const std::string& filename)
+{
+    std::ofstream ofs(filename.c_str());
+    if (!ofs) {
+        mstk_fail("writeFastaProteome: could not open " + filename + ".");
+    }
+    Size nResidues = writeFastaProteome(p, ofs);
+    ofs.close();
+    if (!ofs) {
+        mstk_fail("writeFastaProteome: could not write " + filename + ".");
+    }
+    return nResidues;
+}
+
+} // namespace benchmark
+
+} // namespace mstk
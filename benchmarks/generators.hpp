@@ -0,0 +1,212 @@
+/*
+ * generators.hpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_BENCHMARKS_GENERATORS_HPP__
+#define __MSTK_BENCHMARKS_GENERATORS_HPP__
+
+#include <MSTK/common/Types.hpp>
+#include <iosfwd>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace mstk {
+
+namespace benchmark {
+
+/** A reproducible source of random numbers.
+ *
+ * \c std::mt19937 generates the same sequence on all platforms, but the
+ * standard distributions do not. \c Random therefore derives its uniform
+ * and normal deviates from the raw engine output itself, so that a given
+ * seed yields identical benchmark data on all compilers and libraries.
+ */
+class Random
+{
+public:
+    explicit Random(const UnsignedInt seed);
+
+    /** @return A uniform deviate in [0, 1).
+     */
+    double uniform();
+
+    /** @return A uniform deviate in [lo, hi).
+     */
+    double uniform(const double lo, const double hi);
+
+    /** @return A standard normal deviate (Box-Muller).
+     */
+    double normal();
+
+    /** @return A uniformly distributed index in [0, n).
+     */
+    Size index(const Size n);
+
+private:
+    std::mt19937 engine_;
+    bool hasSpare_;
+    double spare_;
+};
+
+/** Parameters of a synthetic LC-MS run.
+ *
+ * Peptides are drawn with uniformly distributed neutral masses and
+ * retention times. Each peptide is observed in all configured charge
+ * states, with an averagine-like (Poisson) isotope distribution and a
+ * Gaussian elution profile. Every scan additionally contains
+ * \c noisePeaksPerScan uniformly distributed noise peaks.
+ */
+struct LcMsRunParameters
+{
+    /** Default parameters: a 20 minute gradient at 2 scans/s, 2000
+     * peptides in charge states 1-3.
+     */
+    LcMsRunParameters();
+
+    /** The number of peptides. */
+    Size nPeptides;
+    /** The charge states in which each peptide is observed. */
+    std::vector<Int> charges;
+    /** The number of MS1 scans. */
+    Size nScans;
+    /** The scan rate, in scans per second. */
+    double scanRate;
+    /** The width (standard deviation) of the elution profiles, in seconds. */
+    double elutionWidth;
+    /** The neutral peptide mass range, in Da. */
+    double minMass, maxMass;
+    /** The acquired m/z range. */
+    double minMz, maxMz;
+    /** The peptide abundance range (log-uniform). */
+    double minAbundance, maxAbundance;
+    /** The number of noise peaks per scan. */
+    Size noisePeaksPerScan;
+    /** The mean abundance of the (exponentially distributed) noise peaks. */
+    double noiseLevel;
+    /** The relative m/z error of the centroids (standard deviation), in
+     * ppm. */
+    double mzError;
+    /** The width (standard deviation) of the profile peaks, in Th. */
+    double peakWidth;
+    /** The number of profile points sampled per peak. */
+    Size pointsPerPeak;
+    /** The seed of the random number generator. */
+    UnsignedInt seed;
+};
+
+/** A peptide in a synthetic LC-MS run.
+ */
+struct SyntheticPeptide
+{
+    double mass;
+    double retentionTime;
+    double abundance;
+};
+
+/** A single peak (centroid or profile point) of a synthetic scan.
+ */
+struct SyntheticPeak
+{
+    double mz;
+    double abundance;
+};
+
+/** A synthetic MS1 scan. The peaks are sorted by m/z.
+ */
+struct SyntheticScan
+{
+    UnsignedInt scanNumber;
+    double retentionTime;
+    std::vector<SyntheticPeak> peaks;
+};
+
+typedef std::vector<SyntheticScan> SyntheticRun;
+
+/** Draws the peptides of a synthetic LC-MS run.
+ * @param[in] p The run parameters.
+ * @param[out] peptides The peptides; the previous content is replaced.
+ */
+void makePeptides(const LcMsRunParameters& p,
+    std::vector<SyntheticPeptide>& peptides);
+
+/** Generates a synthetic LC-MS run.
+ * @param[in] p The run parameters.
+ * @param[in] profile If true, every peak is sampled as a Gaussian profile
+ *            with \c p.pointsPerPeak points; otherwise the run consists of
+ *            centroids.
+ * @param[out] run The scans; the previous content is replaced.
+ * @throw mstk::PreconditionViolation if the parameters are inconsistent.
+ */
+void makeLcMsRun(const LcMsRunParameters& p, const bool profile,
+    SyntheticRun& run);
+
+/** Parameters of a synthetic proteome.
+ *
+ * Protein lengths are log-normally distributed around \c medianLength,
+ * residues are drawn from the amino acid background frequencies of
+ * UniProtKB/Swiss-Prot.
+ */
+struct ProteomeParameters
+{
+    /** Default parameters: a human-sized proteome of 20000 proteins.
+     */
+    ProteomeParameters();
+
+    /** The number of proteins. */
+    Size nProteins;
+    /** The median protein length, in residues. */
+    Size medianLength;
+    /** The seed of the random number generator. */
+    UnsignedInt seed;
+};
+
+/** Draws a random protein sequence.
+ * @param[in] length The number of residues.
+ * @param[in] rnd The random number generator.
+ * @return A protein sequence that starts with a methionine.
+ */
+String makeProteinSequence(const Size length, Random& rnd);
+
+/** Writes a synthetic proteome in FASTA format.
+ * @param[in] p The proteome parameters.
+ * @param[in] os The output stream.
+ * @return The total number of residues written.
+ */
+Size writeFastaProteome(const ProteomeParameters& p, std::ostream& os);
+
+/** Writes a synthetic proteome into a FASTA file.
+ * @param[in] p The proteome parameters.
+ * @param[in] filename The name of the file; it is overwritten.
+ * @return The total number of residues written.
+ * @throw mstk::RuntimeError if the file cannot be written.
+ */
+Size writeFastaProteome(const ProteomeParameters& p,
+    const std::string& filename);
+
+} // namespace benchmark
+
+} // namespace mstk
+
+#endif /* __MSTK_BENCHMARKS_GENERATORS_HPP__ */
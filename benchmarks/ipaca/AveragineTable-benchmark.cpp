@@ -0,0 +1,131 @@
+/*
+ * AveragineTable-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/ipaca/AveragineTable.hpp>
+#include <MSTK/ipaca/Mercury7Impl.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace mstk::ipaca;
+using namespace mstk;
+
+namespace {
+
+struct TableConstruction
+{
+    void operator()() const
+    {
+        AveragineTable t;
+        benchmark::doNotOptimize(t.getNumberOfPeaks());
+    }
+};
+
+struct TableMapping
+{
+    const String& filename;
+    explicit TableMapping(const String& f) :
+        filename(f)
+    {
+    }
+    void operator()() const
+    {
+        AveragineTable t(filename);
+        benchmark::doNotOptimize(t.getNumberOfPeaks());
+    }
+};
+
+struct EnvelopeLookups
+{
+    const AveragineTable& table;
+    const std::vector<double>& masses;
+    EnvelopeLookups(const AveragineTable& t, const std::vector<double>& m) :
+        table(t), masses(m)
+    {
+    }
+    void operator()() const
+    {
+        double e[8];
+        double sum = 0.0;
+        for (Size i = 0; i < masses.size(); ++i) {
+            table.getEnvelope(masses[i], e, 8);
+            sum += e[1];
+        }
+        benchmark::doNotOptimize(sum);
+    }
+};
+
+struct MercuryEnvelopes
+{
+    const std::vector<double>& masses;
+    explicit MercuryEnvelopes(const std::vector<double>& m) :
+        masses(m)
+    {
+    }
+    void operator()() const
+    {
+        detail::Mercury7Impl mercury;
+        for (Size i = 0; i < masses.size(); ++i) {
+            detail::Spectrum s = mercury(makeAveragine(masses[i]));
+            benchmark::doNotOptimize(s);
+        }
+    }
+};
+
+}
+
+int main()
+{
+    // peptide masses of a synthetic LC-MS run
+    benchmark::LcMsRunParameters p;
+    p.nPeptides = 100000;
+    p.minMass = 500.0;
+    p.maxMass = 8000.0;
+    std::vector<benchmark::SyntheticPeptide> peptides;
+    benchmark::makePeptides(p, peptides);
+    std::vector<double> masses;
+    for (Size i = 0; i < peptides.size(); ++i) {
+        masses.push_back(peptides[i].mass);
+    }
+    std::vector<double> someMasses(masses.begin(), masses.begin() + 1000);
+
+    const String filename = "AveragineTable-benchmark.bin";
+    AveragineTable table;
+    table.save(filename);
+    AveragineTable mapped(filename);
+    std::cout << "Averagine envelopes, 10 Da grid up to 10 kDa" << std::endl;
+    benchmark::run("AveragineTable, construction", TableConstruction(),
+        1000, 3);
+    benchmark::run("AveragineTable, mapping", TableMapping(filename), 1000);
+    benchmark::run("AveragineTable, lookups", EnvelopeLookups(table, masses),
+        masses.size());
+    benchmark::run("AveragineTable, mapped lookups", EnvelopeLookups(mapped,
+        masses), masses.size());
+    benchmark::run("Mercury7, averagine", MercuryEnvelopes(someMasses),
+        someMasses.size(), 3);
+    std::remove(filename.c_str());
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Mercury7-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/ipaca/Mercury7Impl.hpp>
+#include <MSTK/ipaca/Stoichiometry.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+using namespace mstk::ipaca;
+using namespace mstk;
+
+namespace {
+
+detail::Element makeElement(const Size n, const double* masses,
+    const double* frequencies, const double count)
+{
+    detail::Element e;
+    for (Size i = 0; i < n; ++i) {
+        detail::Isotope iso;
+        iso.mz = masses[i];
+        iso.ab = frequencies[i];
+        e.isotopes.push_back(iso);
+    }
+    e.count = count;
+    return e;
+}
+
+/* The averagine stoichiometry (Senko et al., 1995) of a peptide with the
+ * given neutral mass. If \c integer is true, the element counts are rounded.
+ */
+detail::Stoichiometry makeAveragine(const double mass, const bool integer)
+{
+    static const double mC[] = { 12.0, 13.0033548378 };
+    static const double fC[] = { 0.9893, 0.0107 };
+    static const double mH[] = { 1.00782503207, 2.0141017778 };
+    static const double fH[] = { 0.999885, 0.000115 };
+    static const double mN[] = { 14.0030740048, 15.0001088982 };
+    static const double fN[] = { 0.99636, 0.00364 };
+    static const double mO[] = { 15.99491461956, 16.99913170, 17.9991610 };
+    static const double fO[] = { 0.99757, 0.00038, 0.00205 };
+    static const double mS[] = { 31.97207100, 32.97145876, 33.96786690,
+            35.96708076 };
+    static const double fS[] = { 0.9499, 0.0075, 0.0425, 0.0001 };
+    double n = mass / 111.1254;
+    double counts[] = { 4.9384 * n, 7.7583 * n, 1.3577 * n, 1.4773 * n,
+            0.0417 * n };
+    if (integer) {
+        for (Size i = 0; i < 5; ++i) {
+            counts[i] = std::floor(counts[i] + 0.5);
+        }
+    }
+    detail::Stoichiometry s;
+    s.push_back(makeElement(2, mC, fC, counts[0]));
+    s.push_back(makeElement(2, mH, fH, counts[1]));
+    s.push_back(makeElement(2, mN, fN, counts[2]));
+    s.push_back(makeElement(3, mO, fO, counts[3]));
+    if (counts[4] > 0.0) {
+        s.push_back(makeElement(4, mS, fS, counts[4]));
+    }
+    return s;
+}
+
+struct IsotopeDistributions
+{
+    const std::vector<detail::Stoichiometry>& stoichiometries;
+    explicit IsotopeDistributions(const std::vector<detail::Stoichiometry>& s) :
+        stoichiometries(s)
+    {
+    }
+    void operator()() const
+    {
+        detail::Mercury7Impl mercury;
+        for (Size i = 0; i < stoichiometries.size(); ++i) {
+            detail::Spectrum s = mercury(stoichiometries[i]);
+            benchmark::doNotOptimize(s);
+        }
+    }
+};
+
+}
+
+int main()
+{
+    // peptide masses of a synthetic LC-MS run
+    benchmark::LcMsRunParameters p;
+    p.nPeptides = 5000;
+    double minMass[] = { 500.0, 2000.0, 4000.0 };
+    double maxMass[] = { 2000.0, 4000.0, 8000.0 };
+    for (Size k = 0; k < 3; ++k) {
+        p.minMass = minMass[k];
+        p.maxMass = maxMass[k];
+        std::vector<benchmark::SyntheticPeptide> peptides;
+        benchmark::makePeptides(p, peptides);
+        std::vector<detail::Stoichiometry> integer, fractional;
+        for (Size i = 0; i < peptides.size(); ++i) {
+            integer.push_back(makeAveragine(peptides[i].mass, true));
+            fractional.push_back(makeAveragine(peptides[i].mass, false));
+        }
+        std::ostringstream range;
+        range << p.minMass << "-" << p.maxMass << " Da";
+        std::cout << "Isotope distributions of " << peptides.size()
+                << " peptides, " << range.str() << std::endl;
+        benchmark::run("Mercury7, integer, " + range.str(),
+            IsotopeDistributions(integer), integer.size(), 5);
+        benchmark::run("Mercury7, fractional, " + range.str(),
+            IsotopeDistributions(fractional), fractional.size(), 5);
+    }
+    return 0;
+}
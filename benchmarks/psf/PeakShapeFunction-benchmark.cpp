@@ -0,0 +1,85 @@
+/*
+ * PeakShapeFunction-benchmark.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/psf/PeakShapeFunction.hpp>
+#include <MSTK/psf/types/Spectrum.hpp>
+#include "benchmark.hpp"
+#include "generators.hpp"
+#include <vector>
+
+using namespace mstk;
+
+namespace {
+
+template<typename PeakShapeFunction>
+struct Calibration
+{
+    const std::vector<psf::Spectrum>& spectra;
+    explicit Calibration(const std::vector<psf::Spectrum>& s) :
+        spectra(s)
+    {
+    }
+    void operator()() const
+    {
+        psf::MzExtractor getMz;
+        psf::IntensityExtractor getIntensity;
+        for (Size i = 0; i < spectra.size(); ++i) {
+            PeakShapeFunction f;
+            f.calibrateFor(getMz, getIntensity, spectra[i].begin(),
+                spectra[i].end());
+            benchmark::doNotOptimize(f);
+        }
+    }
+};
+
+}
+
+int main()
+{
+    // 50 synthetic profile spectra
+    benchmark::LcMsRunParameters p;
+    p.nScans = 50;
+    p.nPeptides = 200;
+    benchmark::SyntheticRun run;
+    benchmark::makeLcMsRun(p, true, run);
+    std::vector<psf::Spectrum> spectra(run.size());
+    Size nPoints = 0;
+    for (Size i = 0; i < run.size(); ++i) {
+        const std::vector<benchmark::SyntheticPeak>& peaks = run[i].peaks;
+        for (Size j = 0; j < peaks.size(); ++j) {
+            spectra[i].push_back(psf::SpectrumElement(peaks[j].mz,
+                peaks[j].abundance));
+        }
+        nPoints += peaks.size();
+    }
+    std::cout << "Calibrating peak shape functions on " << spectra.size()
+            << " profile spectra, " << nPoints
+            << " points (throughput in points)" << std::endl;
+    benchmark::run("PeakShapeFunction, Gaussian calibration",
+        Calibration<psf::GaussianPeakShapeFunction>(spectra), nPoints, 3);
+    benchmark::run("PeakShapeFunction, Orbitrap calibration",
+        Calibration<psf::OrbitrapPeakShapeFunction>(spectra), nPoints, 3);
+    return 0;
+}
@@ -120,3 +120,26 @@ MACRO(ADD_MSTK_EXAMPLE lib classname src)
 	ADD_CUSTOM_TARGET(${testName} COMMAND ${CMAKE_CURRENT_BINARY_DIR}/${testNameExe})
 	MESSAGE(STATUS "Adding examples for ${lib}/${classname}: ${testNameExe}.")
 ENDMACRO(ADD_MSTK_EXAMPLE lib classname src)
+
+################################################################
+#
+# Adds a benchmark. Benchmarks are not run by ctest; each one
+# gets a custom target '${lib}_${classname}_benchmark' that runs it.
+# The suite name '${lib}_${classname}' is compiled into the executable
+# (MSTK_BENCHMARK_SUITE) and stored with every result; use
+# SET_PROPERTY(... APPEND PROPERTY COMPILE_DEFINITIONS ...) to add
+# further definitions.
+#
+################################################################
+MACRO(ADD_MSTK_BENCHMARK lib classname src)
+    SET(benchmarkName "${lib}_${classname}_benchmark")
+    SET(benchmarkNameExe "${benchmarkName}_exe")
+
+    ADD_EXECUTABLE(${benchmarkNameExe} ${src})
+    TARGET_LINK_LIBRARIES(${benchmarkNameExe} ${BENCHMARK_LIBS})
+    SET_PROPERTY(TARGET ${benchmarkNameExe} APPEND PROPERTY
+        COMPILE_DEFINITIONS "MSTK_BENCHMARK_SUITE=\"${lib}_${classname}\"")
+    ADD_CUSTOM_TARGET(${benchmarkName} COMMAND ${CMAKE_CURRENT_BINARY_DIR}/${benchmarkNameExe})
+    LIST(APPEND "MSTK_${lib}_BENCHMARK_NAMES" ${benchmarkName})
+    MESSAGE(STATUS "Adding benchmark for ${lib}/${classname}: ${benchmarkName}.")
+ENDMACRO(ADD_MSTK_BENCHMARK lib classname src)
@@ -0,0 +1,139 @@
+/*
+ * AlignedAllocator.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_ALIGNEDALLOCATOR_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_ALIGNEDALLOCATOR_HPP__
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/**
+ * @brief STL allocator that returns memory aligned to \c Alignment bytes.
+ *
+ * Contiguous numerical buffers (e.g. the m/z and abundance columns of a
+ * \c mstk::fe::ColumnarSpectrum) are allocated on cache line boundaries,
+ * which allows the compiler to use aligned vector loads. \c Alignment must
+ * be a power of two and a multiple of \c sizeof(void*).
+ */
+template<class T, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<class U>
+    struct rebind
+    {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator()
+    {
+    }
+
+    template<class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+    {
+    }
+
+    pointer address(reference x) const
+    {
+        return &x;
+    }
+
+    const_pointer address(const_reference x) const
+    {
+        return &x;
+    }
+
+    pointer allocate(size_type n, const void* = 0)
+    {
+        if (n == 0) {
+            return 0;
+        }
+        if (n > max_size()) {
+            throw std::bad_alloc();
+        }
+        void* p = 0;
+        if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0) {
+            throw std::bad_alloc();
+        }
+        return static_cast<pointer> (p);
+    }
+
+    void deallocate(pointer p, size_type)
+    {
+        std::free(p);
+    }
+
+    size_type max_size() const
+    {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    void construct(pointer p, const T& value)
+    {
+        new (static_cast<void*> (p)) T(value);
+    }
+
+    void destroy(pointer p)
+    {
+        p->~T();
+    }
+};
+
+template<class T, class U, std::size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&,
+    const AlignedAllocator<U, Alignment>&)
+{
+    return true;
+}
+
+template<class T, class U, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&,
+    const AlignedAllocator<U, Alignment>&)
+{
+    return false;
+}
+
+/** @} */
+
+}
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ * BoundedQueue.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_BOUNDEDQUEUE_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_BOUNDEDQUEUE_HPP__
+
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/** A blocking first-in first-out queue of limited capacity.
+ *
+ * \c BoundedQueue connects the stages of a pipeline that run on different
+ * threads. \c push() blocks while the queue is full, which throttles a fast
+ * producer to the speed of its consumer and bounds the memory held between
+ * the stages; \c pop() blocks while the queue is empty. The producer calls
+ * \c close() after its last element; the consumer then drains the remaining
+ * elements and \c pop() returns false. \c cancel() additionally discards
+ * the queued elements and is meant for error handling, where both sides
+ * must stop as soon as possible.
+ */
+template<class T>
+class BoundedQueue
+{
+public:
+    /** Constructor.
+     * @param[in] capacity The maximum number of queued elements.
+     * @throw mstk::PreconditionViolation if \c capacity is zero.
+     */
+    explicit BoundedQueue(const Size capacity);
+
+    /** Append an element, waiting while the queue is full.
+     * @param[in] value The element; it is moved into the queue.
+     * @return False if the queue has been closed or cancelled; \c value is
+     *         not enqueued in this case.
+     */
+    bool push(T&& value);
+
+    /** Remove the front element, waiting while the queue is empty and open.
+     * @param[out] value The front element.
+     * @return False if the queue is closed and drained, or cancelled.
+     */
+    bool pop(T& value);
+
+    /** Close the queue. Subsequent pushes fail; the queued elements can
+     * still be popped.
+     */
+    void close();
+
+    /** Close the queue and discard all queued elements.
+     */
+    void cancel();
+
+    /** @return The number of queued elements.
+     */
+    Size size() const;
+
+    /** @return The capacity of the queue.
+     */
+    Size getCapacity() const;
+
+    /** @return True if the queue has been closed or cancelled.
+     */
+    bool isClosed() const;
+
+private:
+    BoundedQueue(const BoundedQueue&);
+    BoundedQueue& operator=(const BoundedQueue&);
+
+    mutable std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::deque<T> items_;
+    Size capacity_;
+    bool closed_;
+};
+
+/** @} */
+
+//
+// template implementation
+//
+
+template<class T>
+BoundedQueue<T>::BoundedQueue(const Size capacity) :
+    capacity_(capacity), closed_(false)
+{
+    mstk_precondition(capacity > 0,
+        "BoundedQueue: the capacity must be positive.");
+}
+
+template<class T>
+bool BoundedQueue<T>::push(T&& value)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!closed_ && items_.size() >= capacity_) {
+        notFull_.wait(lock);
+    }
+    if (closed_) {
+        return false;
+    }
+    items_.push_back(std::move(value));
+    lock.unlock();
+    notEmpty_.notify_one();
+    return true;
+}
+
+template<class T>
+bool BoundedQueue<T>::pop(T& value)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!closed_ && items_.empty()) {
+        notEmpty_.wait(lock);
+    }
+    if (items_.empty()) {
+        return false;
+    }
+    value = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    notFull_.notify_one();
+    return true;
+}
+
+template<class T>
+void BoundedQueue<T>::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    notFull_.notify_all();
+    notEmpty_.notify_all();
+}
+
+template<class T>
+void BoundedQueue<T>::cancel()
+{
+    std::deque<T> discarded;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        discarded.swap(items_);
+    }
+    notFull_.notify_all();
+    notEmpty_.notify_all();
+}
+
+template<class T>
+Size BoundedQueue<T>::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+}
+
+template<class T>
+Size BoundedQueue<T>::getCapacity() const
+{
+    return capacity_;
+}
+
+template<class T>
+bool BoundedQueue<T>::isClosed() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+}
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_COMMON_BOUNDEDQUEUE_HPP__ */
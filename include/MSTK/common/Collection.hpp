@@ -26,6 +26,7 @@
 #ifndef __MSTK_INCLUDE_MSTK_COMMON_COLLECTION_HPP__
 #define __MSTK_INCLUDE_MSTK_COMMON_COLLECTION_HPP__
 
+#include <utility>
 #include <vector>
 
 namespace mstk {
@@ -45,6 +46,10 @@ namespace mstk {
  * must provide a complete vector-like interface can thus readily (and sefely)
  * derive from \c Collection<T>.
  *
+ * Every member function is virtual, which prevents inlining. Classes that
+ * do not need to override the interface should derive from the non-virtual
+ * \c StaticCollection<Derived, T> instead.
+ *
  * See the STL documentation for the interface documentation.
  */
 template<class T, class A = std::allocator<T> >
@@ -76,10 +81,18 @@ public:
         c_(rhs.c_)
     {
     }
+    Collection(Collection&& rhs) noexcept :
+        c_(std::move(rhs.c_))
+    {
+    }
     explicit Collection(const std::vector<T, A>& rhs) :
         c_(rhs)
     {
     }
+    explicit Collection(std::vector<T, A>&& rhs) :
+        c_(std::move(rhs))
+    {
+    }
     explicit Collection(size_type n, const T& value = T()) :
         c_(n, value)
     {
@@ -100,6 +113,11 @@ public:
         c_ = rhs.c_;
         return *this;
     }
+    virtual Collection& operator=(Collection&& rhs) noexcept
+    {
+        c_ = std::move(rhs.c_);
+        return *this;
+    }
 
     template<typename U, typename V>
     friend bool operator==(const Collection<U, V>& lhs,
@@ -139,7 +157,7 @@ public:
     }
     virtual void insert(iterator pos, size_type n, const T& value)
     {
-        return c_.insert(pos, n, value);
+        c_.insert(pos, n, value);
     }
     template<class In> void insert(iterator pos, In begin, In end)
     {
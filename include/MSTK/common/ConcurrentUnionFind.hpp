@@ -0,0 +1,135 @@
+/*
+ * ConcurrentUnionFind.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_CONCURRENTUNIONFIND_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_CONCURRENTUNIONFIND_HPP__
+
+#include <MSTK/common/Types.hpp>
+#include <atomic>
+#include <vector>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/**
+ * @brief A lock-free disjoint-set forest.
+ *
+ * \c unite() and \c find() may be called concurrently from any number of
+ * threads. Sets are always linked such that the larger root points to the
+ * smaller one; hence, once all unions have been performed, the
+ * representative of every set is its smallest element, independent of the
+ * order in which the unions happened. Paths are compressed by path halving.
+ */
+class ConcurrentUnionFind
+{
+public:
+    /** Constructor. Creates \c n singleton sets {0}, ..., {n-1}.
+     */
+    explicit ConcurrentUnionFind(const Size n);
+
+    /** @return The number of elements.
+     */
+    Size size() const;
+
+    /** @return The current representative of the set that contains \c x.
+     */
+    Size find(Size x);
+
+    /** Merge the sets that contain \c a and \c b.
+     */
+    void unite(Size a, Size b);
+
+private:
+    ConcurrentUnionFind(const ConcurrentUnionFind&);
+    ConcurrentUnionFind& operator=(const ConcurrentUnionFind&);
+
+    std::vector<std::atomic<Size> > parent_;
+};
+
+//
+// inline functions
+//
+
+inline ConcurrentUnionFind::ConcurrentUnionFind(const Size n) :
+    parent_(n)
+{
+    for (Size i = 0; i < n; ++i) {
+        parent_[i].store(i, std::memory_order_relaxed);
+    }
+}
+
+inline Size ConcurrentUnionFind::size() const
+{
+    return parent_.size();
+}
+
+inline Size ConcurrentUnionFind::find(Size x)
+{
+    for (;;) {
+        Size p = parent_[x].load(std::memory_order_acquire);
+        if (p == x) {
+            return x;
+        }
+        Size gp = parent_[p].load(std::memory_order_acquire);
+        if (gp != p) {
+            // path halving; failure only means that another thread
+            // shortened the path already
+            parent_[x].compare_exchange_weak(p, gp,
+                std::memory_order_acq_rel);
+        }
+        x = gp;
+    }
+}
+
+inline void ConcurrentUnionFind::unite(Size a, Size b)
+{
+    for (;;) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return;
+        }
+        // link the larger root to the smaller one
+        if (a < b) {
+            Size t = a;
+            a = b;
+            b = t;
+        }
+        Size expected = a;
+        if (parent_[a].compare_exchange_strong(expected, b,
+            std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+}
+
+/** @} */
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_COMMON_CONCURRENTUNIONFIND_HPP__ */
@@ -0,0 +1,68 @@
+/*
+ * InstructionSet.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_INSTRUCTIONSET_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_INSTRUCTIONSET_HPP__
+
+#include <MSTK/config.hpp>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/** Runtime detection of the vector instruction sets of the host CPU.
+ *
+ * Kernels with several code paths (e.g. \c mstk::fe::SpectrumKernels) are
+ * compiled for all levels and select the best supported one at runtime, so
+ * binaries built for a generic target still use AVX2/AVX-512 where
+ * available.
+ */
+struct MSTK_EXPORT InstructionSet
+{
+    /** Instruction set levels in increasing order; every level includes
+     * the ones below it.
+     */
+    enum Level
+    {
+        SCALAR = 0, AVX2, AVX512
+    };
+
+    /** The highest level supported by the CPU and the operating system.
+     * Detected once and cached.
+     */
+    static Level getSupported();
+
+    /** @return A human readable name of \c level.
+     */
+    static const char* getName(const Level level);
+};
+
+/** @} */
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_COMMON_INSTRUCTIONSET_HPP__ */
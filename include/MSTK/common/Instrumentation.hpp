@@ -0,0 +1,231 @@
+/*
+ * Instrumentation.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_INSTRUMENTATION_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_INSTRUMENTATION_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * @page common_instrumentation Instrumentation
+ *
+ * MSTK records per-stage timings, counters and histograms of its hot paths
+ * if it is built with @c MSTK_INSTRUMENTATION defined (CMake option
+ * @c ENABLE_INSTRUMENTATION). Otherwise, the instrumentation macros expand
+ * to nothing and their arguments are not evaluated.
+ * @code
+ * #include <MSTK/common/Instrumentation.hpp>
+ * ...
+ *     MSTK_INSTRUMENT_TIMER("fe.Centroider");
+ *     MSTK_INSTRUMENT_RECORD("fe.Centroider.spectrumSize", n);
+ *     ...
+ *     MSTK_INSTRUMENT_COUNT("fe.Centroider.centroids", nCentroids);
+ * @endcode
+ * A timer measures the enclosing scope. Values are accumulated in
+ * thread-local storage without synchronization and aggregated over all
+ * threads when a snapshot is taken:
+ * @code
+ * mstk::Instrumentation::writeJson(std::cout);
+ * @endcode
+ */
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/** Process-wide registry of instrumentation metrics.
+ *
+ * Every metric is identified by a unique name. Each thread accumulates its
+ * own values; values of terminated threads are retained. The snapshot
+ * functions may be called at any time and from any thread.
+ */
+class MSTK_EXPORT Instrumentation
+{
+public:
+    typedef UnsignedInt Id;
+
+    /** The kind of a metric.
+     */
+    enum Kind
+    {
+        /// A monotonic counter; reports the sum of all increments.
+        COUNTER = 0,
+        /// A timer; reports the number, total, minimum and maximum of the
+        /// measured durations in seconds.
+        TIMER,
+        /// A histogram of non-negative values in power-of-two buckets.
+        HISTOGRAM
+    };
+
+    /** The number of histogram buckets. Bucket 0 holds values below 1,
+     * bucket \c k > 0 values in [2^(k-1), 2^k); the last bucket is open.
+     */
+    static const Size nBuckets = 48;
+
+    /** The aggregated values of a metric.
+     */
+    struct Metric
+    {
+        std::string name;
+        Kind kind;
+        /// number of recorded events
+        Size count;
+        /// sum of the recorded values (seconds for timers)
+        double sum;
+        double min;
+        double max;
+        /// histogram buckets; empty for counters and timers
+        std::vector<Size> buckets;
+    };
+
+    /** Registers a metric, or looks up a registered metric by name.
+     * Thread-safe; the instrumentation macros call this once per call site.
+     * @throw mstk::PreconditionViolation if the name is registered with a
+     *        different kind or if too many metrics are registered.
+     */
+    static Id getId(const std::string& name, const Kind kind);
+
+    /** Increments a counter by \c n.
+     */
+    static void count(const Id id, const Size n = 1);
+
+    /** Adds a duration (in seconds) to a timer.
+     */
+    static void time(const Id id, const double seconds);
+
+    /** Adds a value to a histogram.
+     */
+    static void record(const Id id, const double value);
+
+    /** @return The values of all registered metrics, aggregated over all
+     *          threads, in registration order.
+     */
+    static std::vector<Metric> snapshot();
+
+    /** Writes a snapshot as a JSON object that maps metric names to
+     * their values.
+     */
+    static void writeJson(std::ostream& os);
+
+    /** @return The snapshot as a JSON string, see \c writeJson().
+     */
+    static std::string toJson();
+
+    /** Writes \c s as a quoted JSON string, escaping quotes, backslashes
+     * and control characters. Shared with the benchmark result writer.
+     */
+    static void writeJsonString(std::ostream& os, const std::string& s);
+
+    /** Resets the values of all metrics to zero. Values recorded
+     * concurrently by other threads may be lost.
+     */
+    static void reset();
+};
+
+/** Measures the lifetime of the object and adds it to a timer.
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const Instrumentation::Id id) :
+        id_(id), start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        std::chrono::duration<double> d = std::chrono::steady_clock::now()
+                - start_;
+        Instrumentation::time(id_, d.count());
+    }
+
+private:
+    ScopedTimer(const ScopedTimer&);
+    ScopedTimer& operator=(const ScopedTimer&);
+
+    Instrumentation::Id id_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/** @} */
+
+} // namespace mstk
+
+#define MSTK_INSTRUMENT_CONCAT_(a, b) a ## b
+#define MSTK_INSTRUMENT_CONCAT(a, b) MSTK_INSTRUMENT_CONCAT_(a, b)
+
+#ifdef MSTK_INSTRUMENTATION
+
+// MSTK_INSTRUMENT_TIMER()
+/**
+ * Adds the time until the end of the enclosing scope to the timer \c name.
+ */
+#define MSTK_INSTRUMENT_TIMER(name) \
+    static const mstk::Instrumentation::Id \
+        MSTK_INSTRUMENT_CONCAT(mstkTimerId, __LINE__) = \
+            mstk::Instrumentation::getId(name, mstk::Instrumentation::TIMER); \
+    mstk::ScopedTimer MSTK_INSTRUMENT_CONCAT(mstkTimer, __LINE__)( \
+        MSTK_INSTRUMENT_CONCAT(mstkTimerId, __LINE__))
+
+// MSTK_INSTRUMENT_COUNT()
+/**
+ * Increments the counter \c name by \c n.
+ */
+#define MSTK_INSTRUMENT_COUNT(name, n) \
+    do { \
+        static const mstk::Instrumentation::Id mstkCounterId = \
+            mstk::Instrumentation::getId(name, \
+                mstk::Instrumentation::COUNTER); \
+        mstk::Instrumentation::count(mstkCounterId, n); \
+    } while (0)
+
+// MSTK_INSTRUMENT_RECORD()
+/**
+ * Adds \c value to the histogram \c name.
+ */
+#define MSTK_INSTRUMENT_RECORD(name, value) \
+    do { \
+        static const mstk::Instrumentation::Id mstkHistogramId = \
+            mstk::Instrumentation::getId(name, \
+                mstk::Instrumentation::HISTOGRAM); \
+        mstk::Instrumentation::record(mstkHistogramId, value); \
+    } while (0)
+
+#else
+
+#define MSTK_INSTRUMENT_TIMER(name) do { } while (0)
+#define MSTK_INSTRUMENT_COUNT(name, n) do { } while (0)
+#define MSTK_INSTRUMENT_RECORD(name, value) do { } while (0)
+
+#endif
+
+#endif /* __MSTK_INCLUDE_MSTK_COMMON_INSTRUMENTATION_HPP__ */
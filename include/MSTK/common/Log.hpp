@@ -64,6 +64,14 @@
  * the global logging level. Consequently, clients should not use the @c Log API
  * directly but should instead make use of @c MSTK_LOG.
  *
+ * The global level is set at configure time through the @c MSTK_LOG_MAX_LEVEL
+ * CMake option (default: @c DEBUG4 for Debug builds, @c INFO otherwise).
+ * Messages that are compiled in can still be suppressed at runtime:
+ * @code
+ * mstk::FILELog::getReportingLevel() = mstk::logWARNING;
+ * @endcode
+ * In both cases, the arguments of a suppressed message are not evaluated.
+ *
  * Valid logging levels, sorted by increasing level of detail, are
  * @code
  * logERROR, logWARNING, logINFO, logDEBUG, logDEBUG1, logDEBUG2, logDEBUG3, logDEBUG4
@@ -166,6 +174,16 @@ inline void mstk::Output2FILE::output(const std::string& msg)
     fflush(pStream);
 }
 
+// getLogReportingLevel()
+/**
+ * The runtime reporting level shared by all Log<T> instantiations.
+ */
+inline LogLevel& getLogReportingLevel()
+{
+    static LogLevel reportingLevel = logDEBUG4;
+    return reportingLevel;
+}
+
 //Log<T>
 /**
  * A thread-safe logging tool
@@ -200,7 +218,8 @@ public:
 
     // getReportingLevel
     /**
-     * Returns the deepest logging level available.
+     * Returns the deepest logging level available. The level is shared by
+     * all redirectors.
      *
      * This function can be used as a safeguard in the logging macros to defend against illegal
      * user defined global logging levels.
@@ -279,8 +298,7 @@ mstk::Log<T>::~Log()
 template<typename T>
 mstk::LogLevel& mstk::Log<T>::getReportingLevel()
 {
-    static mstk::LogLevel reportingLevel = mstk::logDEBUG4;
-    return reportingLevel;
+    return mstk::getLogReportingLevel();
 }
 
 // toString()
@@ -353,33 +371,88 @@ class FILELOG_DECLSPEC FILELog : public Log<Output2FILE>
 //typedef Log<Output2FILE> FILELog;
 
 
-// FILELOG_MAX_LEVEL
-#ifndef FILELOG_MAX_LEVEL
+// MSTK_LOG_MAX_LEVEL
+#ifndef MSTK_LOG_MAX_LEVEL
 /**
  * The deepest logging level to be compiled into the code.
  *
- * Every logging message depper than that level will not be compiled into the code.
+ * Every logging message deeper than that level will not be compiled into the
+ * code. The CMake build sets this from the \c MSTK_LOG_MAX_LEVEL cache option.
+ */
+#define MSTK_LOG_MAX_LEVEL mstk::logDEBUG4
+#endif
+
+// FILELOG_MAX_LEVEL
+#ifndef FILELOG_MAX_LEVEL
+/**
+ * Deprecated alias for MSTK_LOG_MAX_LEVEL. Messages are compiled in only if
+ * their level passes both limits.
  */
 #define FILELOG_MAX_LEVEL mstk::logDEBUG4
 #endif
 
+// MSTK_LOG_OUTPUT
+#ifndef MSTK_LOG_OUTPUT
+/**
+ * The redirector used by the logging macros: mstk::Output2FILE, or
+ * mstk::Output2Async if MSTK_LOG_ASYNC is defined (CMake option
+ * \c MSTK_LOG_ASYNC).
+ */
+#ifdef MSTK_LOG_ASYNC
+#define MSTK_LOG_OUTPUT mstk::Output2Async
+#else
+#define MSTK_LOG_OUTPUT mstk::Output2FILE
+#endif
+#endif
+
+// MSTK_LOG_UNLIKELY()
+#if defined(__GNUC__)
+#define MSTK_LOG_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+#else
+#define MSTK_LOG_UNLIKELY(cond) (cond)
+#endif
+
+// MSTK_LOG_ENABLED()
+/**
+ * Tests if messages of the given logging level will be written.
+ *
+ * The first part of the test is a compile-time constant, hence code guarded
+ * by a level above MSTK_LOG_MAX_LEVEL is removed entirely. Otherwise, the
+ * test reduces to a comparison against the runtime reporting level and a
+ * check for a valid redirect. Use it to guard expensive computations that
+ * only feed log messages:
+ * @code
+ * if (MSTK_LOG_ENABLED(logDEBUG)) {
+ *     double s = computeStatistics(spectrum);
+ *     MSTK_LOG(logDEBUG) << "statistics: " << s;
+ * }
+ * @endcode
+ */
+#define MSTK_LOG_ENABLED(level) \
+    (!((level) > MSTK_LOG_MAX_LEVEL || (level) > FILELOG_MAX_LEVEL) && \
+     !MSTK_LOG_UNLIKELY((level) > mstk::FILELog::getReportingLevel() || \
+                        !MSTK_LOG_OUTPUT::getRedirect()))
+
 // MSTK_LOG()
 /**
  * Logs to a file handle.
  *
  * This macro checks, if the logging level should be compiled. After that, it creates an
- * anonymous instance of FILELog and writes to its logging stream. Afterwards, the
+ * anonymous instance of Log<MSTK_LOG_OUTPUT> and writes to its logging stream. Afterwards, the
  * anonymous object is destroyed and the logging stream flushed out to the FILE.
  *
+ * The streamed arguments are evaluated only if the message is actually
+ * written, i.e. if MSTK_LOG_ENABLED(level) holds. Disabled messages cost a
+ * single predictable branch; messages above MSTK_LOG_MAX_LEVEL cost nothing.
+ *
  * Use it like this:
  * @code
  * MSTK_LOG(logINFO) << "some logging" << 1224 << "no endl, will be appended automatically";
  * @endcode
  */
 #define MSTK_LOG(level) \
-    if (level > FILELOG_MAX_LEVEL) ;\
-    else if (level > mstk::FILELog::getReportingLevel() || !mstk::Output2FILE::getRedirect()) ; \
-    else mstk::FILELog().get(level)
+    if (!MSTK_LOG_ENABLED(level)) ;\
+    else mstk::Log<MSTK_LOG_OUTPUT>().get(level)
 
 // nowTime()
 // We have to do the following yaketiyak, because the standard <ctime> is not thread safe.
@@ -428,29 +501,34 @@ namespace mstk {
 inline std::string nowTime()
 {
     // get time
-    time_t t;
-    t = time(NULL);
-    if (t == static_cast<std::time_t> (-1)) {
-        return "Error_in_nowTime().time";
-    }
-
-    // convert time to local time
-    tm r = { 0 };
-    if (localtime_r(&t, &r) == NULL) {
-        return "Error_in_nowTime().localtime_r";
+    struct timeval tv;
+    if (gettimeofday(&tv, 0) != 0) {
+        return "Error_in_nowTime().gettimeofday";
     }
 
-    // convert localtime to a string
-    char buffer[101];
-    if (strftime(buffer, sizeof(buffer), "%X", &r) == 0) {
-        return "Error_in_nowTime().strftime";
+    // localtime_r() and strftime() are expensive; each thread caches the
+    // formatted local time and refreshes it once per second
+    static thread_local time_t cachedSecond = static_cast<time_t> (-1);
+    static thread_local char buffer[101] = { 0 };
+    if (tv.tv_sec != cachedSecond) {
+        // convert time to local time
+        time_t t = tv.tv_sec;
+        tm r = { 0 };
+        if (localtime_r(&t, &r) == NULL) {
+            return "Error_in_nowTime().localtime_r";
+        }
+
+        // convert localtime to a string
+        if (strftime(buffer, sizeof(buffer), "%X", &r) == 0) {
+            return "Error_in_nowTime().strftime";
+        }
+        cachedSecond = tv.tv_sec;
     }
 
     // format the string according to our format: "hh:mm:ss.ms"
-    struct timeval tv;
-    gettimeofday(&tv, 0);
-    char result[101] = { 0 };
-    std::sprintf(result, "%s.%03ld", buffer, (long) tv.tv_usec / 1000);
+    char result[121] = { 0 };
+    std::snprintf(result, sizeof(result), "%s.%03ld", buffer,
+        (long) tv.tv_usec / 1000);
 
     return result;
 }
@@ -461,4 +539,8 @@ inline std::string nowTime()
 
 } /* namespace mstk */
 
+#ifdef MSTK_LOG_ASYNC
+#include <MSTK/common/Output2Async.hpp>
+#endif
+
 #endif /* __MSTK_INCLUDE_MSTK_LOG_HPP__ */
@@ -0,0 +1,117 @@
+/*
+ * MappedFile.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_MAPPEDFILE_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_MAPPEDFILE_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/**
+ * @brief Read-only, memory-mapped view of a file.
+ *
+ * The file contents are mapped into the address space of the process and
+ * paged in on demand by the operating system, so opening a large file is
+ * cheap and only the pages that are actually touched are read. The mapping
+ * is page aligned. On platforms without \c mmap the file is read into an
+ * aligned buffer instead.
+ */
+class MSTK_EXPORT MappedFile
+{
+public:
+    /** Default constructor. Constructs an object that does not map a file.
+     */
+    MappedFile();
+
+    /** Constructor. Maps the file \c filename.
+     * @throw mstk::RuntimeError if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const String& filename);
+
+    MappedFile(MappedFile&& rhs) noexcept;
+
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+    /** Destructor. Unmaps the file.
+     */
+    ~MappedFile();
+
+    /** Map the file \c filename; a previously mapped file is unmapped.
+     * @throw mstk::RuntimeError if the file cannot be opened or mapped.
+     */
+    void open(const String& filename);
+
+    /** Unmap the file.
+     */
+    void close();
+
+    /** @return True if a file is mapped.
+     */
+    bool isOpen() const;
+
+    /** @return A pointer to the first byte of the file, or 0 if no file is
+     *          mapped or the file is empty.
+     */
+    const char* data() const;
+
+    /** @return The size of the file in bytes.
+     */
+    Size size() const;
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const char* data_;
+    Size size_;
+    bool open_;
+};
+
+inline bool MappedFile::isOpen() const
+{
+    return open_;
+}
+
+inline const char* MappedFile::data() const
+{
+    return data_;
+}
+
+inline Size MappedFile::size() const
+{
+    return size_;
+}
+
+/** @} */
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Output2Async.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_OUTPUT2ASYNC_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_OUTPUT2ASYNC_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Log.hpp>
+#include <MSTK/common/Types.hpp>
+#include <cstdio>
+#include <string>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+// Output2Async
+/**
+ * Asynchronous redirector of the logging stream to a file handle.
+ *
+ * In contrast to \c Output2FILE, \c output() does not write the message
+ * itself. It copies the preformatted record into a bounded lock-free
+ * multi-producer/single-consumer ring buffer, and a background thread
+ * drains the buffer to the file handle in batches. Logging threads hence
+ * never wait for I/O, and records written by different threads never
+ * interleave.
+ *
+ * The ring buffer is created by \c start(), or with the default settings
+ * on the first message. If the buffer is full, the record is dropped
+ * (\c DROP, the default) or the caller waits until the background thread
+ * has made room (\c BLOCK). Dropped records are counted and reported in
+ * the log.
+ *
+ * Use it in conjunction with the Log<T> class: Log<Output2Async>. Building
+ * with \c MSTK_LOG_ASYNC defined (CMake option \c MSTK_LOG_ASYNC) makes it
+ * the redirector of the \c MSTK_LOG macro.
+ *
+ * @note \c start() and \c stop() must not be called while other threads
+ *       are logging.
+ */
+class MSTK_EXPORT Output2Async
+{
+public:
+    /** Behavior of \c output() if the ring buffer is full.
+     */
+    enum OverflowPolicy
+    {
+        DROP = 0, BLOCK
+    };
+
+    // start()
+    /**
+     * (Re-)starts the background thread. A running sink is stopped (and
+     * drained) first.
+     *
+     * @param[in] capacity The number of records the ring buffer can hold;
+     *                     rounded up to the next power of two.
+     * @param[in] policy The behavior if the ring buffer is full.
+     */
+    static void start(const Size capacity = 4096,
+        const OverflowPolicy policy = DROP);
+
+    // stop()
+    /**
+     * Writes all pending records and stops the background thread. Called
+     * automatically at program exit.
+     */
+    static void stop();
+
+    // flush()
+    /**
+     * Blocks until all records passed to \c output() before the call have
+     * been written.
+     */
+    static void flush();
+
+    // isRunning()
+    /**
+     * @return True if the background thread is running.
+     */
+    static bool isRunning();
+
+    // getDroppedCount()
+    /**
+     * @return The number of records dropped since \c start() because the
+     *         ring buffer was full.
+     */
+    static Size getDroppedCount();
+
+    // getRedirect()
+    /**
+     * The file handle to which the background thread writes.
+     */
+    static FILE*& getRedirect();
+
+    // output()
+    /**
+     * Enqueues a message for asynchronous output.
+     *
+     * This function is used in the Log<T> and mandatory for every Redirector.
+     */
+    static void output(const std::string& msg);
+};
+
+// AsyncLog
+/**
+ * An instance of LOG<T> which is writing to a FILE asynchronously.
+ */
+typedef Log<Output2Async> AsyncLog;
+
+/** @} */
+
+} /* namespace mstk */
+
+#endif /* __MSTK_INCLUDE_MSTK_COMMON_OUTPUT2ASYNC_HPP__ */
@@ -0,0 +1,281 @@
+/*
+ * StaticCollection.hpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_STATICCOLLECTION_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_STATICCOLLECTION_HPP__
+
+#include <utility>
+#include <vector>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/**
+ * @brief Non-virtual base class wrapper around std::vector.
+ *
+ * \c StaticCollection<Derived, T> forwards the \c std::vector interface
+ * exactly like \c Collection<T>, but none of its member functions is
+ * virtual. All calls can therefore be inlined, which matters for the
+ * element-wise loops in the feature extraction code. The class uses the
+ * curiously recurring template pattern: \c Derived is the class that
+ * inherits from \c StaticCollection, e.g.
+ * \code
+ * class Spectrum : public StaticCollection<Spectrum, SpectrumElement> {...};
+ * \endcode
+ * The destructor is protected and non-virtual. Hence, derived objects
+ * cannot be deleted through a pointer to the base class, which is what
+ * makes the missing virtual destructor safe.
+ *
+ * Classes that need to override parts of the vector interface should keep
+ * using the virtual \c Collection<T>.
+ *
+ * See the STL documentation for the interface documentation.
+ */
+template<class Derived, class T, class A = std::allocator<T> >
+class StaticCollection
+{
+public:
+    // typedefs
+    typedef T value_type;
+    typedef A allocator_type;
+
+    typedef typename A::size_type size_type;
+    typedef typename A::difference_type difference_type;
+
+    typedef typename std::vector<T, A>::iterator iterator;
+    typedef typename std::vector<T, A>::const_iterator const_iterator;
+    typedef typename std::vector<T, A>::reverse_iterator reverse_iterator;
+    typedef typename std::vector<T, A>::const_reverse_iterator
+            const_reverse_iterator;
+    typedef typename std::vector<T, A>::pointer pointer;
+    typedef typename std::vector<T, A>::const_pointer const_pointer;
+    typedef typename std::vector<T, A>::reference reference;
+    typedef typename std::vector<T, A>::const_reference const_reference;
+
+    // constructors
+    explicit StaticCollection()
+    {
+    }
+    StaticCollection(const StaticCollection& rhs) :
+        c_(rhs.c_)
+    {
+    }
+    StaticCollection(StaticCollection&& rhs) noexcept :
+        c_(std::move(rhs.c_))
+    {
+    }
+    explicit StaticCollection(const std::vector<T, A>& rhs) :
+        c_(rhs)
+    {
+    }
+    explicit StaticCollection(std::vector<T, A>&& rhs) :
+        c_(std::move(rhs))
+    {
+    }
+    explicit StaticCollection(size_type n, const T& value = T()) :
+        c_(n, value)
+    {
+    }
+    template<class In> StaticCollection(In begin, In end) :
+        c_(begin, end)
+    {
+    }
+
+    // operators
+    StaticCollection& operator=(const StaticCollection& rhs)
+    {
+        c_ = rhs.c_;
+        return *this;
+    }
+    StaticCollection& operator=(StaticCollection&& rhs) noexcept
+    {
+        c_ = std::move(rhs.c_);
+        return *this;
+    }
+
+    template<class D, class U, class V>
+    friend bool operator==(const StaticCollection<D, U, V>& lhs,
+        const StaticCollection<D, U, V>& rhs);
+
+    template<class D, class U, class V>
+    friend bool operator<(const StaticCollection<D, U, V>& lhs,
+        const StaticCollection<D, U, V>& rhs);
+
+    // assignment
+    template<class In> void assign(In begin, In end)
+    {
+        c_.assign(begin, end);
+    }
+    void assign(size_type n, const T& value)
+    {
+        c_.assign(n, value);
+    }
+
+    // stack operations
+    void push_back(const T& value)
+    {
+        c_.push_back(value);
+    }
+    void pop_back(void)
+    {
+        c_.pop_back();
+    }
+
+    // list operations
+    iterator insert(iterator pos, const T& value)
+    {
+        return c_.insert(pos, value);
+    }
+    void insert(iterator pos, size_type n, const T& value)
+    {
+        c_.insert(pos, n, value);
+    }
+    template<class In> void insert(iterator pos, In begin, In end)
+    {
+        c_.insert(pos, begin, end);
+    }
+    iterator erase(iterator pos)
+    {
+        return c_.erase(pos);
+    }
+    iterator erase(iterator begin, iterator end)
+    {
+        return c_.erase(begin, end);
+    }
+    void clear()
+    {
+        c_.clear();
+    }
+
+    // iterators
+    iterator begin()
+    {
+        return c_.begin();
+    }
+    reverse_iterator rbegin()
+    {
+        return c_.rbegin();
+    }
+    iterator end()
+    {
+        return c_.end();
+    }
+    reverse_iterator rend()
+    {
+        return c_.rend();
+    }
+    const_iterator begin() const
+    {
+        return c_.begin();
+    }
+    const_iterator end() const
+    {
+        return c_.end();
+    }
+
+    // element access
+    value_type& operator[](size_type pos)
+    {
+        return c_[pos];
+    }
+    value_type& at(size_type pos)
+    {
+        return c_.at(pos);
+    }
+    const value_type& operator[](size_type pos) const
+    {
+        return c_[pos];
+    }
+    const value_type& at(size_type pos) const
+    {
+        return c_.at(pos);
+    }
+
+    // size and capacity
+    size_type size(void) const
+    {
+        return c_.size();
+    }
+    size_type max_size() const
+    {
+        return c_.max_size();
+    }
+    bool empty() const
+    {
+        return c_.empty();
+    }
+    void resize(size_type sz, const T& value = T())
+    {
+        c_.resize(sz, value);
+    }
+    size_type capacity() const
+    {
+        return c_.capacity();
+    }
+    void reserve(size_type n)
+    {
+        c_.reserve(n); // throws length_error if n > max_size()
+    }
+
+    // other
+    void swap(Derived& rhs)
+    {
+        c_.swap(static_cast<StaticCollection&> (rhs).c_);
+    }
+    allocator_type get_allocator() const
+    {
+        return c_.get_allocator();
+    }
+
+protected:
+    // non-virtual: derived objects must not be deleted through a
+    // pointer to StaticCollection
+    ~StaticCollection()
+    {
+    }
+
+    std::vector<T, A> c_;
+};
+
+// helper functions
+template<class D, class T, class A> bool operator==(
+    const StaticCollection<D, T, A>& lhs, const StaticCollection<D, T, A>& rhs)
+{
+    return lhs.c_ == rhs.c_;
+}
+template<class D, class T, class A> bool operator<(
+    const StaticCollection<D, T, A>& lhs, const StaticCollection<D, T, A>& rhs)
+{
+    return lhs.c_ < rhs.c_;
+}
+
+/** @} */
+
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * parallelFor.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_COMMON_PARALLELFOR_HPP__
+#define __MSTK_INCLUDE_MSTK_COMMON_PARALLELFOR_HPP__
+
+#include <MSTK/common/Types.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace mstk {
+
+/** @addtogroup mstk_common
+ * @{
+ */
+
+/** Returns the number of worker threads to use.
+ * @param[in] nThreads The requested number of threads; 0 selects the number
+ *                     of hardware threads.
+ * @return The number of threads, at least 1.
+ */
+inline UnsignedInt getNumberOfThreads(const UnsignedInt nThreads = 0)
+{
+    if (nThreads > 0) {
+        return nThreads;
+    }
+    UnsignedInt n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+/** Calls \c f(i, t) for all \c i in [\c first, \c last) on \c nThreads
+ * threads, where \c t in [0, \c nThreads) is the index of the calling
+ * thread. Use \c t to address per-thread state (e.g. output buffers) without
+ * locking.
+ *
+ * Work is distributed dynamically: the threads fetch chunks of
+ * \c chunkSize consecutive indices from a shared atomic counter until the
+ * range is exhausted, which balances the load for index ranges of uneven
+ * cost. With a single thread, \c f is called in order on the calling
+ * thread. If \c f throws, the remaining work is abandoned and the
+ * exception is rethrown on the calling thread once all threads have
+ * finished.
+ *
+ * @param[in] first The first index.
+ * @param[in] last One past the last index.
+ * @param[in] f The function object; it is shared by all threads and hence
+ *              must be safe to call concurrently.
+ * @param[in] nThreads The number of threads; 0 selects the number of
+ *                     hardware threads.
+ * @param[in] chunkSize The number of indices a thread fetches at once.
+ */
+template<typename Function>
+void parallelFor(const Size first, const Size last, Function f,
+    const UnsignedInt nThreads = 0, const Size chunkSize = 1)
+{
+    if (first >= last) {
+        return;
+    }
+    const Size n = last - first;
+    const Size chunk = std::max(chunkSize, static_cast<Size> (1));
+    const Size maxThreads = (n + chunk - 1) / chunk;
+    const UnsignedInt nt = static_cast<UnsignedInt> (std::min(
+        static_cast<Size> (getNumberOfThreads(nThreads)), maxThreads));
+    if (nt == 1) {
+        for (Size i = first; i < last; ++i) {
+            f(i, 0);
+        }
+        return;
+    }
+
+    std::atomic<Size> next(first);
+    std::atomic<bool> failed(false);
+    std::vector<std::exception_ptr> errors(nt);
+    auto worker = [&](const UnsignedInt t) {
+        try {
+            for (;;) {
+                if (failed.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                Size b = next.fetch_add(chunk, std::memory_order_relaxed);
+                if (b >= last) {
+                    return;
+                }
+                Size e = std::min(b + chunk, last);
+                for (Size i = b; i < e; ++i) {
+                    f(i, t);
+                }
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nt - 1);
+    for (UnsignedInt t = 1; t < nt; ++t) {
+        threads.push_back(std::thread(worker, t));
+    }
+    // the calling thread does its share of the work
+    worker(0);
+    for (std::vector<std::thread>::iterator i = threads.begin();
+            i != threads.end(); ++i) {
+        i->join();
+    }
+    for (std::vector<std::exception_ptr>::iterator i = errors.begin();
+            i != errors.end(); ++i) {
+        if (*i) {
+            std::rethrow_exception(*i);
+        }
+    }
+}
+
+/** @} */
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_COMMON_PARALLELFOR_HPP__ */
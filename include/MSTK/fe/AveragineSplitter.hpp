@@ -0,0 +1,371 @@
+/*
+ * AveragineSplitter.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_AVERAGINESPLITTER_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_AVERAGINESPLITTER_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** An envelope table without envelopes; see \c AveragineSplitter.
+ */
+struct NoEnvelopeTable
+{
+    Size getEnvelope(const double, double*, const Size) const
+    {
+        return 0;
+    }
+};
+
+/** Charge-aware isotope pattern splitter.
+ *
+ * Use this as the \c Splitter policy of \c mstk::fe::IsotopePatternExtractor
+ * to unmix co-eluting isotope patterns of different charge states. Each
+ * (pre-)isotope pattern is processed independently:
+ *
+ * -# \c QuickCharge proposes the candidate charges from the m/z distances of
+ *    the XICs.
+ * -# For every candidate charge \c z and every XIC as monoisotopic seed,
+ *    the splitter collects the chain of XICs at <tt>1.00286864 / z</tt>
+ *    m/z spacing (within the m/z tolerance), up to \c getMaxPeaks() peaks.
+ * -# A chain of at least two XICs is scored by the cosine similarity of its
+ *    XIC abundances and the averagine envelope of its neutral mass, looked
+ *    up in the envelope table. Chains below the minimum score are
+ *    discarded; among the others, the chain with the largest
+ *    score-weighted abundance becomes an isotope pattern of charge \c z and
+ *    its XICs are removed.
+ * -# Step 2 and 3 repeat until no chain qualifies. Each remaining XIC
+ *    becomes a pattern of its own (usually removed by the cardinality
+ *    requirement of \c IsotopePatternExtractor). If no chain qualifies at
+ *    all, the pattern is kept as is.
+ *
+ * \c EnvelopeTable must provide
+ * <tt>Size getEnvelope(double mass, double* abundances, Size n) const</tt>,
+ * which writes the relative abundances of the first (at most \c n) isotope
+ * peaks of a molecule with the given neutral mass, e.g.
+ * \c mstk::ipaca::AveragineTable. Without a table (or with
+ * \c NoEnvelopeTable), chains are chosen by abundance alone.
+ *
+ * The isotope pattern type must provide \c setCharges(), as
+ * \c mstk::fe::IsotopePattern does. \c splitPattern() is const and touches
+ * nothing but its arguments; hence patterns can be split concurrently.
+ */
+template<class EnvelopeTable = NoEnvelopeTable>
+class AveragineSplitter
+{
+public:
+    /** Constructor. No envelope table, 10 ppm m/z tolerance, a minimum
+     * score of 0.8 and at most 8 peaks per isotope pattern.
+     */
+    AveragineSplitter();
+
+    /** Set the envelope table. The table is not copied and must outlive
+     * the splitter.
+     * @param[in] table The table or 0 to score chains by abundance only.
+     */
+    void setEnvelopeTable(const EnvelopeTable* table);
+
+    /** @return The envelope table or 0.
+     */
+    const EnvelopeTable* getEnvelopeTable() const;
+
+    /** Set the m/z tolerance for the isotope peak positions.
+     * @param[in] ppm The tolerance, in ppm.
+     */
+    void setMzTolerance(const double ppm);
+
+    double getMzTolerance() const;
+
+    /** Set the minimum cosine similarity between the observed abundances
+     * and the envelope.
+     */
+    void setMinScore(const double minScore);
+
+    double getMinScore() const;
+
+    /** Set the maximum number of peaks per isotope pattern.
+     * @throw mstk::PreconditionViolation if \c maxPeaks is less than 2.
+     */
+    void setMaxPeaks(const Size maxPeaks);
+
+    Size getMaxPeaks() const;
+
+    /** Split all isotope patterns in the container.
+     * @param[in,out] isotopePatterns The isotope patterns; replaced by the
+     *                                split patterns.
+     */
+    template<typename IsotopePatternContainer>
+    void split(IsotopePatternContainer& isotopePatterns) const;
+
+    /** Split a single isotope pattern.
+     * @param[in,out] isotopePattern The isotope pattern. Its XICs are sorted
+     *                by m/z and moved into the parts.
+     * @param[out] parts The charge-consistent parts are appended here.
+     */
+    template<typename IsotopePatternType>
+    void splitPattern(IsotopePatternType& isotopePattern,
+        std::vector<IsotopePatternType>& parts) const;
+
+private:
+    const EnvelopeTable* table_;
+    double ppm_;
+    double minScore_;
+    Size maxPeaks_;
+};
+
+} // namespace fe
+
+} // namespace mstk
+
+//
+// template implementation
+//
+#include <MSTK/common/Error.hpp>
+#include <MSTK/fe/IsotopePatternTraits.hpp>
+#include <MSTK/fe/QuickCharge.hpp>
+#include <MSTK/fe/XicTraits.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <set>
+#include <utility>
+
+namespace mstk {
+
+namespace fe {
+
+template<class EnvelopeTable>
+AveragineSplitter<EnvelopeTable>::AveragineSplitter() :
+    table_(0), ppm_(10.0), minScore_(0.8), maxPeaks_(8)
+{
+}
+
+template<class EnvelopeTable>
+void AveragineSplitter<EnvelopeTable>::setEnvelopeTable(
+    const EnvelopeTable* table)
+{
+    table_ = table;
+}
+
+template<class EnvelopeTable>
+const EnvelopeTable* AveragineSplitter<EnvelopeTable>::getEnvelopeTable() const
+{
+    return table_;
+}
+
+template<class EnvelopeTable>
+void AveragineSplitter<EnvelopeTable>::setMzTolerance(const double ppm)
+{
+    ppm_ = ppm;
+}
+
+template<class EnvelopeTable>
+double AveragineSplitter<EnvelopeTable>::getMzTolerance() const
+{
+    return ppm_;
+}
+
+template<class EnvelopeTable>
+void AveragineSplitter<EnvelopeTable>::setMinScore(const double minScore)
+{
+    minScore_ = minScore;
+}
+
+template<class EnvelopeTable>
+double AveragineSplitter<EnvelopeTable>::getMinScore() const
+{
+    return minScore_;
+}
+
+template<class EnvelopeTable>
+void AveragineSplitter<EnvelopeTable>::setMaxPeaks(const Size maxPeaks)
+{
+    mstk_precondition(maxPeaks >= 2,
+        "AveragineSplitter: an isotope pattern needs at least two peaks.");
+    maxPeaks_ = maxPeaks;
+}
+
+template<class EnvelopeTable>
+Size AveragineSplitter<EnvelopeTable>::getMaxPeaks() const
+{
+    return maxPeaks_;
+}
+
+template<class EnvelopeTable>
+template<typename IsotopePatternContainer>
+void AveragineSplitter<EnvelopeTable>::split(
+    IsotopePatternContainer& isotopePatterns) const
+{
+    typedef typename IsotopePatternContainer::value_type IsotopePatternType;
+    std::vector<IsotopePatternType> parts;
+    parts.reserve(isotopePatterns.size());
+    typedef typename IsotopePatternContainer::iterator IT;
+    for (IT i = isotopePatterns.begin(); i != isotopePatterns.end(); ++i) {
+        splitPattern(*i, parts);
+    }
+    isotopePatterns.clear();
+    std::move(parts.begin(), parts.end(), std::back_inserter(isotopePatterns));
+}
+
+template<class EnvelopeTable>
+template<typename IsotopePatternType>
+void AveragineSplitter<EnvelopeTable>::splitPattern(
+    IsotopePatternType& isotopePattern,
+    std::vector<IsotopePatternType>& parts) const
+{
+    // MaxQuant's average isotope distance and the proton mass, in Da
+    static const double isotopeSpacing = 1.00286864;
+    static const double protonMass = 1.00727646688;
+
+    typedef typename IsotopePatternType::value_type XicType;
+    typedef typename XicTraits<XicType>::LessThanMz LessThanMz;
+    typename XicTraits<XicType>::MzAccessor accMz;
+    typename XicTraits<XicType>::AbundanceAccessor accAb;
+    const Size n = isotopePattern.size();
+    if (n < 2) {
+        parts.push_back(std::move(isotopePattern));
+        return;
+    }
+    std::sort(isotopePattern.begin(), isotopePattern.end(), LessThanMz());
+    std::vector<double> mz(n), ab(n);
+    for (Size i = 0; i < n; ++i) {
+        mz[i] = accMz(isotopePattern[i]);
+        ab[i] = accAb(isotopePattern[i]);
+    }
+    // candidate charges, in ascending order
+    int charges[ChargeSet::MAX_CHARGE];
+    const int* chargesEnd = QuickCharge().getCharges(isotopePattern.begin(),
+        isotopePattern.end()).copy(charges);
+
+    // greedily extract the best chain
+    std::vector<bool> used(n, false);
+    std::vector<std::pair<int, std::vector<Size> > > chains;
+    std::vector<Size> chain, best;
+    std::vector<double> envelope(maxPeaks_);
+    for (;;) {
+        double bestValue = 0.0;
+        int bestCharge = 0;
+        for (const int* z = charges; z != chargesEnd; ++z) {
+            const double d = isotopeSpacing / *z;
+            for (Size s = 0; s < n; ++s) {
+                if (used[s]) {
+                    continue;
+                }
+                chain.assign(1, s);
+                while (chain.size() < maxPeaks_) {
+                    // the closest unused XIC at the next isotope position
+                    const double target = mz[s] + chain.size() * d;
+                    const double tol = target * ppm_ * 1e-6;
+                    Size next = n;
+                    for (Size k = std::lower_bound(mz.begin(), mz.end(),
+                        target - tol) - mz.begin(); k < n && mz[k] <= target
+                            + tol; ++k) {
+                        if (!used[k] && (next == n || std::abs(mz[k] - target)
+                                < std::abs(mz[next] - target))) {
+                            next = k;
+                        }
+                    }
+                    if (next == n) {
+                        break;
+                    }
+                    chain.push_back(next);
+                }
+                if (chain.size() < 2) {
+                    continue;
+                }
+                double sum = 0.0;
+                for (Size k = 0; k < chain.size(); ++k) {
+                    sum += ab[chain[k]];
+                }
+                double score = 1.0;
+                const Size m = table_ ? table_->getEnvelope(
+                    (mz[s] - protonMass) * *z, &envelope[0], chain.size()) : 0;
+                if (m > 0) {
+                    double oe = 0.0, oo = 0.0, ee = 0.0;
+                    for (Size k = 0; k < m; ++k) {
+                        oe += ab[chain[k]] * envelope[k];
+                        oo += ab[chain[k]] * ab[chain[k]];
+                        ee += envelope[k] * envelope[k];
+                    }
+                    score = (oo > 0.0 && ee > 0.0) ? oe / std::sqrt(oo * ee)
+                            : 0.0;
+                }
+                if (score < minScore_) {
+                    continue;
+                }
+                if (score * sum > bestValue) {
+                    bestValue = score * sum;
+                    bestCharge = *z;
+                    best.swap(chain);
+                }
+            }
+        }
+        if (bestCharge == 0) {
+            break;
+        }
+        for (Size k = 0; k < best.size(); ++k) {
+            used[best[k]] = true;
+        }
+        chains.push_back(std::make_pair(bestCharge, best));
+    }
+    if (chains.empty()) {
+        parts.push_back(std::move(isotopePattern));
+        return;
+    }
+
+    // move the XICs into the parts
+    typedef typename IsotopePatternTraits<IsotopePatternType>::Creator Creator;
+    Creator creator;
+    for (Size c = 0; c < chains.size(); ++c) {
+        const std::vector<Size>& idx = chains[c].second;
+        std::vector<XicType> xics;
+        xics.reserve(idx.size());
+        for (Size k = 0; k < idx.size(); ++k) {
+            xics.push_back(std::move(isotopePattern[idx[k]]));
+        }
+        std::sort(xics.begin(), xics.end(), LessThanMz());
+        parts.push_back(creator(std::move(xics)));
+        std::set<int> z;
+        z.insert(chains[c].first);
+        parts.back().setCharges(z);
+    }
+    for (Size i = 0; i < n; ++i) {
+        if (!used[i]) {
+            std::vector<XicType> xics(1, std::move(isotopePattern[i]));
+            parts.push_back(creator(std::move(xics)));
+        }
+    }
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_AVERAGINESPLITTER_HPP__ */
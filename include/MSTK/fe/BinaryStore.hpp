@@ -0,0 +1,361 @@
+/*
+ * BinaryStore.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_BINARYSTORE_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_BINARYSTORE_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/MappedFile.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
+#include <MSTK/fe/types/CentroidTableView.hpp>
+#include <fstream>
+#include <iterator>
+#include <stdint.h>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** Header of a binary centroid or XIC table.
+ *
+ * A binary store file holds a single table in a versioned, little-endian,
+ * columnar format:
+ *
+ * - a header of \c SIZE bytes: the magic string "MSTKFEBS", the format
+ *   version, the table type, the number of centroids and XICs, followed by
+ *   the file offset of every column;
+ * - the columns rt (double), m/z (double), abundance (double), scan number
+ *   (uint32), and the raw data scan index, offset and length (uint32) of
+ *   every centroid;
+ * - for XIC tables, the \c nXics + 1 offsets (uint64) of the XICs into the
+ *   centroid columns.
+ *
+ * Every column starts at a multiple of \c ALIGNMENT bytes, so that a mapped
+ * file can be accessed in place (see \c BinaryStoreReader).
+ */
+struct MSTK_EXPORT BinaryStoreHeader
+{
+    enum TableType
+    {
+        CENTROID_TABLE = 1, XIC_TABLE = 2
+    };
+
+    enum Column
+    {
+        RT = 0,
+        MZ,
+        ABUNDANCE,
+        SCAN_NUMBER,
+        RAW_SCAN_INDEX,
+        RAW_OFFSET,
+        RAW_LENGTH,
+        XIC_OFFSETS,
+        N_COLUMNS
+    };
+
+    /** The current format version.
+     */
+    static const uint32_t VERSION = 1;
+    /** The size of the encoded header in bytes.
+     */
+    static const Size SIZE = 128;
+    /** The alignment of the columns in bytes.
+     */
+    static const Size ALIGNMENT = 64;
+
+    /** Default constructor. Constructs an empty centroid table header.
+     */
+    BinaryStoreHeader();
+
+    /** Constructs the header of a table with \c nCentroids centroids and
+     * \c nXics XICs and lays out the columns.
+     */
+    BinaryStoreHeader(const TableType type, const uint64_t nCentroids,
+        const uint64_t nXics);
+
+    /** @return The size of a column entry in bytes.
+     */
+    static Size getElementSize(const Column c);
+
+    /** @return The size of the file described by the header.
+     */
+    uint64_t getFileSize() const;
+
+    /** Encode the header into \c SIZE bytes at \c buf.
+     */
+    void encode(char* buf) const;
+
+    /** Decode and validate the header of a file of \c fileSize bytes.
+     * @throw mstk::RuntimeError if the data is not a binary store of a
+     *        supported version or if the file is truncated.
+     */
+    static BinaryStoreHeader decode(const char* buf, const Size fileSize);
+
+    uint32_t version;
+    uint32_t tableType;
+    uint64_t nCentroids;
+    uint64_t nXics;
+    uint64_t columnOffsets[N_COLUMNS];
+};
+
+/** Write a centroid table.
+ * @param[in] filename The name of the file.
+ * @param[in] centroids The centroids; \c Centroid and \c CompactCentroid are
+ *                      supported. Raw data is not stored, only the raw data
+ *                      handles of \c CompactCentroid.
+ * @throw mstk::RuntimeError if the file cannot be written.
+ */
+template<class CentroidContainer>
+void writeCentroidTable(const String& filename,
+    const CentroidContainer& centroids);
+
+/** Write an XIC table.
+ * @param[in] filename The name of the file.
+ * @param[in] xics The XICs; the elements of every XIC must be \c Centroid
+ *                 or \c CompactCentroid objects.
+ * @throw mstk::RuntimeError if the file cannot be written.
+ */
+template<class XicContainer>
+void writeXicTable(const String& filename, const XicContainer& xics);
+
+/** Read-only access to a memory-mapped binary store.
+ *
+ * The file is mapped and its columns are accessed in place: opening a
+ * store costs a header check, independent of its size, and the views
+ * returned by \c getCentroids() and \c getXics() can be passed directly to
+ * \c XicExtractor or any other algorithm that takes a container of
+ * centroids. The views are invalidated when the reader is closed or
+ * destroyed. Mapping requires a little-endian host.
+ */
+class MSTK_EXPORT BinaryStoreReader
+{
+public:
+    /** Default constructor.
+     */
+    BinaryStoreReader();
+
+    /** Constructor. Opens \c filename.
+     * @throw mstk::RuntimeError if the file cannot be mapped or is not a
+     *        valid binary store.
+     */
+    explicit BinaryStoreReader(const String& filename);
+
+    /** Open \c filename; a previously opened file is closed.
+     * @throw mstk::RuntimeError if the file cannot be mapped or is not a
+     *        valid binary store.
+     */
+    void open(const String& filename);
+
+    /** Close the file.
+     */
+    void close();
+
+    /** @return The header of the file.
+     */
+    const BinaryStoreHeader& getHeader() const;
+
+    /** @return True if the file holds an XIC table.
+     */
+    bool isXicTable() const;
+
+    /** @return A view onto all centroids in the file. For XIC tables, these
+     *          are the centroids of all XICs.
+     */
+    const CentroidTableView& getCentroids() const;
+
+    /** @return A view onto the XICs in the file.
+     * @throw mstk::PreconditionViolation if the file holds a centroid table.
+     */
+    const XicTableView& getXics() const;
+
+private:
+    MappedFile file_;
+    BinaryStoreHeader header_;
+    CentroidTableView centroids_;
+    XicTableView xics_;
+};
+
+namespace detail {
+
+/** @return True if the host stores integers in little-endian byte order.
+ */
+inline bool isLittleEndianHost()
+{
+    const uint32_t one = 1;
+    return *reinterpret_cast<const unsigned char*> (&one) == 1;
+}
+
+/** Buffered writer for the columns of a binary store.
+ */
+class MSTK_EXPORT BinaryStoreWriter
+{
+public:
+    BinaryStoreWriter(const String& filename, const BinaryStoreHeader& header);
+
+    /** Start the column \c c; pads the file up to the column offset.
+     */
+    void beginColumn(const BinaryStoreHeader::Column c);
+
+    /** Append a value to the current column in little-endian byte order.
+     */
+    template<class T>
+    void put(const T value);
+
+    /** Write the padding after the last column and close the file.
+     * @throw mstk::RuntimeError if writing failed.
+     */
+    void finish();
+
+private:
+    void flush();
+
+    String filename_;
+    BinaryStoreHeader header_;
+    std::ofstream os_;
+    std::vector<char> buffer_;
+    uint64_t pos_;
+};
+
+template<class T>
+inline void BinaryStoreWriter::put(const T value)
+{
+    if (buffer_.size() + sizeof(T) > buffer_.capacity()) {
+        flush();
+    }
+    const char* p = reinterpret_cast<const char*> (&value);
+    if (isLittleEndianHost()) {
+        buffer_.insert(buffer_.end(), p, p + sizeof(T));
+    } else {
+        for (Size i = sizeof(T); i > 0; --i) {
+            buffer_.push_back(p[i - 1]);
+        }
+    }
+}
+
+inline RawDataHandle getRawDataHandle(const Centroid&)
+{
+    return RawDataHandle();
+}
+
+inline RawDataHandle getRawDataHandle(const CompactCentroid& c)
+{
+    return c.getRawDataHandle();
+}
+
+/** Write the centroid columns of all centroids in the range of ranges
+ * [first, last).
+ */
+template<class RangeIterator>
+void writeCentroidColumns(BinaryStoreWriter& w, RangeIterator first,
+    RangeIterator last)
+{
+    typedef BinaryStoreHeader H;
+    for (int c = H::RT; c < H::XIC_OFFSETS; ++c) {
+        w.beginColumn(static_cast<H::Column> (c));
+        for (RangeIterator r = first; r != last; ++r) {
+            // views return their ranges by value
+            typedef typename std::iterator_traits<RangeIterator>::value_type Range;
+            typename std::iterator_traits<RangeIterator>::reference range = *r;
+            for (typename Range::const_iterator i = range.begin(); i
+                    != range.end(); ++i) {
+                typename std::iterator_traits<
+                        typename Range::const_iterator>::reference centroid = *i;
+                switch (c) {
+                    case H::RT:
+                        w.put<double> (centroid.getRetentionTime());
+                        break;
+                    case H::MZ:
+                        w.put<double> (centroid.getMz());
+                        break;
+                    case H::ABUNDANCE:
+                        w.put<double> (centroid.getAbundance());
+                        break;
+                    case H::SCAN_NUMBER:
+                        w.put<uint32_t> (centroid.getScanNumber());
+                        break;
+                    case H::RAW_SCAN_INDEX:
+                        w.put<uint32_t> (getRawDataHandle(centroid).scanIndex);
+                        break;
+                    case H::RAW_OFFSET:
+                        w.put<uint32_t> (getRawDataHandle(centroid).offset);
+                        break;
+                    case H::RAW_LENGTH:
+                        w.put<uint32_t> (getRawDataHandle(centroid).length);
+                        break;
+                }
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+//
+// template implementation
+//
+
+template<class CentroidContainer>
+void writeCentroidTable(const String& filename,
+    const CentroidContainer& centroids)
+{
+    BinaryStoreHeader header(BinaryStoreHeader::CENTROID_TABLE,
+        centroids.size(), 0);
+    detail::BinaryStoreWriter w(filename, header);
+    detail::writeCentroidColumns(w, &centroids, &centroids + 1);
+    w.finish();
+}
+
+template<class XicContainer>
+void writeXicTable(const String& filename, const XicContainer& xics)
+{
+    uint64_t nCentroids = 0;
+    for (typename XicContainer::const_iterator i = xics.begin(); i
+            != xics.end(); ++i) {
+        nCentroids += (*i).size();
+    }
+    BinaryStoreHeader header(BinaryStoreHeader::XIC_TABLE, nCentroids,
+        xics.size());
+    detail::BinaryStoreWriter w(filename, header);
+    detail::writeCentroidColumns(w, xics.begin(), xics.end());
+    w.beginColumn(BinaryStoreHeader::XIC_OFFSETS);
+    uint64_t offset = 0;
+    w.put<uint64_t> (offset);
+    for (typename XicContainer::const_iterator i = xics.begin(); i
+            != xics.end(); ++i) {
+        offset += (*i).size();
+        w.put<uint64_t> (offset);
+    }
+    w.finish();
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_BINARYSTORE_HPP__ */
@@ -0,0 +1,77 @@
+/*
+ * CentroidCreator.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_CENTROIDCREATOR_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_CENTROIDCREATOR_HPP__
+
+#include <MSTK/common/Types.hpp>
+
+namespace mstk {
+
+namespace fe {
+
+/** Creates centroid objects for the \c Centroider.
+ *
+ * The default implementation forwards to the
+ * <tt>C(rt, mz, sn, ab, first, last)</tt> constructor, i.e. the centroid
+ * type decides what to do with the raw data of the bump. Centroid types that
+ * do not own their raw data (see \c CompactCentroid) specialize the creator.
+ */
+template<typename C>
+class CentroidCreator
+{
+public:
+    /** Create a centroid.
+     * @param[in] rt The retention time of the scan.
+     * @param[in] mz The m/z value of the centroid.
+     * @param[in] sn The scan number.
+     * @param[in] ab The centroid abundance.
+     * @param[in] scanFirst Iterator to the first element of the scan that is
+     *                      being centroided.
+     * @param[in] first Iterator to the first raw element of the bump.
+     * @param[in] last Iterator past the last raw element of the bump.
+     */
+    template<typename InputIterator>
+    C operator()(Double rt, Double mz, UnsignedInt sn, Double ab,
+        InputIterator scanFirst, InputIterator first, InputIterator last);
+};
+
+//
+// template implementation
+//
+
+template<typename C>
+template<typename InputIterator>
+C CentroidCreator<C>::operator()(Double rt, Double mz, UnsignedInt sn,
+    Double ab, InputIterator, InputIterator first, InputIterator last)
+{
+    return C(rt, mz, sn, ab, first, last);
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_CENTROIDCREATOR_HPP__ */
@@ -26,6 +26,8 @@
 #ifndef __MSTK_INCLUDE_MSTK_FE_CENTROIDTRAITS_HPP__
 #define __MSTK_INCLUDE_MSTK_FE_CENTROIDTRAITS_HPP__
 
+#include <MSTK/fe/CentroidCreator.hpp>
+
 namespace mstk {
 
 namespace fe {
@@ -37,6 +39,7 @@ struct CentroidTraits
     typedef typename T::AbundanceAccessor AbundanceAccessor;
     typedef typename T::RtAccessor RtAccessor;
     typedef typename T::LessThanRt LessThanRt;
+    typedef CentroidCreator<T> Creator;
 };
 
 } // namespace fe
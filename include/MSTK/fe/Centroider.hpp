@@ -27,7 +27,9 @@
 #define __MSTK_INCLUDE_MSTK_FE_CENTROIDER_HPP__
 
 #include <MSTK/common/Types.hpp>
+#include <MSTK/common/Instrumentation.hpp>
 #include <MSTK/common/Log.hpp>
+#include <MSTK/fe/CentroidTraits.hpp>
 #include <iterator>
 #include <utility>
 
@@ -42,15 +44,46 @@ class Centroider : public BumpFinder,
                    public AbundanceAccumulator
 {
 public:
+    /** The creator used to construct the centroids, see \c CentroidCreator.
+     */
+    typedef typename CentroidTraits<CentroidType>::Creator Creator;
+
+    /** Default constructor.
+     */
+    Centroider();
+
+    /** Constructor.
+     * @param[in] creator The creator used to construct the centroids.
+     */
+    explicit Centroider(const Creator& creator);
+
     template<typename InputIterator, typename OutputIterator>
     void operator()(InputIterator first, InputIterator last,
         Double retentionTime, UnsignedInt scanNumber, OutputIterator out);
+
+private:
+    Creator creator_;
 };
 
 //
 // template implementation
 //
 
+template<class CentroidType, class BumpFinder, class MeanAccumulator,
+        class AbundanceAccumulator>
+Centroider<CentroidType, BumpFinder, MeanAccumulator, AbundanceAccumulator>::Centroider() :
+        creator_()
+{
+}
+
+template<class CentroidType, class BumpFinder, class MeanAccumulator,
+        class AbundanceAccumulator>
+Centroider<CentroidType, BumpFinder, MeanAccumulator, AbundanceAccumulator>::Centroider(
+    const Creator& creator) :
+        creator_(creator)
+{
+}
+
 template<class CentroidType, class BumpFinder, class MeanAccumulator,
         class AbundanceAccumulator>
 template<class InputIterator, typename OutputIterator>
@@ -65,6 +98,9 @@ void Centroider<CentroidType, BumpFinder, MeanAccumulator,
     // define the interface that must be supported by the different policies.
     MSTK_LOG(logDEBUG2)
             << "Got Spectrum of size: " << std::distance(first, last);
+    MSTK_INSTRUMENT_TIMER("fe.Centroider");
+    MSTK_INSTRUMENT_RECORD("fe.Centroider.spectrumSize",
+        std::distance(first, last));
     std::pair<InputIterator, InputIterator> bumpBounds = std::make_pair(first,
         first);
     // find bumps until the right bump bound equals the right range bound
@@ -79,10 +115,10 @@ void Centroider<CentroidType, BumpFinder, MeanAccumulator,
         double ab = this->abundance(bumpBounds.first, bumpBounds.second);
         // centroids must have a valid abundance measurement
         if (ab > 0.0) {
-            CentroidType c(retentionTime, mz, scanNumber, ab,
+            *out = creator_(retentionTime, mz, scanNumber, ab, first,
                 bumpBounds.first, bumpBounds.second);
-            *out = c;
             ++out;
+            MSTK_INSTRUMENT_COUNT("fe.Centroider.centroids", 1);
         }
     }
 }
@@ -0,0 +1,69 @@
+/*
+ * DenseUncenteredCorrelation.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_DENSEUNCENTEREDCORRELATION_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_DENSEUNCENTEREDCORRELATION_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/DenseXicProfile.hpp>
+
+namespace mstk {
+
+namespace fe {
+
+/** Uncentered correlation of XIC elution profiles on dense, scan-aligned
+ * vectors.
+ *
+ * Computes the same measure as \c UncenteredCorrelation, but pairs the
+ * abundances of two XICs by scan number instead of merging them by
+ * retention time: the profiles are rebased onto the scans of a
+ * \c DenseXicProfileArena and the correlation reduces to a dot product
+ * over the overlapping scan window, which runs on the vectorized
+ * \c ProfileKernels. Drop-in replacement for \c UncenteredCorrelation as
+ * the \c Correlator policy of \c IsotopePatternExtractor. The results
+ * agree with \c UncenteredCorrelation up to rounding, as long as
+ * centroids with equal retention times have equal scan numbers.
+ */
+class MSTK_EXPORT DenseUncenteredCorrelation
+{
+public:
+    typedef double ThresholdType;
+    typedef DenseXicProfileArena ProfileArena;
+
+protected:
+    virtual ~DenseUncenteredCorrelation() = 0;
+
+    /** @return The correlation between the i-th and the j-th profile.
+     */
+    ThresholdType correlate(const DenseXicProfileArena& profiles,
+        const Size i, const Size j);
+};
+
+}
+
+}
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_DENSEUNCENTEREDCORRELATION_HPP__ */
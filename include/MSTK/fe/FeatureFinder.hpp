@@ -0,0 +1,656 @@
+/*
+ * FeatureFinder.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_FEATUREFINDER_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_FEATUREFINDER_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/BoundedQueue.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** An end-to-end LC-MS feature finding pipeline.
+ *
+ * \c FeatureFinder chains centroiding, XIC extraction and isotope pattern
+ * extraction. Instead of materializing the centroids and XICs of the
+ * complete run, the scans are streamed through the stages:
+ *
+ *   - every scan is centroided as soon as it is added;
+ *   - the centroids are fed into a \c StreamingXicExtractor, which emits
+ *     XICs as soon as they can no longer grow;
+ *   - the isotope pattern stage collects the XICs and hands groups of them
+ *     to the \c IsotopePatternExtractor as soon as their neighbourhood is
+ *     complete, i.e. as soon as no XIC emitted later can intersect their
+ *     boxes. The finished isotope patterns are passed to a callback.
+ *
+ * In \c PIPELINED mode, each stage runs on its own thread and the stages are
+ * connected by bounded queues, so that they overlap on different cores and
+ * a fast producer cannot run ahead of the slower stages. In \c SEQUENTIAL
+ * mode, all stages run on the calling thread.
+ *
+ * The isotope pattern stage passes an XIC on once its retention time box
+ * ends before the smallest retention time any future XIC can have (the
+ * minimum over the open XICs and the current scan), minus the maximum
+ * retention time tolerance of the XIC box generators. Only complete
+ * connected components of the XIC box intersection graph are passed on.
+ * Hence, the set of isotope patterns is the same as the one obtained by
+ * running \c Centroider, \c XicExtractor and \c IsotopePatternExtractor on
+ * the complete run; only their order differs. XICs that stay open over long
+ * stretches of the run (e.g. background ions) delay the release of their
+ * neighbourhood.
+ *
+ * The stages are configured entirely through the policy classes of the
+ * existing components, e.g.
+ * \code
+ * typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+ *         SumAbundanceAccumulator> MyCentroider;
+ * typedef StreamingXicExtractor<CentroidWeightedMeanDisambiguator,
+ *         RunningMeanSmoother, XicLocalMinSplitter<Xic>, Xic,
+ *         CentroidBoxGenerator> MyXicExtractor;
+ * typedef IsotopePatternExtractor<UncenteredCorrelation, NopSplitter>
+ *         MyIsotopePatternExtractor;
+ * typedef FeatureFinder<MyCentroider, MyXicExtractor,
+ *         MyIsotopePatternExtractor, IsotopePattern, XicBoxGenerator>
+ *         MyFeatureFinder;
+ * \endcode
+ *
+ * @tparam CentroiderType The centroider (e.g. \c Centroider<...>).
+ * @tparam XicExtractorType The streaming XIC extractor (e.g.
+ *         \c StreamingXicExtractor<...>).
+ * @tparam IsotopePatternExtractorType The isotope pattern extractor (e.g.
+ *         \c IsotopePatternExtractor<...>).
+ * @tparam IsotopePatternType The isotope pattern type handed to the callback.
+ * @tparam XicBoxGenerator The XIC box generator (e.g. \c XicBoxGenerator);
+ *         it must provide \c getMaxRtTolerance().
+ * @tparam SpectrumType The input scan type; it must provide \c begin(),
+ *         \c end(), \c getRetentionTime() and \c getScanNumber().
+ */
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType = Spectrum>
+class FeatureFinder
+{
+public:
+    typedef typename XicExtractorType::CentroidType CentroidType;
+    typedef typename XicExtractorType::ResultType XicType;
+    typedef typename XicExtractorType::BoxGeneratorType CentroidBoxGenerator;
+    typedef typename XicExtractorType::ThresholdType SplitThresholdType;
+    typedef typename IsotopePatternExtractorType::ThresholdType
+            CorrelationThresholdType;
+    typedef std::function<void(IsotopePatternType&&)> Callback;
+
+    /** The execution mode.
+     */
+    enum Mode
+    {
+        SEQUENTIAL = 0, PIPELINED
+    };
+
+    /** Constructor.
+     * @param[in] centroider The centroider.
+     * @param[in] centroidBoxGenerator The box generator for the XIC
+     *            extraction.
+     * @param[in] minXicCardinality The minimum number of centroids per XIC.
+     * @param[in] xicSplitThreshold The threshold passed to the XIC splitter.
+     * @param[in] xicBoxGenerators The box generators for the isotope pattern
+     *            extraction.
+     * @param[in] correlationThreshold The minimum correlation of XICs in an
+     *            isotope pattern.
+     * @param[in] minIsotopePatternCardinality The minimum number of XICs per
+     *            isotope pattern.
+     * @param[in] callback Called once for every isotope pattern. In
+     *            \c PIPELINED mode, it is called on the isotope pattern
+     *            stage thread.
+     * @param[in] mode The execution mode.
+     * @param[in] queueCapacity The capacity of the queues between the
+     *            stages, in scans.
+     * @throw mstk::PreconditionViolation if \c xicBoxGenerators is empty or
+     *        \c queueCapacity is zero.
+     */
+    FeatureFinder(const CentroiderType& centroider,
+        const CentroidBoxGenerator& centroidBoxGenerator,
+        const UnsignedInt minXicCardinality,
+        const SplitThresholdType xicSplitThreshold,
+        const std::vector<XicBoxGenerator>& xicBoxGenerators,
+        const CorrelationThresholdType correlationThreshold,
+        const UnsignedInt minIsotopePatternCardinality,
+        const Callback& callback, const Mode mode = PIPELINED,
+        const Size queueCapacity = 64);
+
+    /** Destructor. Stops all stages; does not flush.
+     */
+    ~FeatureFinder();
+
+    /** Add a scan. Scans must be added in ascending retention time order.
+     * In \c PIPELINED mode, the call returns as soon as the scan is queued;
+     * it blocks while the queue is full.
+     * @param[in] spectrum The scan.
+     * @throw Rethrows exceptions raised by any of the stages.
+     */
+    void addScan(const SpectrumType& spectrum);
+
+    /** Add a scan, see \c addScan(const SpectrumType&).
+     */
+    void addScan(SpectrumType&& spectrum);
+
+    /** Finish the run: process all queued scans, close all open XICs and
+     * emit the remaining isotope patterns. The pipeline can be reused for
+     * another run afterwards.
+     * @throw Rethrows exceptions raised by any of the stages.
+     */
+    void flush();
+
+    /** @return The execution mode.
+     */
+    Mode getMode() const;
+
+private:
+    FeatureFinder(const FeatureFinder&);
+    FeatureFinder& operator=(const FeatureFinder&);
+
+    /** The centroids of a single scan.
+     */
+    struct CentroidBatch
+    {
+        std::vector<CentroidType> centroids;
+        double retentionTime;
+    };
+
+    /** The XICs emitted while processing a scan, together with a lower
+     * bound for the retention times of all XICs emitted later.
+     */
+    struct XicBatch
+    {
+        std::vector<XicType> xics;
+        double minRetentionTime;
+    };
+
+    void start();
+    void stop();
+    void fail();
+    void runCentroider();
+    void runXicExtractor();
+    void runIsotopePatternExtractor();
+    void centroid(const SpectrumType& spectrum, CentroidBatch& batch);
+    void extractXics(CentroidBatch& batch, XicBatch& xics);
+    void finishXics(XicBatch& xics);
+    void extractIsotopePatterns(XicBatch& xics);
+    void release(const bool all);
+
+    CentroiderType centroider_;
+    XicExtractorType xicExtractor_;
+    IsotopePatternExtractorType isotopePatternExtractor_;
+    std::vector<XicBoxGenerator> xicBoxGenerators_;
+    CorrelationThresholdType correlationThreshold_;
+    UnsignedInt minIsotopePatternCardinality_;
+    Callback callback_;
+    Mode mode_;
+    Size queueCapacity_;
+    double maxRtTolerance_;
+
+    // XIC extraction stage
+    std::vector<XicType>* xicSink_;
+
+    // isotope pattern stage
+    std::vector<XicType> pending_;
+    Size lastPending_;
+    double minRetentionTime_;
+
+    // pipeline
+    bool running_;
+    std::unique_ptr<BoundedQueue<SpectrumType> > scans_;
+    std::unique_ptr<BoundedQueue<CentroidBatch> > centroids_;
+    std::unique_ptr<BoundedQueue<XicBatch> > xics_;
+    std::vector<std::thread> threads_;
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+} // namespace fe
+
+} // namespace mstk
+
+//
+// template implementation
+//
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Instrumentation.hpp>
+#include <MSTK/common/Log.hpp>
+
+#include <fbi/fbi.h>
+#include <fbi/connectedcomponents.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace mstk {
+
+namespace fe {
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+FeatureFinder<CentroiderType, XicExtractorType, IsotopePatternExtractorType,
+        IsotopePatternType, XicBoxGenerator, SpectrumType>::FeatureFinder(
+    const CentroiderType& centroider,
+    const CentroidBoxGenerator& centroidBoxGenerator,
+    const UnsignedInt minXicCardinality,
+    const SplitThresholdType xicSplitThreshold,
+    const std::vector<XicBoxGenerator>& xicBoxGenerators,
+    const CorrelationThresholdType correlationThreshold,
+    const UnsignedInt minIsotopePatternCardinality, const Callback& callback,
+    const Mode mode, const Size queueCapacity) :
+    centroider_(centroider),
+            xicExtractor_(centroidBoxGenerator, minXicCardinality,
+                xicSplitThreshold, [this](XicType&& xic) {
+                    xicSink_->push_back(std::move(xic));
+                }), xicBoxGenerators_(xicBoxGenerators),
+            correlationThreshold_(correlationThreshold),
+            minIsotopePatternCardinality_(minIsotopePatternCardinality),
+            callback_(callback), mode_(mode), queueCapacity_(queueCapacity),
+            maxRtTolerance_(0.0), xicSink_(0), lastPending_(0),
+            minRetentionTime_(-std::numeric_limits<double>::infinity()),
+            running_(false)
+{
+    mstk_precondition(!xicBoxGenerators_.empty(),
+        "FeatureFinder: require at least one XIC box generator.");
+    mstk_precondition(queueCapacity_ > 0,
+        "FeatureFinder: the queue capacity must be positive.");
+    for (typename std::vector<XicBoxGenerator>::const_iterator i =
+            xicBoxGenerators_.begin(); i != xicBoxGenerators_.end(); ++i) {
+        maxRtTolerance_ = std::max(maxRtTolerance_, i->getMaxRtTolerance());
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+FeatureFinder<CentroiderType, XicExtractorType, IsotopePatternExtractorType,
+        IsotopePatternType, XicBoxGenerator, SpectrumType>::~FeatureFinder()
+{
+    if (running_) {
+        fail();
+        try {
+            stop();
+        } catch (...) {
+            // errors are only reported through addScan() and flush()
+        }
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::addScan(const SpectrumType& spectrum)
+{
+    if (mode_ == SEQUENTIAL) {
+        CentroidBatch centroids;
+        centroid(spectrum, centroids);
+        XicBatch xics;
+        extractXics(centroids, xics);
+        extractIsotopePatterns(xics);
+        return;
+    }
+    addScan(SpectrumType(spectrum));
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::addScan(SpectrumType&& spectrum)
+{
+    if (mode_ == SEQUENTIAL) {
+        addScan(static_cast<const SpectrumType&> (spectrum));
+        return;
+    }
+    if (!running_) {
+        start();
+    }
+    if (!scans_->push(std::move(spectrum))) {
+        // a stage failed and cancelled the pipeline
+        stop();
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::flush()
+{
+    if (mode_ == SEQUENTIAL) {
+        XicBatch xics;
+        finishXics(xics);
+        extractIsotopePatterns(xics);
+        return;
+    }
+    if (running_) {
+        scans_->close();
+        stop();
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+typename FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::Mode FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::getMode() const
+{
+    return mode_;
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::start()
+{
+    error_ = std::exception_ptr();
+    scans_.reset(new BoundedQueue<SpectrumType> (queueCapacity_));
+    centroids_.reset(new BoundedQueue<CentroidBatch> (queueCapacity_));
+    xics_.reset(new BoundedQueue<XicBatch> (queueCapacity_));
+    running_ = true;
+    threads_.push_back(std::thread(&FeatureFinder::runCentroider, this));
+    threads_.push_back(std::thread(&FeatureFinder::runXicExtractor, this));
+    threads_.push_back(
+        std::thread(&FeatureFinder::runIsotopePatternExtractor, this));
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::stop()
+{
+    for (std::vector<std::thread>::iterator i = threads_.begin(); i
+            != threads_.end(); ++i) {
+        i->join();
+    }
+    threads_.clear();
+    running_ = false;
+    if (error_) {
+        // the stages were interrupted; start the next run from scratch
+        XicBatch discarded;
+        xicSink_ = &discarded.xics;
+        xicExtractor_.flush();
+        xicSink_ = 0;
+        pending_.clear();
+        lastPending_ = 0;
+        minRetentionTime_ = -std::numeric_limits<double>::infinity();
+        std::exception_ptr e = error_;
+        error_ = std::exception_ptr();
+        std::rethrow_exception(e);
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::fail()
+{
+    {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        if (!error_) {
+            error_ = std::current_exception();
+        }
+    }
+    scans_->cancel();
+    centroids_->cancel();
+    xics_->cancel();
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::runCentroider()
+{
+    try {
+        SpectrumType spectrum;
+        while (scans_->pop(spectrum)) {
+            CentroidBatch batch;
+            centroid(spectrum, batch);
+            if (!centroids_->push(std::move(batch))) {
+                return;
+            }
+        }
+        centroids_->close();
+    } catch (...) {
+        fail();
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::runXicExtractor()
+{
+    try {
+        CentroidBatch batch;
+        while (centroids_->pop(batch)) {
+            XicBatch xics;
+            extractXics(batch, xics);
+            if (!xics_->push(std::move(xics))) {
+                return;
+            }
+        }
+        // if the pipeline was cancelled, the push fails
+        XicBatch xics;
+        finishXics(xics);
+        if (xics_->push(std::move(xics))) {
+            xics_->close();
+        }
+    } catch (...) {
+        fail();
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::runIsotopePatternExtractor()
+{
+    try {
+        XicBatch xics;
+        while (xics_->pop(xics)) {
+            extractIsotopePatterns(xics);
+        }
+    } catch (...) {
+        fail();
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::centroid(const SpectrumType& spectrum,
+    CentroidBatch& batch)
+{
+    MSTK_INSTRUMENT_TIMER("fe.FeatureFinder.centroid");
+    batch.centroids.clear();
+    batch.retentionTime = spectrum.getRetentionTime();
+    centroider_(spectrum.begin(), spectrum.end(), spectrum.getRetentionTime(),
+        spectrum.getScanNumber(), std::back_inserter(batch.centroids));
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::extractXics(CentroidBatch& batch, XicBatch& xics)
+{
+    MSTK_INSTRUMENT_TIMER("fe.FeatureFinder.extractXics");
+    xicSink_ = &xics.xics;
+    xicExtractor_.addScan(batch.centroids.begin(), batch.centroids.end());
+    xicSink_ = 0;
+    // future XICs consist of centroids of the open XICs or of later scans
+    xics.minRetentionTime = std::min(
+        xicExtractor_.getMinimumOpenRetentionTime(), batch.retentionTime);
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::finishXics(XicBatch& xics)
+{
+    xicSink_ = &xics.xics;
+    xicExtractor_.flush();
+    xicSink_ = 0;
+    xics.minRetentionTime = std::numeric_limits<double>::infinity();
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::extractIsotopePatterns(XicBatch& xics)
+{
+    pending_.insert(pending_.end(), std::make_move_iterator(xics.xics.begin()),
+        std::make_move_iterator(xics.xics.end()));
+    xics.xics.clear();
+    minRetentionTime_ = xics.minRetentionTime;
+    if (minRetentionTime_ == std::numeric_limits<double>::infinity()) {
+        // end of run
+        release(true);
+        minRetentionTime_ = -std::numeric_limits<double>::infinity();
+        return;
+    }
+    // Look for releasable XICs once the number of pending XICs has doubled
+    // since the last attempt; this keeps the cost of the repeated box
+    // intersections linear in the number of XICs.
+    if (pending_.size() >= 2 * lastPending_ + 64) {
+        release(false);
+    }
+}
+
+template<class CentroiderType, class XicExtractorType,
+        class IsotopePatternExtractorType, class IsotopePatternType,
+        class XicBoxGenerator, class SpectrumType>
+void FeatureFinder<CentroiderType, XicExtractorType,
+        IsotopePatternExtractorType, IsotopePatternType, XicBoxGenerator,
+        SpectrumType>::release(const bool all)
+{
+    MSTK_INSTRUMENT_TIMER("fe.FeatureFinder.release");
+    std::vector<XicType> ready;
+    if (all) {
+        ready.swap(pending_);
+    } else {
+        // An XIC is settled if its retention time boxes end before the
+        // boxes of any future XIC can begin.
+        const double limit = minRetentionTime_ - maxRtTolerance_;
+        const Size n = pending_.size();
+        std::vector<char> settled(n, 0);
+        bool anySettled = false;
+        for (Size i = 0; i < n; ++i) {
+            double hi = -std::numeric_limits<double>::infinity();
+            for (typename std::vector<XicBoxGenerator>::const_iterator g =
+                    xicBoxGenerators_.begin(); g != xicBoxGenerators_.end(); ++g) {
+                hi = std::max(hi, g->template get<0> (pending_[i]).second);
+            }
+            settled[i] = hi < limit;
+            anySettled = anySettled || settled[i];
+        }
+        if (!anySettled) {
+            lastPending_ = n;
+            return;
+        }
+        // release complete connected components of settled XICs only
+        typedef fbi::SetA<XicType, 0, 1> SetA;
+        typename SetA::ResultType adjList = SetA::intersect(pending_,
+            xicBoxGenerators_[0], xicBoxGenerators_);
+        std::vector<typename SetA::IntType> labels;
+        const Size nComponents = findConnectedComponents(adjList, labels);
+        std::vector<char> releasable(nComponents + 1, 1); // labels start at 1
+        for (Size i = 0; i < n; ++i) {
+            if (!settled[i]) {
+                releasable[labels[i]] = 0;
+            }
+        }
+        std::vector<XicType> keep;
+        for (Size i = 0; i < n; ++i) {
+            if (releasable[labels[i]]) {
+                ready.push_back(std::move(pending_[i]));
+            } else {
+                keep.push_back(std::move(pending_[i]));
+            }
+        }
+        pending_.swap(keep);
+    }
+    lastPending_ = pending_.size();
+    MSTK_LOG(logDEBUG) << "FeatureFinder: releasing " << ready.size()
+            << " XICs, " << pending_.size() << " pending.";
+    if (ready.empty()) {
+        return;
+    }
+    std::vector<IsotopePatternType> isotopePatterns;
+    isotopePatternExtractor_(ready, xicBoxGenerators_, correlationThreshold_,
+        minIsotopePatternCardinality_, isotopePatterns);
+    for (typename std::vector<IsotopePatternType>::iterator i =
+            isotopePatterns.begin(); i != isotopePatterns.end(); ++i) {
+        callback_(std::move(*i));
+    }
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_FEATUREFINDER_HPP__ */
@@ -26,6 +26,9 @@
 #ifndef __MSTK_INCLUDE_MSTK_FE_ISOTOPEPATTERNCREATOR_HPP__
 #define __MSTK_INCLUDE_MSTK_FE_ISOTOPEPATTERNCREATOR_HPP__
 
+#include <type_traits>
+#include <utility>
+
 namespace mstk {
 
 namespace fe {
@@ -36,6 +39,20 @@ class IsotopePatternCreator
 public:
     template <typename XicContainer>
     X operator()(XicContainer& xics);
+
+    /** Creates an object from a temporary container. If \c X can be
+     * constructed from the container directly, its elements are moved;
+     * otherwise this falls back to the range construction.
+     */
+    template <typename XicContainer>
+    X operator()(XicContainer&& xics);
+
+private:
+    template <typename XicContainer>
+    X create(XicContainer&& xics, std::true_type);
+
+    template <typename XicContainer>
+    X create(XicContainer&& xics, std::false_type);
 };
 
 } // namespace fe
@@ -59,6 +76,28 @@ X IsotopePatternCreator<X>::operator()(XicContainer& xics)
     return X(xics.begin(), xics.end());
 }
 
+template <typename X>
+template <typename XicContainer>
+X IsotopePatternCreator<X>::operator()(XicContainer&& xics)
+{
+    return create(std::move(xics),
+        typename std::is_constructible<X, XicContainer&&>::type());
+}
+
+template <typename X>
+template <typename XicContainer>
+X IsotopePatternCreator<X>::create(XicContainer&& xics, std::true_type)
+{
+    return X(std::move(xics));
+}
+
+template <typename X>
+template <typename XicContainer>
+X IsotopePatternCreator<X>::create(XicContainer&& xics, std::false_type)
+{
+    return X(xics.begin(), xics.end());
+}
+
 }
 
 }
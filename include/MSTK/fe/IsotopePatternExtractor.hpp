@@ -33,14 +33,51 @@
 #include <fbi/fbi.h>
 #include <fbi/connectedcomponents.h>
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 namespace mstk {
 
 namespace fe {
 
+/** Groups XICs into isotope patterns.
+ *
+ * Candidate pairs of XICs are found by box intersection and kept if the
+ * correlation of their elution profiles reaches a threshold. The
+ * \c Correlator policy defines a \c ThresholdType, a \c ProfileArena that
+ * holds the elution profiles of all XICs (built once per call through
+ * <tt>ProfileArena::assign(xics)</tt>) and
+ * <tt>correlate(const ProfileArena&, Size i, Size j)</tt>; see
+ * \c UncenteredCorrelation and \c DenseUncenteredCorrelation. The
+ * \c Splitter policy receives the container of isotope patterns through
+ * <tt>split(isotopePatterns)</tt> and may replace them, e.g. to unmix
+ * charge states (see \c NopSplitter and \c AveragineSplitter).
+ */
 template<class Correlator, class Splitter>
 class IsotopePatternExtractor : public Correlator, public Splitter
 {
 public:
+    /** Constructor.
+     * @param[in] nThreads The number of threads. 1 (the default) selects the
+     *                     serial path, 0 the number of hardware threads.
+     */
+    explicit IsotopePatternExtractor(const UnsignedInt nThreads = 1);
+
+    /** Set the number of threads used by the correlation filter. With more
+     * than one thread, the candidate edges of the XIC graph are correlated
+     * concurrently; the results, including the order of the isotope
+     * patterns, are identical to the serial path. Hence, the \c Correlator
+     * policy must be safe to call concurrently.
+     * @param[in] nThreads The number of threads; 0 selects the number of
+     *                     hardware threads.
+     */
+    void setNumberOfThreads(const UnsignedInt nThreads);
+
+    /** @return The number of threads, as set by the user.
+     */
+    UnsignedInt getNumberOfThreads() const;
+
     template<class XicContainer, class IsotopePatternContainer,
             class XicBoxGenerators>
     Size operator()(const XicContainer& xics,
@@ -48,6 +85,28 @@ public:
         const typename Correlator::ThresholdType& correlationThreshold,
         const UnsignedInt minCardinality,
         IsotopePatternContainer& isotopePatterns);
+
+private:
+    /** Per-thread state of the correlation filter: the accepted edges of
+     * all adjacency rows processed by the thread. The trailing padding keeps
+     * the state of different threads on different cache lines.
+     */
+    struct CorrelationWorker
+    {
+        std::vector<Size> edges;
+        char padding[64];
+    };
+
+    /** The location of the accepted edges of one adjacency row.
+     */
+    struct EdgeSegment
+    {
+        UnsignedInt worker;
+        Size first;
+        Size last;
+    };
+
+    UnsignedInt nThreads_;
 };
 
 } // namespace fe
@@ -59,15 +118,37 @@ public:
 //
 #include <MSTK/common/CardinalityLessThan.hpp>
 #include <MSTK/common/Error.hpp>
+#include <MSTK/common/Instrumentation.hpp>
 #include <MSTK/common/Log.hpp>
 #include <MSTK/fe/QuickCharge.hpp>
 #include <MSTK/fe/XicTraits.hpp>
 #include <MSTK/fe/IsotopePatternTraits.hpp>
+#include <MSTK/common/parallelFor.hpp>
 
 namespace mstk {
 
 namespace fe {
 
+template<class Correlator, class Splitter>
+IsotopePatternExtractor<Correlator, Splitter>::IsotopePatternExtractor(
+    const UnsignedInt nThreads) :
+        nThreads_(nThreads)
+{
+}
+
+template<class Correlator, class Splitter>
+void IsotopePatternExtractor<Correlator, Splitter>::setNumberOfThreads(
+    const UnsignedInt nThreads)
+{
+    nThreads_ = nThreads;
+}
+
+template<class Correlator, class Splitter>
+UnsignedInt IsotopePatternExtractor<Correlator, Splitter>::getNumberOfThreads() const
+{
+    return nThreads_;
+}
+
 template<class Correlator, class Splitter>
 template<class XicContainer, class IsotopePatternContainer,
         class XicBoxGenerators>
@@ -80,46 +161,86 @@ Size IsotopePatternExtractor<Correlator, Splitter>::operator()(
     mstk_precondition(!boxGenerators.empty(),
         "Require at least one search box generator.");
     MSTK_LOG(logDEBUG) << "Extracting isotope patterns from " << xics.size() << "XICs.";
+    MSTK_INSTRUMENT_TIMER("fe.IsotopePatternExtractor");
+    MSTK_INSTRUMENT_COUNT("fe.IsotopePatternExtractor.xics", xics.size());
     typedef typename XicContainer::value_type XicType;
     typedef typename fbi::SetA<XicType, 0, 1> SetA;
     // carry out the box intersection
     typedef typename SetA::ResultType AdjList;
-    AdjList adjList = SetA::intersect(xics,
-        boxGenerators[0], boxGenerators);
+    AdjList adjList;
+    {
+        MSTK_INSTRUMENT_TIMER("fe.IsotopePatternExtractor.intersect");
+        adjList = SetA::intersect(xics, boxGenerators[0], boxGenerators);
+    }
 
     // Correlation filter. Keep adjacency list entries only if
     // the correlation between XICs along rt is above a user-defined
     // threshold.
     size_t nXics = xics.size();
     AdjList filteredAdjList(nXics);
-    for (size_t i = 0; i < nXics; ++i) {
-        typedef typename AdjList::value_type::const_iterator SCI;
-        for (SCI j = adjList[i].begin(); j != adjList[i].end(); ++j) {
-            // The adjacency list models an undirected graph and the
-            // pearson correlation is a symmetric measure; hence, avoid
-            // a double calculation, only run the test for one of (i, *j)
-            // or (*j, i) and insert the result into both places in the
-            // adjacency list.
-            // Also, make sure that every vertex has an edge to itself.
-            if (*j <= i) {
-                if (i == *j
-                        || this->correlate(xics[i].begin(), xics[i].end(),
-                            xics[*j].begin(), xics[*j].end())
-                                >= correlationThreshold) {
-                    filteredAdjList[i].push_back(*j);
-                    filteredAdjList[*j].push_back(i);
+    {
+        MSTK_INSTRUMENT_TIMER("fe.IsotopePatternExtractor.correlate");
+        // Walking the XICs themselves touches full centroid objects; pack
+        // their elution profiles into the Correlator's arena instead.
+        typename Correlator::ProfileArena profiles;
+        profiles.assign(xics);
+        // Each thread correlates whole adjacency rows and keeps the accepted
+        // edges in its own buffer; a segment records where the edges of a
+        // row went. The edges are merged in row order, which yields the
+        // same adjacency list as a serial pass.
+        const UnsignedInt nThreads = mstk::getNumberOfThreads(nThreads_);
+        const Size chunkSize = std::max(static_cast<Size> (1),
+            nXics / (64 * nThreads));
+        std::vector<CorrelationWorker> workers(nThreads);
+        std::vector<EdgeSegment> segments(nXics);
+        parallelFor(0, nXics, [&](const Size i, const UnsignedInt t) {
+            CorrelationWorker& w = workers[t];
+            EdgeSegment& seg = segments[i];
+            seg.worker = t;
+            seg.first = w.edges.size();
+            typedef typename AdjList::value_type::const_iterator SCI;
+            for (SCI j = adjList[i].begin(); j != adjList[i].end(); ++j) {
+                // The adjacency list models an undirected graph and the
+                // correlation is a symmetric measure; hence, avoid a double
+                // calculation, only run the test for one of (i, *j) or
+                // (*j, i) and insert the result into both places in the
+                // adjacency list.
+                // Also, make sure that every vertex has an edge to itself.
+                if (*j <= i) {
+                    if (i == *j
+                            || this->correlate(profiles, i, *j)
+                                    >= correlationThreshold) {
+                        w.edges.push_back(*j);
+                    }
+                } else {
+                    break;
                 }
-            } else {
-                break;
             }
+            seg.last = w.edges.size();
+        }, nThreads, chunkSize);
+        // symmetric merge
+        Size nCandidates = 0;
+        for (size_t i = 0; i < nXics; ++i) {
+            const std::vector<Size>& edges = workers[segments[i].worker].edges;
+            for (Size k = segments[i].first; k < segments[i].last; ++k) {
+                filteredAdjList[i].push_back(edges[k]);
+                filteredAdjList[edges[k]].push_back(i);
+            }
+            nCandidates += adjList[i].size();
         }
+        MSTK_INSTRUMENT_COUNT("fe.IsotopePatternExtractor.candidates",
+            nCandidates);
     }
     // get rid of old adjacency list
     adjList.clear();
     // find the connected components in the filtered adjancency list
     typedef typename fbi::SetA<XicType, 0, 1>::IntType LabelType;
     std::vector < LabelType > labels;
-    size_t nComponents = findConnectedComponents(filteredAdjList, labels);
+    size_t nComponents;
+    {
+        MSTK_INSTRUMENT_TIMER("fe.IsotopePatternExtractor.components");
+        nComponents = findConnectedComponents(filteredAdjList, labels);
+    }
     MSTK_LOG(logDEBUG) << "Found " << nComponents << " primary isotope patterns.";
 
     // Collect the XICs into pseudo-isotope patterns.
@@ -153,21 +274,27 @@ Size IsotopePatternExtractor<Correlator, Splitter>::operator()(
         //qc(i->begin(), i->end(), std::back_inserter(charges));
         //i->setCharges(std::set<int>(charges.begin(), charges.end()));
     }
-    // split the isotope patterns using the Splitter policy class
-    this->split(ips);
-    //
-    // make sure that the size requirements still hold
-    ips.erase(
-        std::remove_if(ips.begin(), ips.end(), insufficientNumberOfXics),
-        ips.end());
-
-    // convert the results into real XICs
+    // convert the results into real isotope patterns
     MSTK_LOG(logDEBUG) << "Transforming " << ips.size() << " isotope patterns.";
-    typedef typename IsotopePatternTraits<
-            typename IsotopePatternContainer::value_type>::Creator Creator;
+    typedef typename IsotopePatternContainer::value_type IsotopePatternType;
+    typedef typename IsotopePatternTraits<IsotopePatternType>::Creator Creator;
     isotopePatterns.clear();
-    std::transform(ips.begin(), ips.end(), std::back_inserter(isotopePatterns),
-        Creator());
+    std::transform(std::make_move_iterator(ips.begin()),
+        std::make_move_iterator(ips.end()),
+        std::back_inserter(isotopePatterns), Creator());
+    ips.clear();
+    // split the isotope patterns using the Splitter policy class
+    {
+        MSTK_INSTRUMENT_TIMER("fe.IsotopePatternExtractor.split");
+        this->split(isotopePatterns);
+    }
+    // make sure that the size requirements still hold
+    typedef CardinalityLessThan<IsotopePatternType> InsufficientSize;
+    isotopePatterns.erase(std::remove_if(isotopePatterns.begin(),
+        isotopePatterns.end(), InsufficientSize(minCardinality)),
+        isotopePatterns.end());
+    MSTK_INSTRUMENT_COUNT("fe.IsotopePatternExtractor.isotopePatterns",
+        isotopePatterns.size());
     return isotopePatterns.size();
 }
 
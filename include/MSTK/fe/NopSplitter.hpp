@@ -37,8 +37,8 @@ namespace fe {
 class NopSplitter
 {
 public:
-    template <typename XicSets>
-    void split(XicSets& xicsets);
+    template <typename IsotopePatternContainer>
+    void split(IsotopePatternContainer& isotopePatterns);
 };
 
 } // namespace fe
@@ -53,8 +53,8 @@ namespace mstk {
 
 namespace fe {
 
-template<typename XicSets>
-void NopSplitter::split(XicSets& xicSets)
+template<typename IsotopePatternContainer>
+void NopSplitter::split(IsotopePatternContainer& isotopePatterns)
 {
     return;
 }
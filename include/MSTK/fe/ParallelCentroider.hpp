@@ -0,0 +1,196 @@
+/*
+ * ParallelCentroider.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_PARALLELCENTROIDER_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_PARALLELCENTROIDER_HPP__
+
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Log.hpp>
+#include <MSTK/common/parallelFor.hpp>
+#include <MSTK/fe/Centroider.hpp>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** Centroids a sequence of spectra on multiple threads.
+ *
+ * The batch centroider distributes the spectra of a run over a set of worker
+ * threads, each of which runs its own copy of a \c Centroider with the given
+ * policies. Centroids are collected in per-thread buffers and merged in the
+ * order of the input spectra, i.e. the result does not depend on the number
+ * of threads or on the scheduling.
+ *
+ * The spectrum type must provide \c begin(), \c end(),
+ * \c getRetentionTime() and \c getScanNumber() (e.g. \c Spectrum or
+ * \c ColumnarSpectrum). The centroid creator is shared by all threads. Note
+ * that the \c RawDataStore based creator of \c CompactCentroid references
+ * the scan that was added to the store last and hence cannot be used here.
+ */
+template<class CentroidType, class BumpFinder, class MeanAccumulator,
+        class AbundanceAccumulator>
+class ParallelCentroider
+{
+public:
+    typedef Centroider<CentroidType, BumpFinder, MeanAccumulator,
+            AbundanceAccumulator> SerialCentroider;
+    typedef typename SerialCentroider::Creator Creator;
+
+    /** Constructor.
+     * @param[in] nThreads The number of threads; 0 selects the number of
+     *                     hardware threads.
+     * @param[in] creator The creator used to construct the centroids.
+     */
+    explicit ParallelCentroider(const UnsignedInt nThreads = 0,
+        const Creator& creator = Creator());
+
+    /** Set the number of threads.
+     * @param[in] nThreads The number of threads; 0 selects the number of
+     *                     hardware threads.
+     */
+    void setNumberOfThreads(const UnsignedInt nThreads);
+
+    /** @return The number of threads, as set by the user.
+     */
+    UnsignedInt getNumberOfThreads() const;
+
+    /** Centroid a sequence of spectra.
+     * @param[in] first Iterator to the first spectrum.
+     * @param[in] last Iterator past the last spectrum.
+     * @param[out] out Output iterator that receives the centroids of all
+     *                 spectra, in input order.
+     * @return The number of centroids.
+     */
+    template<typename RandomAccessIterator, typename OutputIterator>
+    Size operator()(RandomAccessIterator first, RandomAccessIterator last,
+        OutputIterator out);
+
+private:
+    /** Per-thread state. The trailing padding keeps the state of different
+     * threads on different cache lines.
+     */
+    struct Worker
+    {
+        explicit Worker(const Creator& creator) :
+            centroider(creator), centroids()
+        {
+        }
+
+        SerialCentroider centroider;
+        std::vector<CentroidType> centroids;
+        char padding[64];
+    };
+
+    /** The location of the centroids of one spectrum.
+     */
+    struct Segment
+    {
+        UnsignedInt worker;
+        Size first;
+        Size last;
+    };
+
+    UnsignedInt nThreads_;
+    Creator creator_;
+};
+
+//
+// template implementation
+//
+
+template<class CentroidType, class BumpFinder, class MeanAccumulator,
+        class AbundanceAccumulator>
+ParallelCentroider<CentroidType, BumpFinder, MeanAccumulator,
+        AbundanceAccumulator>::ParallelCentroider(const UnsignedInt nThreads,
+    const Creator& creator) :
+        nThreads_(nThreads), creator_(creator)
+{
+}
+
+template<class CentroidType, class BumpFinder, class MeanAccumulator,
+        class AbundanceAccumulator>
+void ParallelCentroider<CentroidType, BumpFinder, MeanAccumulator,
+        AbundanceAccumulator>::setNumberOfThreads(const UnsignedInt nThreads)
+{
+    nThreads_ = nThreads;
+}
+
+template<class CentroidType, class BumpFinder, class MeanAccumulator,
+        class AbundanceAccumulator>
+UnsignedInt ParallelCentroider<CentroidType, BumpFinder, MeanAccumulator,
+        AbundanceAccumulator>::getNumberOfThreads() const
+{
+    return nThreads_;
+}
+
+template<class CentroidType, class BumpFinder, class MeanAccumulator,
+        class AbundanceAccumulator>
+template<typename RandomAccessIterator, typename OutputIterator>
+Size ParallelCentroider<CentroidType, BumpFinder, MeanAccumulator,
+        AbundanceAccumulator>::operator()(RandomAccessIterator first,
+    RandomAccessIterator last, OutputIterator out)
+{
+    const Size nSpectra = std::distance(first, last);
+    const UnsignedInt nThreads = mstk::getNumberOfThreads(nThreads_);
+    MSTK_LOG(logDEBUG) << "ParallelCentroider: centroiding " << nSpectra
+            << " spectra on " << nThreads << " threads.";
+
+    std::vector<Worker> workers(nThreads, Worker(creator_));
+    std::vector<Segment> segments(nSpectra);
+    // each spectrum is centroided into the buffer of the thread that picks
+    // it up; the segment records where its centroids ended up
+    parallelFor(0, nSpectra, [&](const Size i, const UnsignedInt t) {
+        Worker& w = workers[t];
+        Segment& s = segments[i];
+        s.worker = t;
+        s.first = w.centroids.size();
+        w.centroider(first[i].begin(), first[i].end(),
+            first[i].getRetentionTime(), first[i].getScanNumber(),
+            std::back_inserter(w.centroids));
+        s.last = w.centroids.size();
+    }, nThreads);
+
+    // merge in input order
+    Size n = 0;
+    typedef typename std::vector<Segment>::const_iterator SI;
+    for (SI s = segments.begin(); s != segments.end(); ++s) {
+        std::vector<CentroidType>& cs = workers[s->worker].centroids;
+        for (Size i = s->first; i < s->last; ++i) {
+            *out = std::move(cs[i]);
+            ++out;
+        }
+        n += s->last - s->first;
+    }
+    return n;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_PARALLELCENTROIDER_HPP__ */
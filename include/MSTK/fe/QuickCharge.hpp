@@ -27,95 +27,329 @@
 #define __MSTK_INCLUDE_MSTK_COMMON_QUICKCHARGE_HPP__
 #include <MSTK/config.hpp>
 
+#include <MSTK/common/Types.hpp>
+#include <stdint.h>
+#include <vector>
+
 namespace mstk {
 
 namespace fe {
 
+/** A set of charges in [1, \c MAX_CHARGE], stored as a bitset.
+ */
+class ChargeSet
+{
+public:
+    /** The largest charge that can be stored.
+     */
+    static const Int MAX_CHARGE = 64;
+
+    /** Constructor. Constructs an empty set.
+     */
+    ChargeSet() :
+        bits_(0)
+    {
+    }
+
+    /** Insert a charge.
+     * @param[in] charge The charge; charges outside [1, \c MAX_CHARGE] are
+     *                   ignored.
+     * @return True if the charge was not in the set before.
+     */
+    bool insert(const Int charge);
+
+    /** @return True if \c charge is in the set.
+     */
+    bool contains(const Int charge) const;
+
+    /** @return The number of charges in the set.
+     */
+    Size size() const;
+
+    bool empty() const;
+
+    void clear();
+
+    /** @return The bitset; bit \c z-1 is set for every charge \c z.
+     */
+    uint64_t getBits() const;
+
+    /** Write the charges in ascending order.
+     * @param[in] out Output iterator for the charges.
+     * @return The output iterator past the last charge.
+     */
+    template<typename OutputIterator>
+    OutputIterator copy(OutputIterator out) const;
+
+private:
+    uint64_t bits_;
+};
+
 /**
  * Implementation of the QuickCharge algorithm, as proposed by Michael Hoopman,
  * MacCoss lab, Seattle.
+ *
+ * For every peak, QuickCharge looks at all following peaks in a 1.1 Th
+ * window and reports the inverse of their m/z distances, rounded to the
+ * nearest integer, as candidate charges. The peaks must be sorted by m/z.
+ * Two optional filters reduce spurious charges:
+ * - a tolerance window: a distance only supports charge \c z if it lies
+ *   within the tolerance of the isotope distance <tt>1.00286864 / z</tt>;
+ * - a minimum support: a charge is only reported if at least that many
+ *   peaks support it (every peak supports a charge at most once).
+ *
+ * No memory is allocated: the distances are calculated on the fly and the
+ * charges are tracked in a \c ChargeSet. Hence, charges above
+ * \c ChargeSet::MAX_CHARGE are not reported.
  */
 class QuickCharge
 {
 public:
+    /** Constructor.
+     * @param[in] tolerance The tolerance window, in Th; 0 disables the
+     *                      window.
+     * @param[in] minSupport The minimum number of supporting peaks.
+     */
+    explicit QuickCharge(const Double tolerance = 0.0,
+        const Size minSupport = 1);
+
+    void setTolerance(const Double tolerance);
+
+    Double getTolerance() const;
+
+    /** Set the minimum number of supporting peaks.
+     * @throw mstk::PreconditionViolation if \c minSupport is 0.
+     */
+    void setMinSupport(const Size minSupport);
+
+    Size getMinSupport() const;
+
     /**
      * operator()
      * @param first Iterator pointing at the starting element of a sequence.
      * @param last Iterator pointing at the last element of a sequence.
-     * @param out Output iterator for the detected charges.
+     * @param out Output iterator for the detected charges, in the order of
+     *            detection.
      */
     template<typename InputIterator, typename OutputIterator>
     void operator()(InputIterator first, InputIterator last,
-        OutputIterator out);
+        OutputIterator out) const;
+
+    /** Get the charges of a sequence of peaks.
+     * @param first Iterator pointing at the starting element of a sequence.
+     * @param last Iterator pointing at the last element of a sequence.
+     * @return The detected charges.
+     */
+    template<typename ForwardIterator>
+    ChargeSet getCharges(ForwardIterator first, ForwardIterator last) const;
+
+    /** Get the charges of all isotope patterns, e.g. the result of
+     * \c mstk::fe::IsotopePatternExtractor, on multiple threads.
+     * @param[in] isotopePatterns The isotope patterns; their XICs must be
+     *                            sorted by m/z.
+     * @param[out] charges The charges of the i-th pattern go into
+     *                     \c charges[i].
+     * @param[in] nThreads The number of threads; 0 selects the number of
+     *                     hardware threads.
+     */
+    template<typename IsotopePatternContainer>
+    void getCharges(const IsotopePatternContainer& isotopePatterns,
+        std::vector<ChargeSet>& charges, const UnsignedInt nThreads = 0) const;
+
+private:
+    /** Calls \c f(charge) for every charge, once it is detected.
+     */
+    template<typename ForwardIterator, typename Function>
+    void detect(ForwardIterator first, ForwardIterator last, Function f) const;
+
+    Double tolerance_;
+    Size minSupport_;
 };
 
 } // namespace fe
 
 } // namespace mstk
 
-#include <vector>
-#include <set>
-#include <MSTK/common/Types.hpp>
+//
+// template implementation
+//
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/parallelFor.hpp>
+#include <MSTK/fe/XicTraits.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iterator>
-#include <MSTK/common/Log.hpp>
-#include <MSTK/fe/XicTraits.hpp>
 
 namespace mstk {
 
 namespace fe {
 
-template<typename InputIterator, typename OutputIterator>
-void QuickCharge::operator()(InputIterator first, InputIterator last,
-    OutputIterator out)
+inline bool ChargeSet::insert(const Int charge)
+{
+    if (charge < 1 || charge > MAX_CHARGE) {
+        return false;
+    }
+    const uint64_t bit = static_cast<uint64_t> (1) << (charge - 1);
+    const bool inserted = (bits_ & bit) == 0;
+    bits_ |= bit;
+    return inserted;
+}
+
+inline bool ChargeSet::contains(const Int charge) const
 {
-    // calculate vector of mass distances
-    Size n = std::distance(first, last);
-    if (n < 1) {
-        return;
+    return charge >= 1 && charge <= MAX_CHARGE && (bits_
+            & (static_cast<uint64_t> (1) << (charge - 1))) != 0;
+}
+
+inline Size ChargeSet::size() const
+{
+    Size n = 0;
+    for (uint64_t b = bits_; b != 0; b &= b - 1) {
+        ++n;
     }
-    std::vector<Double> diff(n - 1);
-    InputIterator l = first;
-    InputIterator r = l; std::advance(r, 1);
-    Size i = 0;
-    typedef typename std::iterator_traits<InputIterator>::value_type ValueType;
-    typedef typename XicTraits<ValueType>::MzAccessor MzAccessor;
-    MzAccessor accMz;
-    while (r != last) {
-        diff[i] = accMz(*r) - accMz(*l);
-        ++i;
-        ++r;
-        ++l;
+    return n;
+}
+
+inline bool ChargeSet::empty() const
+{
+    return bits_ == 0;
+}
+
+inline void ChargeSet::clear()
+{
+    bits_ = 0;
+}
+
+inline uint64_t ChargeSet::getBits() const
+{
+    return bits_;
+}
+
+template<typename OutputIterator>
+OutputIterator ChargeSet::copy(OutputIterator out) const
+{
+    for (Int z = 1; z <= MAX_CHARGE; ++z) {
+        if (contains(z)) {
+            *out = z;
+            ++out;
+        }
+    }
+    return out;
+}
+
+inline QuickCharge::QuickCharge(const Double tolerance, const Size minSupport) :
+    tolerance_(tolerance), minSupport_(1)
+{
+    setMinSupport(minSupport);
+}
+
+inline void QuickCharge::setTolerance(const Double tolerance)
+{
+    tolerance_ = tolerance;
+}
+
+inline Double QuickCharge::getTolerance() const
+{
+    return tolerance_;
+}
+
+inline void QuickCharge::setMinSupport(const Size minSupport)
+{
+    mstk_precondition(minSupport > 0,
+        "QuickCharge: the minimum support must be positive.");
+    minSupport_ = minSupport;
+}
+
+inline Size QuickCharge::getMinSupport() const
+{
+    return minSupport_;
+}
+
+template<typename ForwardIterator, typename Function>
+void QuickCharge::detect(ForwardIterator first, ForwardIterator last,
+    Function f) const
+{
+    // MaxQuant's average isotope distance, in Da
+    static const Double isotopeSpacing = 1.00286864;
+    // distances below this correspond to charges beyond MAX_CHARGE
+    static const Double minDelta = 1.0 / (ChargeSet::MAX_CHARGE + 0.5);
+    typedef typename std::iterator_traits<ForwardIterator>::value_type
+            ValueType;
+    typename XicTraits<ValueType>::MzAccessor accMz;
+    ChargeSet charges;
+    UnsignedInt support[ChargeSet::MAX_CHARGE];
+    if (minSupport_ > 1) {
+        std::fill(support, support + ChargeSet::MAX_CHARGE, 0);
     }
     // walk through all observed masses and calculate
     // potential charges. The rationale is to look at
     // all following peaks in a 1.1 Da window and to determine
     // the inverse distances
-    std::set<Int> charges;
-    charges.clear();
-    for (Size i = 0; i < (n - 1); ++i) {
-        Size j = i;
-        Double delta(0.0);
+    for (ForwardIterator l = first; l != last; ++l) {
+        const Double mz = accMz(*l);
         Int oldCharge(0);
-        while (j < (n - 1)) {
-            delta = delta + diff[j];
+        ForwardIterator r = l;
+        for (++r; r != last; ++r) {
+            const Double delta = accMz(*r) - mz;
             if (delta > 1.1) {
                 break;
             }
-            Int charge = static_cast<Int>(std::floor(1.0 / delta + 0.5));
-            if (charge != oldCharge) {
-                oldCharge = charge;
-                if (!charges.count(charge)) {
-                    *out = charge;
-                    ++out;
-                    charges.insert(charge);
-                }
+            if (delta < minDelta) {
+                continue;
+            }
+            Int charge = static_cast<Int> (std::floor(1.0 / delta + 0.5));
+            if (charge == oldCharge || (tolerance_ > 0.0 && std::abs(delta
+                    - isotopeSpacing / charge) > tolerance_)) {
+                continue;
+            }
+            oldCharge = charge;
+            if (charges.contains(charge)) {
+                continue;
             }
-            ++j;
+            if (minSupport_ > 1 && ++support[charge - 1] < minSupport_) {
+                continue;
+            }
+            charges.insert(charge);
+            f(charge);
         }
     }
 }
 
+template<typename InputIterator, typename OutputIterator>
+void QuickCharge::operator()(InputIterator first, InputIterator last,
+    OutputIterator out) const
+{
+    detect(first, last, [&out](const Int charge) {
+        *out = charge;
+        ++out;
+    });
+}
+
+template<typename ForwardIterator>
+ChargeSet QuickCharge::getCharges(ForwardIterator first,
+    ForwardIterator last) const
+{
+    ChargeSet charges;
+    detect(first, last, [&charges](const Int charge) {
+        charges.insert(charge);
+    });
+    return charges;
+}
+
+template<typename IsotopePatternContainer>
+void QuickCharge::getCharges(const IsotopePatternContainer& isotopePatterns,
+    std::vector<ChargeSet>& charges, const UnsignedInt nThreads) const
+{
+    charges.assign(isotopePatterns.size(), ChargeSet());
+    const UnsignedInt n = getNumberOfThreads(nThreads);
+    const Size chunkSize = std::max(static_cast<Size> (1),
+        isotopePatterns.size() / (64 * n));
+    parallelFor(0, isotopePatterns.size(), [&](const Size i, const UnsignedInt) {
+        charges[i] = getCharges(isotopePatterns[i].begin(),
+            isotopePatterns[i].end());
+    }, n, chunkSize);
+}
+
 } // namespace fe
 
 } // namespace mstk
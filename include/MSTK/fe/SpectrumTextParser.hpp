@@ -0,0 +1,121 @@
+/*
+ * SpectrumTextParser.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_SPECTRUMTEXTPARSER_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_SPECTRUMTEXTPARSER_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** Bulk parser for text peak lists.
+ *
+ * The parser reads the "mz abundance" format of
+ * \c operator>>(std::istream&, Spectrum&) directly from a memory buffer or
+ * a memory-mapped file. Numbers are parsed without going through the
+ * (locale-aware) stream machinery and without allocating, and every
+ * spectrum is sized before its peaks are read.
+ *
+ * A file may hold several scans. Every scan starts with a header line that
+ * begins with '#' and carries whitespace-separated key=value pairs:
+ *
+ * \code
+ * # scanNumber=12 rt=301.25 msLevel=2 precursorMz=512.27 precursorCharge=2
+ * 401.2345 1203.5
+ * 401.7362 310.0
+ * \endcode
+ *
+ * The keys are \c scanNumber, \c rt, \c msLevel, \c totalIonCurrent,
+ * \c precursorScanNumber, \c precursorMz, \c precursorCharge and
+ * \c precursorAbundance; unknown keys are ignored. Peaks that precede the
+ * first header form a scan without metadata, so plain peak lists parse as a
+ * single spectrum. As with \c operator>>, peaks with an abundance of zero or
+ * less are dropped.
+ */
+class MSTK_EXPORT SpectrumTextParser
+{
+public:
+    typedef std::function<void(Spectrum&&)> Callback;
+
+    /** Parse all scans in [first, last) and hand them to \c callback in
+     * file order.
+     * @return The number of scans.
+     * @throw mstk::RuntimeError if the buffer holds a malformed line.
+     */
+    Size parse(const char* first, const char* last,
+        const Callback& callback) const;
+
+    /** Parse all scans in [first, last) and append them to \c spectra.
+     * @return The number of scans.
+     * @throw mstk::RuntimeError if the buffer holds a malformed line.
+     */
+    Size parse(const char* first, const char* last,
+        std::vector<Spectrum>& spectra) const;
+
+    /** Map \c filename and parse all of its scans.
+     * @return The number of scans.
+     * @throw mstk::RuntimeError if the file cannot be mapped or holds a
+     *        malformed line.
+     */
+    Size parseFile(const String& filename, std::vector<Spectrum>& spectra) const;
+
+    /** Parse a floating point number in the C locale. Accepts an optional
+     * sign, digits with an optional decimal point and an optional exponent.
+     * The result is correctly rounded for up to 15 significant digits and
+     * decimal exponents up to 22 in magnitude, i.e. for all numbers found
+     * in peak lists; longer numbers may be off by one ulp.
+     * @param[in,out] p The position to start at; on success, it is advanced
+     *                  past the number.
+     * @param[in] end The end of the buffer.
+     * @param[out] value The number.
+     * @return False if there is no number at \c p.
+     */
+    static bool parseDouble(const char*& p, const char* end, double& value);
+
+private:
+    void parseHeader(const char* first, const char* last, Spectrum& s,
+        const Size line) const;
+    const char* parseScan(const char* first, const char* last, Spectrum& s,
+        Size& line) const;
+};
+
+/** Write a spectrum in the format read by \c SpectrumTextParser, including
+ * a header line with its metadata. Numbers are written with enough digits
+ * to be read back exactly.
+ */
+MSTK_EXPORT void writeSpectrumText(std::ostream& os, const Spectrum& s);
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_SPECTRUMTEXTPARSER_HPP__ */
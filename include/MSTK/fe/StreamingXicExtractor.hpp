@@ -0,0 +1,468 @@
+/*
+ * StreamingXicExtractor.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_STREAMINGXICEXTRACTOR_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_STREAMINGXICEXTRACTOR_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Log.hpp>
+#include <MSTK/fe/CentroidTraits.hpp>
+#include <MSTK/fe/XicTraits.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** Incremental, scan-by-scan XIC extraction.
+ *
+ * \c XicExtractor needs all centroids of a run in memory before it can
+ * build a single XIC. \c StreamingXicExtractor accepts the centroids scan
+ * by scan in retention time order and emits every XIC through a callback as
+ * soon as it can no longer grow. Peak memory is proportional to the number
+ * of concurrently eluting features, not to the length of the run.
+ *
+ * Two centroids are connected if their boxes (see \c CentroidBoxGenerator)
+ * intersect; the scan number tolerance of the box generator is the rt gap
+ * tolerance. The centroids of the last few scans are kept in an m/z-sorted
+ * index together with the open XIC they belong to. A new centroid joins all
+ * open XICs it connects to, merging them if necessary. Once the boxes of
+ * all centroids of an open XIC lie behind the current scan, the XIC is
+ * closed, sorted, disambiguated, smoothed, split and handed to the callback,
+ * using the same policies as \c XicExtractor. The set of emitted XICs is
+ * thus the same as the one \c XicExtractor returns for the complete run;
+ * only their order differs.
+ *
+ * @tparam Disambiguator Disambiguation policy (e.g.
+ *         \c CentroidWeightedMeanDisambiguator).
+ * @tparam Smoother Smoothing policy (e.g. \c RunningMeanSmoother).
+ * @tparam Splitter Splitter type (e.g. \c XicLocalMinSplitter<XicType>).
+ * @tparam XicType The XIC type handed to the callback.
+ * @tparam BoxGenerator The box generator (e.g. \c CentroidBoxGenerator);
+ *         dimension 0 must be the scan/rt dimension, dimension 1 m/z.
+ */
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+class StreamingXicExtractor : public Disambiguator, public Smoother
+{
+public:
+    typedef typename XicType::value_type CentroidType;
+    /** The type of the extracted XICs.
+     */
+    typedef XicType ResultType;
+    typedef BoxGenerator BoxGeneratorType;
+    typedef typename Splitter::ThresholdType ThresholdType;
+    typedef std::function<void(XicType&&)> Callback;
+
+    /** Constructor.
+     * @param[in] boxGenerator The box generator that defines the scan and
+     *                         m/z tolerances.
+     * @param[in] minCardinality The minimum number of centroids per XIC.
+     * @param[in] splitThreshold The threshold passed to the splitter.
+     * @param[in] callback Called once for every finished XIC.
+     */
+    StreamingXicExtractor(const BoxGenerator& boxGenerator,
+        const UnsignedInt minCardinality, const ThresholdType splitThreshold,
+        const Callback& callback);
+
+    /** Add the centroids of a single scan. Scans must be added in ascending
+     * scan number order. Finished XICs are emitted before this function
+     * returns.
+     * @param[in] first Iterator to the first centroid of the scan.
+     * @param[in] last Iterator one past the last centroid of the scan.
+     * @throw mstk::PreconditionViolation if a scan arrives out of order.
+     */
+    template<class InputIterator>
+    void addScan(InputIterator first, InputIterator last);
+
+    /** Add a single centroid.
+     * @param[in] centroid The centroid; it must not precede any of the
+     *                     centroids added before.
+     * @throw mstk::PreconditionViolation if the centroid is out of order.
+     */
+    void add(const CentroidType& centroid);
+
+    /** Close and emit all open XICs. Call this once at the end of a run;
+     * the extractor can be reused for another run afterwards. The
+     * destructor does not flush.
+     */
+    void flush();
+
+    /** @return The number of open XICs.
+     */
+    Size getNumberOfOpenXics() const;
+
+    /** @return The number of centroids held in open XICs.
+     */
+    Size getNumberOfBufferedCentroids() const;
+
+    /** @return The smallest retention time of all centroids held in open
+     *          XICs, or infinity if there are none. Every XIC emitted later
+     *          consists of these centroids and of centroids added later.
+     */
+    double getMinimumOpenRetentionTime() const;
+
+private:
+    typedef std::vector<CentroidType> CentroidSet;
+    /** The m/z index: maps the lower m/z bound of a centroid's box to the
+     * sequence number of its entry.
+     */
+    typedef std::multimap<double, Size> Index;
+
+    /** A centroid whose box can still intersect future centroids.
+     */
+    struct Entry
+    {
+        double lo0, hi0, lo1, hi1;
+        Size trace;
+        typename Index::iterator pos;
+    };
+
+    /** An open XIC. \c active holds the sequence numbers of its entries;
+     * expired entries are pruned lazily.
+     */
+    struct Trace
+    {
+        CentroidSet centroids;
+        std::vector<Size> active;
+        Size nActive;
+        double minRt;
+    };
+
+    void expire(const double lo0);
+    Size newTrace();
+    void merge(const Size from, const Size to);
+    void close(const Size t);
+    void emit(CentroidSet& centroids);
+
+    BoxGenerator boxGenerator_;
+    UnsignedInt minCardinality_;
+    ThresholdType splitThreshold_;
+    Callback callback_;
+    /** Active entries in insertion order; \c firstEntry_ is the sequence
+     * number of the front entry.
+     */
+    std::deque<Entry> entries_;
+    Size firstEntry_;
+    Index index_;
+    double maxWidth_;
+    double lastLo0_;
+    std::vector<Trace> traces_;
+    std::vector<Size> freeTraces_;
+    Size nOpen_;
+    Size nBuffered_;
+    std::vector<Size> touched_;
+    CentroidSet smoothCopy_;
+    Splitter splitter_;
+};
+
+} // namespace fe
+
+} // namespace mstk
+
+//
+// template implementation
+//
+
+namespace mstk {
+
+namespace fe {
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::StreamingXicExtractor(const BoxGenerator& boxGenerator,
+    const UnsignedInt minCardinality, const ThresholdType splitThreshold,
+    const Callback& callback) :
+    boxGenerator_(boxGenerator), minCardinality_(minCardinality),
+            splitThreshold_(splitThreshold), callback_(callback),
+            firstEntry_(0), maxWidth_(0.0),
+            lastLo0_(-std::numeric_limits<double>::infinity()), nOpen_(0),
+            nBuffered_(0)
+{
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+template<class InputIterator>
+void StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::addScan(InputIterator first, InputIterator last)
+{
+    for (; first != last; ++first) {
+        add(*first);
+    }
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+void StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::add(const CentroidType& centroid)
+{
+    const std::pair<double, double> b0 =
+            boxGenerator_.template get<0> (centroid);
+    const std::pair<double, double> b1 =
+            boxGenerator_.template get<1> (centroid);
+    mstk_precondition(b0.first >= lastLo0_,
+        "StreamingXicExtractor::add(): centroids must be added in scan order.");
+    lastLo0_ = b0.first;
+    expire(b0.first);
+
+    // collect the open XICs the centroid connects to
+    touched_.clear();
+    for (typename Index::iterator i = index_.lower_bound(b1.first - maxWidth_);
+            i != index_.end() && i->first <= b1.second; ++i) {
+        const Entry& e = entries_[i->second - firstEntry_];
+        if (e.hi1 >= b1.first && e.lo0 <= b0.second && e.hi0 >= b0.first) {
+            touched_.push_back(e.trace);
+        }
+    }
+    std::sort(touched_.begin(), touched_.end());
+    touched_.erase(std::unique(touched_.begin(), touched_.end()),
+        touched_.end());
+
+    Size t;
+    if (touched_.empty()) {
+        t = newTrace();
+    } else {
+        // merge into the largest XIC to move as few centroids as possible
+        t = touched_.front();
+        for (std::vector<Size>::const_iterator i = touched_.begin() + 1; i
+                != touched_.end(); ++i) {
+            if (traces_[*i].centroids.size() > traces_[t].centroids.size()) {
+                t = *i;
+            }
+        }
+        for (std::vector<Size>::const_iterator i = touched_.begin(); i
+                != touched_.end(); ++i) {
+            if (*i != t) {
+                merge(*i, t);
+            }
+        }
+    }
+
+    // register the centroid
+    const Size seq = firstEntry_ + entries_.size();
+    Entry e;
+    e.lo0 = b0.first;
+    e.hi0 = b0.second;
+    e.lo1 = b1.first;
+    e.hi1 = b1.second;
+    e.trace = t;
+    e.pos = index_.insert(std::make_pair(b1.first, seq));
+    entries_.push_back(e);
+    maxWidth_ = std::max(maxWidth_, b1.second - b1.first);
+    Trace& tr = traces_[t];
+    typename CentroidTraits<CentroidType>::RtAccessor rt;
+    tr.minRt = std::min(tr.minRt, rt(centroid));
+    tr.centroids.push_back(centroid);
+    if (tr.active.size() >= 2 * tr.nActive + 16) {
+        tr.active.erase(
+            std::remove_if(tr.active.begin(), tr.active.end(),
+                std::bind2nd(std::less<Size>(), firstEntry_)),
+            tr.active.end());
+    }
+    tr.active.push_back(seq);
+    ++tr.nActive;
+    ++nBuffered_;
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+void StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::flush()
+{
+    expire(std::numeric_limits<double>::infinity());
+    lastLo0_ = -std::numeric_limits<double>::infinity();
+    maxWidth_ = 0.0;
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+Size StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::getNumberOfOpenXics() const
+{
+    return nOpen_;
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+Size StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::getNumberOfBufferedCentroids() const
+{
+    return nBuffered_;
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+double StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::getMinimumOpenRetentionTime() const
+{
+    double minRt = std::numeric_limits<double>::infinity();
+    for (typename std::vector<Trace>::const_iterator i = traces_.begin(); i
+            != traces_.end(); ++i) {
+        // free slots hold no centroids
+        if (!i->centroids.empty()) {
+            minRt = std::min(minRt, i->minRt);
+        }
+    }
+    return minRt;
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+void StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::expire(const double lo0)
+{
+    // Entries are expired in insertion order. This is exact as long as the
+    // upper scan bound of the boxes grows with the scan number, which holds
+    // for constant tolerances.
+    while (!entries_.empty() && entries_.front().hi0 < lo0) {
+        const Entry& e = entries_.front();
+        index_.erase(e.pos);
+        const Size t = e.trace;
+        entries_.pop_front();
+        ++firstEntry_;
+        if (--traces_[t].nActive == 0) {
+            close(t);
+        }
+    }
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+Size StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::newTrace()
+{
+    ++nOpen_;
+    if (!freeTraces_.empty()) {
+        const Size t = freeTraces_.back();
+        freeTraces_.pop_back();
+        traces_[t].minRt = std::numeric_limits<double>::infinity();
+        return t;
+    }
+    Trace tr;
+    tr.nActive = 0;
+    tr.minRt = std::numeric_limits<double>::infinity();
+    traces_.push_back(tr);
+    return traces_.size() - 1;
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+void StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::merge(const Size from, const Size to)
+{
+    Trace& f = traces_[from];
+    Trace& t = traces_[to];
+    t.centroids.insert(t.centroids.end(),
+        std::make_move_iterator(f.centroids.begin()),
+        std::make_move_iterator(f.centroids.end()));
+    for (std::vector<Size>::const_iterator i = f.active.begin(); i
+            != f.active.end(); ++i) {
+        if (*i >= firstEntry_) {
+            entries_[*i - firstEntry_].trace = to;
+            t.active.push_back(*i);
+        }
+    }
+    t.nActive += f.nActive;
+    t.minRt = std::min(t.minRt, f.minRt);
+    // release the slot
+    CentroidSet().swap(f.centroids);
+    f.active.clear();
+    f.nActive = 0;
+    freeTraces_.push_back(from);
+    --nOpen_;
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+void StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::close(const Size t)
+{
+    CentroidSet cs;
+    cs.swap(traces_[t].centroids);
+    traces_[t].active.clear();
+    freeTraces_.push_back(t);
+    --nOpen_;
+    nBuffered_ -= cs.size();
+
+    // same per-XIC processing as in XicExtractor
+    typedef typename CentroidTraits<CentroidType>::LessThanRt Less;
+    std::sort(cs.begin(), cs.end(), Less());
+    cs.erase(this->disambiguate(cs.begin(), cs.end()), cs.end());
+    if (cs.size() < minCardinality_) {
+        return;
+    }
+    smoothCopy_.assign(cs.begin(), cs.end());
+    this->smooth(smoothCopy_.begin(), smoothCopy_.end());
+    splitter_.split(cs.begin(), cs.end(), smoothCopy_.begin(),
+        smoothCopy_.end(), splitThreshold_);
+    if (splitter_.size() == 0) {
+        emit(cs);
+        return;
+    }
+    // the splitter hands out const iterators into cs
+    typedef typename CentroidSet::iterator CI;
+    typedef typename CentroidSet::const_iterator CCI;
+    const CCI origin = cs.begin();
+    for (typename Splitter::const_iterator i = splitter_.begin(); i
+            != splitter_.end(); ++i) {
+        CI f = cs.begin() + (i->first - origin);
+        CI l = cs.begin() + (i->second - origin);
+        CentroidSet part(std::make_move_iterator(f),
+            std::make_move_iterator(l));
+        emit(part);
+    }
+}
+
+template<class Disambiguator, class Smoother, class Splitter, class XicType,
+        class BoxGenerator>
+void StreamingXicExtractor<Disambiguator, Smoother, Splitter, XicType,
+        BoxGenerator>::emit(CentroidSet& centroids)
+{
+    if (centroids.size() < minCardinality_) {
+        return;
+    }
+    typedef typename XicTraits<XicType>::Creator Creator;
+    Creator creator;
+    XicType xic = creator(std::move(centroids));
+    callback_(std::move(xic));
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_STREAMINGXICEXTRACTOR_HPP__ */
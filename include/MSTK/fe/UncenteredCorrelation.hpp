@@ -27,6 +27,8 @@
 #define __MSTK_INCLUDE_MSTK_FE_UNCENTEREDCORRELATION_HPP__
 
 #include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/XicProfile.hpp>
 
 namespace mstk {
 
@@ -36,10 +38,16 @@ class UncenteredCorrelation
 {
 public:
     typedef double ThresholdType;
+    typedef XicProfileArena ProfileArena;
 
 protected:
     virtual ~UncenteredCorrelation() = 0;
 
+    /** @return The correlation between the i-th and the j-th profile.
+     */
+    ThresholdType correlate(const XicProfileArena& profiles, const Size i,
+        const Size j);
+
     template<typename InputIterator>
     ThresholdType correlate(InputIterator lhsFirst, InputIterator lhsLast,
         InputIterator rhsFirst, InputIterator rhsLast);
@@ -117,6 +125,13 @@ UncenteredCorrelation::ThresholdType UncenteredCorrelation::correlate(
     return static_cast<ThresholdType>((lr != 0) ? (lr / std::sqrt(lsq * rsq)) : 0.0);
 }
 
+inline UncenteredCorrelation::ThresholdType UncenteredCorrelation::correlate(
+    const XicProfileArena& profiles, const Size i, const Size j)
+{
+    return correlate(profiles.begin(i), profiles.end(i), profiles.begin(j),
+        profiles.end(j));
+}
+
 } // namespace fe
 
 } // namespace mstk
@@ -26,6 +26,9 @@
 #ifndef __MSTK_INCLUDE_MSTK_FE_XICCREATOR_HPP__
 #define __MSTK_INCLUDE_MSTK_FE_XICCREATOR_HPP__
 
+#include <type_traits>
+#include <utility>
+
 namespace mstk {
 
 namespace fe {
@@ -36,6 +39,20 @@ class XicCreator
 public:
     template <typename CentroidContainer>
     X operator()(CentroidContainer& centroids);
+
+    /** Creates an object from a temporary container. If \c X can be
+     * constructed from the container directly, its elements are moved;
+     * otherwise this falls back to the range construction.
+     */
+    template <typename CentroidContainer>
+    X operator()(CentroidContainer&& centroids);
+
+private:
+    template <typename CentroidContainer>
+    X create(CentroidContainer&& centroids, std::true_type);
+
+    template <typename CentroidContainer>
+    X create(CentroidContainer&& centroids, std::false_type);
 };
 
 } // namespace fe
@@ -59,6 +76,28 @@ X XicCreator<X>::operator()(CentroidContainer& centroids)
     return X(centroids.begin(), centroids.end());
 }
 
+template <typename X>
+template <typename CentroidContainer>
+X XicCreator<X>::operator()(CentroidContainer&& centroids)
+{
+    return create(std::move(centroids),
+        typename std::is_constructible<X, CentroidContainer&&>::type());
+}
+
+template <typename X>
+template <typename CentroidContainer>
+X XicCreator<X>::create(CentroidContainer&& centroids, std::true_type)
+{
+    return X(std::move(centroids));
+}
+
+template <typename X>
+template <typename CentroidContainer>
+X XicCreator<X>::create(CentroidContainer&& centroids, std::false_type)
+{
+    return X(centroids.begin(), centroids.end());
+}
+
 }
 
 }
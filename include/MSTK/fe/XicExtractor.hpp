@@ -28,13 +28,21 @@
 
 #include <MSTK/config.hpp>
 #include <MSTK/common/Types.hpp>
+#include <MSTK/common/Instrumentation.hpp>
 #include <MSTK/common/Log.hpp>
+#include <MSTK/common/parallelFor.hpp>
 #include <MSTK/fe/CentroidTraits.hpp>
 #include <MSTK/fe/XicTraits.hpp>
+#include <MSTK/fe/parallelConnectedComponents.hpp>
 
 #include <fbi/fbi.h>
 #include <fbi/connectedcomponents.h>
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 namespace mstk {
 
 namespace fe {
@@ -43,6 +51,28 @@ template<class Disambiguator, class Smoother, class Splitter>
 class XicExtractor : public Disambiguator, public Smoother
 {
 public:
+    /** Constructor.
+     * @param[in] nThreads The number of threads. 1 (the default) selects the
+     *                     serial path, 0 the number of hardware threads.
+     */
+    explicit XicExtractor(const UnsignedInt nThreads = 1);
+
+    /** Set the number of threads. With more than one thread, the box
+     * intersection and the connected component labeling run in parallel (see
+     * \c parallelConnectedComponents()), and the XICs are sorted,
+     * disambiguated, smoothed and split concurrently. The results, including
+     * the order of the XICs, are identical to the serial path. Hence, the
+     * \c Disambiguator and \c Smoother policies must be safe to call
+     * concurrently; the \c Splitter is instantiated once per thread.
+     * @param[in] nThreads The number of threads; 0 selects the number of
+     *                     hardware threads.
+     */
+    void setNumberOfThreads(const UnsignedInt nThreads);
+
+    /** @return The number of threads, as set by the user.
+     */
+    UnsignedInt getNumberOfThreads() const;
+
     template<class CentroidContainer, class XicContainer,
             class CentroidBoxGenerator>
     Size operator()(const CentroidContainer& centroids,
@@ -50,6 +80,30 @@ public:
         const UnsignedInt minCardinality,
         const typename Splitter::ThresholdType splitThreshold,
         XicContainer& xics);
+
+private:
+    /** Per-thread state of the splitting stage. The trailing padding keeps
+     * the state of different threads on different cache lines.
+     */
+    template<class CentroidSet>
+    struct SplitWorker
+    {
+        CentroidSet smoothCopy;
+        Splitter splitter;
+        std::vector<CentroidSet> splits;
+        char padding[64];
+    };
+
+    /** The location of the split parts of one XIC.
+     */
+    struct SplitSegment
+    {
+        UnsignedInt worker;
+        Size first;
+        Size last;
+    };
+
+    UnsignedInt nThreads_;
 };
 
 } // namespace fe
@@ -65,6 +119,26 @@ namespace mstk {
 
 namespace fe {
 
+template<typename Disambiguator, typename Smoother, typename Splitter>
+XicExtractor<Disambiguator, Smoother, Splitter>::XicExtractor(
+    const UnsignedInt nThreads) :
+        nThreads_(nThreads)
+{
+}
+
+template<typename Disambiguator, typename Smoother, typename Splitter>
+void XicExtractor<Disambiguator, Smoother, Splitter>::setNumberOfThreads(
+    const UnsignedInt nThreads)
+{
+    nThreads_ = nThreads;
+}
+
+template<typename Disambiguator, typename Smoother, typename Splitter>
+UnsignedInt XicExtractor<Disambiguator, Smoother, Splitter>::getNumberOfThreads() const
+{
+    return nThreads_;
+}
+
 template<typename Disambiguator, typename Smoother, typename Splitter>
 template<typename CentroidContainer, typename XicContainer,
         typename CentroidBoxGenerator>
@@ -75,16 +149,32 @@ Size XicExtractor<Disambiguator, Smoother, Splitter>::operator ()(
 {
     MSTK_LOG(logDEBUG) << "XicExtractor::operator(): extracting XICs from "
             << centroids.size() << " centroids.";
+    MSTK_INSTRUMENT_TIMER("fe.XicExtractor");
+    MSTK_INSTRUMENT_COUNT("fe.XicExtractor.centroids", centroids.size());
     typedef typename CentroidContainer::value_type CentroidType;
 
-    // calculate the adjacency list
-    auto results = fbi::SetA<CentroidType, 0, 1>::intersect(centroids,
-        boxGenerator, boxGenerator);
-
-    // get the connected components
+    // get the connected components of the centroid box intersection graph
     typedef typename fbi::SetA<CentroidType, 0, 1>::IntType LabelType;
     std::vector < LabelType > labels;
-    size_t nComponents = findConnectedComponents(results, labels);
+    size_t nComponents;
+    if (nThreads_ == 1) {
+        // calculate the adjacency list
+        typedef typename fbi::SetA<CentroidType, 0, 1>::ResultType AdjList;
+        AdjList results;
+        {
+            MSTK_INSTRUMENT_TIMER("fe.XicExtractor.intersect");
+            results = fbi::SetA<CentroidType, 0, 1>::intersect(centroids,
+                boxGenerator, boxGenerator);
+        }
+        MSTK_INSTRUMENT_TIMER("fe.XicExtractor.components");
+        nComponents = findConnectedComponents(results, labels);
+    } else {
+        // the parallel path interleaves the intersection and the labeling;
+        // both are accounted to the components stage
+        MSTK_INSTRUMENT_TIMER("fe.XicExtractor.components");
+        nComponents = parallelConnectedComponents(centroids, boxGenerator,
+            labels, nThreads_);
+    }
     MSTK_LOG(logDEBUG) << "XicExtractor::operator(): Found " << nComponents
             << " primary XICs.";
 
@@ -97,20 +187,37 @@ Size XicExtractor<Disambiguator, Smoother, Splitter>::operator ()(
     CentroidSets centroidSets;
     centroidSets.reserve(nComponents); // make sure we only allocate once
     centroidSets.resize(nComponents); // construct sets
+    // size the sets exactly, so that every set is allocated only once
+    std::vector<Size> setSizes(nComponents, 0);
+    for (size_t i = 0; i < centroids.size(); ++i) {
+        ++setSizes[labels[i] - 1];
+    }
+    for (size_t i = 0; i < nComponents; ++i) {
+        centroidSets[i].reserve(setSizes[i]);
+    }
     for (size_t i = 0; i < centroids.size(); ++i) {
         // push the i-th centroid into the label[i]-th centroid set
         CentroidSet& cs = centroidSets[labels[i] - 1]; // labels start at 1
         cs.push_back(centroids[i]);
     }
 
+    // The per-XIC stages run on all threads. XIC sizes are highly skewed,
+    // hence the XICs are handed out dynamically in small chunks.
+    const UnsignedInt nThreads = mstk::getNumberOfThreads(nThreads_);
+    const Size chunkSize = std::max(static_cast<Size> (1),
+        centroidSets.size() / (64 * nThreads));
+
     // sort and get rid of any ambiguity in the sets
     typedef typename CentroidTraits<CentroidType>::LessThanRt Less;
-    for (typename CentroidSets::iterator i = centroidSets.begin();
-            i != centroidSets.end(); ++i) {
-        std::sort(i->begin(), i->end(), Less());
-        MSTK_LOG(logDEBUG) << "Have ambiguous XIC with " << i->size() << " entries.";
-        i->erase(this->disambiguate(i->begin(), i->end()), i->end());
-        MSTK_LOG(logDEBUG) << "Have disambiguated XIC with " << i->size() << " entries.";
+    {
+        MSTK_INSTRUMENT_TIMER("fe.XicExtractor.disambiguate");
+        parallelFor(0, centroidSets.size(), [&](const Size k, const UnsignedInt) {
+            CentroidSet& cs = centroidSets[k];
+            std::sort(cs.begin(), cs.end(), Less());
+            MSTK_LOG(logDEBUG) << "Have ambiguous XIC with " << cs.size() << " entries.";
+            cs.erase(this->disambiguate(cs.begin(), cs.end()), cs.end());
+            MSTK_LOG(logDEBUG) << "Have disambiguated XIC with " << cs.size() << " entries.";
+        }, nThreads, chunkSize);
     }
 
     // require a minimum cardinality for the centroid sets
@@ -124,34 +231,66 @@ Size XicExtractor<Disambiguator, Smoother, Splitter>::operator ()(
             << centroidSets.size() << " secondary XICs.";
 
     // Now walk through all XICs and attempt to split them.
-    // Whenever a XIC is split, we collect the new parts in a splits vector
-    // that is later merged with the existing XICs. We are working with two
-    // containers because we don't know how many splits there are going to be
-    // and need to make sure that there will not be any reallocations that
-    // would invalidate the iterators.
-    CentroidSets splits;
-    typedef typename CentroidSets::iterator XI;
-    for (XI i = centroidSets.begin(); i != centroidSets.end(); ++i) {
-        CentroidSet smoothCopy(*i);
-        this->smooth(smoothCopy.begin(), smoothCopy.end());
-        Splitter splitter;
-        splitter.split(i->begin(), i->end(), smoothCopy.begin(),
-            smoothCopy.end(), splitThreshold);
-        // store the first subXic in place
-        *i = CentroidSet(splitter.begin()->first, splitter.begin()->second);
-        // store the others
-        if (splitter.size() > 1) {
-            typename Splitter::const_iterator k = splitter.begin();
-            std::advance(k, 1);
-            while (k < splitter.end()) {
-                splits.push_back(CentroidSet(k->first, k->second));
-                ++k;
+    // Whenever a XIC is split, the first part stays in place and the other
+    // parts are moved into the split buffer of the current thread; a segment
+    // records which parts belong to which XIC. The parts are later appended
+    // to the existing XICs in XIC order, i.e. independent of the number of
+    // threads. The smoothing buffer of each thread is reused for all of its
+    // XICs to avoid an allocation per XIC.
+    {
+        MSTK_INSTRUMENT_TIMER("fe.XicExtractor.split");
+        typedef SplitWorker<CentroidSet> Worker;
+        std::vector<Worker> workers(nThreads);
+        std::vector<SplitSegment> segments(centroidSets.size());
+        parallelFor(0, centroidSets.size(), [&](const Size k, const UnsignedInt t) {
+            Worker& w = workers[t];
+            SplitSegment& seg = segments[k];
+            seg.worker = t;
+            seg.first = seg.last = w.splits.size();
+            CentroidSet& cs = centroidSets[k];
+            w.smoothCopy.assign(cs.begin(), cs.end());
+            this->smooth(w.smoothCopy.begin(), w.smoothCopy.end());
+            w.splitter.split(cs.begin(), cs.end(), w.smoothCopy.begin(),
+                w.smoothCopy.end(), splitThreshold);
+            if (w.splitter.size() == 0) {
+                return;
+            }
+            // the splitter hands out const iterators into cs
+            typedef typename CentroidSet::iterator CI;
+            typedef typename CentroidSet::const_iterator CCI;
+            const CCI origin = cs.begin();
+            typename Splitter::const_iterator i = w.splitter.begin();
+            CI first = cs.begin() + (i->first - origin);
+            CI last = cs.begin() + (i->second - origin);
+            // move the others
+            for (++i; i != w.splitter.end(); ++i) {
+                CI f = cs.begin() + (i->first - origin);
+                CI l = cs.begin() + (i->second - origin);
+                w.splits.push_back(
+                    CentroidSet(std::make_move_iterator(f),
+                        std::make_move_iterator(l)));
+            }
+            seg.last = w.splits.size();
+            // keep the first subXic in place
+            cs.erase(last, cs.end());
+            cs.erase(cs.begin(), first);
+        }, nThreads, chunkSize);
+        // join the lists
+        Size nSplits = 0;
+        for (typename std::vector<Worker>::const_iterator i = workers.begin();
+                i != workers.end(); ++i) {
+            nSplits += i->splits.size();
+        }
+        centroidSets.reserve(centroidSets.size() + nSplits);
+        for (typename std::vector<SplitSegment>::const_iterator i =
+                segments.begin(); i != segments.end(); ++i) {
+            CentroidSets& splits = workers[i->worker].splits;
+            for (Size j = i->first; j < i->last; ++j) {
+                centroidSets.push_back(std::move(splits[j]));
             }
         }
+        workers.clear();
     }
-    // join the lists
-    centroidSets.insert(centroidSets.end(), splits.begin(), splits.end());
-    splits.clear();
     MSTK_LOG(logDEBUG) << "XicExtractor::operator(): Found "
             << centroidSets.size() << " ternary XICs.";
     // once again, get rid of all XICs with an insufficient number of centroids
@@ -162,10 +301,13 @@ Size XicExtractor<Disambiguator, Smoother, Splitter>::operator ()(
             << centroidSets.size() << " quaternary XICs.";
 
     // convert the results into real XICs
+    MSTK_INSTRUMENT_TIMER("fe.XicExtractor.create");
     typedef typename XicTraits<typename XicContainer::value_type>::Creator Creator;
     xics.clear();
-    std::transform(centroidSets.begin(), centroidSets.end(),
-        std::back_inserter(xics), Creator());
+    std::transform(std::make_move_iterator(centroidSets.begin()),
+        std::make_move_iterator(centroidSets.end()), std::back_inserter(xics),
+        Creator());
+    MSTK_INSTRUMENT_COUNT("fe.XicExtractor.xics", xics.size());
     return xics.size();
 }
 
@@ -95,7 +95,8 @@ Size XicLocalMinSplitter<XicType>::split(ForwardIterator1 rawFirst, ForwardItera
     // with less than 4 measurements, there is no point in splitting because we
     // will always generate a single measurement XIC
     if (std::distance(smoothFirst, smoothLast) < 4) {
-        iterators_.push_back(std::make_pair(smoothFirst, smoothLast));
+        // the ranges always address the raw XIC
+        iterators_.push_back(std::make_pair(rawFirst, rawLast));
         MSTK_LOG(logDEBUG3) << __FUNCTION__ << ": size too small (" << size()
                 << "<4)";
         return 1;
@@ -0,0 +1,204 @@
+/*
+ * parallelConnectedComponents.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_PARALLELCONNECTEDCOMPONENTS_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_PARALLELCONNECTEDCOMPONENTS_HPP__
+
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/ConcurrentUnionFind.hpp>
+#include <MSTK/common/parallelFor.hpp>
+
+#include <fbi/fbi.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+namespace detail {
+
+/** Lightweight stand-in for an element of a box container; used to run the
+ * box intersection on subsets of the container without copying elements.
+ */
+template<class T>
+struct BoxRef
+{
+    Size index;
+};
+
+/** Box generator for \c BoxRef objects; forwards to the box generator of
+ * the referenced elements.
+ */
+template<class Container, class BoxGenerator>
+struct BoxRefGenerator
+{
+    typedef typename Container::value_type ValueType;
+
+    BoxRefGenerator(const Container& c, const BoxGenerator& g) :
+        container(&c), generator(&g)
+    {
+    }
+
+    template<size_t N>
+    typename std::tuple_element<N,
+            typename fbi::Traits<ValueType>::key_type>::type get(
+        const BoxRef<ValueType>& r) const
+    {
+        return generator->template get<N>((*container)[r.index]);
+    }
+
+    const Container* container;
+    const BoxGenerator* generator;
+};
+
+} // namespace detail
+
+} // namespace fe
+
+} // namespace mstk
+
+namespace fbi {
+
+template<class T>
+struct Traits<mstk::fe::detail::BoxRef<T> > : Traits<T>
+{
+};
+
+} // namespace fbi
+
+namespace mstk {
+
+namespace fe {
+
+/** Finds the connected components of the box intersection graph of
+ * \c boxes on multiple threads.
+ *
+ * The function computes the same result as running
+ * <tt>fbi::SetA<T, 0, 1>::intersect(boxes, g, g)</tt> followed by
+ * \c findConnectedComponents(), without materializing the global adjacency
+ * list: the elements are sorted along the second box dimension (m/z for
+ * \c CentroidBoxGenerator) and partitioned into slabs of equal size. Each
+ * slab is extended by a halo of all following elements whose boxes start
+ * before the last box of the slab ends, so that every intersecting pair is
+ * seen by at least one slab. The slabs are intersected concurrently and
+ * their adjacency lists are merged into a lock-free union-find structure.
+ *
+ * Components are labeled 1, 2, ... in the order of their smallest element
+ * index, which is the labeling produced by \c findConnectedComponents().
+ * The labels are therefore identical to those of the serial path.
+ *
+ * @param[in] boxes The container of elements.
+ * @param[in] boxGenerator The box generator.
+ * @param[out] labels The component label of every element (starting at 1).
+ * @param[in] nThreads The number of threads; 0 selects the number of
+ *                     hardware threads.
+ * @return The number of connected components.
+ */
+template<class Container, class BoxGenerator, class LabelType>
+Size parallelConnectedComponents(const Container& boxes,
+    const BoxGenerator& boxGenerator, std::vector<LabelType>& labels,
+    const UnsignedInt nThreads = 0)
+{
+    typedef typename Container::value_type ValueType;
+    typedef detail::BoxRef<ValueType> Ref;
+    typedef detail::BoxRefGenerator<Container, BoxGenerator> RefGenerator;
+    typedef typename fbi::SetA<Ref, 0, 1>::ResultType ResultType;
+
+    const Size n = boxes.size();
+    labels.assign(n, 0);
+    if (n == 0) {
+        return 0;
+    }
+
+    // extents along the partitioning dimension
+    std::vector<double> lo(n), hi(n);
+    for (Size i = 0; i < n; ++i) {
+        auto b = boxGenerator.template get<1>(boxes[i]);
+        lo[i] = b.first;
+        hi[i] = b.second;
+    }
+    std::vector<Size> order(n);
+    for (Size i = 0; i < n; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&lo](const Size a, const Size b) {
+            return lo[a] < lo[b];
+        });
+
+    // Use more slabs than threads to balance uneven slab densities. Slabs
+    // must not become too small, or the halo dominates the work.
+    const UnsignedInt nt = getNumberOfThreads(nThreads);
+    const Size minSlabSize = 1024;
+    const Size nSlabs = std::max(static_cast<Size> (1),
+        std::min(static_cast<Size> (4 * nt), n / minSlabSize));
+
+    ConcurrentUnionFind uf(n);
+    RefGenerator g(boxes, boxGenerator);
+    parallelFor(0, nSlabs, [&](const Size s, const UnsignedInt) {
+        const Size first = s * n / nSlabs;
+        const Size last = (s + 1) * n / nSlabs;
+        double end = hi[order[first]];
+        for (Size k = first + 1; k < last; ++k) {
+            end = std::max(end, hi[order[k]]);
+        }
+        // the slab, plus all following boxes that may overlap it
+        std::vector<Ref> slab;
+        slab.reserve(last - first);
+        Size k = first;
+        for (; k < last || (k < n && lo[order[k]] <= end); ++k) {
+            Ref r = { order[k] };
+            slab.push_back(r);
+        }
+        ResultType adj = fbi::SetA<Ref, 0, 1>::intersect(slab, g, g);
+        for (Size i = 0; i < adj.size(); ++i) {
+            for (typename ResultType::value_type::const_iterator j =
+                    adj[i].begin(); j != adj[i].end(); ++j) {
+                uf.unite(slab[i].index, slab[*j].index);
+            }
+        }
+    }, nt);
+
+    // label by increasing representative, i.e. by smallest element index
+    Size nComponents = 0;
+    for (Size i = 0; i < n; ++i) {
+        Size root = uf.find(i);
+        if (root == i) {
+            labels[i] = static_cast<LabelType> (++nComponents);
+        } else {
+            labels[i] = labels[root];
+        }
+    }
+    return nComponents;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_PARALLELCONNECTEDCOMPONENTS_HPP__ */
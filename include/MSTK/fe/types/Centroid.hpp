@@ -133,11 +133,26 @@ public:
      */
     Centroid(const Centroid& rhs);
 
+    /** Move constructor. Takes over the raw data of \c rhs.
+     */
+    Centroid(Centroid&& rhs) noexcept;
+
     /** Alternate constructor.
+     * The raw data range [first, last) may be given by any iterator that
+     * dereferences to a \c SpectrumElement, e.g. \c Spectrum or
+     * \c SpectrumView iterators.
      */
+    template<typename InputIterator>
     Centroid(Double retentionTime, Double mz, UnsignedInt sn, Double ab,
-        Spectrum::const_iterator first,
-        Spectrum::const_iterator last);
+        InputIterator first, InputIterator last);
+
+    /** Assignment operator.
+     */
+    Centroid& operator=(const Centroid& rhs);
+
+    /** Move assignment operator. Takes over the raw data of \c rhs.
+     */
+    Centroid& operator=(Centroid&& rhs) noexcept;
 
     /** Comparison operator.
      * @param[in] rhs The right hand side comparison object.
@@ -202,6 +217,12 @@ public:
     void setRawData(const Spectrum& s);
 
 private:
+    /** Checks the constructor preconditions.
+     * @throw mstk::PreconditionViolation if the retention time, m/z or
+     *        abundance values are negative.
+     */
+    void checkPreconditions() const;
+
     /** The retention time.
      */
     Double rt_;
@@ -229,6 +250,19 @@ private:
  */
 std::ostream& operator<<(std::ostream& os, const Centroid& c);
 
+//
+// template implementation
+//
+
+template<typename InputIterator>
+Centroid::Centroid(Double retentionTime, Double mz, UnsignedInt sn, Double ab,
+    InputIterator first, InputIterator last) :
+    rt_(retentionTime), mz_(mz), sn_(sn), ab_(ab), raw_()
+{
+    checkPreconditions();
+    raw_.assign(first, last);
+}
+
 } // namespace fe   
 
 } // namespace mstk
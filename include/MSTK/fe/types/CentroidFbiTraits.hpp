@@ -28,6 +28,7 @@
 
 #include <MSTK/config.hpp>
 #include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
 #include <fbi/fbi.h>
 #include <utility>
 
@@ -38,6 +39,12 @@ struct Traits<mstk::fe::Centroid> : mpl::TraitsGenerator<double, double>
 {
 };
 
+template<>
+struct Traits<mstk::fe::CompactCentroid> : mpl::TraitsGenerator<double,
+        double>
+{
+};
+
 }
 
 namespace mstk {
@@ -51,6 +58,11 @@ struct CentroidBoxGenerator
             typename fbi::Traits<Centroid>::key_type>::type
     get(const Centroid &) const;
 
+    template<size_t N>
+    typename std::tuple_element<N,
+            typename fbi::Traits<CompactCentroid>::key_type>::type
+    get(const CompactCentroid &) const;
+
     int snTolerance_;
     double mzTolerance_; // in ppm
 
@@ -87,6 +99,23 @@ std::pair<double, double> CentroidBoxGenerator::get<1>(const Centroid & centroid
     return std::make_pair(mz * (1 - shift), mz * (1 + shift));
 }
 
+template<>
+inline std::pair<double, double> CentroidBoxGenerator::get<0>(
+    const CompactCentroid & centroid) const
+{
+    double sn = centroid.getScanNumber();
+    return std::make_pair(sn - snTolerance_ - 0.1, sn + snTolerance_ + 0.1);
+}
+
+template<>
+inline std::pair<double, double> CentroidBoxGenerator::get<1>(
+    const CompactCentroid & centroid) const
+{
+    double shift = mzTolerance_ * 1e-6;
+    double mz = centroid.getMz();
+    return std::make_pair(mz * (1 - shift), mz * (1 + shift));
+}
+
 }
 
 }
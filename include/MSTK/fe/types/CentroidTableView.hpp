@@ -0,0 +1,389 @@
+/*
+ * CentroidTableView.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_CENTROIDTABLEVIEW_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_CENTROIDTABLEVIEW_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
+#include <MSTK/fe/types/RawDataStore.hpp>
+#include <cstddef>
+#include <iterator>
+#include <stdint.h>
+
+namespace mstk {
+
+namespace fe {
+
+namespace detail {
+
+/** Random access iterator over an indexable view whose elements are
+ * synthesized on access and returned by value.
+ *
+ * The iterator holds a copy of the view (a few pointers and a size), so it
+ * stays valid after a temporary view, e.g. an XIC returned by
+ * \c XicTableView::operator[], has been destroyed.
+ */
+template<class View>
+class ViewIterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef typename View::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef value_type reference;
+
+    ViewIterator() :
+        view_(), pos_(0)
+    {
+    }
+
+    ViewIterator(const View* view, const std::size_t pos) :
+        view_(*view), pos_(pos)
+    {
+    }
+
+    value_type operator*() const
+    {
+        return view_[pos_];
+    }
+
+    value_type operator[](difference_type n) const
+    {
+        return view_[pos_ + n];
+    }
+
+    ViewIterator& operator++()
+    {
+        ++pos_;
+        return *this;
+    }
+
+    ViewIterator operator++(int)
+    {
+        ViewIterator tmp(*this);
+        ++pos_;
+        return tmp;
+    }
+
+    ViewIterator& operator--()
+    {
+        --pos_;
+        return *this;
+    }
+
+    ViewIterator operator--(int)
+    {
+        ViewIterator tmp(*this);
+        --pos_;
+        return tmp;
+    }
+
+    ViewIterator& operator+=(difference_type n)
+    {
+        pos_ += n;
+        return *this;
+    }
+
+    ViewIterator& operator-=(difference_type n)
+    {
+        pos_ -= n;
+        return *this;
+    }
+
+    ViewIterator operator+(difference_type n) const
+    {
+        return ViewIterator(&view_, pos_ + n);
+    }
+
+    ViewIterator operator-(difference_type n) const
+    {
+        return ViewIterator(&view_, pos_ - n);
+    }
+
+    difference_type operator-(const ViewIterator& rhs) const
+    {
+        return static_cast<difference_type> (pos_)
+                - static_cast<difference_type> (rhs.pos_);
+    }
+
+    bool operator==(const ViewIterator& rhs) const
+    {
+        return pos_ == rhs.pos_;
+    }
+
+    bool operator!=(const ViewIterator& rhs) const
+    {
+        return pos_ != rhs.pos_;
+    }
+
+    bool operator<(const ViewIterator& rhs) const
+    {
+        return pos_ < rhs.pos_;
+    }
+
+    bool operator>(const ViewIterator& rhs) const
+    {
+        return pos_ > rhs.pos_;
+    }
+
+    bool operator<=(const ViewIterator& rhs) const
+    {
+        return pos_ <= rhs.pos_;
+    }
+
+    bool operator>=(const ViewIterator& rhs) const
+    {
+        return pos_ >= rhs.pos_;
+    }
+
+private:
+    View view_;
+    std::size_t pos_;
+};
+
+} // namespace detail
+
+/** A non-owning, columnar view onto a table of centroids.
+ *
+ * The view references one contiguous array per centroid field, e.g. the
+ * columns of a memory-mapped centroid table (see \c BinaryStoreReader).
+ * Elements are synthesized as \c CompactCentroid objects on access, so the
+ * view can be passed as a \c CentroidContainer to \c XicExtractor without
+ * copying the table. The view does not manage the lifetime of the data.
+ */
+class CentroidTableView
+{
+public:
+    typedef CompactCentroid value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef detail::ViewIterator<CentroidTableView> const_iterator;
+    typedef const_iterator iterator;
+
+    /** Pointers to the first element of every column.
+     */
+    struct Columns
+    {
+        Columns() :
+            rt(0), mz(0), abundance(0), scanNumber(0), rawScanIndex(0),
+                    rawOffset(0), rawLength(0)
+        {
+        }
+
+        const double* rt;
+        const double* mz;
+        const double* abundance;
+        const uint32_t* scanNumber;
+        const uint32_t* rawScanIndex;
+        const uint32_t* rawOffset;
+        const uint32_t* rawLength;
+    };
+
+    /** Default constructor. Constructs an empty view.
+     */
+    CentroidTableView();
+
+    /** Constructs a view onto \c n centroids.
+     * @param[in] columns The columns; all columns must hold at least \c n
+     *                    elements.
+     * @param[in] n The number of centroids.
+     */
+    CentroidTableView(const Columns& columns, const size_type n);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_type size() const;
+    bool empty() const;
+    CompactCentroid operator[](const size_type pos) const;
+
+    /** @return A view onto the centroids in [first, last). No data is
+     *          copied.
+     */
+    CentroidTableView slice(const size_type first, const size_type last) const;
+
+    /** @return The column pointers.
+     */
+    const Columns& columns() const;
+
+private:
+    Columns columns_;
+    size_type size_;
+};
+
+/** A non-owning view onto a table of XICs.
+ *
+ * All centroids of all XICs are held in a single \c CentroidTableView; the
+ * centroids of the i-th XIC are [offsets[i], offsets[i+1]). Dereferencing
+ * yields the \c CentroidTableView of a single XIC.
+ */
+class XicTableView
+{
+public:
+    typedef CentroidTableView value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef detail::ViewIterator<XicTableView> const_iterator;
+    typedef const_iterator iterator;
+
+    /** Default constructor. Constructs an empty view.
+     */
+    XicTableView();
+
+    /** Constructor.
+     * @param[in] centroids The centroids of all XICs.
+     * @param[in] offsets The \c n + 1 XIC offsets into \c centroids.
+     * @param[in] n The number of XICs.
+     */
+    XicTableView(const CentroidTableView& centroids, const uint64_t* offsets,
+        const size_type n);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_type size() const;
+    bool empty() const;
+    CentroidTableView operator[](const size_type pos) const;
+
+    /** @return The centroids of all XICs.
+     */
+    const CentroidTableView& getCentroids() const;
+
+private:
+    CentroidTableView centroids_;
+    const uint64_t* offsets_;
+    size_type size_;
+};
+
+///
+/// inline functions
+///
+
+inline CentroidTableView::CentroidTableView() :
+    columns_(), size_(0)
+{
+}
+
+inline CentroidTableView::CentroidTableView(const Columns& columns,
+    const size_type n) :
+    columns_(columns), size_(n)
+{
+}
+
+inline CentroidTableView::const_iterator CentroidTableView::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+inline CentroidTableView::const_iterator CentroidTableView::end() const
+{
+    return const_iterator(this, size_);
+}
+
+inline CentroidTableView::size_type CentroidTableView::size() const
+{
+    return size_;
+}
+
+inline bool CentroidTableView::empty() const
+{
+    return size_ == 0;
+}
+
+inline CompactCentroid CentroidTableView::operator[](const size_type pos) const
+{
+    return CompactCentroid(columns_.rt[pos], columns_.mz[pos],
+        columns_.scanNumber[pos], columns_.abundance[pos],
+        RawDataHandle(columns_.rawScanIndex[pos], columns_.rawOffset[pos],
+            columns_.rawLength[pos]));
+}
+
+inline CentroidTableView CentroidTableView::slice(const size_type first,
+    const size_type last) const
+{
+    Columns c;
+    c.rt = columns_.rt + first;
+    c.mz = columns_.mz + first;
+    c.abundance = columns_.abundance + first;
+    c.scanNumber = columns_.scanNumber + first;
+    c.rawScanIndex = columns_.rawScanIndex + first;
+    c.rawOffset = columns_.rawOffset + first;
+    c.rawLength = columns_.rawLength + first;
+    return CentroidTableView(c, last - first);
+}
+
+inline const CentroidTableView::Columns& CentroidTableView::columns() const
+{
+    return columns_;
+}
+
+inline XicTableView::XicTableView() :
+    centroids_(), offsets_(0), size_(0)
+{
+}
+
+inline XicTableView::XicTableView(const CentroidTableView& centroids,
+    const uint64_t* offsets, const size_type n) :
+    centroids_(centroids), offsets_(offsets), size_(n)
+{
+}
+
+inline XicTableView::const_iterator XicTableView::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+inline XicTableView::const_iterator XicTableView::end() const
+{
+    return const_iterator(this, size_);
+}
+
+inline XicTableView::size_type XicTableView::size() const
+{
+    return size_;
+}
+
+inline bool XicTableView::empty() const
+{
+    return size_ == 0;
+}
+
+inline CentroidTableView XicTableView::operator[](const size_type pos) const
+{
+    return centroids_.slice(static_cast<size_type> (offsets_[pos]),
+        static_cast<size_type> (offsets_[pos + 1]));
+}
+
+inline const CentroidTableView& XicTableView::getCentroids() const
+{
+    return centroids_;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_CENTROIDTABLEVIEW_HPP__ */
@@ -0,0 +1,335 @@
+/*
+ * ColumnarSpectrum.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_COLUMNARSPECTRUM_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_COLUMNARSPECTRUM_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/AlignedAllocator.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumView.hpp>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** A mass spectrum stored as a structure of arrays.
+ *
+ * In contrast to \c Spectrum, which keeps a vector of (m/z, abundance)
+ * pairs, \c ColumnarSpectrum holds the m/z and abundance values in two
+ * separate, cache-line aligned arrays. Iteration happens through
+ * \c SpectrumView iterators, i.e. the container can be used wherever a
+ * read-only \c Spectrum range is expected.
+ */
+class MSTK_EXPORT ColumnarSpectrum
+{
+public:
+    typedef SpectrumElement Element;
+    // for use with SpectrumTraits<T>:
+    typedef SpectrumElement Value;
+    typedef SpectrumElement value_type;
+    typedef std::vector<double, AlignedAllocator<double> > Column;
+    typedef Column::size_type size_type;
+    typedef SpectrumView::const_iterator const_iterator;
+    typedef SpectrumView::const_iterator iterator;
+
+    /** Default constructor. Constructs an empty spectrum.
+     */
+    ColumnarSpectrum();
+
+    /** Converts a \c Spectrum into its columnar representation, including
+     * all metadata.
+     */
+    explicit ColumnarSpectrum(const Spectrum& s);
+
+    /** Constructs a columnar spectrum from separate m/z and abundance
+     * vectors.
+     * @throw mstk::PreconditionViolation if the vector sizes differ.
+     */
+    ColumnarSpectrum(const std::vector<double>& mz,
+        const std::vector<double>& abundances);
+
+    /** Test if two \c ColumnarSpectrum objects are equal.
+     */
+    bool operator==(const ColumnarSpectrum& s) const;
+
+    /** Converts the columnar spectrum back into a \c Spectrum, including
+     * all metadata.
+     */
+    Spectrum toSpectrum() const;
+
+    /** @return A non-owning view onto the spectrum data. The view is
+     *          invalidated by all operations that modify the container size.
+     */
+    SpectrumView view() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_type size() const;
+    bool empty() const;
+    void reserve(size_type n);
+    SpectrumElement operator[](size_type pos) const;
+
+    /** Append an element to the spectrum.
+     */
+    void push_back(const SpectrumElement& e);
+
+    /* Clear the spectrum. Deletes all elements in the object
+     * and resets all member values to zero.
+     */
+    void clear();
+
+    /** @return The m/z column.
+     */
+    const Column& mz() const;
+
+    /** @return The abundance column.
+     */
+    const Column& abundance() const;
+
+    /** Mutable access to the m/z values. Both columns always have the same
+     * size; hence, only the values can be modified, not the column size.
+     * @return A pointer to the \c size() m/z values.
+     */
+    double* mzData();
+
+    /** Mutable access to the abundance values; see \c mzData().
+     * @return A pointer to the \c size() abundance values.
+     */
+    double* abundanceData();
+
+    /** Get the sum over all abundances. This does *not* triangulate.
+     *   @return The accumulated abundance.
+     */
+    double getTotalAbundance() const;
+
+    void setRetentionTime(const double rt);
+
+    double getRetentionTime() const;
+
+    void setMsLevel(const unsigned int l);
+
+    unsigned int getMsLevel() const;
+
+    void setScanNumber(const unsigned int scanNumber);
+
+    unsigned int getScanNumber() const;
+
+    void setTotalIonCurrent(const double totalIonCurrent);
+
+    double getTotalIonCurrent() const;
+
+    void setPrecursorScanNumber(const unsigned int psn);
+
+    unsigned int getPrecursorScanNumber() const;
+
+    void setPrecursorMz(const double pmz);
+
+    double getPrecursorMz() const;
+
+    void setPrecursorCharge(const int pz);
+
+    int getPrecursorCharge() const;
+
+    void setPrecursorAbundance(const double pab);
+
+    double getPrecursorAbundance() const;
+
+private:
+    Column mz_;
+    Column ab_;
+    double rt_;
+    unsigned int msLevel_;
+    unsigned int scanNumber_;
+    double totalIonCurrent_;
+    unsigned int precursorScanNumber_;
+    double precursorMz_;
+    int precursorCharge_;
+    double precursorAbundance_;
+};
+
+///
+/// inline functions
+///
+
+inline SpectrumView ColumnarSpectrum::view() const
+{
+    return SpectrumView(mz_.data(), ab_.data(), ab_.size());
+}
+
+inline ColumnarSpectrum::const_iterator ColumnarSpectrum::begin() const
+{
+    return const_iterator(mz_.data(), ab_.data());
+}
+
+inline ColumnarSpectrum::const_iterator ColumnarSpectrum::end() const
+{
+    return const_iterator(mz_.data() + mz_.size(), ab_.data() + ab_.size());
+}
+
+inline ColumnarSpectrum::size_type ColumnarSpectrum::size() const
+{
+    return ab_.size();
+}
+
+inline bool ColumnarSpectrum::empty() const
+{
+    return ab_.empty();
+}
+
+inline void ColumnarSpectrum::reserve(size_type n)
+{
+    mz_.reserve(n);
+    ab_.reserve(n);
+}
+
+inline SpectrumElement ColumnarSpectrum::operator[](size_type pos) const
+{
+    return SpectrumElement(mz_[pos], ab_[pos]);
+}
+
+inline void ColumnarSpectrum::push_back(const SpectrumElement& e)
+{
+    mz_.push_back(e.mz);
+    try {
+        ab_.push_back(e.abundance);
+    } catch (...) {
+        // keep both columns the same size
+        mz_.pop_back();
+        throw;
+    }
+}
+
+inline const ColumnarSpectrum::Column& ColumnarSpectrum::mz() const
+{
+    return mz_;
+}
+
+inline const ColumnarSpectrum::Column& ColumnarSpectrum::abundance() const
+{
+    return ab_;
+}
+
+inline double* ColumnarSpectrum::mzData()
+{
+    return mz_.data();
+}
+
+inline double* ColumnarSpectrum::abundanceData()
+{
+    return ab_.data();
+}
+
+inline double ColumnarSpectrum::getTotalAbundance() const
+{
+    return view().getTotalAbundance();
+}
+
+inline void ColumnarSpectrum::setRetentionTime(const double rt)
+{
+    rt_ = rt;
+}
+
+inline double ColumnarSpectrum::getRetentionTime() const
+{
+    return rt_;
+}
+
+inline void ColumnarSpectrum::setMsLevel(const unsigned int l)
+{
+    msLevel_ = l;
+}
+
+inline unsigned int ColumnarSpectrum::getMsLevel() const
+{
+    return msLevel_;
+}
+
+inline void ColumnarSpectrum::setScanNumber(const unsigned int scanNumber)
+{
+    scanNumber_ = scanNumber;
+}
+
+inline unsigned int ColumnarSpectrum::getScanNumber() const
+{
+    return scanNumber_;
+}
+
+inline void ColumnarSpectrum::setTotalIonCurrent(const double totalIonCurrent)
+{
+    totalIonCurrent_ = totalIonCurrent;
+}
+
+inline double ColumnarSpectrum::getTotalIonCurrent() const
+{
+    return totalIonCurrent_;
+}
+
+inline void ColumnarSpectrum::setPrecursorScanNumber(const unsigned int psn)
+{
+    precursorScanNumber_ = psn;
+}
+
+inline unsigned int ColumnarSpectrum::getPrecursorScanNumber() const
+{
+    return precursorScanNumber_;
+}
+
+inline void ColumnarSpectrum::setPrecursorMz(const double pmz)
+{
+    precursorMz_ = pmz;
+}
+
+inline double ColumnarSpectrum::getPrecursorMz() const
+{
+    return precursorMz_;
+}
+
+inline void ColumnarSpectrum::setPrecursorCharge(const int pz)
+{
+    precursorCharge_ = pz;
+}
+
+inline int ColumnarSpectrum::getPrecursorCharge() const
+{
+    return precursorCharge_;
+}
+
+inline void ColumnarSpectrum::setPrecursorAbundance(const double pab)
+{
+    precursorAbundance_ = pab;
+}
+
+inline double ColumnarSpectrum::getPrecursorAbundance() const
+{
+    return precursorAbundance_;
+}
+
+} /* namespace fe */
+
+} /* namespace mstk */
+
+#endif /*__MSTK_INCLUDE_MSTK_FE_TYPES_COLUMNARSPECTRUM_HPP__*/
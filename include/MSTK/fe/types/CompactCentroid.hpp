@@ -0,0 +1,273 @@
+/*
+ * CompactCentroid.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_COMPACTCENTROID_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_COMPACTCENTROID_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/CentroidCreator.hpp>
+#include <MSTK/fe/types/RawDataStore.hpp>
+#include <MSTK/fe/types/SpectrumView.hpp>
+#include <functional>
+#include <iosfwd>
+#include <iterator>
+
+namespace mstk {
+
+namespace fe {
+
+/** A lightweight m/z centroid that references its raw data.
+ *
+ * In contrast to \c Centroid, which owns a copy of its raw data,
+ * \c CompactCentroid only stores retention time, m/z, scan number and
+ * abundance plus an (optional) handle into a \c RawDataStore. The object is
+ * trivially copyable and does not allocate, which makes it the preferred
+ * centroid type for large runs. It supports the same \c CentroidTraits as
+ * \c Centroid, i.e. it can be used with \c Centroider, \c XicExtractor and
+ * the disambiguation, smoothing and splitting policies.
+ */
+class MSTK_EXPORT CompactCentroid
+{
+public:
+    /** Functor to compare two centroids based on their retention time.
+     */
+    struct LessThanRt : public std::binary_function<CompactCentroid,
+            CompactCentroid, bool>
+    {
+        bool operator()(const CompactCentroid& lhs,
+            const CompactCentroid& rhs);
+    };
+
+    /** Functor to compare two centroids based on their mass/charge ratio.
+     */
+    struct LessThanMz : public std::binary_function<CompactCentroid,
+            CompactCentroid, bool>
+    {
+        bool operator()(const CompactCentroid& lhs,
+            const CompactCentroid& rhs);
+    };
+
+    /** Functor to compare two centroids based on their scan number.
+     */
+    struct LessThanScanNumber : public std::binary_function<CompactCentroid,
+            CompactCentroid, bool>
+    {
+        bool operator()(const CompactCentroid& lhs,
+            const CompactCentroid& rhs);
+    };
+
+    /** Functor to compare two centroids based on their abundance.
+     */
+    struct LessThanAbundance : public std::binary_function<CompactCentroid,
+            CompactCentroid, bool>
+    {
+        bool operator()(const CompactCentroid& lhs,
+            const CompactCentroid& rhs);
+    };
+
+    /** Accessor functor to access the m/z value of a centroid.
+     */
+    struct MzAccessor
+    {
+        typedef double value_type;
+        double& operator()(CompactCentroid& c);
+        double operator()(const CompactCentroid& c) const;
+    };
+
+    /** Accessor functor to access the rt value of a centroid.
+     */
+    struct RtAccessor
+    {
+        typedef double value_type;
+        double& operator()(CompactCentroid& c);
+        double operator()(const CompactCentroid& c) const;
+    };
+
+    /** Accessor functor to access the abundance value of a centroid.
+     */
+    struct AbundanceAccessor
+    {
+        typedef double value_type;
+        double& operator()(CompactCentroid& c);
+        double operator()(const CompactCentroid& c) const;
+    };
+
+    /** Constructor.
+     */
+    CompactCentroid();
+
+    /** Alternate constructor.
+     * @param[in] retentionTime The retention time, in seconds.
+     * @param[in] mz The m/z value.
+     * @param[in] sn The scan number.
+     * @param[in] ab The abundance.
+     * @param[in] h Handle to the raw data of the centroid.
+     * @throw mstk::PreconditionViolation if the retention time, m/z or
+     *        abundance values are negative.
+     */
+    CompactCentroid(Double retentionTime, Double mz, UnsignedInt sn,
+        Double ab, const RawDataHandle& h = RawDataHandle());
+
+    /** Comparison operator.
+     * @param[in] rhs The right hand side comparison object.
+     */
+    bool operator==(const CompactCentroid& rhs) const;
+
+    /** Get the retention time associated with the centroid.
+     * @return The retention time value, in seconds.
+     */
+    Double getRetentionTime() const;
+
+    /** Set the retention time for the centroid.
+     * @param[in] rt The retention time, in seconds.
+     * @throw mstk::PreconditionViolation if \c rt < 0.0.
+     */
+    void setRetentionTime(Double rt);
+
+    /** Get the mass/charge value of the centroid.
+     * @return The m/z value.
+     */
+    Double getMz() const;
+
+    /** Set the mass/charge value of the centroid.
+     * @param[in] mz The mass/charge value.
+     * @throw mstk::PreconditionViolation if \c mz < 0.0.
+     */
+    void setMz(const Double mz);
+
+    /** Get the scan number associated with the centroid.
+     * @return The scan number.
+     */
+    UnsignedInt getScanNumber() const;
+
+    /** Set the scan number of the centroid.
+     * @param[in] sn The scan number.
+     */
+    void setScanNumber(const UnsignedInt sn);
+
+    /** Get the centroid abundance.
+     * @return The abundance of the centroid.
+     */
+    Double getAbundance() const;
+
+    /** Set the centroid abundance.
+     * @param[in] ab The centroid abundance.
+     * @throw mstk::PreconditionViolation if \c ab < 0.0.
+     */
+    void setAbundance(const Double ab);
+
+    /** Get the handle to the raw data underlying the centroid.
+     * @return The raw data handle; invalid if no raw data is referenced.
+     */
+    const RawDataHandle& getRawDataHandle() const;
+
+    /** Set the handle to the raw data underlying the centroid.
+     * @param[in] h The raw data handle.
+     */
+    void setRawDataHandle(const RawDataHandle& h);
+
+    /** Get the raw data underlying the centroid.
+     * @param[in] store The store that holds the raw data of the centroid.
+     * @return A view onto the raw data; empty if no raw data is referenced.
+     */
+    SpectrumView getRawData(const RawDataStore& store) const;
+
+private:
+    /** The retention time.
+     */
+    Double rt_;
+
+    /** The m/z position.
+     */
+    Double mz_;
+
+    /** The centroid abundance.
+     */
+    Double ab_;
+
+    /** The scan number.
+     */
+    UnsignedInt sn_;
+
+    /** The raw data handle. May be invalid.
+     */
+    RawDataHandle raw_;
+};
+
+/** Streams a text representation of the centroid object.
+ * @param[inout] os The stream into which to write.
+ * @param[in] c The centroid object that should be streamed.
+ */
+std::ostream& operator<<(std::ostream& os, const CompactCentroid& c);
+
+/** Creates \c CompactCentroid objects for the \c Centroider.
+ *
+ * If the creator has been given a \c RawDataStore, the centroids reference
+ * their raw data in the scan that was added to the store last. Hence, the
+ * raw data of a scan must be added to the store before it is centroided,
+ * and the range passed to the \c Centroider must be that scan, e.g.
+ * \code
+ * UnsignedInt i = store.addScan(s.begin(), s.end());
+ * SpectrumView v = store.getScan(i);
+ * centroider(v.begin(), v.end(), rt, sn, out);
+ * \endcode
+ * Without a store, no raw data is referenced.
+ */
+template<>
+class CentroidCreator<CompactCentroid>
+{
+public:
+    /** Constructor.
+     * @param[in] store The raw data store or 0.
+     */
+    explicit CentroidCreator(const RawDataStore* store = 0) :
+        store_(store)
+    {
+    }
+
+    template<typename InputIterator>
+    CompactCentroid operator()(Double rt, Double mz, UnsignedInt sn,
+        Double ab, InputIterator scanFirst, InputIterator first,
+        InputIterator last)
+    {
+        if (store_ == 0 || store_->empty()) {
+            return CompactCentroid(rt, mz, sn, ab);
+        }
+        return CompactCentroid(rt, mz, sn, ab,
+            RawDataHandle(static_cast<UnsignedInt> (store_->size() - 1),
+                static_cast<UnsignedInt> (std::distance(scanFirst, first)),
+                static_cast<UnsignedInt> (std::distance(first, last))));
+    }
+
+private:
+    const RawDataStore* store_;
+};
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_COMPACTCENTROID_HPP__ */
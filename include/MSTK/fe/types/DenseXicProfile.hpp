@@ -0,0 +1,152 @@
+/*
+ * DenseXicProfile.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_DENSEXICPROFILE_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_DENSEXICPROFILE_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/AlignedAllocator.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/CentroidTraits.hpp>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** The elution profiles of a set of XICs as dense vectors over scan
+ * numbers.
+ *
+ * The profile of the i-th XIC starts at scan \c getFirstScan(i) and holds
+ * one abundance per scan up to the last scan of the XIC; scans without a
+ * centroid are zero. Two profiles are aligned by offsetting their data
+ * pointers by the difference of their first scans, which turns the
+ * rt-ordered merge of two XICs into a dot product over the overlapping
+ * scan window (see \c DenseUncenteredCorrelation). All profiles live in a
+ * single, cache line aligned array. The arena can be read concurrently.
+ *
+ * Every XIC must hold at most one centroid per scan, as guaranteed by the
+ * disambiguation stage of \c XicExtractor; the abundances of duplicates
+ * are summed.
+ */
+class DenseXicProfileArena
+{
+public:
+    /** Build the profiles of \c xics, replacing the current content.
+     * @param[in] xics A random access container of XICs.
+     */
+    template<class XicContainer>
+    void assign(const XicContainer& xics);
+
+    /** @return The number of profiles.
+     */
+    Size size() const
+    {
+        return firstScans_.size();
+    }
+
+    /** @return The scan number of the first element of the i-th profile.
+     */
+    UnsignedInt getFirstScan(const Size i) const
+    {
+        return firstScans_[i];
+    }
+
+    /** @return The number of scans covered by the i-th profile.
+     */
+    Size getLength(const Size i) const
+    {
+        return offsets_[i + 1] - offsets_[i];
+    }
+
+    /** @return The abundances of the i-th profile.
+     */
+    const double* data(const Size i) const
+    {
+        return values_.data() + offsets_[i];
+    }
+
+    /** @return The sum of squared abundances of the i-th profile.
+     */
+    double getSquaredNorm(const Size i) const
+    {
+        return squaredNorms_[i];
+    }
+
+private:
+    std::vector<double, AlignedAllocator<double> > values_;
+    std::vector<Size> offsets_;
+    std::vector<UnsignedInt> firstScans_;
+    std::vector<double> squaredNorms_;
+};
+
+template<class XicContainer>
+void DenseXicProfileArena::assign(const XicContainer& xics)
+{
+    typedef typename XicContainer::value_type XicType;
+    typedef typename XicType::const_iterator CI;
+    typedef typename std::iterator_traits<CI>::value_type CentroidType;
+    typename CentroidTraits<CentroidType>::AbundanceAccessor accAb;
+    const Size n = xics.size();
+    offsets_.resize(n + 1);
+    firstScans_.resize(n);
+    squaredNorms_.resize(n);
+    offsets_[0] = 0;
+    for (Size i = 0; i < n; ++i) {
+        UnsignedInt first = 0, last = 0;
+        CI c = xics[i].begin();
+        if (c != xics[i].end()) {
+            first = last = c->getScanNumber();
+            for (++c; c != xics[i].end(); ++c) {
+                first = std::min(first, c->getScanNumber());
+                last = std::max(last, c->getScanNumber());
+            }
+            offsets_[i + 1] = offsets_[i] + (last - first + 1);
+        } else {
+            offsets_[i + 1] = offsets_[i];
+        }
+        firstScans_[i] = first;
+    }
+    values_.assign(offsets_.back(), 0.0);
+    for (Size i = 0; i < n; ++i) {
+        double* v = values_.data() + offsets_[i];
+        for (CI c = xics[i].begin(); c != xics[i].end(); ++c) {
+            v[c->getScanNumber() - firstScans_[i]] += accAb(*c);
+        }
+        double sq = 0.0;
+        for (Size k = 0; k < getLength(i); ++k) {
+            sq += v[k] * v[k];
+        }
+        squaredNorms_[i] = sq;
+    }
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_DENSEXICPROFILE_HPP__ */
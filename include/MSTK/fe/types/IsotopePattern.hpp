@@ -27,7 +27,8 @@
 #define __MSTK_INCLUDE_MSTK_FE_TYPES_ISOTOPEPATTERN_HPP__
 
 #include <MSTK/config.hpp>
-#include <MSTK/common/Collection.hpp>
+#include <MSTK/common/StaticCollection.hpp>
+#include <MSTK/fe/AveragineSplitter.hpp>
 #include <MSTK/fe/types/Xic.hpp>
 #include <MSTK/fe/types/Spectrum.hpp>
 
@@ -42,7 +43,7 @@ namespace fe {
 
 /* A representation for an isotope pattern.
  */
-class IsotopePattern : public Collection<Xic>
+class IsotopePattern : public StaticCollection<IsotopePattern, Xic>
 {
 public:
     /** Constructor
@@ -54,6 +55,28 @@ public:
      */
     IsotopePattern(const_iterator first, const_iterator last);
 
+    /** Constructor.
+     * Constructs an isotope pattern from a set of Xics. The Xics are moved
+     * into the isotope pattern, i.e. no element is copied.
+     */
+    explicit IsotopePattern(std::vector<Xic>&& xics);
+
+    /** Copy constructor.
+     */
+    IsotopePattern(const IsotopePattern& rhs);
+
+    /** Move constructor. Takes over the XICs and charges of \c rhs.
+     */
+    IsotopePattern(IsotopePattern&& rhs) noexcept;
+
+    /** Assignment operator.
+     */
+    IsotopePattern& operator=(const IsotopePattern& rhs);
+
+    /** Move assignment operator. Takes over the XICs and charges of \c rhs.
+     */
+    IsotopePattern& operator=(IsotopePattern&& rhs) noexcept;
+
     /** Set the isotope pattern charge state information.
      *
      * @param[in] z The charge states for the isotope pattern.
@@ -73,12 +96,27 @@ public:
     void asSpectrum(Spectrum& ss) const;
 
     /** Split the current isotope pattern into multiple isotope patterns,
-     *  i.e. unmix by charge state.
+     *  i.e. unmix by charge state. This uses \c AveragineSplitter without an
+     *  envelope table, i.e. charge chains are chosen by abundance alone.
+     *  Use the overload taking an envelope table to score the parts against
+     *  averagine envelopes.
      * @param isotopePatterns A vector of single-charge (not singly-charged)
-     *                        isotope patterns.
+     *                        isotope patterns; its content is replaced.
      */
     void split(std::vector<IsotopePattern>& isotopePatterns);
 
+    /** Split the current isotope pattern into multiple isotope patterns,
+     *  scoring the parts against the averagine envelopes of \c table (see
+     *  \c AveragineSplitter for the requirements on \c EnvelopeTable, e.g.
+     *  \c mstk::ipaca::AveragineTable).
+     * @param isotopePatterns A vector of single-charge (not singly-charged)
+     *                        isotope patterns; its content is replaced.
+     * @param[in] table The envelope table.
+     */
+    template<class EnvelopeTable>
+    void split(std::vector<IsotopePattern>& isotopePatterns,
+        const EnvelopeTable& table);
+
     /** Calculate the overall abundance of the isotope pattern
      * @return The abundance (the sum of all XIC abundances).
      */
@@ -98,6 +136,17 @@ private:
  */
 std::ostream& operator<<(std::ostream& os, const IsotopePattern& p);
 
+template<class EnvelopeTable>
+void IsotopePattern::split(std::vector<IsotopePattern>& isotopePatterns,
+    const EnvelopeTable& table)
+{
+    AveragineSplitter<EnvelopeTable> splitter;
+    splitter.setEnvelopeTable(&table);
+    IsotopePattern ip(*this);
+    isotopePatterns.clear();
+    splitter.splitPattern(ip, isotopePatterns);
+}
+
 } // namespace fe
 
 } // namespace mstk
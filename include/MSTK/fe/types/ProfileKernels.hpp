@@ -0,0 +1,72 @@
+/*
+ * ProfileKernels.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_PROFILEKERNELS_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_PROFILEKERNELS_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/InstructionSet.hpp>
+#include <MSTK/common/Types.hpp>
+
+namespace mstk {
+
+namespace fe {
+
+/** Vectorized kernels on dense, scan-aligned elution profiles (see
+ * \c DenseXicProfileArena).
+ *
+ * As for \c SpectrumKernels, \c get() returns the best implementation the
+ * host supports. All implementations use the same summation order:
+ * \c dotProduct accumulates into eight partial sums (element \c i goes to
+ * sum <tt>i % 8</tt>) that are added pairwise at the end. The results are
+ * bitwise identical unless the compiler contracts the scalar multiply-adds
+ * into FMA instructions (e.g. with <tt>-mfma</tt>), and may differ from a
+ * sequential sum in the last bits.
+ */
+struct MSTK_EXPORT ProfileKernels
+{
+    /** @return The dot product of two arrays of \c n values.
+     */
+    double (*dotProduct)(const double* lhs, const double* rhs, const Size n);
+
+    /** The instruction set the kernels use.
+     */
+    InstructionSet::Level level;
+
+    /** @return The kernels for the best instruction set of the host.
+     */
+    static const ProfileKernels& get();
+
+    /** @return The kernels for \c level, or for the best supported level
+     *          below it if the host does not support \c level.
+     */
+    static const ProfileKernels& get(const InstructionSet::Level level);
+};
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_PROFILEKERNELS_HPP__ */
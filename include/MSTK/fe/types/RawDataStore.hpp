@@ -0,0 +1,179 @@
+/*
+ * RawDataStore.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_RAWDATASTORE_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_RAWDATASTORE_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/ColumnarSpectrum.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumView.hpp>
+#include <limits>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** Reference to a contiguous range of raw data points in a \c RawDataStore.
+ */
+struct RawDataHandle
+{
+    /** Default constructor. Constructs an invalid handle that does not
+     * reference any raw data.
+     */
+    RawDataHandle() :
+        scanIndex(std::numeric_limits<UnsignedInt>::max()), offset(0),
+                length(0)
+    {
+    }
+
+    /** Constructor.
+     * @param[in] si The index of the scan in the raw data store.
+     * @param[in] o The offset of the first raw data point in the scan.
+     * @param[in] l The number of raw data points.
+     */
+    RawDataHandle(const UnsignedInt si, const UnsignedInt o,
+        const UnsignedInt l) :
+        scanIndex(si), offset(o), length(l)
+    {
+    }
+
+    /** @return True if the handle references a scan.
+     */
+    bool isValid() const
+    {
+        return scanIndex != std::numeric_limits<UnsignedInt>::max();
+    }
+
+    bool operator==(const RawDataHandle& rhs) const
+    {
+        return scanIndex == rhs.scanIndex && offset == rhs.offset
+                && length == rhs.length;
+    }
+
+    UnsignedInt scanIndex;
+    UnsignedInt offset;
+    UnsignedInt length;
+};
+
+/** A shared store for the raw (profile) data of a run.
+ *
+ * The store keeps the raw data points of all scans in two contiguous
+ * columns; scans are identified by the index in which they have been added.
+ * Centroid types that do not own their raw data (see \c CompactCentroid)
+ * reference it through a \c RawDataHandle, so the raw data of a run is held
+ * in memory exactly once.
+ */
+class MSTK_EXPORT RawDataStore
+{
+public:
+    typedef ColumnarSpectrum::Column Column;
+
+    /** Default constructor. Constructs an empty store.
+     */
+    RawDataStore();
+
+    /** Add the raw data of a scan to the store.
+     * @param[in] first Iterator to the first element of the scan; must
+     *                  dereference to a \c SpectrumElement.
+     * @param[in] last Iterator past the last element of the scan.
+     * @return The index of the scan in the store.
+     */
+    template<typename InputIterator>
+    UnsignedInt addScan(InputIterator first, InputIterator last);
+
+    /** @return A view onto the raw data of the scan with index \c scanIndex.
+     *          The view is invalidated when a scan is added to the store.
+     * @throw mstk::PreconditionViolation if the index is out of range.
+     */
+    SpectrumView getScan(const UnsignedInt scanIndex) const;
+
+    /** @return A view onto the raw data referenced by \c h. The view is
+     *          empty if \c h is invalid. It is invalidated when a scan is
+     *          added to the store.
+     * @throw mstk::PreconditionViolation if the handle exceeds the scan.
+     */
+    SpectrumView get(const RawDataHandle& h) const;
+
+    /** @return The number of scans in the store.
+     */
+    Size size() const;
+
+    /** @return True if the store does not hold any scans.
+     */
+    bool empty() const;
+
+    /** @return The number of raw data points over all scans.
+     */
+    Size getNumberOfPoints() const;
+
+    /** Reserve memory.
+     * @param[in] nScans The expected number of scans.
+     * @param[in] nPoints The expected number of raw data points.
+     */
+    void reserve(const Size nScans, const Size nPoints);
+
+    /** Remove all scans from the store.
+     */
+    void clear();
+
+private:
+    /** The m/z values of all scans.
+     */
+    Column mz_;
+
+    /** The abundance values of all scans.
+     */
+    Column ab_;
+
+    /** The offset of every scan in the columns, plus the total number of
+     * points as the final entry.
+     */
+    std::vector<Size> offsets_;
+};
+
+//
+// template implementation
+//
+
+template<typename InputIterator>
+UnsignedInt RawDataStore::addScan(InputIterator first, InputIterator last)
+{
+    for (; first != last; ++first) {
+        SpectrumElement e = *first;
+        mz_.push_back(e.mz);
+        ab_.push_back(e.abundance);
+    }
+    offsets_.push_back(ab_.size());
+    return static_cast<UnsignedInt> (offsets_.size() - 2);
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_RAWDATASTORE_HPP__ */
@@ -0,0 +1,424 @@
+/*
+ * ScanTable.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_SCANTABLE_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_SCANTABLE_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** The scans of a run as a metadata table plus separate peak storage.
+ *
+ * Each row holds the metadata of one \c Spectrum (retention time, MS level,
+ * scan number, TIC and precursor information) in one column per field. The
+ * peaks of all scans live in a single contiguous buffer; a row only refers
+ * to its peaks by offset and count. Sorting and partitioning the table
+ * therefore permutes the metadata columns and never moves peak data.
+ *
+ * Rows are accessed through the lightweight \c ScanTable::Row proxy, which
+ * offers the metadata getters of \c Spectrum. The \c Spectrum comparators
+ * \c LessThanRt, \c LessThanMsLevel and \c EqualMsLevel accept rows, i.e.
+ *
+ * \code
+ * table.sort(Spectrum::LessThanRt<ScanTable::Row, ScanTable::Row>());
+ * Size nMs1 = table.partition(Spectrum::EqualMsLevel(1));
+ * \endcode
+ *
+ * Scan numbers are looked up in a hash index in O(1). Retention time range
+ * queries use binary search and require the table to be sorted by
+ * retention time, which is the case for scans added in acquisition order.
+ */
+class MSTK_EXPORT ScanTable
+{
+public:
+    /** A reference to a row of a \c ScanTable. Rows are invalidated by all
+     * operations that add, sort or partition rows.
+     */
+    class Row
+    {
+    public:
+        Row(const ScanTable& table, const Size index);
+
+        /** @return The index of the row in the table.
+         */
+        Size getIndex() const;
+        double getRetentionTime() const;
+        unsigned int getMsLevel() const;
+        unsigned int getScanNumber() const;
+        double getTotalIonCurrent() const;
+        unsigned int getPrecursorScanNumber() const;
+        double getPrecursorMz() const;
+        int getPrecursorCharge() const;
+        double getPrecursorAbundance() const;
+
+        /** @return The number of peaks of the scan.
+         */
+        Size getNumberOfPeaks() const;
+
+        /** @return The peaks of the scan; no data is copied.
+         */
+        SpectrumRange getPeaks() const;
+
+        /** @return A copy of the scan as a \c Spectrum, including all
+         *          metadata.
+         */
+        Spectrum toSpectrum() const;
+
+    private:
+        const ScanTable* table_;
+        Size index_;
+    };
+
+    /** Returned by lookups that do not find a row.
+     */
+    static const Size npos;
+
+    /** Constructs an empty table.
+     */
+    ScanTable();
+
+    /** Reserve space for \c nScans rows and \c nPeaks peaks in total.
+     */
+    void reserve(const Size nScans, const Size nPeaks);
+
+    /** Append a spectrum as a new row. The peaks are copied into the peak
+     * storage of the table.
+     * @return The index of the new row.
+     */
+    Size add(const Spectrum& s);
+
+    /** Remove all rows and peaks.
+     */
+    void clear();
+
+    /** @return The number of rows.
+     */
+    Size size() const;
+
+    bool empty() const;
+
+    /** @return The number of peaks of all scans.
+     */
+    Size getNumberOfPeaks() const;
+
+    /** @return The row at \c index.
+     */
+    Row operator[](const Size index) const;
+
+    /** Find a scan by its scan number in O(1).
+     * @return The index of the row or \c npos. If several rows share the
+     *         scan number, the first of them is returned.
+     */
+    Size findScanNumber(const unsigned int scanNumber) const;
+
+    /** @return true if the rows are sorted by retention time.
+     */
+    bool isSortedByRetentionTime() const;
+
+    /** Find the rows with a retention time in [beginRt, endRt] by binary
+     * search.
+     * @return The row index range [first, second).
+     * @throw mstk::PreconditionViolation if the rows are not sorted by
+     *        retention time.
+     */
+    std::pair<Size, Size> findRetentionTimeRange(const double beginRt,
+        const double endRt) const;
+
+    /** Stable sort of the rows; peak data is not moved.
+     * @param[in] comp A strict weak ordering on \c Row objects, e.g.
+     *            \c Spectrum::LessThanRt<ScanTable::Row, ScanTable::Row>.
+     */
+    template<typename Compare>
+    void sort(Compare comp);
+
+    /** Stable partition of the rows such that all rows that satisfy
+     * \c pred come first; peak data is not moved.
+     * @param[in] pred A predicate on \c Row objects, e.g.
+     *            \c Spectrum::EqualMsLevel.
+     * @return The number of rows that satisfy \c pred.
+     */
+    template<typename Predicate>
+    Size partition(Predicate pred);
+
+    /** Direct access to the metadata columns.
+     */
+    const std::vector<double>& getRetentionTimes() const;
+    const std::vector<unsigned int>& getMsLevels() const;
+    const std::vector<unsigned int>& getScanNumbers() const;
+
+private:
+    /** Reorder all metadata columns such that row \c i holds the former
+     * row \c order[i].
+     */
+    void permute(const std::vector<Size>& order);
+
+    /** Rebuild the scan number index and the retention time order flag.
+     */
+    void reindex();
+
+    template<typename Compare>
+    struct RowIndexLess
+    {
+        const ScanTable& table;
+        Compare& comp;
+        RowIndexLess(const ScanTable& t, Compare& c) :
+            table(t), comp(c)
+        {
+        }
+        bool operator()(const Size lhs, const Size rhs) const
+        {
+            return comp(table[lhs], table[rhs]);
+        }
+    };
+
+    std::vector<double> rt_;
+    std::vector<unsigned int> msLevel_;
+    std::vector<unsigned int> scanNumber_;
+    std::vector<double> totalIonCurrent_;
+    std::vector<unsigned int> precursorScanNumber_;
+    std::vector<double> precursorMz_;
+    std::vector<int> precursorCharge_;
+    std::vector<double> precursorAbundance_;
+    /** Position and number of the peaks of each row in \c peaks_.
+     */
+    std::vector<Size> peakOffset_;
+    std::vector<Size> peakCount_;
+    std::vector<SpectrumElement> peaks_;
+    std::unordered_map<unsigned int, Size> scanNumberIndex_;
+    bool sortedByRt_;
+};
+
+///
+/// comparator support
+///
+
+template<>
+struct Spectrum::LessThanRt<ScanTable::Row, ScanTable::Row> :
+        std::binary_function<ScanTable::Row, ScanTable::Row, bool>
+{
+    bool operator()(const ScanTable::Row& lhs, const ScanTable::Row& rhs) const
+    {
+        return lhs.getRetentionTime() < rhs.getRetentionTime();
+    }
+};
+
+template<>
+struct Spectrum::LessThanRt<ScanTable::Row, double> : std::binary_function<
+        ScanTable::Row, double, bool>
+{
+    bool operator()(const ScanTable::Row& lhs, const double& rhs) const
+    {
+        return lhs.getRetentionTime() < rhs;
+    }
+};
+
+template<>
+struct Spectrum::LessThanRt<double, ScanTable::Row> : std::binary_function<
+        double, ScanTable::Row, bool>
+{
+    bool operator()(const double& lhs, const ScanTable::Row& rhs) const
+    {
+        return lhs < rhs.getRetentionTime();
+    }
+};
+
+template<>
+struct Spectrum::LessThanMsLevel<ScanTable::Row, ScanTable::Row> :
+        std::binary_function<ScanTable::Row, ScanTable::Row, bool>
+{
+    bool operator()(const ScanTable::Row& lhs, const ScanTable::Row& rhs) const
+    {
+        return lhs.getMsLevel() < rhs.getMsLevel();
+    }
+};
+
+template<>
+struct Spectrum::LessThanMsLevel<ScanTable::Row, double> :
+        std::binary_function<ScanTable::Row, double, bool>
+{
+    bool operator()(const ScanTable::Row& lhs, const double& rhs) const
+    {
+        return lhs.getMsLevel() < rhs;
+    }
+};
+
+template<>
+struct Spectrum::LessThanMsLevel<double, ScanTable::Row> :
+        std::binary_function<double, ScanTable::Row, bool>
+{
+    bool operator()(const double& lhs, const ScanTable::Row& rhs) const
+    {
+        return lhs < rhs.getMsLevel();
+    }
+};
+
+///
+/// inline functions
+///
+
+inline ScanTable::Row::Row(const ScanTable& table, const Size index) :
+    table_(&table), index_(index)
+{
+}
+
+inline Size ScanTable::Row::getIndex() const
+{
+    return index_;
+}
+
+inline double ScanTable::Row::getRetentionTime() const
+{
+    return table_->rt_[index_];
+}
+
+inline unsigned int ScanTable::Row::getMsLevel() const
+{
+    return table_->msLevel_[index_];
+}
+
+inline unsigned int ScanTable::Row::getScanNumber() const
+{
+    return table_->scanNumber_[index_];
+}
+
+inline double ScanTable::Row::getTotalIonCurrent() const
+{
+    return table_->totalIonCurrent_[index_];
+}
+
+inline unsigned int ScanTable::Row::getPrecursorScanNumber() const
+{
+    return table_->precursorScanNumber_[index_];
+}
+
+inline double ScanTable::Row::getPrecursorMz() const
+{
+    return table_->precursorMz_[index_];
+}
+
+inline int ScanTable::Row::getPrecursorCharge() const
+{
+    return table_->precursorCharge_[index_];
+}
+
+inline double ScanTable::Row::getPrecursorAbundance() const
+{
+    return table_->precursorAbundance_[index_];
+}
+
+inline Size ScanTable::Row::getNumberOfPeaks() const
+{
+    return table_->peakCount_[index_];
+}
+
+inline Size ScanTable::size() const
+{
+    return rt_.size();
+}
+
+inline bool ScanTable::empty() const
+{
+    return rt_.empty();
+}
+
+inline Size ScanTable::getNumberOfPeaks() const
+{
+    return peaks_.size();
+}
+
+inline ScanTable::Row ScanTable::operator[](const Size index) const
+{
+    return Row(*this, index);
+}
+
+inline bool ScanTable::isSortedByRetentionTime() const
+{
+    return sortedByRt_;
+}
+
+inline const std::vector<double>& ScanTable::getRetentionTimes() const
+{
+    return rt_;
+}
+
+inline const std::vector<unsigned int>& ScanTable::getMsLevels() const
+{
+    return msLevel_;
+}
+
+inline const std::vector<unsigned int>& ScanTable::getScanNumbers() const
+{
+    return scanNumber_;
+}
+
+template<typename Compare>
+void ScanTable::sort(Compare comp)
+{
+    std::vector<Size> order(size());
+    for (Size i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        RowIndexLess<Compare> (*this, comp));
+    permute(order);
+}
+
+template<typename Predicate>
+Size ScanTable::partition(Predicate pred)
+{
+    std::vector<char> selected(size());
+    std::vector<Size> order;
+    order.reserve(size());
+    for (Size i = 0; i < size(); ++i) {
+        selected[i] = pred((*this)[i]);
+        if (selected[i]) {
+            order.push_back(i);
+        }
+    }
+    const Size n = order.size();
+    for (Size i = 0; i < size(); ++i) {
+        if (!selected[i]) {
+            order.push_back(i);
+        }
+    }
+    permute(order);
+    return n;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_SCANTABLE_HPP__ */
@@ -28,11 +28,12 @@
 #define __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUM_HPP__
 #include <MSTK/config.hpp>
 
-#include <MSTK/common/Collection.hpp>
+#include <MSTK/common/StaticCollection.hpp>
 #include <algorithm>
 #include <functional>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace mstk {
@@ -49,6 +50,9 @@ struct SpectrumElement
 
     struct MzAccessor
     {
+        // for use with the psf extractor interface
+        typedef double result_type;
+        typedef SpectrumElement element_type;
         double operator()(const SpectrumElement& e) const
         {
             return e.mz;
@@ -57,6 +61,9 @@ struct SpectrumElement
 
     struct AbundanceAccessor
     {
+        // for use with the psf extractor interface
+        typedef double result_type;
+        typedef SpectrumElement element_type;
         double operator()(const SpectrumElement& e) const
         {
             return e.abundance;
@@ -89,7 +96,8 @@ struct SpectrumElement
 /**
  * A sparse representation of a mass spectrum.
  */
-class MSTK_EXPORT Spectrum : public Collection<SpectrumElement>
+class MSTK_EXPORT Spectrum : public StaticCollection<Spectrum,
+        SpectrumElement>
 {
 public:
     typedef SpectrumElement Element;
@@ -148,6 +156,12 @@ public:
         {
             return msLevel_ == s.msLevel_;
         }
+        // for other scan types, e.g. ScanTable::Row
+        template<class S>
+        bool operator()(const S& s) const
+        {
+            return msLevel_ == s.getMsLevel();
+        }
         unsigned int msLevel_;
     };
 
@@ -193,6 +207,15 @@ public:
      */
     Spectrum(const_iterator first, const_iterator last);
 
+    /** Copy constructor.
+     */
+    Spectrum(const Spectrum& rhs);
+
+    /** Move constructor. Takes over the peaks of \c rhs and copies its
+     * metadata; \c rhs is left without peaks but keeps its metadata.
+     */
+    Spectrum(Spectrum&& rhs) noexcept;
+
     /** Destructor.
      */
     ~Spectrum();
@@ -201,6 +224,11 @@ public:
      */
     Spectrum& operator=(const Spectrum& rhs);
 
+    /** Move assignment operator. Takes over the peaks of \c rhs and copies its
+     * metadata; \c rhs is left without peaks but keeps its metadata.
+     */
+    Spectrum& operator=(Spectrum&& rhs) noexcept;
+
     /** Test if two @Spectrum object are equal.
      */
     bool operator==(const Spectrum& s) const;
@@ -243,33 +271,63 @@ public:
     double getPrecursorAbundance() const;
 
     /** Get an iterator pointing at the maximum abundance peak.
-     *   @return Iterator to the maximum abundance element
+     *   @return Iterator to the (first) maximum abundance element
+     *   @see SpectrumKernels
      */
     iterator getMaxAbundancePeak();
 
     /** Get an iterator pointing at the maximum abundance peak.
-     *   @return Iterator to the maximum abundance element
+     *   @return Iterator to the (first) maximum abundance element
+     *   @see SpectrumKernels
      */
     const_iterator getMaxAbundancePeak() const;
 
     /** Get the sum over all abundances. This does *not* triangulate.
      *   @return The accumulated abundance.
+     *   @see SpectrumKernels for the summation order.
      */
-    double getTotalAbundance();
+    double getTotalAbundance() const;
 
     /** Merges two Spectrum objects.
      *   @param Spectrum instance to merge with.
      *   @pre Requires the current instance and the merge instance to be sorted.
      *
      * This merges two SparseSpectra, combining their abundances if
-     * they exhibit identical masses.
+     * they exhibit identical masses. The merge runs in linear time; use
+     * \c mergeSpectra() to combine many spectra at once.
      */
     void merge(const Spectrum& ss);
 
+    /** Units of an m/z tolerance.
+     */
+    enum ToleranceUnit
+    {
+        TOLERANCE_DA, TOLERANCE_PPM
+    };
+
     /** Remove duplicate m/z entries with tolerance.
      *   Add up the abundances
+     *   @return A copy of the spectrum (including its metadata) without
+     *           duplicates; see \c compactDuplicates().
+     */
+    Spectrum removeDuplicates(double tol = 0.0016) const;
+
+    /** Remove duplicate m/z entries in place.
+     *
+     * Starting with the lowest m/z, all subsequent peaks whose m/z is less
+     * than \c tol above the first peak of their group are combined into a
+     * single peak with the summed abundance and the abundance-weighted mean
+     * m/z. The existing buffer is reused and the metadata is kept. Spectra
+     * without duplicates are detected in a single branch-free pass and
+     * left untouched.
+     *   @param tol The tolerance.
+     *   @param unit The unit of \c tol; ppm tolerances are relative to the
+     *          m/z of the first peak of a group.
+     *   @return The number of removed peaks.
+     *   @pre The spectrum must be sorted by m/z.
      */
-    Spectrum removeDuplicates(double tol = 0.0016);
+    size_type compactDuplicates(const double tol = 0.0016,
+        const ToleranceUnit unit = TOLERANCE_DA);
 
     /** Splice a Spectrum into two spectra.
      *   @param first Iterator to first Spectrum::Element that is
@@ -282,10 +340,11 @@ public:
     template<typename Out>
     void splice(const iterator first, const iterator last, Out out);
 
-    /** @return the Spectrum containing the m/z range [beginMz, endMz)
+    /** @return the Spectrum containing the m/z range [beginMz, endMz]
      *  @param beginMz The lower bound of mz range
      *  @param endMz The upper bound of mz range
      *  @return A new Spectrum object
+     *  @see SpectrumRangeIndex for repeated queries without copies.
      */
     Spectrum subset(const double beginMz, const double endMz) const;
 
@@ -293,6 +352,19 @@ public:
     void shiftBy(const double diff);
     void shiftMaxToMonoisotopicMass();
 
+    /** Recalibrate the m/z values: mz' = mz * scale + offset.
+     */
+    void transformMz(const double scale, const double offset);
+
+    /** Multiply all abundances by \c factor.
+     */
+    void scaleAbundances(const double factor);
+
+    /** Scale the abundances such that the maximum abundance peak has
+     * abundance \c to. Spectra without positive abundances are not changed.
+     */
+    void normalizeAbundances(const double to = 1.0);
+
 private:
     double rt_;
     unsigned int msLevel_;
@@ -311,6 +383,37 @@ MSTK_EXPORT std::ostream
 MSTK_EXPORT std::ostream& operator<<(std::ostream& os,
     Spectrum::Element& e);
 
+/** A range of spectrum elements.
+ */
+typedef std::pair<Spectrum::const_iterator, Spectrum::const_iterator>
+        SpectrumRange;
+
+/** Merge any number of m/z-sorted spectra in a single pass.
+ *
+ * The peaks of all spectra are merged through a binary heap, i.e. in
+ * O(n log k) for k spectra with n peaks in total, and written into a
+ * pre-sized result. Consecutive peaks (in merged order) whose m/z lies
+ * within \c mzTolerance of the first peak of their group are combined into
+ * a single peak with the summed abundance and the abundance-weighted mean
+ * m/z (cf. \c Spectrum::removeDuplicates()). With the default tolerance of
+ * zero, only peaks of identical m/z are combined, as in
+ * \c Spectrum::merge().
+ *
+ * @param[in] first Iterator to the first spectrum.
+ * @param[in] last Iterator past the last spectrum.
+ * @param[in] mzTolerance The m/z tolerance for combining peaks.
+ * @return The merged spectrum; its metadata is default-initialized.
+ * @pre All spectra must be sorted by m/z.
+ */
+template<typename InputIterator>
+Spectrum mergeSpectra(InputIterator first, InputIterator last,
+    const double mzTolerance = 0.0);
+
+/** Merge the m/z-sorted element ranges \c ranges; see \c mergeSpectra().
+ */
+MSTK_EXPORT Spectrum mergeSpectrumRanges(
+    const std::vector<SpectrumRange>& ranges, const double mzTolerance = 0.0);
+
 ///
 /// inline functions
 ///
@@ -567,6 +670,18 @@ void Spectrum::splice(const iterator first, const iterator last, Out out)
     c_.erase(first, last);
 }
 
+template<typename InputIterator>
+Spectrum mergeSpectra(InputIterator first, InputIterator last,
+    const double mzTolerance)
+{
+    std::vector<SpectrumRange> ranges;
+    for (; first != last; ++first) {
+        const Spectrum& s = *first;
+        ranges.push_back(SpectrumRange(s.begin(), s.end()));
+    }
+    return mergeSpectrumRanges(ranges, mzTolerance);
+}
+
 } /* namespace fe */
 
 } /* namespace mstk */
@@ -0,0 +1,98 @@
+/*
+ * SpectrumKernels.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMKERNELS_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMKERNELS_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/InstructionSet.hpp>
+#include <MSTK/common/Types.hpp>
+
+namespace mstk {
+
+namespace fe {
+
+struct SpectrumElement;
+
+/** Vectorized kernels for the per-scan reductions and transforms of a
+ * \c Spectrum.
+ *
+ * The kernels operate on contiguous (m/z, abundance) pairs, i.e. directly
+ * on the storage of a \c Spectrum. The reductions have scalar, AVX2 and
+ * AVX-512 implementations; \c get() returns the best ones the host
+ * supports. The transforms are limited by memory bandwidth and use the
+ * (compiler-vectorized) scalar loops on all levels.
+ *
+ * All implementations of a kernel produce bitwise identical results:
+ * - \c sumAbundances accumulates into eight partial sums (element \c i goes
+ *   to sum <tt>i % 8</tt>) that are added pairwise at the end. The result
+ *   may therefore differ from a sequential sum in the last bits.
+ * - \c findMaxAbundance returns the index of the first maximum, as
+ *   \c std::max_element. The abundances must not be NaN.
+ * - \c transformMz computes <tt>mz * scale + offset</tt> and
+ *   \c scaleAbundances <tt>abundance * factor</tt>; the respective other
+ *   column is not touched.
+ */
+struct MSTK_EXPORT SpectrumKernels
+{
+    /** @return The sum over the abundances of \c n elements.
+     */
+    double (*sumAbundances)(const SpectrumElement* first, const Size n);
+
+    /** @return The index of the first element with the maximum abundance
+     *          or \c n if \c n is 0.
+     */
+    Size (*findMaxAbundance)(const SpectrumElement* first, const Size n);
+
+    /** Applies the affine transform <tt>mz * scale + offset</tt> to the m/z
+     * values of \c n elements.
+     */
+    void (*transformMz)(SpectrumElement* first, const Size n,
+        const double scale, const double offset);
+
+    /** Multiplies the abundances of \c n elements by \c factor.
+     */
+    void (*scaleAbundances)(SpectrumElement* first, const Size n,
+        const double factor);
+
+    /** The instruction set the kernels use.
+     */
+    InstructionSet::Level level;
+
+    /** @return The kernels for the best instruction set of the host.
+     */
+    static const SpectrumKernels& get();
+
+    /** @return The kernels for \c level, or for the best supported level
+     *          below it if the host does not support \c level.
+     */
+    static const SpectrumKernels& get(const InstructionSet::Level level);
+};
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMKERNELS_HPP__ */
@@ -0,0 +1,214 @@
+/*
+ * SpectrumRangeIndex.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMRANGEINDEX_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMRANGEINDEX_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** An m/z range query index on a sorted \c Spectrum.
+ *
+ * The index answers the same m/z window queries as \c Spectrum::subset(),
+ * but returns the selected elements as a \c SpectrumRange into the indexed
+ * spectrum instead of copying them. The summed abundance in a window is
+ * answered from a prefix sum over the abundances, i.e. in O(log n) per
+ * window. The prefix sums are built on the first abundance query (or by
+ * \c buildAbundanceIndex()), so pure range queries do not pay for them.
+ *
+ * Many windows are best answered in one call to \c getRanges() or
+ * \c getAbundances(): with the windows sorted by their lower bound, the
+ * spectrum is swept once and each bound is found by a galloping search
+ * from the previous position.
+ *
+ * The index keeps a reference to the spectrum. It is invalidated by all
+ * operations that modify the spectrum.
+ */
+class MSTK_EXPORT SpectrumRangeIndex
+{
+public:
+    typedef Spectrum::const_iterator const_iterator;
+    /** An m/z window; both bounds are included, as in
+     * \c Spectrum::subset().
+     */
+    typedef std::pair<double, double> MzWindow;
+
+    /** Constructs an index on a spectrum. This does not touch the
+     * spectrum data.
+     * @param[in] s The spectrum; must outlive the index.
+     * @pre The spectrum must be sorted by m/z.
+     */
+    explicit SpectrumRangeIndex(const Spectrum& s);
+
+    /** @return The indexed spectrum.
+     */
+    const Spectrum& getSpectrum() const;
+
+    /** Get the elements in [beginMz, endMz] without copying them.
+     * @param[in] beginMz The lower bound of the m/z range.
+     * @param[in] endMz The upper bound of the m/z range.
+     * @return The range of elements \c Spectrum::subset() would copy.
+     */
+    SpectrumRange getRange(const double beginMz, const double endMz) const;
+
+    /** Get the summed abundance in [beginMz, endMz] in O(log n).
+     * @param[in] beginMz The lower bound of the m/z range.
+     * @param[in] endMz The upper bound of the m/z range.
+     * @return The total abundance in the window.
+     */
+    double getAbundance(const double beginMz, const double endMz) const;
+
+    /** Get the summed abundance of a range of the indexed spectrum in O(1).
+     * @param[in] r A range of elements of the indexed spectrum.
+     * @return The total abundance of the range.
+     */
+    double getAbundance(const SpectrumRange& r) const;
+
+    /** Answer many m/z windows in a single sweep over the spectrum.
+     * @param[in] first Iterator to the first \c MzWindow.
+     * @param[in] last Iterator past the last \c MzWindow.
+     * @param[out] out Receives one \c SpectrumRange per window.
+     * @return The output iterator past the last written range.
+     * @throw mstk::PreconditionViolation if the windows are not sorted by
+     *        their lower bound.
+     */
+    template<typename InputIterator, typename OutputIterator>
+    OutputIterator getRanges(InputIterator first, InputIterator last,
+        OutputIterator out) const;
+
+    /** Get the summed abundances of many m/z windows in a single sweep
+     * over the spectrum.
+     * @param[in] first Iterator to the first \c MzWindow.
+     * @param[in] last Iterator past the last \c MzWindow.
+     * @param[out] out Receives one total abundance per window.
+     * @return The output iterator past the last written value.
+     * @throw mstk::PreconditionViolation if the windows are not sorted by
+     *        their lower bound.
+     */
+    template<typename InputIterator, typename OutputIterator>
+    OutputIterator getAbundances(InputIterator first, InputIterator last,
+        OutputIterator out) const;
+
+    /** Build the abundance prefix sums now. Building the index is not
+     * thread-safe; call this before sharing the index between threads.
+     */
+    void buildAbundanceIndex() const;
+
+    /** @return true if the abundance prefix sums have been built.
+     */
+    bool hasAbundanceIndex() const;
+
+private:
+    /** A lower bound search for \c mz that gallops forward from \c from.
+     * @pre All elements before \c from have an m/z less than \c mz.
+     */
+    Size lowerBound(const double mz, const Size from) const;
+
+    /** An upper bound search for \c mz that gallops forward from \c from.
+     * @pre All elements before \c from have an m/z not greater than \c mz.
+     */
+    Size upperBound(const double mz, const Size from) const;
+
+    /** The abundance sum over [first, last).
+     */
+    double sum(const Size first, const Size last) const;
+
+    const Spectrum* spectrum_;
+    /** prefix_[i] holds the total abundance of the first i elements.
+     */
+    mutable std::vector<double> prefix_;
+};
+
+///
+/// inline functions
+///
+
+inline const Spectrum& SpectrumRangeIndex::getSpectrum() const
+{
+    return *spectrum_;
+}
+
+inline bool SpectrumRangeIndex::hasAbundanceIndex() const
+{
+    return !prefix_.empty();
+}
+
+inline double SpectrumRangeIndex::sum(const Size first, const Size last) const
+{
+    if (prefix_.empty()) {
+        buildAbundanceIndex();
+    }
+    return prefix_[last] - prefix_[first];
+}
+
+template<typename InputIterator, typename OutputIterator>
+OutputIterator SpectrumRangeIndex::getRanges(InputIterator first,
+    InputIterator last, OutputIterator out) const
+{
+    const const_iterator b = spectrum_->begin();
+    double previousMz = -std::numeric_limits<double>::infinity();
+    Size lo = 0;
+    for (; first != last; ++first, ++out) {
+        const MzWindow& w = *first;
+        mstk_precondition(w.first >= previousMz,
+            "SpectrumRangeIndex::getRanges(): windows must be sorted by their lower bound.");
+        previousMz = w.first;
+        lo = lowerBound(w.first, lo);
+        *out = SpectrumRange(b + lo, b + upperBound(w.second, lo));
+    }
+    return out;
+}
+
+template<typename InputIterator, typename OutputIterator>
+OutputIterator SpectrumRangeIndex::getAbundances(InputIterator first,
+    InputIterator last, OutputIterator out) const
+{
+    double previousMz = -std::numeric_limits<double>::infinity();
+    Size lo = 0;
+    for (; first != last; ++first, ++out) {
+        const MzWindow& w = *first;
+        mstk_precondition(w.first >= previousMz,
+            "SpectrumRangeIndex::getAbundances(): windows must be sorted by their lower bound.");
+        previousMz = w.first;
+        lo = lowerBound(w.first, lo);
+        *out = sum(lo, upperBound(w.second, lo));
+    }
+    return out;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMRANGEINDEX_HPP__ */
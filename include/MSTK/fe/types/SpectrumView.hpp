@@ -0,0 +1,350 @@
+/*
+ * SpectrumView.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMVIEW_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMVIEW_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace mstk {
+
+namespace fe {
+
+/** A non-owning, structure-of-arrays view onto a mass spectrum.
+ *
+ * The view references two contiguous arrays that hold the m/z and the
+ * abundance values of the spectrum. Dereferencing a view iterator yields a
+ * \c SpectrumElement by value, so all algorithms that access spectrum
+ * elements through \c SpectrumValueTraits (\c Centroider, \c Splitter, the
+ * psf algorithms, ...) run on the view unchanged. Because the columns are
+ * separate, abundance-only passes touch only the abundance array and can be
+ * vectorized by the compiler.
+ *
+ * The view does not manage the lifetime of the underlying data; see
+ * \c ColumnarSpectrum for an owning container.
+ */
+class SpectrumView
+{
+public:
+    typedef SpectrumElement Element;
+    // for use with SpectrumTraits<T>:
+    typedef SpectrumElement Value;
+    typedef SpectrumElement value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    /** Random access iterator over a \c SpectrumView. The iterator walks
+     * the m/z and abundance columns in lock-step and returns the
+     * corresponding \c SpectrumElement by value.
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef SpectrumElement value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const SpectrumElement* pointer;
+        typedef SpectrumElement reference;
+
+        const_iterator() :
+            mz_(0), ab_(0)
+        {
+        }
+
+        const_iterator(const double* mz, const double* ab) :
+            mz_(mz), ab_(ab)
+        {
+        }
+
+        SpectrumElement operator*() const
+        {
+            return SpectrumElement(*mz_, *ab_);
+        }
+
+        SpectrumElement operator[](difference_type n) const
+        {
+            return SpectrumElement(mz_[n], ab_[n]);
+        }
+
+        /** Direct access to the m/z value at the current position.
+         */
+        double mz() const
+        {
+            return *mz_;
+        }
+
+        /** Direct access to the abundance value at the current position.
+         */
+        double abundance() const
+        {
+            return *ab_;
+        }
+
+        const_iterator& operator++()
+        {
+            ++mz_;
+            ++ab_;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        const_iterator& operator--()
+        {
+            --mz_;
+            --ab_;
+            return *this;
+        }
+
+        const_iterator operator--(int)
+        {
+            const_iterator tmp(*this);
+            --(*this);
+            return tmp;
+        }
+
+        const_iterator& operator+=(difference_type n)
+        {
+            mz_ += n;
+            ab_ += n;
+            return *this;
+        }
+
+        const_iterator& operator-=(difference_type n)
+        {
+            mz_ -= n;
+            ab_ -= n;
+            return *this;
+        }
+
+        const_iterator operator+(difference_type n) const
+        {
+            return const_iterator(mz_ + n, ab_ + n);
+        }
+
+        const_iterator operator-(difference_type n) const
+        {
+            return const_iterator(mz_ - n, ab_ - n);
+        }
+
+        difference_type operator-(const const_iterator& rhs) const
+        {
+            return ab_ - rhs.ab_;
+        }
+
+        bool operator==(const const_iterator& rhs) const
+        {
+            return ab_ == rhs.ab_;
+        }
+
+        bool operator!=(const const_iterator& rhs) const
+        {
+            return ab_ != rhs.ab_;
+        }
+
+        bool operator<(const const_iterator& rhs) const
+        {
+            return ab_ < rhs.ab_;
+        }
+
+        bool operator>(const const_iterator& rhs) const
+        {
+            return ab_ > rhs.ab_;
+        }
+
+        bool operator<=(const const_iterator& rhs) const
+        {
+            return ab_ <= rhs.ab_;
+        }
+
+        bool operator>=(const const_iterator& rhs) const
+        {
+            return ab_ >= rhs.ab_;
+        }
+
+    private:
+        const double* mz_;
+        const double* ab_;
+    };
+
+    typedef const_iterator iterator;
+
+    /** Default constructor. Constructs an empty view.
+     */
+    SpectrumView();
+
+    /** Constructs a view onto \c n elements stored in two columns.
+     * @param[in] mz Pointer to the first m/z value.
+     * @param[in] abundance Pointer to the first abundance value.
+     * @param[in] n The number of elements in both columns.
+     */
+    SpectrumView(const double* mz, const double* abundance, size_type n);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_type size() const;
+    bool empty() const;
+    SpectrumElement operator[](size_type pos) const;
+
+    /** @return A pointer to the contiguous m/z column.
+     */
+    const double* mzData() const;
+
+    /** @return A pointer to the contiguous abundance column.
+     */
+    const double* abundanceData() const;
+
+    /** Get the sum over all abundances. This does *not* triangulate.
+     * @return The accumulated abundance.
+     */
+    double getTotalAbundance() const;
+
+    /** Get an iterator pointing at the (first) maximum abundance peak.
+     * @return Iterator to the maximum abundance element or \c end() if the
+     *         view is empty.
+     */
+    const_iterator getMaxAbundancePeak() const;
+
+    /** @return A view on the m/z range selected by \c Spectrum::subset()
+     *          (both bounds included). No data is copied.
+     * @param beginMz The lower bound of the m/z range.
+     * @param endMz The upper bound of the m/z range.
+     * @pre The view must be sorted by m/z.
+     */
+    SpectrumView subset(const double beginMz, const double endMz) const;
+
+private:
+    const double* mz_;
+    const double* ab_;
+    size_type size_;
+};
+
+///
+/// inline functions
+///
+
+inline SpectrumView::SpectrumView() :
+    mz_(0), ab_(0), size_(0)
+{
+}
+
+inline SpectrumView::SpectrumView(const double* mz, const double* abundance,
+    size_type n) :
+    mz_(mz), ab_(abundance), size_(n)
+{
+}
+
+inline SpectrumView::const_iterator SpectrumView::begin() const
+{
+    return const_iterator(mz_, ab_);
+}
+
+inline SpectrumView::const_iterator SpectrumView::end() const
+{
+    return const_iterator(mz_ + size_, ab_ + size_);
+}
+
+inline SpectrumView::size_type SpectrumView::size() const
+{
+    return size_;
+}
+
+inline bool SpectrumView::empty() const
+{
+    return size_ == 0;
+}
+
+inline SpectrumElement SpectrumView::operator[](size_type pos) const
+{
+    return SpectrumElement(mz_[pos], ab_[pos]);
+}
+
+inline const double* SpectrumView::mzData() const
+{
+    return mz_;
+}
+
+inline const double* SpectrumView::abundanceData() const
+{
+    return ab_;
+}
+
+inline double SpectrumView::getTotalAbundance() const
+{
+    // eight independent partial sums, as in the SpectrumKernels; a single
+    // accumulator would serialize the additions (unless -ffast-math)
+    double s[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    size_type i = 0;
+    for (; i + 8 <= size_; i += 8) {
+        for (size_type k = 0; k < 8; ++k) {
+            s[k] += ab_[i + k];
+        }
+    }
+    for (size_type k = 0; i < size_; ++i, ++k) {
+        s[k] += ab_[i];
+    }
+    return ((s[0] + s[1]) + (s[2] + s[3])) + ((s[4] + s[5]) + (s[6] + s[7]));
+}
+
+inline SpectrumView::const_iterator SpectrumView::getMaxAbundancePeak() const
+{
+    if (size_ == 0) {
+        return end();
+    }
+    const double* m = std::max_element(ab_, ab_ + size_);
+    return begin() + (m - ab_);
+}
+
+inline SpectrumView SpectrumView::subset(const double beginMz,
+    const double endMz) const
+{
+    const double* lower = std::lower_bound(mz_, mz_ + size_, beginMz);
+    const double* upper = std::upper_bound(lower, mz_ + size_, endMz);
+    return SpectrumView(lower, ab_ + (lower - mz_),
+        static_cast<size_type> (upper - lower));
+}
+
+inline SpectrumView::const_iterator operator+(
+    SpectrumView::const_iterator::difference_type n,
+    const SpectrumView::const_iterator& i)
+{
+    return i + n;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_SPECTRUMVIEW_HPP__ */
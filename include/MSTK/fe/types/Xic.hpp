@@ -27,7 +27,7 @@
 #define __MSTK_INCLUDE_MSTK_FE_TYPES_XIC_HPP__
 
 #include <MSTK/config.hpp>
-#include <MSTK/common/Collection.hpp>
+#include <MSTK/common/StaticCollection.hpp>
 #include <MSTK/fe/types/Centroid.hpp>
 
 #include <functional>
@@ -45,7 +45,7 @@ namespace fe {
  *       \c recalculate() to force the statistics update
  *       before any \c getXYZ() request.
  */
-class MSTK_EXPORT Xic : public Collection<Centroid>
+class MSTK_EXPORT Xic : public StaticCollection<Xic, Centroid>
 {
 public:
     /** Comparison functor for abundance-based comparison of XIC objects.
@@ -97,7 +97,7 @@ public:
     };
 
     // other typedefs
-    typedef Collection<Centroid>::const_iterator const_iterator;
+    typedef StaticCollection<Xic, Centroid>::const_iterator const_iterator;
 
     /** Constructor.
      */
@@ -111,6 +111,28 @@ public:
      */
     Xic(const_iterator first, const_iterator last);
 
+    /** Construct XIC from a set of centroids. The centroids are moved into
+     * the XIC, i.e. no element is copied.
+     * @param[in] centroids The centroids that make up the XIC.
+     */
+    explicit Xic(std::vector<Centroid>&& centroids);
+
+    /** Copy constructor.
+     */
+    Xic(const Xic& rhs);
+
+    /** Move constructor. Takes over the centroids of \c rhs.
+     */
+    Xic(Xic&& rhs) noexcept;
+
+    /** Assignment operator.
+     */
+    Xic& operator=(const Xic& rhs);
+
+    /** Move assignment operator. Takes over the centroids of \c rhs.
+     */
+    Xic& operator=(Xic&& rhs) noexcept;
+
     /** Comparison operator for equality.
      * @param[in] rhs The XIC object to compare with.
      * @return True if the current object and \c rhs are the same.
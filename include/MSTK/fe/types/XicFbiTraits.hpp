@@ -53,6 +53,13 @@ struct XicBoxGenerator
     XicBoxGenerator(double mzShift, std::pair<double, double> rtToleranceRange,
         std::pair<double, double> mzToleranceRange, int charge);
 
+    /** @return The maximum half width of the retention time boxes, in s.
+     */
+    double getMaxRtTolerance() const
+    {
+        return maxRtTolerance_;
+    }
+
     double mzShift_; // in Da
     double minRtTolerance_; // in s
     double maxRtTolerance_; // in s
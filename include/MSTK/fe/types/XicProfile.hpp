@@ -0,0 +1,169 @@
+/*
+ * XicProfile.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_FE_TYPES_XICPROFILE_HPP__
+#define __MSTK_INCLUDE_MSTK_FE_TYPES_XICPROFILE_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/CentroidTraits.hpp>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace mstk {
+
+namespace fe {
+
+/** A single (retention time, abundance) sample of a XIC elution profile.
+ */
+struct XicProfilePoint
+{
+    double retentionTime;
+    double abundance;
+
+    /** Accessor functor to access the rt value of a profile point.
+     */
+    struct RtAccessor
+    {
+        typedef double value_type;
+        double operator()(const XicProfilePoint& p) const
+        {
+            return p.retentionTime;
+        }
+    };
+
+    /** Accessor functor to access the abundance value of a profile point.
+     */
+    struct AbundanceAccessor
+    {
+        typedef double value_type;
+        double operator()(const XicProfilePoint& p) const
+        {
+            return p.abundance;
+        }
+    };
+
+    /** Functor to compare two profile points based on their retention time.
+     */
+    struct LessThanRt : public std::binary_function<XicProfilePoint,
+            XicProfilePoint, bool>
+    {
+        bool operator()(const XicProfilePoint& lhs,
+            const XicProfilePoint& rhs) const
+        {
+            return lhs.retentionTime < rhs.retentionTime;
+        }
+    };
+};
+
+/** Profile points carry no m/z value; they support the retention time and
+ * abundance accessors only, which is all the correlation policies (e.g.
+ * \c UncenteredCorrelation) require.
+ */
+template<>
+struct CentroidTraits<XicProfilePoint>
+{
+    typedef XicProfilePoint::AbundanceAccessor AbundanceAccessor;
+    typedef XicProfilePoint::RtAccessor RtAccessor;
+    typedef XicProfilePoint::LessThanRt LessThanRt;
+};
+
+/** The elution profiles of a set of XICs, packed into a single contiguous
+ * array.
+ *
+ * A XIC holds full centroid objects, which makes walking its elution
+ * profile expensive: every step touches a large object (including its raw
+ * data) for two values. \c XicProfileArena extracts the (rt, abundance)
+ * pairs of all XICs once; the profile of the i-th XIC is the range
+ * [\c begin(i), \c end(i)), in the order of the XIC's centroids. The arena
+ * can be read concurrently.
+ */
+class XicProfileArena
+{
+public:
+    typedef const XicProfilePoint* const_iterator;
+
+    /** Pack the elution profiles of \c xics, replacing the current content.
+     * @param[in] xics A random access container of XICs.
+     */
+    template<class XicContainer>
+    void assign(const XicContainer& xics);
+
+    /** @return The number of profiles.
+     */
+    Size size() const
+    {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    /** @return The beginning of the i-th profile.
+     */
+    const_iterator begin(const Size i) const
+    {
+        return points_.data() + offsets_[i];
+    }
+
+    /** @return The end of the i-th profile.
+     */
+    const_iterator end(const Size i) const
+    {
+        return points_.data() + offsets_[i + 1];
+    }
+
+private:
+    std::vector<XicProfilePoint> points_;
+    std::vector<Size> offsets_;
+};
+
+template<class XicContainer>
+void XicProfileArena::assign(const XicContainer& xics)
+{
+    typedef typename XicContainer::value_type XicType;
+    typedef typename XicType::const_iterator CI;
+    typedef typename std::iterator_traits<CI>::value_type CentroidType;
+    typename CentroidTraits<CentroidType>::RtAccessor accRt;
+    typename CentroidTraits<CentroidType>::AbundanceAccessor accAb;
+    offsets_.resize(xics.size() + 1);
+    offsets_[0] = 0;
+    for (Size i = 0; i < xics.size(); ++i) {
+        offsets_[i + 1] = offsets_[i]
+                + std::distance(xics[i].begin(), xics[i].end());
+    }
+    points_.resize(offsets_.back());
+    XicProfilePoint* p = points_.data();
+    for (Size i = 0; i < xics.size(); ++i) {
+        for (CI c = xics[i].begin(); c != xics[i].end(); ++c, ++p) {
+            p->retentionTime = accRt(*c);
+            p->abundance = accAb(*c);
+        }
+    }
+}
+
+} // namespace fe
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_FE_TYPES_XICPROFILE_HPP__ */
@@ -0,0 +1,189 @@
+/*
+ * AveragineTable.hpp
+ *
+ *  Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef __MSTK_INCLUDE_MSTK_IPACA_AVERAGINETABLE_HPP__
+#define __MSTK_INCLUDE_MSTK_IPACA_AVERAGINETABLE_HPP__
+
+#include <MSTK/config.hpp>
+#include <MSTK/common/MappedFile.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/ipaca/Stoichiometry.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace mstk {
+
+namespace ipaca {
+
+/** The averagine stoichiometry (Senko et al., 1995) of a peptide with the
+ * given neutral mass. Element counts are rounded to integers.
+ * @param mass The neutral (average) mass, in Da.
+ * @return The averagine stoichiometry.
+ */
+detail::Stoichiometry makeAveragine(const Double mass);
+
+/** Precomputed isotope envelopes of averagine peptides.
+ *
+ * Computing a theoretical isotope distribution with \c Mercury7 convolves
+ * the element distributions from scratch, which is far too slow for
+ * scoring thousands of candidate isotope patterns. \c AveragineTable calls
+ * \c Mercury7 once per grid mass (every \c massStep Da up to \c maxMass)
+ * and stores the envelopes, i.e. the isotope peaks binned by nominal
+ * isotope number and scaled to a maximum of 1. Queries interpolate
+ * linearly between the two neighboring grid masses in constant time.
+ *
+ * A table can be saved to a compact binary file and memory-mapped later,
+ * which avoids the \c Mercury7 calls at startup. The file consists of a
+ * header of \c HEADER_SIZE bytes (the magic string "MSTKAVGT", the format
+ * version, the number of peaks and grid masses, and the mass step) and the
+ * envelopes as little-endian single precision floats. A mapped table is
+ * accessed in place; mapping requires a little-endian host.
+ *
+ * Charged species follow the conventions of \c Mercury7: the m/z of an
+ * isotope peak is <tt>(M - charge * e) / |charge|</tt>, where \c M is the
+ * mass of the stoichiometry and \c e the electron mass. For \c PROTON
+ * charges, the stoichiometry includes the charge-carrying hydrogens; for
+ * \c ELECTRON charges, it is the neutral molecule.
+ */
+class AveragineTable
+{
+public:
+    /** The type of particle that carries the charge; see \c Mercury7.
+     */
+    enum Particle
+    {
+        ELECTRON, PROTON
+    };
+
+    /** The current file format version.
+     */
+    static const uint32_t VERSION = 1;
+    /** The size of the file header in bytes.
+     */
+    static const Size HEADER_SIZE = 64;
+
+    /** Constructor. Computes the table.
+     * @param[in] maxMass The largest grid mass, in Da.
+     * @param[in] massStep The distance between grid masses, in Da.
+     * @param[in] nPeaks The number of isotope peaks stored per envelope.
+     * @throw mstk::PreconditionViolation if a parameter is not positive or
+     *        \c massStep exceeds \c maxMass.
+     */
+    explicit AveragineTable(const Double maxMass = 10000.0,
+        const Double massStep = 10.0, const Size nPeaks = 8);
+
+    /** Constructor. Maps a table file written by \c save().
+     * @throw mstk::RuntimeError if the file cannot be mapped or is not a
+     *        valid averagine table.
+     */
+    explicit AveragineTable(const String& filename);
+
+    AveragineTable(AveragineTable&& rhs) noexcept;
+
+    AveragineTable& operator=(AveragineTable&& rhs) noexcept;
+
+    /** Map a table file written by \c save(); replaces the current table.
+     * @throw mstk::RuntimeError if the file cannot be mapped or is not a
+     *        valid averagine table. The table is left unchanged.
+     */
+    void open(const String& filename);
+
+    /** Write the table to a binary file.
+     * @throw mstk::RuntimeError if the file cannot be written.
+     */
+    void save(const String& filename) const;
+
+    /** Get the isotope envelope of an averagine peptide.
+     * @param[in] mass The mass, in Da; masses beyond the grid are clamped to
+     *                 the first or last grid mass.
+     * @param[out] abundances The relative abundances of the first isotope
+     *                        peaks, starting with the monoisotopic peak.
+     * @param[in] n The maximum number of abundances to write.
+     * @return The number of abundances written, i.e. the minimum of \c n
+     *         and \c getNumberOfPeaks().
+     */
+    Size getEnvelope(const Double mass, Double* abundances, const Size n) const;
+
+    /** Get the isotope envelope of a charged averagine peptide, i.e. the
+     * envelope at the stoichiometry mass <tt>|charge| * mz + charge * e</tt>.
+     * This holds for both particle types: with protonation, the envelope
+     * includes the charge-carrying hydrogens, as in \c Mercury7.
+     * @param[in] mz The m/z of the monoisotopic peak.
+     * @param[in] charge The charge, signed; zero if \c mz is a mass.
+     * @param[out] abundances See above.
+     * @param[in] n See above.
+     * @return See above.
+     */
+    Size getEnvelope(const Double mz, const Int charge, Double* abundances,
+        const Size n) const;
+
+    /** Convert the m/z of a charged species into the mass of the uncharged
+     * molecule.
+     * @param[in] mz The m/z.
+     * @param[in] charge The charge, signed; zero if \c mz is a mass.
+     * @param[in] particle The type of particle that carries the charge.
+     * @return The neutral mass, in Da.
+     */
+    static Double getNeutralMass(const Double mz, const Int charge,
+        const Particle particle);
+
+    /** @return The largest grid mass, in Da.
+     */
+    Double getMaxMass() const;
+
+    /** @return The distance between grid masses, in Da.
+     */
+    Double getMassStep() const;
+
+    /** @return The number of isotope peaks per envelope.
+     */
+    Size getNumberOfPeaks() const;
+
+    /** @return True if the table is mapped from a file.
+     */
+    bool isMapped() const;
+
+private:
+    AveragineTable(const AveragineTable&);
+    AveragineTable& operator=(const AveragineTable&);
+
+    Double massStep_;
+    Size nMasses_;
+    Size nPeaks_;
+    /** The computed envelopes, \c nPeaks_ values per grid mass; empty if
+     * the table is mapped.
+     */
+    std::vector<float> storage_;
+    MappedFile file_;
+    /** Points into \c storage_ or \c file_.
+     */
+    const float* envelopes_;
+};
+
+} // namespace ipaca
+
+} // namespace mstk
+
+#endif /* __MSTK_INCLUDE_MSTK_IPACA_AVERAGINETABLE_HPP__ */
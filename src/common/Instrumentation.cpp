@@ -0,0 +1,374 @@
+/*
+ * Instrumentation.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/Instrumentation.hpp>
+#include <MSTK/common/Error.hpp>
+#include <atomic>
+#include <cmath>
+#include <ios>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <sstream>
+
+namespace mstk {
+
+namespace {
+
+const Size maxMetrics = 256;
+
+/** The values of one metric in one thread. Only the owning thread writes;
+ * snapshots read concurrently, hence all fields are (relaxed) atomics.
+ */
+struct Slot
+{
+    std::atomic<Size> count;
+    std::atomic<double> sum;
+    std::atomic<double> min;
+    std::atomic<double> max;
+    std::atomic<std::atomic<Size>*> buckets;
+};
+
+struct ThreadSlots
+{
+    Slot slots[maxMetrics];
+};
+
+void clearSlot(Slot& s)
+{
+    s.count.store(0, std::memory_order_relaxed);
+    s.sum.store(0.0, std::memory_order_relaxed);
+    s.min.store(std::numeric_limits<double>::infinity(),
+        std::memory_order_relaxed);
+    s.max.store(-std::numeric_limits<double>::infinity(),
+        std::memory_order_relaxed);
+    std::atomic<Size>* b = s.buckets.load(std::memory_order_acquire);
+    if (b) {
+        for (Size k = 0; k < Instrumentation::nBuckets; ++k) {
+            b[k].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void clearMetric(Instrumentation::Metric& m)
+{
+    m.count = 0;
+    m.sum = 0.0;
+    m.min = std::numeric_limits<double>::infinity();
+    m.max = -std::numeric_limits<double>::infinity();
+    m.buckets.assign(
+        m.kind == Instrumentation::HISTOGRAM ? Instrumentation::nBuckets : 0,
+        0);
+}
+
+void addSlot(Instrumentation::Metric& m, const Slot& s)
+{
+    m.count += s.count.load(std::memory_order_relaxed);
+    m.sum += s.sum.load(std::memory_order_relaxed);
+    m.min = std::min(m.min, s.min.load(std::memory_order_relaxed));
+    m.max = std::max(m.max, s.max.load(std::memory_order_relaxed));
+    const std::atomic<Size>* b = s.buckets.load(std::memory_order_acquire);
+    if (b) {
+        for (Size k = 0; k < m.buckets.size(); ++k) {
+            m.buckets[k] += b[k].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+struct Registry
+{
+    std::mutex mutex;
+    /// registered metrics; the values hold the totals of terminated threads
+    std::vector<Instrumentation::Metric> retired;
+    std::set<ThreadSlots*> threads;
+};
+
+Registry& getRegistry()
+{
+    // never destroyed: threads may terminate, and snapshots may be taken,
+    // during static destruction
+    static Registry* registry = new Registry;
+    return *registry;
+}
+
+ThreadSlots* registerThread()
+{
+    ThreadSlots* t = new ThreadSlots;
+    for (Size i = 0; i < maxMetrics; ++i) {
+        t->slots[i].buckets.store(0, std::memory_order_relaxed);
+        clearSlot(t->slots[i]);
+    }
+    Registry& r = getRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threads.insert(t);
+    return t;
+}
+
+void retireThread(ThreadSlots* t)
+{
+    Registry& r = getRegistry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (Size i = 0; i < r.retired.size(); ++i) {
+            addSlot(r.retired[i], t->slots[i]);
+        }
+        r.threads.erase(t);
+    }
+    for (Size i = 0; i < maxMetrics; ++i) {
+        delete[] t->slots[i].buckets.load(std::memory_order_relaxed);
+    }
+    delete t;
+}
+
+/** Owns the slots of the current thread and retires them when the thread
+ * terminates.
+ */
+struct ThreadSlotsHolder
+{
+    ThreadSlots* slots;
+    ~ThreadSlotsHolder()
+    {
+        if (slots) {
+            retireThread(slots);
+        }
+    }
+};
+
+thread_local ThreadSlotsHolder holder = { 0 };
+
+inline Slot& getSlot(const Instrumentation::Id id)
+{
+    if (!holder.slots) {
+        holder.slots = registerThread();
+    }
+    return holder.slots->slots[id];
+}
+
+inline void add(std::atomic<Size>& a, const Size n)
+{
+    a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void add(Slot& s, const double value)
+{
+    add(s.count, 1);
+    s.sum.store(s.sum.load(std::memory_order_relaxed) + value,
+        std::memory_order_relaxed);
+    if (value < s.min.load(std::memory_order_relaxed)) {
+        s.min.store(value, std::memory_order_relaxed);
+    }
+    if (value > s.max.load(std::memory_order_relaxed)) {
+        s.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+Size getBucket(const double value)
+{
+    if (!(value >= 1.0)) {
+        return 0;
+    }
+    // value = f * 2^e with f in [0.5, 1), i.e. value in [2^(e-1), 2^e)
+    int e = 0;
+    std::frexp(value, &e);
+    return std::min(static_cast<Size> (e), Instrumentation::nBuckets - 1);
+}
+
+} // namespace
+
+const Size Instrumentation::nBuckets;
+
+Instrumentation::Id Instrumentation::getId(const std::string& name,
+    const Kind kind)
+{
+    Registry& r = getRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (Size i = 0; i < r.retired.size(); ++i) {
+        if (r.retired[i].name == name) {
+            mstk_precondition(r.retired[i].kind == kind,
+                "Instrumentation metric registered with a different kind.");
+            return static_cast<Id> (i);
+        }
+    }
+    mstk_precondition(r.retired.size() < maxMetrics,
+        "Too many instrumentation metrics.");
+    Metric m;
+    m.name = name;
+    m.kind = kind;
+    clearMetric(m);
+    r.retired.push_back(m);
+    return static_cast<Id> (r.retired.size() - 1);
+}
+
+void Instrumentation::count(const Id id, const Size n)
+{
+    Slot& s = getSlot(id);
+    add(s.count, 1);
+    s.sum.store(s.sum.load(std::memory_order_relaxed) + n,
+        std::memory_order_relaxed);
+}
+
+void Instrumentation::time(const Id id, const double seconds)
+{
+    add(getSlot(id), seconds);
+}
+
+void Instrumentation::record(const Id id, const double value)
+{
+    Slot& s = getSlot(id);
+    add(s, value);
+    std::atomic<Size>* b = s.buckets.load(std::memory_order_relaxed);
+    if (!b) {
+        b = new std::atomic<Size>[nBuckets];
+        for (Size k = 0; k < nBuckets; ++k) {
+            b[k].store(0, std::memory_order_relaxed);
+        }
+        s.buckets.store(b, std::memory_order_release);
+    }
+    add(b[getBucket(value)], 1);
+}
+
+std::vector<Instrumentation::Metric> Instrumentation::snapshot()
+{
+    Registry& r = getRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<Metric> metrics(r.retired);
+    for (std::set<ThreadSlots*>::const_iterator t = r.threads.begin(); t
+            != r.threads.end(); ++t) {
+        for (Size i = 0; i < metrics.size(); ++i) {
+            addSlot(metrics[i], (*t)->slots[i]);
+        }
+    }
+    for (Size i = 0; i < metrics.size(); ++i) {
+        if (metrics[i].count == 0) {
+            metrics[i].min = metrics[i].max = 0.0;
+        }
+    }
+    return metrics;
+}
+
+void Instrumentation::writeJson(std::ostream& os)
+{
+    std::vector<Metric> metrics = snapshot();
+    std::streamsize precision = os.precision(12);
+    std::ios_base::fmtflags flags = os.flags();
+    os.unsetf(std::ios_base::floatfield);
+    os << '{';
+    for (Size i = 0; i < metrics.size(); ++i) {
+        const Metric& m = metrics[i];
+        os << (i == 0 ? "\n  " : ",\n  ");
+        writeJsonString(os, m.name);
+        os << ": {";
+        switch (m.kind) {
+            case COUNTER:
+                os << "\"type\": \"counter\", \"value\": "
+                        << static_cast<Size> (m.sum);
+                break;
+            case TIMER:
+                os << "\"type\": \"timer\", \"count\": " << m.count
+                        << ", \"total\": " << m.sum << ", \"min\": " << m.min
+                        << ", \"max\": " << m.max << ", \"mean\": "
+                        << (m.count > 0 ? m.sum / m.count : 0.0);
+                break;
+            case HISTOGRAM:
+                os << "\"type\": \"histogram\", \"count\": " << m.count
+                        << ", \"sum\": " << m.sum << ", \"min\": " << m.min
+                        << ", \"max\": " << m.max << ", \"buckets\": [";
+                // non-empty buckets, identified by their lower bound
+                bool first = true;
+                for (Size k = 0; k < m.buckets.size(); ++k) {
+                    if (m.buckets[k] == 0) {
+                        continue;
+                    }
+                    os << (first ? "" : ", ") << "{\"lower\": "
+                            << (k == 0 ? 0.0 : std::ldexp(1.0,
+                                static_cast<int> (k) - 1)) << ", \"count\": "
+                            << m.buckets[k] << '}';
+                    first = false;
+                }
+                os << ']';
+                break;
+        }
+        os << '}';
+    }
+    os << (metrics.empty() ? "}" : "\n}") << std::endl;
+    os.precision(precision);
+    os.flags(flags);
+}
+
+std::string Instrumentation::toJson()
+{
+    std::ostringstream os;
+    writeJson(os);
+    return os.str();
+}
+
+void Instrumentation::writeJsonString(std::ostream& os, const std::string& s)
+{
+    os << '"';
+    for (std::string::const_iterator i = s.begin(); i != s.end(); ++i) {
+        switch (*i) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char> (*i) < 0x20) {
+                    // the remaining control characters
+                    const char* hex = "0123456789abcdef";
+                    const unsigned char c = static_cast<unsigned char> (*i);
+                    os << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+                } else {
+                    os << *i;
+                }
+        }
+    }
+    os << '"';
+}
+
+void Instrumentation::reset()
+{
+    Registry& r = getRegistry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (Size i = 0; i < r.retired.size(); ++i) {
+        clearMetric(r.retired[i]);
+    }
+    for (std::set<ThreadSlots*>::const_iterator t = r.threads.begin(); t
+            != r.threads.end(); ++t) {
+        for (Size i = 0; i < maxMetrics; ++i) {
+            clearSlot((*t)->slots[i]);
+        }
+    }
+}
+
+} // namespace mstk
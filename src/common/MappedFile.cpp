@@ -0,0 +1,165 @@
+/*
+ * MappedFile.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/MappedFile.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Log.hpp>
+
+#ifdef _WIN32
+#include <cstdlib>
+#include <fstream>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mstk {
+
+MappedFile::MappedFile() :
+    data_(0), size_(0), open_(false)
+{
+}
+
+MappedFile::MappedFile(const String& filename) :
+    data_(0), size_(0), open_(false)
+{
+    open(filename);
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept :
+    data_(rhs.data_), size_(rhs.size_), open_(rhs.open_)
+{
+    rhs.data_ = 0;
+    rhs.size_ = 0;
+    rhs.open_ = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    if (this != &rhs) {
+        close();
+        data_ = rhs.data_;
+        size_ = rhs.size_;
+        open_ = rhs.open_;
+        rhs.data_ = 0;
+        rhs.size_ = 0;
+        rhs.open_ = false;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+void MappedFile::open(const String& filename)
+{
+    close();
+    std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!ifs) {
+        throw mstk::RuntimeError("MappedFile: cannot open '" + filename + "'.");
+    }
+    ifs.seekg(0, std::ios::end);
+    const Size n = static_cast<Size> (ifs.tellg());
+    ifs.seekg(0, std::ios::beg);
+    char* p = 0;
+    if (n > 0) {
+        p = static_cast<char*> (_aligned_malloc(n, 4096));
+        if (p == 0 || !ifs.read(p, n)) {
+            _aligned_free(p);
+            throw mstk::RuntimeError(
+                "MappedFile: cannot read '" + filename + "'.");
+        }
+    }
+    data_ = p;
+    size_ = n;
+    open_ = true;
+}
+
+void MappedFile::close()
+{
+    _aligned_free(const_cast<char*> (data_));
+    data_ = 0;
+    size_ = 0;
+    open_ = false;
+}
+
+#else
+
+void MappedFile::open(const String& filename)
+{
+    close();
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw mstk::RuntimeError("MappedFile: cannot open '" + filename
+                + "': " + std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        const String msg = std::strerror(errno);
+        ::close(fd);
+        throw mstk::RuntimeError("MappedFile: cannot stat '" + filename
+                + "': " + msg);
+    }
+    const Size n = static_cast<Size> (st.st_size);
+    void* p = 0;
+    if (n > 0) {
+        p = ::mmap(0, n, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            const String msg = std::strerror(errno);
+            ::close(fd);
+            throw mstk::RuntimeError("MappedFile: cannot map '" + filename
+                    + "': " + msg);
+        }
+    }
+    // the mapping stays valid after closing the descriptor
+    ::close(fd);
+    data_ = static_cast<const char*> (p);
+    size_ = n;
+    open_ = true;
+    MSTK_LOG(logDEBUG) << "MappedFile: mapped " << n << " bytes of '"
+            << filename << "'.";
+}
+
+void MappedFile::close()
+{
+    if (data_ != 0) {
+        ::munmap(const_cast<char*> (data_), size_);
+    }
+    data_ = 0;
+    size_ = 0;
+    open_ = false;
+}
+
+#endif
+
+}
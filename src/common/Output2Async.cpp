@@ -0,0 +1,329 @@
+/*
+ * Output2Async.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/common/Output2Async.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mstk {
+
+namespace {
+
+/** Bounded MPSC ring buffer of log records (after D. Vyukov's bounded
+ * MPMC queue) plus the thread that drains it.
+ */
+class AsyncSink
+{
+public:
+    AsyncSink(const Size capacity, const Output2Async::OverflowPolicy policy);
+    ~AsyncSink();
+    void push(const std::string& msg);
+    void flush();
+    Size getDroppedCount() const;
+
+private:
+    struct Cell
+    {
+        std::atomic<Size> sequence;
+        std::string record;
+    };
+
+    void run();
+    bool drain();
+    void wakeUp();
+
+    std::vector<Cell> cells_;
+    Size mask_;
+    Output2Async::OverflowPolicy policy_;
+    std::atomic<Size> enqueuePos_;
+    // consumer state; only touched by the background thread
+    Size dequeuePos_;
+    Size reportedDrops_;
+    std::atomic<Size> written_;
+    std::atomic<Size> dropped_;
+    std::atomic<bool> stop_;
+    std::atomic<bool> sleeping_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+};
+
+AsyncSink::AsyncSink(const Size capacity,
+    const Output2Async::OverflowPolicy policy) :
+    cells_(), mask_(0), policy_(policy), enqueuePos_(0), dequeuePos_(0),
+            reportedDrops_(0), written_(0), dropped_(0), stop_(false),
+            sleeping_(false)
+{
+    Size n = 2;
+    while (n < capacity) {
+        n *= 2;
+    }
+    std::vector<Cell> cells(n);
+    cells_.swap(cells);
+    mask_ = n - 1;
+    for (Size i = 0; i < n; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    thread_ = std::thread(&AsyncSink::run, this);
+}
+
+AsyncSink::~AsyncSink()
+{
+    stop_.store(true, std::memory_order_release);
+    condition_.notify_one();
+    thread_.join();
+}
+
+void AsyncSink::push(const std::string& msg)
+{
+    Cell* cell = 0;
+    Size pos = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        cell = &cells_[pos & mask_];
+        Size seq = cell->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t dif = static_cast<std::ptrdiff_t> (seq)
+                - static_cast<std::ptrdiff_t> (pos);
+        if (dif == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1,
+                std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            // full
+            if (policy_ == Output2Async::DROP) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            condition_.notify_one();
+            std::this_thread::yield();
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    // the cell keeps its capacity, hence this does not allocate once the
+    // buffer has seen messages of typical length
+    cell->record.assign(msg);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    wakeUp();
+}
+
+void AsyncSink::flush()
+{
+    const Size target = enqueuePos_.load(std::memory_order_acquire);
+    while (written_.load(std::memory_order_acquire) < target) {
+        condition_.notify_one();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+Size AsyncSink::getDroppedCount() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void AsyncSink::wakeUp()
+{
+    // only the first producer to see the sleeping thread notifies
+    if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(
+        false)) {
+        condition_.notify_one();
+    }
+}
+
+bool AsyncSink::drain()
+{
+    FILE* pStream = Output2Async::getRedirect();
+    Size n = 0;
+    for (;;) {
+        Cell& cell = cells_[dequeuePos_ & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+            break;
+        }
+        if (pStream) {
+            fwrite(cell.record.data(), 1, cell.record.size(), pStream);
+        }
+        cell.sequence.store(dequeuePos_ + mask_ + 1,
+            std::memory_order_release);
+        ++dequeuePos_;
+        ++n;
+    }
+    const Size dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops_ && pStream) {
+        fprintf(pStream, "- %s WARNING: %lu log message(s) dropped\n",
+            nowTime().c_str(),
+            static_cast<unsigned long> (dropped - reportedDrops_));
+        reportedDrops_ = dropped;
+        ++n;
+    }
+    if (n > 0) {
+        if (pStream) {
+            fflush(pStream);
+        }
+        written_.store(dequeuePos_, std::memory_order_release);
+    }
+    return n > 0;
+}
+
+void AsyncSink::run()
+{
+    Size idle = 0;
+    for (;;) {
+        // records enqueued before stop() was called are written before the
+        // thread terminates
+        const bool stopping = stop_.load(std::memory_order_acquire);
+        if (drain()) {
+            idle = 0;
+            continue;
+        }
+        if (stopping) {
+            return;
+        }
+        // Nap briefly to collect the next batch. Only after a while without
+        // records does the thread go to sleep and ask producers for a
+        // wake-up; producers notify without taking the mutex, and a
+        // wake-up lost in the window before wait_for() only delays the
+        // output by the timeout.
+        const bool deep = ++idle > 16;
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (deep) {
+            sleeping_.store(true, std::memory_order_seq_cst);
+        }
+        Cell& next = cells_[dequeuePos_ & mask_];
+        if (!stop_.load(std::memory_order_acquire)
+                && next.sequence.load(std::memory_order_acquire)
+                        != dequeuePos_ + 1) {
+            condition_.wait_for(lock, deep ? std::chrono::milliseconds(100)
+                    : std::chrono::milliseconds(1));
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+std::mutex& getSinkMutex()
+{
+    static std::mutex m;
+    return m;
+}
+
+std::atomic<AsyncSink*>& getSink()
+{
+    static std::atomic<AsyncSink*> sink(0);
+    return sink;
+}
+
+// set once the sink has been shut down at program exit; later messages
+// are written synchronously
+std::atomic<bool>& getShutDown()
+{
+    static std::atomic<bool> shutDown(false);
+    return shutDown;
+}
+
+struct SinkGuard
+{
+    ~SinkGuard()
+    {
+        Output2Async::stop();
+        getShutDown().store(true);
+    }
+};
+
+AsyncSink* startSink(const Size capacity,
+    const Output2Async::OverflowPolicy policy)
+{
+    static SinkGuard guard;
+    AsyncSink* sink = new AsyncSink(capacity, policy);
+    getSink().store(sink, std::memory_order_release);
+    return sink;
+}
+
+} // namespace
+
+void Output2Async::start(const Size capacity, const OverflowPolicy policy)
+{
+    std::lock_guard<std::mutex> lock(getSinkMutex());
+    delete getSink().exchange(0);
+    startSink(capacity, policy);
+}
+
+void Output2Async::stop()
+{
+    std::lock_guard<std::mutex> lock(getSinkMutex());
+    delete getSink().exchange(0);
+}
+
+void Output2Async::flush()
+{
+    AsyncSink* sink = getSink().load(std::memory_order_acquire);
+    if (sink) {
+        sink->flush();
+    }
+}
+
+bool Output2Async::isRunning()
+{
+    return getSink().load(std::memory_order_acquire) != 0;
+}
+
+Size Output2Async::getDroppedCount()
+{
+    AsyncSink* sink = getSink().load(std::memory_order_acquire);
+    return sink ? sink->getDroppedCount() : 0;
+}
+
+FILE*& Output2Async::getRedirect()
+{
+    static FILE* pStream = stderr;
+    return pStream;
+}
+
+void Output2Async::output(const std::string& msg)
+{
+    AsyncSink* sink = getSink().load(std::memory_order_acquire);
+    if (!sink) {
+        if (getShutDown().load()) {
+            FILE* pStream = getRedirect();
+            if (pStream) {
+                fprintf(pStream, "%s", msg.c_str());
+                fflush(pStream);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> lock(getSinkMutex());
+        sink = getSink().load(std::memory_order_acquire);
+        if (!sink) {
+            sink = startSink(4096, DROP);
+        }
+    }
+    sink->push(msg);
+}
+
+} // namespace mstk
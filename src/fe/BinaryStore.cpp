@@ -0,0 +1,317 @@
+/*
+ * BinaryStore.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/BinaryStore.hpp>
+#include <MSTK/common/Log.hpp>
+#include <cstring>
+#include <limits>
+
+namespace mstk {
+
+namespace fe {
+
+namespace {
+
+const char MAGIC[8] = { 'M', 'S', 'T', 'K', 'F', 'E', 'B', 'S' };
+
+uint64_t align(const uint64_t pos)
+{
+    const uint64_t a = BinaryStoreHeader::ALIGNMENT;
+    return (pos + a - 1) / a * a;
+}
+
+void encodeLittleEndian(const uint64_t value, const Size nBytes, char* buf)
+{
+    for (Size i = 0; i < nBytes; ++i) {
+        buf[i] = static_cast<char> ((value >> (8 * i)) & 0xff);
+    }
+}
+
+uint64_t decodeLittleEndian(const char* buf, const Size nBytes)
+{
+    uint64_t value = 0;
+    for (Size i = 0; i < nBytes; ++i) {
+        value |= static_cast<uint64_t> (static_cast<unsigned char> (buf[i]))
+                << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+const uint32_t BinaryStoreHeader::VERSION;
+const Size BinaryStoreHeader::SIZE;
+const Size BinaryStoreHeader::ALIGNMENT;
+
+BinaryStoreHeader::BinaryStoreHeader()
+{
+    *this = BinaryStoreHeader(CENTROID_TABLE, 0, 0);
+}
+
+BinaryStoreHeader::BinaryStoreHeader(const TableType type,
+    const uint64_t nc, const uint64_t nx) :
+    version(VERSION), tableType(type), nCentroids(nc), nXics(nx)
+{
+    uint64_t pos = SIZE;
+    for (int c = 0; c < N_COLUMNS; ++c) {
+        pos = align(pos);
+        columnOffsets[c] = pos;
+        if (c == XIC_OFFSETS) {
+            pos += type == XIC_TABLE ? (nXics + 1) * getElementSize(
+                XIC_OFFSETS) : 0;
+        } else {
+            pos += nCentroids * getElementSize(static_cast<Column> (c));
+        }
+    }
+}
+
+Size BinaryStoreHeader::getElementSize(const Column c)
+{
+    switch (c) {
+        case RT:
+        case MZ:
+        case ABUNDANCE:
+            return sizeof(double);
+        case SCAN_NUMBER:
+        case RAW_SCAN_INDEX:
+        case RAW_OFFSET:
+        case RAW_LENGTH:
+            return sizeof(uint32_t);
+        case XIC_OFFSETS:
+            return sizeof(uint64_t);
+        default:
+            return 0;
+    }
+}
+
+uint64_t BinaryStoreHeader::getFileSize() const
+{
+    const uint64_t n = tableType == XIC_TABLE ? (nXics + 1)
+            * getElementSize(XIC_OFFSETS) : 0;
+    return align(columnOffsets[XIC_OFFSETS] + n);
+}
+
+void BinaryStoreHeader::encode(char* buf) const
+{
+    std::memset(buf, 0, SIZE);
+    std::memcpy(buf, MAGIC, sizeof(MAGIC));
+    encodeLittleEndian(version, 4, buf + 8);
+    encodeLittleEndian(tableType, 4, buf + 12);
+    encodeLittleEndian(nCentroids, 8, buf + 16);
+    encodeLittleEndian(nXics, 8, buf + 24);
+    for (int c = 0; c < N_COLUMNS; ++c) {
+        encodeLittleEndian(columnOffsets[c], 8, buf + 32 + 8 * c);
+    }
+}
+
+BinaryStoreHeader BinaryStoreHeader::decode(const char* buf,
+    const Size fileSize)
+{
+    if (fileSize < SIZE || std::memcmp(buf, MAGIC, sizeof(MAGIC)) != 0) {
+        throw mstk::RuntimeError("BinaryStoreHeader: not a binary store.");
+    }
+    BinaryStoreHeader h;
+    h.version = static_cast<uint32_t> (decodeLittleEndian(buf + 8, 4));
+    if (h.version != VERSION) {
+        throw mstk::RuntimeError(
+            "BinaryStoreHeader: unsupported binary store version.");
+    }
+    h.tableType = static_cast<uint32_t> (decodeLittleEndian(buf + 12, 4));
+    if (h.tableType != CENTROID_TABLE && h.tableType != XIC_TABLE) {
+        throw mstk::RuntimeError("BinaryStoreHeader: unknown table type.");
+    }
+    h.nCentroids = decodeLittleEndian(buf + 16, 8);
+    h.nXics = decodeLittleEndian(buf + 24, 8);
+    for (int c = 0; c < N_COLUMNS; ++c) {
+        h.columnOffsets[c] = decodeLittleEndian(buf + 32 + 8 * c, 8);
+    }
+    // nXics + 1 offsets must not wrap around; the file size bounds the rest
+    if (h.tableType == XIC_TABLE && h.nXics
+            == std::numeric_limits<uint64_t>::max()) {
+        throw mstk::RuntimeError(
+            "BinaryStoreHeader: truncated or corrupt binary store.");
+    }
+    // every column must be aligned and lie within the file
+    for (int c = 0; c < N_COLUMNS; ++c) {
+        uint64_t n = c == XIC_OFFSETS ? (h.tableType == XIC_TABLE ? h.nXics
+                + 1 : 0) : h.nCentroids;
+        const uint64_t elementSize = getElementSize(static_cast<Column> (c));
+        if (h.columnOffsets[c] % ALIGNMENT != 0 || h.columnOffsets[c]
+                > fileSize || n > (fileSize - h.columnOffsets[c])
+                / elementSize) {
+            throw mstk::RuntimeError(
+                "BinaryStoreHeader: truncated or corrupt binary store.");
+        }
+    }
+    return h;
+}
+
+BinaryStoreReader::BinaryStoreReader()
+{
+}
+
+BinaryStoreReader::BinaryStoreReader(const String& filename)
+{
+    open(filename);
+}
+
+void BinaryStoreReader::open(const String& filename)
+{
+    close();
+    if (!detail::isLittleEndianHost()) {
+        throw mstk::RuntimeError(
+            "BinaryStoreReader: mapping requires a little-endian host.");
+    }
+    file_.open(filename);
+    BinaryStoreHeader h;
+    try {
+        h = BinaryStoreHeader::decode(file_.data(), file_.size());
+    } catch (...) {
+        file_.close();
+        throw;
+    }
+
+    const char* base = file_.data();
+    typedef BinaryStoreHeader H;
+    CentroidTableView::Columns c;
+    c.rt = reinterpret_cast<const double*> (base + h.columnOffsets[H::RT]);
+    c.mz = reinterpret_cast<const double*> (base + h.columnOffsets[H::MZ]);
+    c.abundance = reinterpret_cast<const double*> (base
+            + h.columnOffsets[H::ABUNDANCE]);
+    c.scanNumber = reinterpret_cast<const uint32_t*> (base
+            + h.columnOffsets[H::SCAN_NUMBER]);
+    c.rawScanIndex = reinterpret_cast<const uint32_t*> (base
+            + h.columnOffsets[H::RAW_SCAN_INDEX]);
+    c.rawOffset = reinterpret_cast<const uint32_t*> (base
+            + h.columnOffsets[H::RAW_OFFSET]);
+    c.rawLength = reinterpret_cast<const uint32_t*> (base
+            + h.columnOffsets[H::RAW_LENGTH]);
+    CentroidTableView centroids(c, static_cast<Size> (h.nCentroids));
+
+    XicTableView xics;
+    if (h.tableType == H::XIC_TABLE) {
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*> (base
+                + h.columnOffsets[H::XIC_OFFSETS]);
+        // the XICs must partition the centroid table
+        bool valid = offsets[0] == 0 && offsets[h.nXics] == h.nCentroids;
+        for (uint64_t i = 0; valid && i < h.nXics; ++i) {
+            valid = offsets[i] <= offsets[i + 1];
+        }
+        if (!valid) {
+            file_.close();
+            throw mstk::RuntimeError(
+                "BinaryStoreReader: corrupt XIC offsets in '" + filename
+                        + "'.");
+        }
+        xics = XicTableView(centroids, offsets, static_cast<Size> (h.nXics));
+    }
+    header_ = h;
+    centroids_ = centroids;
+    xics_ = xics;
+    MSTK_LOG(logDEBUG) << "BinaryStoreReader: opened '" << filename
+            << "' with " << h.nCentroids << " centroids and " << h.nXics
+            << " XICs.";
+}
+
+void BinaryStoreReader::close()
+{
+    file_.close();
+    header_ = BinaryStoreHeader();
+    centroids_ = CentroidTableView();
+    xics_ = XicTableView();
+}
+
+const BinaryStoreHeader& BinaryStoreReader::getHeader() const
+{
+    return header_;
+}
+
+bool BinaryStoreReader::isXicTable() const
+{
+    return header_.tableType == BinaryStoreHeader::XIC_TABLE;
+}
+
+const CentroidTableView& BinaryStoreReader::getCentroids() const
+{
+    return centroids_;
+}
+
+const XicTableView& BinaryStoreReader::getXics() const
+{
+    mstk_precondition(isXicTable(),
+        "BinaryStoreReader::getXics(): the store holds a centroid table.");
+    return xics_;
+}
+
+namespace detail {
+
+BinaryStoreWriter::BinaryStoreWriter(const String& filename,
+    const BinaryStoreHeader& header) :
+    filename_(filename), header_(header),
+            os_(filename.c_str(), std::ios::out | std::ios::binary
+                    | std::ios::trunc), pos_(BinaryStoreHeader::SIZE)
+{
+    if (!os_) {
+        throw mstk::RuntimeError(
+            "BinaryStoreWriter: cannot open '" + filename + "'.");
+    }
+    char buf[BinaryStoreHeader::SIZE];
+    header.encode(buf);
+    os_.write(buf, BinaryStoreHeader::SIZE);
+    buffer_.reserve(1 << 16);
+}
+
+void BinaryStoreWriter::beginColumn(const BinaryStoreHeader::Column c)
+{
+    flush();
+    mstk_precondition(pos_ <= header_.columnOffsets[c],
+        "BinaryStoreWriter::beginColumn(): column overflow.");
+    buffer_.assign(static_cast<Size> (header_.columnOffsets[c] - pos_), 0);
+}
+
+void BinaryStoreWriter::flush()
+{
+    os_.write(buffer_.data(), buffer_.size());
+    pos_ += buffer_.size();
+    buffer_.clear();
+}
+
+void BinaryStoreWriter::finish()
+{
+    flush();
+    buffer_.assign(static_cast<Size> (header_.getFileSize() - pos_), 0);
+    flush();
+    os_.close();
+    if (!os_) {
+        throw mstk::RuntimeError(
+            "BinaryStoreWriter: cannot write '" + filename_ + "'.");
+    }
+}
+
+} // namespace detail
+
+} // namespace fe
+
+} // namespace mstk
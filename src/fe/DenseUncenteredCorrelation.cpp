@@ -0,0 +1,60 @@
+/*
+ * DenseUncenteredCorrelation.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/DenseUncenteredCorrelation.hpp>
+#include <MSTK/fe/types/ProfileKernels.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace mstk {
+
+namespace fe {
+
+DenseUncenteredCorrelation::~DenseUncenteredCorrelation()
+{
+}
+
+DenseUncenteredCorrelation::ThresholdType DenseUncenteredCorrelation::correlate(
+    const DenseXicProfileArena& profiles, const Size i, const Size j)
+{
+    static const ProfileKernels& kernels = ProfileKernels::get();
+    // the overlapping scan window [lo, hi)
+    const Size li = profiles.getFirstScan(i);
+    const Size lj = profiles.getFirstScan(j);
+    const Size lo = std::max(li, lj);
+    const Size hi = std::min(li + profiles.getLength(i),
+        lj + profiles.getLength(j));
+    if (hi <= lo) {
+        return 0.0;
+    }
+    const double lr = kernels.dotProduct(profiles.data(i) + (lo - li),
+        profiles.data(j) + (lo - lj), hi - lo);
+    return static_cast<ThresholdType> ((lr != 0) ? (lr / std::sqrt(
+        profiles.getSquaredNorm(i) * profiles.getSquaredNorm(j))) : 0.0);
+}
+
+} // namespace fe
+
+} // namespace mstk
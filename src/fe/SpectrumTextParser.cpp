@@ -0,0 +1,323 @@
+/*
+ * SpectrumTextParser.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/SpectrumTextParser.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/MappedFile.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdint.h>
+
+namespace mstk {
+
+namespace fe {
+
+namespace {
+
+const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+                         1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                         1e18, 1e19, 1e20, 1e21, 1e22 };
+
+inline bool isDigit(const char c)
+{
+    return static_cast<unsigned int> (c - '0') < 10u;
+}
+
+inline bool isBlank(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipBlanks(const char* p, const char* end)
+{
+    while (p != end && isBlank(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+inline const char* findEndOfLine(const char* p, const char* end)
+{
+    const char* q = static_cast<const char*> (std::memchr(p, '\n', end - p));
+    return q ? q : end;
+}
+
+void throwParseError(const char* what, const Size line)
+{
+    std::ostringstream oss;
+    oss << "SpectrumTextParser: " << what << " in line " << line << ".";
+    throw mstk::RuntimeError(oss.str());
+}
+
+/** Find the end of the scan starting at \c p, i.e. the start of the next
+ * header line, and count its lines.
+ */
+const char* findEndOfScan(const char* p, const char* end, Size& nLines)
+{
+    nLines = 0;
+    while (p != end) {
+        const char* eol = findEndOfLine(p, end);
+        ++nLines;
+        if (eol == end || eol + 1 == end) {
+            return end;
+        }
+        p = eol + 1;
+        if (*p == '#') {
+            return p;
+        }
+    }
+    return end;
+}
+
+} // namespace
+
+bool SpectrumTextParser::parseDouble(const char*& p, const char* end,
+    double& value)
+{
+    const char* s = p;
+    bool negative = false;
+    if (s != end && (*s == '-' || *s == '+')) {
+        negative = *s == '-';
+        ++s;
+    }
+    // collect up to 19 significant digits; the remaining digits only
+    // affect the decimal exponent
+    uint64_t mantissa = 0;
+    int nSignificant = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    for (; s != end && isDigit(*s); ++s) {
+        hasDigits = true;
+        if (nSignificant < 19) {
+            mantissa = mantissa * 10 + (*s - '0');
+            nSignificant += mantissa != 0;
+        } else {
+            ++exponent;
+        }
+    }
+    if (s != end && *s == '.') {
+        for (++s; s != end && isDigit(*s); ++s) {
+            hasDigits = true;
+            if (nSignificant < 19) {
+                mantissa = mantissa * 10 + (*s - '0');
+                nSignificant += mantissa != 0;
+                --exponent;
+            }
+        }
+    }
+    if (!hasDigits) {
+        return false;
+    }
+    if (s != end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        bool negativeExponent = false;
+        if (e != end && (*e == '-' || *e == '+')) {
+            negativeExponent = *e == '-';
+            ++e;
+        }
+        if (e == end || !isDigit(*e)) {
+            return false;
+        }
+        int x = 0;
+        for (; e != end && isDigit(*e); ++e) {
+            if (x < 10000) {
+                x = x * 10 + (*e - '0');
+            }
+        }
+        exponent += negativeExponent ? -x : x;
+        s = e;
+    }
+
+    double v;
+    if (mantissa == 0) {
+        v = 0.0;
+    } else if (mantissa <= (static_cast<uint64_t> (1) << 53) && exponent
+            >= -22 && exponent <= 22) {
+        // both operands are exact, hence the result is correctly rounded
+        v = static_cast<double> (mantissa);
+        v = exponent < 0 ? v / POW10[-exponent] : v * POW10[exponent];
+    } else if (exponent >= -22 && exponent <= 22) {
+        // long mantissas: a single rounding step in extended precision
+        const long double m = static_cast<long double> (mantissa);
+        v = static_cast<double> (exponent < 0 ? m / POW10[-exponent] : m
+                * POW10[exponent]);
+    } else {
+        v = static_cast<double> (static_cast<long double> (mantissa)
+                * std::pow(10.0L, exponent));
+    }
+    value = negative ? -v : v;
+    p = s;
+    return true;
+}
+
+void SpectrumTextParser::parseHeader(const char* first, const char* last,
+    Spectrum& s, const Size line) const
+{
+    const char* p = first + 1; // skip '#'
+    while (true) {
+        p = skipBlanks(p, last);
+        if (p == last) {
+            break;
+        }
+        const char* key = p;
+        while (p != last && !isBlank(*p) && *p != '=') {
+            ++p;
+        }
+        const Size keyLength = p - key;
+        if (p == last || *p != '=') {
+            // not a key=value pair; ignore the word
+            continue;
+        }
+        ++p;
+        double v = 0.0;
+        if (!parseDouble(p, last, v) || (p != last && !isBlank(*p))) {
+            throwParseError("malformed header value", line);
+        }
+#define MSTK_HEADER_KEY_IS(NAME) \
+        (keyLength == sizeof(NAME) - 1 && std::memcmp(key, NAME, keyLength) == 0)
+        if (MSTK_HEADER_KEY_IS("scanNumber")) {
+            s.setScanNumber(static_cast<unsigned int> (v));
+        } else if (MSTK_HEADER_KEY_IS("rt")) {
+            s.setRetentionTime(v);
+        } else if (MSTK_HEADER_KEY_IS("msLevel")) {
+            s.setMsLevel(static_cast<unsigned int> (v));
+        } else if (MSTK_HEADER_KEY_IS("totalIonCurrent")) {
+            s.setTotalIonCurrent(v);
+        } else if (MSTK_HEADER_KEY_IS("precursorScanNumber")) {
+            s.setPrecursorScanNumber(static_cast<unsigned int> (v));
+        } else if (MSTK_HEADER_KEY_IS("precursorMz")) {
+            s.setPrecursorMz(v);
+        } else if (MSTK_HEADER_KEY_IS("precursorCharge")) {
+            s.setPrecursorCharge(static_cast<int> (v));
+        } else if (MSTK_HEADER_KEY_IS("precursorAbundance")) {
+            s.setPrecursorAbundance(v);
+        }
+#undef MSTK_HEADER_KEY_IS
+    }
+}
+
+const char* SpectrumTextParser::parseScan(const char* first,
+    const char* last, Spectrum& s, Size& line) const
+{
+    const char* p = first;
+    if (p != last && *p == '#') {
+        const char* eol = findEndOfLine(p, last);
+        parseHeader(p, eol, s, line);
+        ++line;
+        p = eol == last ? last : eol + 1;
+    }
+    // size the spectrum before reading the peaks
+    Size nLines = 0;
+    const char* end = findEndOfScan(p, last, nLines);
+    s.reserve(nLines);
+    while (p != end) {
+        const char* eol = findEndOfLine(p, end);
+        const char* q = skipBlanks(p, eol);
+        if (q != eol) {
+            double mz, ab;
+            if (!parseDouble(q, eol, mz) || q == eol || !isBlank(*q)) {
+                throwParseError("malformed peak", line);
+            }
+            q = skipBlanks(q, eol);
+            if (!parseDouble(q, eol, ab) || skipBlanks(q, eol) != eol) {
+                throwParseError("malformed peak", line);
+            }
+            // only push_back if abundance is > 0
+            if (ab > 0.0) {
+                s.push_back(Spectrum::Element(mz, ab));
+            }
+        }
+        ++line;
+        p = eol == end ? end : eol + 1;
+    }
+    return end;
+}
+
+Size SpectrumTextParser::parse(const char* first, const char* last,
+    const Callback& callback) const
+{
+    Size line = 1;
+    Size nScans = 0;
+    const char* p = first;
+    // peaks before the first header form a scan without metadata
+    if (p != last && *p != '#') {
+        Size nLines = 0;
+        const char* end = findEndOfScan(p, last, nLines);
+        bool hasPeaks = false;
+        for (const char* q = p; q != end && !hasPeaks; ++q) {
+            hasPeaks = !isBlank(*q) && *q != '\n';
+        }
+        if (!hasPeaks) {
+            line += nLines;
+            p = end;
+        }
+    }
+    while (p != last) {
+        Spectrum s;
+        p = parseScan(p, last, s, line);
+        callback(std::move(s));
+        ++nScans;
+    }
+    return nScans;
+}
+
+Size SpectrumTextParser::parse(const char* first, const char* last,
+    std::vector<Spectrum>& spectra) const
+{
+    return parse(first, last, [&spectra](Spectrum&& s) {
+        spectra.push_back(std::move(s));
+    });
+}
+
+Size SpectrumTextParser::parseFile(const String& filename,
+    std::vector<Spectrum>& spectra) const
+{
+    MappedFile f(filename);
+    return parse(f.data(), f.data() + f.size(), spectra);
+}
+
+void writeSpectrumText(std::ostream& os, const Spectrum& s)
+{
+    const std::streamsize precision = os.precision(17);
+    os << "# scanNumber=" << s.getScanNumber() << " rt="
+            << s.getRetentionTime() << " msLevel=" << s.getMsLevel()
+            << " totalIonCurrent=" << s.getTotalIonCurrent()
+            << " precursorScanNumber=" << s.getPrecursorScanNumber()
+            << " precursorMz=" << s.getPrecursorMz() << " precursorCharge="
+            << s.getPrecursorCharge() << " precursorAbundance="
+            << s.getPrecursorAbundance() << "\n";
+    for (Spectrum::const_iterator i = s.begin(); i != s.end(); ++i) {
+        os << i->mz << " " << i->abundance << "\n";
+    }
+    os.precision(precision);
+}
+
+} // namespace fe
+
+} // namespace mstk
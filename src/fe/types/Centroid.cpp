@@ -25,6 +25,7 @@
  */
 #include <MSTK/fe/types/Centroid.hpp>
 #include <MSTK/common/Error.hpp>
+#include <utility>
 
 namespace mstk {
 
@@ -70,15 +71,39 @@ Centroid::Centroid(const Centroid& rhs) :
 {
 }
 
-Centroid::Centroid(Double retentionTime, Double mz, UnsignedInt sn, Double ab,
-    Spectrum::const_iterator first, Spectrum::const_iterator last) :
-    rt_(retentionTime), mz_(mz), sn_(sn), ab_(ab), raw_(first, last)
+Centroid::Centroid(Centroid&& rhs) noexcept :
+        rt_(rhs.rt_), mz_(rhs.mz_), sn_(rhs.sn_), ab_(rhs.ab_),
+        raw_(std::move(rhs.raw_))
 {
-    mstk_precondition(retentionTime >= 0.0,
+}
+
+Centroid& Centroid::operator=(const Centroid& rhs)
+{
+    rt_ = rhs.rt_;
+    mz_ = rhs.mz_;
+    sn_ = rhs.sn_;
+    ab_ = rhs.ab_;
+    raw_ = rhs.raw_;
+    return *this;
+}
+
+Centroid& Centroid::operator=(Centroid&& rhs) noexcept
+{
+    rt_ = rhs.rt_;
+    mz_ = rhs.mz_;
+    sn_ = rhs.sn_;
+    ab_ = rhs.ab_;
+    raw_ = std::move(rhs.raw_);
+    return *this;
+}
+
+void Centroid::checkPreconditions() const
+{
+    mstk_precondition(rt_ >= 0.0,
             "mstk::Centroid retention times cannot be negative.");
-    mstk_precondition(mz >= 0.0,
+    mstk_precondition(mz_ >= 0.0,
             "mstk::Centroid m/z ratios cannot be negative.");
-    mstk_precondition(ab >= 0.0,
+    mstk_precondition(ab_ >= 0.0,
             "mstk::Centroid abundance cannot be negative.");
 }
 
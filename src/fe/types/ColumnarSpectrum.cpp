@@ -0,0 +1,115 @@
+/*
+ * ColumnarSpectrum.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <MSTK/fe/types/ColumnarSpectrum.hpp>
+#include <MSTK/common/Error.hpp>
+
+namespace mstk {
+
+namespace fe {
+
+ColumnarSpectrum::ColumnarSpectrum() :
+    mz_(), ab_(), rt_(0.0), msLevel_(0), scanNumber_(0),
+    totalIonCurrent_(0.0), precursorScanNumber_(0), precursorMz_(0.0),
+    precursorCharge_(0), precursorAbundance_(0.0)
+{
+}
+
+ColumnarSpectrum::ColumnarSpectrum(const Spectrum& s) :
+    mz_(), ab_(), rt_(s.getRetentionTime()), msLevel_(s.getMsLevel()),
+    scanNumber_(s.getScanNumber()),
+    totalIonCurrent_(s.getTotalIonCurrent()),
+    precursorScanNumber_(s.getPrecursorScanNumber()),
+    precursorMz_(s.getPrecursorMz()),
+    precursorCharge_(s.getPrecursorCharge()),
+    precursorAbundance_(s.getPrecursorAbundance())
+{
+    mz_.reserve(s.size());
+    ab_.reserve(s.size());
+    for (Spectrum::const_iterator i = s.begin(); i != s.end(); ++i) {
+        mz_.push_back(i->mz);
+        ab_.push_back(i->abundance);
+    }
+}
+
+ColumnarSpectrum::ColumnarSpectrum(const std::vector<double>& mz,
+    const std::vector<double>& abundances) :
+    mz_(mz.begin(), mz.end()), ab_(abundances.begin(), abundances.end()),
+    rt_(0.0), msLevel_(0), scanNumber_(0), totalIonCurrent_(0.0),
+    precursorScanNumber_(0), precursorMz_(0.0), precursorCharge_(0),
+    precursorAbundance_(0.0)
+{
+    mstk_precondition(mz.size() == abundances.size(),
+            "ColumnarSpectrum: m/z and abundance columns must have the same size.");
+}
+
+bool ColumnarSpectrum::operator==(const ColumnarSpectrum& s) const
+{
+    return mz_ == s.mz_ && ab_ == s.ab_ && msLevel_ == s.msLevel_
+            && rt_ == s.rt_ && s.scanNumber_ == scanNumber_
+            && s.totalIonCurrent_ == totalIonCurrent_
+            && s.precursorScanNumber_ == precursorScanNumber_
+            && s.precursorMz_ == precursorMz_
+            && s.precursorCharge_ == precursorCharge_
+            && s.precursorAbundance_ == precursorAbundance_;
+}
+
+Spectrum ColumnarSpectrum::toSpectrum() const
+{
+    Spectrum s;
+    s.reserve(size());
+    for (size_type i = 0; i < size(); ++i) {
+        s.push_back(SpectrumElement(mz_[i], ab_[i]));
+    }
+    s.setRetentionTime(rt_);
+    s.setMsLevel(msLevel_);
+    s.setScanNumber(scanNumber_);
+    s.setTotalIonCurrent(totalIonCurrent_);
+    s.setPrecursorScanNumber(precursorScanNumber_);
+    s.setPrecursorMz(precursorMz_);
+    s.setPrecursorCharge(precursorCharge_);
+    s.setPrecursorAbundance(precursorAbundance_);
+    return s;
+}
+
+void ColumnarSpectrum::clear()
+{
+    mz_.clear();
+    ab_.clear();
+    rt_ = 0.0;
+    msLevel_ = 0;
+    scanNumber_ = 0;
+    totalIonCurrent_ = 0.0;
+    precursorScanNumber_ = 0;
+    precursorMz_ = 0.0;
+    precursorCharge_ = 0;
+    precursorAbundance_ = 0.0;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
@@ -0,0 +1,183 @@
+/*
+ * CompactCentroid.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/CompactCentroid.hpp>
+#include <MSTK/common/Error.hpp>
+#include <iostream>
+
+namespace mstk {
+
+namespace fe {
+
+double& CompactCentroid::MzAccessor::operator()(CompactCentroid& c)
+{
+    return c.mz_;
+}
+
+double CompactCentroid::MzAccessor::operator()(const CompactCentroid& c) const
+{
+    return c.mz_;
+}
+
+double& CompactCentroid::RtAccessor::operator()(CompactCentroid& c)
+{
+    return c.rt_;
+}
+
+double CompactCentroid::RtAccessor::operator()(const CompactCentroid& c) const
+{
+    return c.rt_;
+}
+
+double& CompactCentroid::AbundanceAccessor::operator()(CompactCentroid& c)
+{
+    return c.ab_;
+}
+
+double CompactCentroid::AbundanceAccessor::operator()(
+    const CompactCentroid& c) const
+{
+    return c.ab_;
+}
+
+CompactCentroid::CompactCentroid() :
+    rt_(0.0), mz_(0.0), ab_(0.0), sn_(0), raw_()
+{
+}
+
+CompactCentroid::CompactCentroid(Double retentionTime, Double mz,
+    UnsignedInt sn, Double ab, const RawDataHandle& h) :
+    rt_(retentionTime), mz_(mz), ab_(ab), sn_(sn), raw_(h)
+{
+    mstk_precondition(retentionTime >= 0.0,
+            "mstk::CompactCentroid retention times cannot be negative.");
+    mstk_precondition(mz >= 0.0,
+            "mstk::CompactCentroid m/z ratios cannot be negative.");
+    mstk_precondition(ab >= 0.0,
+            "mstk::CompactCentroid abundance cannot be negative.");
+}
+
+bool CompactCentroid::operator==(const CompactCentroid& rhs) const
+{
+    return (rt_ == rhs.rt_ && mz_ == rhs.mz_ && sn_ == rhs.sn_ && ab_
+            == rhs.ab_ && raw_ == rhs.raw_);
+}
+
+Double CompactCentroid::getRetentionTime() const
+{
+    return rt_;
+}
+
+void CompactCentroid::setRetentionTime(const Double rt)
+{
+    mstk_precondition(rt >= 0.0,
+            "mstk::CompactCentroid retention times cannot be negative.");
+    rt_ = rt;
+}
+
+Double CompactCentroid::getMz() const
+{
+    return mz_;
+}
+
+void CompactCentroid::setMz(const Double mz)
+{
+    mstk_precondition(mz >= 0.0,
+            "mstk::CompactCentroid m/z ratios cannot be negative.");
+    mz_ = mz;
+}
+
+UnsignedInt CompactCentroid::getScanNumber() const
+{
+    return sn_;
+}
+
+void CompactCentroid::setScanNumber(const UnsignedInt sn)
+{
+    sn_ = sn;
+}
+
+Double CompactCentroid::getAbundance() const
+{
+    return ab_;
+}
+
+void CompactCentroid::setAbundance(const Double ab)
+{
+    mstk_precondition(ab >= 0.0,
+            "mstk::CompactCentroid abundance cannot be negative.");
+    ab_ = ab;
+}
+
+const RawDataHandle& CompactCentroid::getRawDataHandle() const
+{
+    return raw_;
+}
+
+void CompactCentroid::setRawDataHandle(const RawDataHandle& h)
+{
+    raw_ = h;
+}
+
+SpectrumView CompactCentroid::getRawData(const RawDataStore& store) const
+{
+    return store.get(raw_);
+}
+
+bool CompactCentroid::LessThanRt::operator()(const CompactCentroid& lhs,
+    const CompactCentroid& rhs)
+{
+    return lhs.getRetentionTime() < rhs.getRetentionTime();
+}
+
+bool CompactCentroid::LessThanMz::operator()(const CompactCentroid& lhs,
+    const CompactCentroid& rhs)
+{
+    return lhs.getMz() < rhs.getMz();
+}
+
+bool CompactCentroid::LessThanScanNumber::operator()(
+    const CompactCentroid& lhs, const CompactCentroid& rhs)
+{
+    return lhs.getScanNumber() < rhs.getScanNumber();
+}
+
+bool CompactCentroid::LessThanAbundance::operator()(
+    const CompactCentroid& lhs, const CompactCentroid& rhs)
+{
+    return lhs.getAbundance() < rhs.getAbundance();
+}
+
+std::ostream& operator<<(std::ostream& os, const CompactCentroid& c)
+{
+    os << c.getRetentionTime() << '\t' << c.getScanNumber() << '\t'
+            << c.getMz() << '\t' << c.getAbundance();
+    return os;
+}
+
+} // namespace fe
+
+} // namespace mstk
+
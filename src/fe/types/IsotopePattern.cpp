@@ -25,8 +25,10 @@
  */
 #include <MSTK/fe/types/IsotopePattern.hpp>
 #include <MSTK/common/Error.hpp>
+#include <MSTK/fe/AveragineSplitter.hpp>
 
 #include <functional>
+#include <utility>
 
 // anonymous namespace for local stuff
 namespace {
@@ -47,15 +49,45 @@ namespace mstk {
 namespace fe {
 
 IsotopePattern::IsotopePattern() :
-    Collection<Xic> ()
+    StaticCollection<IsotopePattern, Xic>()
 {
 }
 
 IsotopePattern::IsotopePattern(const_iterator first, const_iterator last) :
-    Collection<Xic>(first, last)
+    StaticCollection<IsotopePattern, Xic>(first, last)
 {
 }
 
+IsotopePattern::IsotopePattern(std::vector<Xic>&& xics) :
+    StaticCollection<IsotopePattern, Xic>(std::move(xics))
+{
+}
+
+IsotopePattern::IsotopePattern(const IsotopePattern& rhs) :
+    StaticCollection<IsotopePattern, Xic>(rhs), charges_(rhs.charges_)
+{
+}
+
+IsotopePattern::IsotopePattern(IsotopePattern&& rhs) noexcept :
+    StaticCollection<IsotopePattern, Xic>(std::move(rhs)),
+            charges_(std::move(rhs.charges_))
+{
+}
+
+IsotopePattern& IsotopePattern::operator=(const IsotopePattern& rhs)
+{
+    c_ = rhs.c_;
+    charges_ = rhs.charges_;
+    return *this;
+}
+
+IsotopePattern& IsotopePattern::operator=(IsotopePattern&& rhs) noexcept
+{
+    c_ = std::move(rhs.c_);
+    charges_ = std::move(rhs.charges_);
+    return *this;
+}
+
 void IsotopePattern::setCharges(const std::set<int>& z)
 {
     charges_ = z;
@@ -93,9 +125,11 @@ void IsotopePattern::asSpectrum(Spectrum& ss) const
 
 void IsotopePattern::split(std::vector<IsotopePattern>& pips)
 {
-    // TODO: implement!
-    mstk_fail("not implemented");
-    return;
+    // without envelope information, chains are chosen by abundance alone
+    AveragineSplitter<> splitter;
+    IsotopePattern ip(*this);
+    pips.clear();
+    splitter.splitPattern(ip, pips);
 }
 
 double IsotopePattern::getAbundance() const
@@ -116,7 +150,7 @@ std::ostream& operator<<(std::ostream& os, const IsotopePattern& p)
     }
     os << '\t' << p.getAbundance();
     /*
-    typedef Collection<Xic>::const_iterator IT;
+    typedef IsotopePattern::const_iterator IT;
     for (IT i = p.begin(); i != p.end(); ++i) {
         os << *i << '\n';
     }
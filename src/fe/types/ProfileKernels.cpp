@@ -0,0 +1,126 @@
+/*
+ * ProfileKernels.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/ProfileKernels.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MSTK_PROFILEKERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace mstk {
+
+namespace fe {
+
+namespace {
+
+/** The pairwise reduction of the eight partial sums shared by all paths.
+ */
+inline double reduceSums(const double* s)
+{
+    return ((s[0] + s[1]) + (s[2] + s[3])) + ((s[4] + s[5]) + (s[6] + s[7]));
+}
+
+///
+/// scalar kernels
+///
+
+double dotProductScalar(const double* l, const double* r, const Size n)
+{
+    double s[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    Size i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (Size k = 0; k < 8; ++k) {
+            s[k] += l[i + k] * r[i + k];
+        }
+    }
+    for (Size k = 0; i < n; ++i, ++k) {
+        s[k] += l[i] * r[i];
+    }
+    return reduceSums(s);
+}
+
+#ifdef MSTK_PROFILEKERNELS_X86
+
+///
+/// AVX2 kernels. Multiplication and addition are kept separate (no FMA) to
+/// match the rounding of the scalar kernel.
+///
+
+__attribute__((target("avx2")))
+double dotProductAvx2(const double* l, const double* r, const Size n)
+{
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    Size i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(l + i),
+            _mm256_loadu_pd(r + i)));
+        s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(l + i + 4),
+            _mm256_loadu_pd(r + i + 4)));
+    }
+    double s[8];
+    _mm256_storeu_pd(s, s0);
+    _mm256_storeu_pd(s + 4, s1);
+    for (Size k = 0; i < n; ++i, ++k) {
+        s[k] += l[i] * r[i];
+    }
+    return reduceSums(s);
+}
+
+#endif // MSTK_PROFILEKERNELS_X86
+
+const ProfileKernels scalarKernels = { &dotProductScalar,
+        InstructionSet::SCALAR };
+
+#ifdef MSTK_PROFILEKERNELS_X86
+// Elution profiles are short (tens of scans); wider vectors do not pay off
+// and AVX-512 hosts use the AVX2 kernels.
+const ProfileKernels avx2Kernels = { &dotProductAvx2, InstructionSet::AVX2 };
+#endif
+
+} // namespace
+
+const ProfileKernels& ProfileKernels::get()
+{
+    static const ProfileKernels& kernels = get(InstructionSet::AVX512);
+    return kernels;
+}
+
+const ProfileKernels& ProfileKernels::get(const InstructionSet::Level level)
+{
+    const InstructionSet::Level l = level < InstructionSet::getSupported()
+            ? level : InstructionSet::getSupported();
+#ifdef MSTK_PROFILEKERNELS_X86
+    if (l >= InstructionSet::AVX2) {
+        return avx2Kernels;
+    }
+#endif
+    return scalarKernels;
+}
+
+} // namespace fe
+
+} // namespace mstk
@@ -0,0 +1,92 @@
+/*
+ * RawDataStore.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/RawDataStore.hpp>
+#include <MSTK/common/Error.hpp>
+
+namespace mstk {
+
+namespace fe {
+
+RawDataStore::RawDataStore() :
+    mz_(), ab_(), offsets_(1, 0)
+{
+}
+
+SpectrumView RawDataStore::getScan(const UnsignedInt scanIndex) const
+{
+    mstk_precondition(scanIndex < size(),
+            "RawDataStore::getScan(): scan index out of range.");
+    Size first = offsets_[scanIndex];
+    return SpectrumView(mz_.data() + first, ab_.data() + first,
+        offsets_[scanIndex + 1] - first);
+}
+
+SpectrumView RawDataStore::get(const RawDataHandle& h) const
+{
+    if (!h.isValid()) {
+        return SpectrumView();
+    }
+    mstk_precondition(h.scanIndex < size(),
+            "RawDataStore::get(): scan index out of range.");
+    Size first = offsets_[h.scanIndex] + h.offset;
+    mstk_precondition(first + h.length <= offsets_[h.scanIndex + 1],
+            "RawDataStore::get(): handle exceeds the scan.");
+    return SpectrumView(mz_.data() + first, ab_.data() + first, h.length);
+}
+
+Size RawDataStore::size() const
+{
+    return offsets_.size() - 1;
+}
+
+bool RawDataStore::empty() const
+{
+    return offsets_.size() == 1;
+}
+
+Size RawDataStore::getNumberOfPoints() const
+{
+    return ab_.size();
+}
+
+void RawDataStore::reserve(const Size nScans, const Size nPoints)
+{
+    offsets_.reserve(nScans + 1);
+    mz_.reserve(nPoints);
+    ab_.reserve(nPoints);
+}
+
+void RawDataStore::clear()
+{
+    mz_.clear();
+    ab_.clear();
+    offsets_.assign(1, 0);
+}
+
+} // namespace fe
+
+} // namespace mstk
+
@@ -0,0 +1,180 @@
+/*
+ * ScanTable.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/ScanTable.hpp>
+#include <MSTK/common/Error.hpp>
+
+namespace mstk {
+
+namespace fe {
+
+const Size ScanTable::npos = std::numeric_limits<Size>::max();
+
+namespace {
+
+/** Gather \c column in the given order.
+ */
+template<typename T>
+void permuteColumn(std::vector<T>& column, const std::vector<Size>& order)
+{
+    std::vector<T> permuted;
+    permuted.reserve(column.size());
+    for (Size i = 0; i < order.size(); ++i) {
+        permuted.push_back(column[order[i]]);
+    }
+    column.swap(permuted);
+}
+
+} // namespace
+
+SpectrumRange ScanTable::Row::getPeaks() const
+{
+    Spectrum::const_iterator first = table_->peaks_.begin()
+            + table_->peakOffset_[index_];
+    return SpectrumRange(first, first + table_->peakCount_[index_]);
+}
+
+Spectrum ScanTable::Row::toSpectrum() const
+{
+    SpectrumRange peaks = getPeaks();
+    Spectrum s(peaks.first, peaks.second);
+    s.setRetentionTime(getRetentionTime());
+    s.setMsLevel(getMsLevel());
+    s.setScanNumber(getScanNumber());
+    s.setTotalIonCurrent(getTotalIonCurrent());
+    s.setPrecursorScanNumber(getPrecursorScanNumber());
+    s.setPrecursorMz(getPrecursorMz());
+    s.setPrecursorCharge(getPrecursorCharge());
+    s.setPrecursorAbundance(getPrecursorAbundance());
+    return s;
+}
+
+ScanTable::ScanTable() :
+    sortedByRt_(true)
+{
+}
+
+void ScanTable::reserve(const Size nScans, const Size nPeaks)
+{
+    rt_.reserve(nScans);
+    msLevel_.reserve(nScans);
+    scanNumber_.reserve(nScans);
+    totalIonCurrent_.reserve(nScans);
+    precursorScanNumber_.reserve(nScans);
+    precursorMz_.reserve(nScans);
+    precursorCharge_.reserve(nScans);
+    precursorAbundance_.reserve(nScans);
+    peakOffset_.reserve(nScans);
+    peakCount_.reserve(nScans);
+    peaks_.reserve(nPeaks);
+    scanNumberIndex_.reserve(nScans);
+}
+
+Size ScanTable::add(const Spectrum& s)
+{
+    const Size row = size();
+    if (!rt_.empty() && s.getRetentionTime() < rt_.back()) {
+        sortedByRt_ = false;
+    }
+    peakOffset_.push_back(peaks_.size());
+    peakCount_.push_back(s.size());
+    peaks_.insert(peaks_.end(), s.begin(), s.end());
+    rt_.push_back(s.getRetentionTime());
+    msLevel_.push_back(s.getMsLevel());
+    scanNumber_.push_back(s.getScanNumber());
+    totalIonCurrent_.push_back(s.getTotalIonCurrent());
+    precursorScanNumber_.push_back(s.getPrecursorScanNumber());
+    precursorMz_.push_back(s.getPrecursorMz());
+    precursorCharge_.push_back(s.getPrecursorCharge());
+    precursorAbundance_.push_back(s.getPrecursorAbundance());
+    // keeps the first row for duplicate scan numbers
+    scanNumberIndex_.insert(std::make_pair(s.getScanNumber(), row));
+    return row;
+}
+
+void ScanTable::clear()
+{
+    rt_.clear();
+    msLevel_.clear();
+    scanNumber_.clear();
+    totalIonCurrent_.clear();
+    precursorScanNumber_.clear();
+    precursorMz_.clear();
+    precursorCharge_.clear();
+    precursorAbundance_.clear();
+    peakOffset_.clear();
+    peakCount_.clear();
+    peaks_.clear();
+    scanNumberIndex_.clear();
+    sortedByRt_ = true;
+}
+
+Size ScanTable::findScanNumber(const unsigned int scanNumber) const
+{
+    std::unordered_map<unsigned int, Size>::const_iterator i =
+            scanNumberIndex_.find(scanNumber);
+    return i == scanNumberIndex_.end() ? npos : i->second;
+}
+
+std::pair<Size, Size> ScanTable::findRetentionTimeRange(
+    const double beginRt, const double endRt) const
+{
+    mstk_precondition(sortedByRt_,
+        "ScanTable::findRetentionTimeRange(): rows must be sorted by retention time.");
+    std::vector<double>::const_iterator first = std::lower_bound(rt_.begin(),
+        rt_.end(), beginRt);
+    std::vector<double>::const_iterator last = std::upper_bound(first,
+        rt_.end(), endRt);
+    return std::make_pair(static_cast<Size> (first - rt_.begin()),
+        static_cast<Size> (last - rt_.begin()));
+}
+
+void ScanTable::permute(const std::vector<Size>& order)
+{
+    permuteColumn(rt_, order);
+    permuteColumn(msLevel_, order);
+    permuteColumn(scanNumber_, order);
+    permuteColumn(totalIonCurrent_, order);
+    permuteColumn(precursorScanNumber_, order);
+    permuteColumn(precursorMz_, order);
+    permuteColumn(precursorCharge_, order);
+    permuteColumn(precursorAbundance_, order);
+    permuteColumn(peakOffset_, order);
+    permuteColumn(peakCount_, order);
+    reindex();
+}
+
+void ScanTable::reindex()
+{
+    scanNumberIndex_.clear();
+    for (Size i = 0; i < size(); ++i) {
+        scanNumberIndex_.insert(std::make_pair(scanNumber_[i], i));
+    }
+    sortedByRt_ = std::is_sorted(rt_.begin(), rt_.end());
+}
+
+} // namespace fe
+
+} // namespace mstk
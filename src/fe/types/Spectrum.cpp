@@ -26,20 +26,23 @@
  */
 
 #include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumKernels.hpp>
 #include <MSTK/common/Error.hpp>
+#include <MSTK/common/Types.hpp>
 #include <numeric>
 #include <fstream>
 #include <iostream>
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <utility>
 
 namespace mstk {
 
 namespace fe {
 
 Spectrum::Spectrum()
-  : Collection<SpectrumElement>(), rt_(0.0), msLevel_(0), 
+  : StaticCollection<Spectrum, SpectrumElement>(), rt_(0.0), msLevel_(0), 
   scanNumber_(0), totalIonCurrent_(0.0), precursorScanNumber_(0),
   precursorMz_(0.0), precursorCharge_(0), precursorAbundance_(0.0)
 {}
@@ -47,7 +50,7 @@ Spectrum::Spectrum()
 /** Range constructor.
  */
 Spectrum::Spectrum(iterator first, iterator last) 
-  : Collection<SpectrumElement>(first, last),
+  : StaticCollection<Spectrum, SpectrumElement>(first, last),
   rt_(0.0), msLevel_(0), 
   scanNumber_(0), totalIonCurrent_(0.0), precursorScanNumber_(0),
   precursorMz_(0.0), precursorCharge_(0), precursorAbundance_(0.0)
@@ -56,7 +59,7 @@ Spectrum::Spectrum(iterator first, iterator last)
 /** Range constructor.
  */
 Spectrum::Spectrum(const_iterator first, const_iterator last) 
-  : Collection<SpectrumElement>(first, last),
+  : StaticCollection<Spectrum, SpectrumElement>(first, last),
   rt_(0.0), msLevel_(0), 
   scanNumber_(0), totalIonCurrent_(0.0), precursorScanNumber_(0),
   precursorMz_(0.0), precursorCharge_(0), precursorAbundance_(0.0)
@@ -64,7 +67,7 @@ Spectrum::Spectrum(const_iterator first, const_iterator last)
 
 Spectrum::Spectrum(const std::vector<double>& mz, 
   const std::vector<double>& abundances)
-  : Collection<SpectrumElement>()
+  : StaticCollection<Spectrum, SpectrumElement>()
 {
     // call default constructor
     clear();
@@ -76,6 +79,24 @@ Spectrum::Spectrum(const std::vector<double>& mz,
     }
 }
 
+Spectrum::Spectrum(const Spectrum& rhs)
+  : StaticCollection<Spectrum, SpectrumElement>(rhs),
+  rt_(rhs.rt_), msLevel_(rhs.msLevel_), scanNumber_(rhs.scanNumber_),
+  totalIonCurrent_(rhs.totalIonCurrent_),
+  precursorScanNumber_(rhs.precursorScanNumber_),
+  precursorMz_(rhs.precursorMz_), precursorCharge_(rhs.precursorCharge_),
+  precursorAbundance_(rhs.precursorAbundance_)
+{}
+
+Spectrum::Spectrum(Spectrum&& rhs) noexcept
+  : StaticCollection<Spectrum, SpectrumElement>(std::move(rhs)),
+  rt_(rhs.rt_), msLevel_(rhs.msLevel_), scanNumber_(rhs.scanNumber_),
+  totalIonCurrent_(rhs.totalIonCurrent_),
+  precursorScanNumber_(rhs.precursorScanNumber_),
+  precursorMz_(rhs.precursorMz_), precursorCharge_(rhs.precursorCharge_),
+  precursorAbundance_(rhs.precursorAbundance_)
+{}
+
 // destructor
 Spectrum::~Spectrum()
 {
@@ -97,6 +118,23 @@ Spectrum& Spectrum::operator=(const Spectrum& rhs)
     }
     return *this;
 }
+
+Spectrum& Spectrum::operator=(Spectrum&& rhs) noexcept
+{
+    if (this != &rhs) {
+        rt_ = rhs.rt_;
+        msLevel_ = rhs.msLevel_;
+        scanNumber_ = rhs.scanNumber_;
+        totalIonCurrent_ = rhs.totalIonCurrent_;
+        precursorScanNumber_ = rhs.precursorScanNumber_;
+        precursorMz_ = rhs.precursorMz_;
+        precursorCharge_ = rhs.precursorCharge_;
+        precursorAbundance_ = rhs.precursorAbundance_;
+        c_ = std::move(rhs.c_);
+        rhs.c_.clear();
+    }
+    return *this;
+}
    
 bool Spectrum::operator==(const Spectrum& s) const {
     return c_ == s.c_ && msLevel_ == s.msLevel_ && rt_ == s.rt_
@@ -141,22 +179,43 @@ Spectrum Spectrum::subset(const double beginMz,
 void Spectrum::shiftTo(const double to)
 {
     if (!empty()) {
-        double diff = to - c_[0].mz;
-        transform(c_.begin(), c_.end(), c_.begin(), 
-          Spectrum::ShiftMz(diff));
+        shiftBy(to - c_[0].mz);
     }
 }
 
 void Spectrum::shiftBy(const double by)
 {
-    transform(c_.begin(), c_.end(), c_.begin(), Spectrum::ShiftMz(by));
+    transformMz(1.0, by);
+}
+
+void Spectrum::transformMz(const double scale, const double offset)
+{
+    if (!empty()) {
+        SpectrumKernels::get().transformMz(&c_[0], size(), scale, offset);
+    }
+}
+
+void Spectrum::scaleAbundances(const double factor)
+{
+    if (!empty()) {
+        SpectrumKernels::get().scaleAbundances(&c_[0], size(), factor);
+    }
+}
+
+void Spectrum::normalizeAbundances(const double to)
+{
+    if (!empty()) {
+        const double max = getMaxAbundancePeak()->abundance;
+        if (max > 0.0) {
+            scaleAbundances(to / max);
+        }
+    }
 }
 
 void Spectrum::shiftMaxToMonoisotopicMass(void)
 {
     if (!empty()) {
-        iterator maxIdx = std::max_element(c_.begin(), c_.end(), 
-          LessThanAbundance<Spectrum::Element, Spectrum::Element>());
+        iterator maxIdx = getMaxAbundancePeak();
         if (maxIdx != c_.begin()) {
             shiftBy(c_[0].mz - (maxIdx->mz));
         }
@@ -165,76 +224,240 @@ void Spectrum::shiftMaxToMonoisotopicMass(void)
 
 Spectrum::const_iterator Spectrum::getMaxAbundancePeak() const
 {
-    return std::max_element(begin(), end(), Spectrum::LessThanAbundance<
-      Spectrum::Element, Spectrum::Element>());
+    if (empty()) {
+        return end();
+    }
+    return begin() + SpectrumKernels::get().findMaxAbundance(&c_[0], size());
 }
 
 Spectrum::iterator Spectrum::getMaxAbundancePeak()
 {
-    return std::max_element(begin(), end(), Spectrum::LessThanAbundance<
-      Spectrum::Element, Spectrum::Element>());
+    if (empty()) {
+        return end();
+    }
+    return begin() + SpectrumKernels::get().findMaxAbundance(&c_[0], size());
 }
 
-double Spectrum::getTotalAbundance()
+double Spectrum::getTotalAbundance() const
 {
-    return std::accumulate(begin(), end(), 0.0, Spectrum::SumAbundance());
+    if (empty()) {
+        return 0.0;
+    }
+    return SpectrumKernels::get().sumAbundances(&c_[0], size());
 }
 
 void Spectrum::merge(const Spectrum& other)
 {
     // FIXME: check ms levels and do something smart w/ the member variables
-    iterator s1 = begin();
+    // Merge into a fresh buffer in a single pass; inserting into c_ while
+    // walking it is quadratic.
+    std::vector<Element, allocator_type> merged;
+    merged.reserve(size() + other.size());
+    const_iterator s1 = begin();
     const_iterator s2 = other.begin();
-
     while (s1 != end() && s2 != other.end()) {
         if (s1->mz < s2->mz) {
-            //s1 is behind
+            merged.push_back(*s1);
             ++s1;
-        }
-        else if (s1->mz > s2->mz) {
-            //s2 is behind
-            s1 = insert(s1, Element(s2->mz, s2->abundance));
+        } else if (s1->mz > s2->mz) {
+            merged.push_back(*s2);
             ++s2;
-        }
-        else { /*s1->mz == s2->mz */
-            *s1 = Element(s1->mz, s1->abundance + s2->abundance);
+        } else { /*s1->mz == s2->mz */
+            merged.push_back(Element(s1->mz, s1->abundance + s2->abundance));
             ++s1;
             ++s2;
         }
     }
-    // if we terminated because we reached the end of
-    // this->sepctrum_, add the remainder
-    std::copy(s2, other.end(), std::back_inserter(c_));
+    // add the remainder of whichever spectrum is left
+    merged.insert(merged.end(), s1, const_iterator(end()));
+    merged.insert(merged.end(), s2, other.end());
+    c_.swap(merged);
+}
+
+namespace {
+
+/** The current position in one of the spectra of a k-way merge.
+ */
+struct MergeCursor
+{
+    Spectrum::const_iterator pos;
+    Spectrum::const_iterator last;
+    Size index;
+};
+
+/** Heap order for a min-heap on m/z; ties are resolved by the input order
+ * of the spectra, which makes the summation order deterministic.
+ */
+struct LaterCursor
+{
+    bool operator()(const MergeCursor& lhs, const MergeCursor& rhs) const
+    {
+        if (lhs.pos->mz != rhs.pos->mz) {
+            return lhs.pos->mz > rhs.pos->mz;
+        }
+        return lhs.index > rhs.index;
+    }
+};
+
+} // namespace
+
+Spectrum mergeSpectrumRanges(const std::vector<SpectrumRange>& ranges,
+    const double mzTolerance)
+{
+    std::vector<MergeCursor> heap;
+    heap.reserve(ranges.size());
+    Size n = 0;
+    for (Size i = 0; i < ranges.size(); ++i) {
+        if (ranges[i].first != ranges[i].second) {
+            MergeCursor c = { ranges[i].first, ranges[i].second, i };
+            heap.push_back(c);
+            n += std::distance(ranges[i].first, ranges[i].second);
+        }
+    }
+    Spectrum merged;
+    merged.reserve(n);
+    LaterCursor later;
+    std::make_heap(heap.begin(), heap.end(), later);
+    // the peak group under construction; m/z offsets are taken relative to
+    // the first peak, so groups of identical m/z keep their m/z exactly
+    bool open = false;
+    double anchor = 0.0;
+    double sumAb = 0.0;
+    double sumDmzAb = 0.0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        MergeCursor& c = heap.back();
+        const Spectrum::Element& e = *c.pos;
+        if (open && (e.mz == anchor || e.mz - anchor < mzTolerance)) {
+            sumAb += e.abundance;
+            sumDmzAb += (e.mz - anchor) * e.abundance;
+        } else {
+            if (open) {
+                merged.push_back(Spectrum::Element(sumAb > 0.0 ? anchor
+                        + sumDmzAb / sumAb : anchor, sumAb));
+            }
+            open = true;
+            anchor = e.mz;
+            sumAb = e.abundance;
+            sumDmzAb = 0.0;
+        }
+        if (++c.pos != c.last) {
+            std::push_heap(heap.begin(), heap.end(), later);
+        } else {
+            heap.pop_back();
+        }
+    }
+    if (open) {
+        merged.push_back(Spectrum::Element(sumAb > 0.0 ? anchor + sumDmzAb
+                / sumAb : anchor, sumAb));
+    }
+    return merged;
 }
 
-Spectrum Spectrum::removeDuplicates(double tol)
+namespace {
+
+/** Find the first peak whose successor lies within the tolerance.
+ * Works on blocks of peaks without early exit inside a block, so that the
+ * comparisons within a block are branch-free and independent.
+ * @return The index of the peak or \c n - 1 if there are no duplicates.
+ */
+Size findFirstDuplicate(const SpectrumElement* e, const Size n,
+    const double tol, const double ppm)
 {
-    if (empty() || size() == 1) {
-        return *this;
+    const Size blockSize = 8;
+    Size i = 0;
+    for (; i + blockSize < n; i += blockSize) {
+        int any = 0;
+        for (Size k = i; k < i + blockSize; ++k) {
+            any |= e[k + 1].mz - e[k].mz < tol + ppm * e[k].mz;
+        }
+        if (any) {
+            break;
+        }
     }
-    Spectrum unique;
-    Spectrum::iterator i=this->begin();
-    Spectrum::iterator j=i+1;
-    while (i != this->end()){
-        while (j->mz - i->mz < tol && j!=this->end())
-            ++j;
-        double sumab = 0;
-        double wmz = 0;
-        for (Spectrum::iterator temp = i; temp != j; ++temp) {
-            sumab += temp->abundance;
-            wmz += temp->mz * temp->abundance;
+    for (; i + 1 < n; ++i) {
+        if (e[i + 1].mz - e[i].mz < tol + ppm * e[i].mz) {
+            return i;
+        }
+    }
+    return n - 1;
+}
+
+/** Combine the peaks in [first, last) that lie within the tolerance of the
+ * first peak of their group and write the result to \c out. The output may
+ * alias the input, as long as it does not lie behind \c first.
+ * @return The output iterator past the last written peak.
+ */
+template<typename OutputIterator>
+OutputIterator compactDuplicateRange(const SpectrumElement* first,
+    const SpectrumElement* last, OutputIterator out, const double tol,
+    const double ppm)
+{
+    // m/z offsets are taken relative to the first peak of a group, so groups
+    // of identical m/z keep their m/z exactly
+    while (first != last) {
+        const double anchor = first->mz;
+        const double limit = tol + ppm * anchor;
+        double sumAb = first->abundance;
+        double sumDmzAb = 0.0;
+        for (++first; first != last && first->mz - anchor < limit; ++first) {
+            sumAb += first->abundance;
+            sumDmzAb += (first->mz - anchor) * first->abundance;
         }
-        wmz /= sumab;
-        Spectrum::Element el(wmz, sumab);
-        unique.push_back(el);
-        i=j;
-        if (i != this->end()) {
-            j=i+1;
-        }            
+        *out = SpectrumElement(sumAb > 0.0 ? anchor + sumDmzAb / sumAb
+                : anchor, sumAb);
+        ++out;
+    }
+    return out;
+}
+
+} // namespace
+
+Spectrum Spectrum::removeDuplicates(double tol) const
+{
+    Spectrum unique;
+    unique.rt_ = rt_;
+    unique.msLevel_ = msLevel_;
+    unique.scanNumber_ = scanNumber_;
+    unique.totalIonCurrent_ = totalIonCurrent_;
+    unique.precursorScanNumber_ = precursorScanNumber_;
+    unique.precursorMz_ = precursorMz_;
+    unique.precursorCharge_ = precursorCharge_;
+    unique.precursorAbundance_ = precursorAbundance_;
+    const Size n = size();
+    if (n == 0) {
+        return unique;
     }
+    // copy the duplicate-free prefix as a block and only compact the rest
+    const Element* e = &c_[0];
+    const Size i = findFirstDuplicate(e, n, tol, 0.0);
+    unique.c_.reserve(n);
+    unique.c_.assign(e, e + i);
+    compactDuplicateRange(e + i, e + n, std::back_inserter(unique.c_), tol,
+        0.0);
     return unique;
 }
 
+Spectrum::size_type Spectrum::compactDuplicates(const double tol,
+    const ToleranceUnit unit)
+{
+    const Size n = size();
+    if (n < 2) {
+        return 0;
+    }
+    // tolerance at m/z x: da + ppm * x
+    const double da = unit == TOLERANCE_DA ? tol : 0.0;
+    const double ppm = unit == TOLERANCE_PPM ? tol * 1e-6 : 0.0;
+    Element* e = &c_[0];
+    const Size i = findFirstDuplicate(e, n, da, ppm);
+    if (i == n - 1) {
+        return 0;
+    }
+    const Size w = compactDuplicateRange(e + i, e + n, e + i, da, ppm) - e;
+    c_.erase(c_.begin() + w, c_.end());
+    return n - w;
+}
+
 std::ostream& operator<<(std::ostream& os, Spectrum& p)
 {
     for (Spectrum::iterator i = p.begin(); i != p.end(); ++i) {
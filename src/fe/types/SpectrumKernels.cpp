@@ -0,0 +1,287 @@
+/*
+ * SpectrumKernels.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/SpectrumKernels.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MSTK_SPECTRUMKERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace mstk {
+
+namespace fe {
+
+namespace {
+
+// the kernels address the m/z and abundance values as a double array
+static_assert(sizeof(SpectrumElement) == 2 * sizeof(double),
+    "SpectrumElement must consist of two packed doubles.");
+
+/** The pairwise reduction of the eight partial sums shared by all paths.
+ */
+inline double reduceSums(const double* s)
+{
+    return ((s[0] + s[1]) + (s[2] + s[3])) + ((s[4] + s[5]) + (s[6] + s[7]));
+}
+
+///
+/// scalar kernels
+///
+
+double sumAbundancesScalar(const SpectrumElement* e, const Size n)
+{
+    double s[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    Size i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (Size k = 0; k < 8; ++k) {
+            s[k] += e[i + k].abundance;
+        }
+    }
+    for (Size k = 0; i < n; ++i, ++k) {
+        s[k] += e[i].abundance;
+    }
+    return reduceSums(s);
+}
+
+Size findMaxAbundanceScalar(const SpectrumElement* e, const Size n)
+{
+    if (n == 0) {
+        return 0;
+    }
+    Size best = 0;
+    for (Size i = 1; i < n; ++i) {
+        if (e[best].abundance < e[i].abundance) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void transformMzScalar(SpectrumElement* e, const Size n, const double scale,
+    const double offset)
+{
+    for (Size i = 0; i < n; ++i) {
+        e[i].mz = e[i].mz * scale + offset;
+    }
+}
+
+void scaleAbundancesScalar(SpectrumElement* e, const Size n,
+    const double factor)
+{
+    for (Size i = 0; i < n; ++i) {
+        e[i].abundance *= factor;
+    }
+}
+
+#ifdef MSTK_SPECTRUMKERNELS_X86
+
+///
+/// AVX2 kernels; element pairs are loaded as [mz0 ab0 mz1 ab1]
+///
+
+__attribute__((target("avx2")))
+double sumAbundancesAvx2(const SpectrumElement* e, const Size n)
+{
+    const double* d = reinterpret_cast<const double*> (e);
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    Size i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const double* p = d + 2 * i;
+        // [ab0 ab2 ab1 ab3] and [ab4 ab6 ab5 ab7]
+        s0 = _mm256_add_pd(s0, _mm256_unpackhi_pd(_mm256_loadu_pd(p),
+            _mm256_loadu_pd(p + 4)));
+        s1 = _mm256_add_pd(s1, _mm256_unpackhi_pd(_mm256_loadu_pd(p + 8),
+            _mm256_loadu_pd(p + 12)));
+    }
+    // restore the partial sum order of the scalar kernel
+    double s[8];
+    _mm256_storeu_pd(s, _mm256_permute4x64_pd(s0, 0xD8));
+    _mm256_storeu_pd(s + 4, _mm256_permute4x64_pd(s1, 0xD8));
+    for (Size k = 0; i < n; ++i, ++k) {
+        s[k] += e[i].abundance;
+    }
+    return reduceSums(s);
+}
+
+__attribute__((target("avx2")))
+Size findMaxAbundanceAvx2(const SpectrumElement* e, const Size n)
+{
+    if (n < 8) {
+        return findMaxAbundanceScalar(e, n);
+    }
+    const double* d = reinterpret_cast<const double*> (e);
+    // first pass: the maximum value
+    __m256d m = _mm256_set1_pd(e[0].abundance);
+    Size i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const double* p = d + 2 * i;
+        m = _mm256_max_pd(m, _mm256_unpackhi_pd(_mm256_loadu_pd(p),
+            _mm256_loadu_pd(p + 4)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, m);
+    double max = lanes[0];
+    for (Size k = 1; k < 4; ++k) {
+        max = max < lanes[k] ? lanes[k] : max;
+    }
+    for (; i < n; ++i) {
+        max = max < e[i].abundance ? e[i].abundance : max;
+    }
+    // second pass: its first position
+    const __m256d vmax = _mm256_set1_pd(max);
+    for (i = 0; i + 4 <= n; i += 4) {
+        const double* p = d + 2 * i;
+        const __m256d a = _mm256_unpackhi_pd(_mm256_loadu_pd(p),
+            _mm256_loadu_pd(p + 4));
+        if (_mm256_movemask_pd(_mm256_cmp_pd(a, vmax, _CMP_EQ_OQ))) {
+            break;
+        }
+    }
+    for (; i < n; ++i) {
+        if (e[i].abundance == max) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+///
+/// AVX-512 kernels; four element pairs per register
+///
+
+__attribute__((target("avx512f")))
+double sumAbundancesAvx512(const SpectrumElement* e, const Size n)
+{
+    const double* d = reinterpret_cast<const double*> (e);
+    const __m512i odd = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+    __m512d s = _mm512_setzero_pd();
+    Size i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const double* p = d + 2 * i;
+        s = _mm512_add_pd(s, _mm512_permutex2var_pd(_mm512_loadu_pd(p), odd,
+            _mm512_loadu_pd(p + 8)));
+    }
+    double sums[8];
+    _mm512_storeu_pd(sums, s);
+    for (Size k = 0; i < n; ++i, ++k) {
+        sums[k] += e[i].abundance;
+    }
+    return reduceSums(sums);
+}
+
+__attribute__((target("avx512f")))
+Size findMaxAbundanceAvx512(const SpectrumElement* e, const Size n)
+{
+    if (n < 8) {
+        return findMaxAbundanceScalar(e, n);
+    }
+    const double* d = reinterpret_cast<const double*> (e);
+    const __m512i odd = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+    __m512d m = _mm512_set1_pd(e[0].abundance);
+    Size i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const double* p = d + 2 * i;
+        const __m512d a = _mm512_permutex2var_pd(_mm512_loadu_pd(p), odd,
+            _mm512_loadu_pd(p + 8));
+        // a compare and blend rather than _mm512_max_pd, whose undefined
+        // pass-through operand trips -Wmaybe-uninitialized in GCC; it also
+        // keeps the scalar semantics for NaN
+        m = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, m, _CMP_GT_OQ), m, a);
+    }
+    double lanes[8];
+    _mm512_storeu_pd(lanes, m);
+    double max = lanes[0];
+    for (Size k = 1; k < 8; ++k) {
+        max = max < lanes[k] ? lanes[k] : max;
+    }
+    for (; i < n; ++i) {
+        max = max < e[i].abundance ? e[i].abundance : max;
+    }
+    const __m512d vmax = _mm512_set1_pd(max);
+    for (i = 0; i + 8 <= n; i += 8) {
+        const double* p = d + 2 * i;
+        const __m512d a = _mm512_permutex2var_pd(_mm512_loadu_pd(p), odd,
+            _mm512_loadu_pd(p + 8));
+        if (_mm512_cmp_pd_mask(a, vmax, _CMP_EQ_OQ)) {
+            break;
+        }
+    }
+    for (; i < n; ++i) {
+        if (e[i].abundance == max) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+#endif // MSTK_SPECTRUMKERNELS_X86
+
+const SpectrumKernels scalarKernels = { &sumAbundancesScalar,
+        &findMaxAbundanceScalar, &transformMzScalar, &scaleAbundancesScalar,
+        InstructionSet::SCALAR };
+
+#ifdef MSTK_SPECTRUMKERNELS_X86
+// The transforms are bound by memory bandwidth; the compiler-vectorized
+// scalar loops are as fast as explicit AVX code on interleaved data.
+const SpectrumKernels avx2Kernels = { &sumAbundancesAvx2,
+        &findMaxAbundanceAvx2, &transformMzScalar, &scaleAbundancesScalar,
+        InstructionSet::AVX2 };
+
+const SpectrumKernels avx512Kernels = { &sumAbundancesAvx512,
+        &findMaxAbundanceAvx512, &transformMzScalar, &scaleAbundancesScalar,
+        InstructionSet::AVX512 };
+#endif
+
+} // namespace
+
+const SpectrumKernels& SpectrumKernels::get()
+{
+    static const SpectrumKernels& kernels = get(InstructionSet::AVX512);
+    return kernels;
+}
+
+const SpectrumKernels& SpectrumKernels::get(const InstructionSet::Level level)
+{
+    const InstructionSet::Level l = level < InstructionSet::getSupported()
+            ? level : InstructionSet::getSupported();
+#ifdef MSTK_SPECTRUMKERNELS_X86
+    switch (l) {
+        case InstructionSet::AVX512:
+            return avx512Kernels;
+        case InstructionSet::AVX2:
+            return avx2Kernels;
+        default:
+            break;
+    }
+#endif
+    return scalarKernels;
+}
+
+} // namespace fe
+
+} // namespace mstk
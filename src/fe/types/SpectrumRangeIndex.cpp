@@ -0,0 +1,114 @@
+/*
+ * SpectrumRangeIndex.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/SpectrumRangeIndex.hpp>
+#include <algorithm>
+
+namespace mstk {
+
+namespace fe {
+
+SpectrumRangeIndex::SpectrumRangeIndex(const Spectrum& s) :
+    spectrum_(&s), prefix_()
+{
+}
+
+SpectrumRange SpectrumRangeIndex::getRange(const double beginMz,
+    const double endMz) const
+{
+    const_iterator first = std::lower_bound(spectrum_->begin(),
+        spectrum_->end(), beginMz,
+        Spectrum::LessThanMz<Spectrum::Element, double>());
+    const_iterator last = std::upper_bound(first, spectrum_->end(), endMz,
+        Spectrum::LessThanMz<double, Spectrum::Element>());
+    return SpectrumRange(first, last);
+}
+
+double SpectrumRangeIndex::getAbundance(const double beginMz,
+    const double endMz) const
+{
+    return getAbundance(getRange(beginMz, endMz));
+}
+
+double SpectrumRangeIndex::getAbundance(const SpectrumRange& r) const
+{
+    const const_iterator b = spectrum_->begin();
+    return sum(r.first - b, r.second - b);
+}
+
+void SpectrumRangeIndex::buildAbundanceIndex() const
+{
+    const Size n = spectrum_->size();
+    std::vector<double> prefix(n + 1);
+    double s = 0.0;
+    prefix[0] = s;
+    for (Size i = 0; i < n; ++i) {
+        s += (*spectrum_)[i].abundance;
+        prefix[i + 1] = s;
+    }
+    prefix_.swap(prefix);
+}
+
+Size SpectrumRangeIndex::lowerBound(const double mz, const Size from) const
+{
+    const Spectrum& s = *spectrum_;
+    const Size n = s.size();
+    if (from == n || !(s[from].mz < mz)) {
+        return from;
+    }
+    // s[from].mz < mz: double the step until we pass mz, then bisect
+    Size lo = from;
+    Size step = 1;
+    while (lo + step < n && s[lo + step].mz < mz) {
+        lo += step;
+        step *= 2;
+    }
+    const Size hi = std::min(lo + step, n);
+    return std::lower_bound(s.begin() + lo + 1, s.begin() + hi, mz,
+        Spectrum::LessThanMz<Spectrum::Element, double>()) - s.begin();
+}
+
+Size SpectrumRangeIndex::upperBound(const double mz, const Size from) const
+{
+    const Spectrum& s = *spectrum_;
+    const Size n = s.size();
+    if (from == n || mz < s[from].mz) {
+        return from;
+    }
+    // s[from].mz <= mz: double the step until we pass mz, then bisect
+    Size lo = from;
+    Size step = 1;
+    while (lo + step < n && !(mz < s[lo + step].mz)) {
+        lo += step;
+        step *= 2;
+    }
+    const Size hi = std::min(lo + step, n);
+    return std::upper_bound(s.begin() + lo + 1, s.begin() + hi, mz,
+        Spectrum::LessThanMz<double, Spectrum::Element>()) - s.begin();
+}
+
+} // namespace fe
+
+} // namespace mstk
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <limits>
 #include <cassert>
+#include <utility>
 
 #include <MSTK/common/Log.hpp>
 #include <MSTK/common/Error.hpp>
@@ -95,6 +96,49 @@ Xic::Xic(Xic::const_iterator first, Xic::const_iterator last) :
     this->recalculate();
 }
 
+Xic::Xic(std::vector<Centroid>&& centroids) :
+    StaticCollection<Xic, Centroid>(std::move(centroids)), rt_(0.0),
+            rtSigma_(0.0), mz_(0.0), mzSigma_(0.0), abundance_(0.0)
+{
+    this->recalculate();
+}
+
+Xic::Xic(const Xic& rhs) :
+    StaticCollection<Xic, Centroid>(rhs), rt_(rhs.rt_),
+            rtSigma_(rhs.rtSigma_), mz_(rhs.mz_), mzSigma_(rhs.mzSigma_),
+            abundance_(rhs.abundance_)
+{
+}
+
+Xic::Xic(Xic&& rhs) noexcept :
+    StaticCollection<Xic, Centroid>(std::move(rhs)), rt_(rhs.rt_),
+            rtSigma_(rhs.rtSigma_), mz_(rhs.mz_), mzSigma_(rhs.mzSigma_),
+            abundance_(rhs.abundance_)
+{
+}
+
+Xic& Xic::operator=(const Xic& rhs)
+{
+    c_ = rhs.c_;
+    rt_ = rhs.rt_;
+    rtSigma_ = rhs.rtSigma_;
+    mz_ = rhs.mz_;
+    mzSigma_ = rhs.mzSigma_;
+    abundance_ = rhs.abundance_;
+    return *this;
+}
+
+Xic& Xic::operator=(Xic&& rhs) noexcept
+{
+    c_ = std::move(rhs.c_);
+    rt_ = rhs.rt_;
+    rtSigma_ = rhs.rtSigma_;
+    mz_ = rhs.mz_;
+    mzSigma_ = rhs.mzSigma_;
+    abundance_ = rhs.abundance_;
+    return *this;
+}
+
 bool Xic::operator==(const Xic& rhs)
 {
     return rt_ == rhs.rt_ && rtSigma_ == rhs.rtSigma_ && mz_ == rhs.mz_
@@ -439,7 +483,7 @@ void Xic::split(std::vector<Xic>& splitXics, double mindepth)
 double Xic::correlate(Xic& rhs)
 {
     // make sure the Xics are sorted in rt
-    // FIXME: Xic should not be derived from Collection<T> and
+    // FIXME: Xic should not be derived from StaticCollection and
     //        should instead guarantee the sorting of its elements
     std::sort(begin(), end(), Centroid::LessThanScanNumber());
     std::sort(rhs.begin(), rhs.end(), Centroid::LessThanScanNumber());
@@ -0,0 +1,324 @@
+/*
+ * AveragineTable.cpp
+ *
+ *  Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/ipaca/AveragineTable.hpp>
+#include <MSTK/ipaca/Mercury7Impl.hpp>
+#include <MSTK/ipaca/Spectrum.hpp>
+#include <MSTK/ipaca/Traits.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Log.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace mstk {
+
+namespace ipaca {
+
+namespace {
+
+detail::Element makeElement(const Size n, const Double* masses,
+    const Double* frequencies, const Double count)
+{
+    detail::Element e;
+    for (Size i = 0; i < n; ++i) {
+        detail::Isotope iso;
+        iso.mz = masses[i];
+        iso.ab = frequencies[i];
+        e.isotopes.push_back(iso);
+    }
+    e.count = count;
+    return e;
+}
+
+/** The mass difference between neighboring isotope peaks (13C - 12C).
+ */
+const Double isotopeSpacing = 1.0033548378;
+
+const char MAGIC[8] = { 'M', 'S', 'T', 'K', 'A', 'V', 'G', 'T' };
+
+bool isLittleEndianHost()
+{
+    const uint32_t one = 1;
+    return *reinterpret_cast<const unsigned char*> (&one) == 1;
+}
+
+void encodeLittleEndian(const uint64_t value, const Size nBytes, char* buf)
+{
+    for (Size i = 0; i < nBytes; ++i) {
+        buf[i] = static_cast<char> ((value >> (8 * i)) & 0xff);
+    }
+}
+
+uint64_t decodeLittleEndian(const char* buf, const Size nBytes)
+{
+    uint64_t value = 0;
+    for (Size i = 0; i < nBytes; ++i) {
+        value |= static_cast<uint64_t> (static_cast<unsigned char> (buf[i]))
+                << (8 * i);
+    }
+    return value;
+}
+
+}
+
+detail::Stoichiometry makeAveragine(const Double mass)
+{
+    static const Double mC[] = { 12.0, 13.0033548378 };
+    static const Double fC[] = { 0.9893, 0.0107 };
+    static const Double mN[] = { 14.0030740048, 15.0001088982 };
+    static const Double fN[] = { 0.99636, 0.00364 };
+    static const Double mO[] = { 15.99491461956, 16.99913170, 17.9991610 };
+    static const Double fO[] = { 0.99757, 0.00038, 0.00205 };
+    static const Double mS[] = { 31.97207100, 32.97145876, 33.96786690,
+            35.96708076 };
+    static const Double fS[] = { 0.9499, 0.0075, 0.0425, 0.0001 };
+    const Double n = mass / 111.1254;
+    detail::Stoichiometry s;
+    s.push_back(makeElement(2, mC, fC, std::floor(4.9384 * n + 0.5)));
+    // use the default hydrogens, so that protonation finds them
+    s.push_back(detail::getHydrogens(
+        static_cast<Size> (std::floor(7.7583 * n + 0.5))));
+    s.push_back(makeElement(2, mN, fN, std::floor(1.3577 * n + 0.5)));
+    s.push_back(makeElement(3, mO, fO, std::floor(1.4773 * n + 0.5)));
+    const Double nS = std::floor(0.0417 * n + 0.5);
+    if (nS > 0.0) {
+        s.push_back(makeElement(4, mS, fS, nS));
+    }
+    return s;
+}
+
+const uint32_t AveragineTable::VERSION;
+const Size AveragineTable::HEADER_SIZE;
+
+AveragineTable::AveragineTable(const Double maxMass, const Double massStep,
+    const Size nPeaks) :
+    massStep_(massStep), nMasses_(0), nPeaks_(nPeaks), envelopes_(0)
+{
+    mstk_precondition(maxMass > 0.0 && massStep > 0.0 && nPeaks > 0,
+        "AveragineTable: all parameters must be positive.");
+    mstk_precondition(massStep <= maxMass,
+        "AveragineTable: the mass step must not exceed the maximum mass.");
+    nMasses_ = static_cast<Size> (std::floor(maxMass / massStep + 1e-9));
+    storage_.assign(nMasses_ * nPeaks_, 0.0f);
+    std::vector<Double> e(nPeaks_);
+    detail::Mercury7Impl mercury;
+    for (Size k = 0; k < nMasses_; ++k) {
+        detail::Spectrum s = mercury(makeAveragine((k + 1) * massStep_));
+        if (s.empty()) {
+            continue;
+        }
+        // bin the fine structure by nominal isotope number
+        Double mono = s.front().mz;
+        for (detail::Spectrum::const_iterator i = s.begin(); i != s.end(); ++i) {
+            mono = std::min(mono, i->mz);
+        }
+        std::fill(e.begin(), e.end(), 0.0);
+        for (detail::Spectrum::const_iterator i = s.begin(); i != s.end(); ++i) {
+            const Size bin = static_cast<Size> (std::floor((i->mz - mono)
+                    / isotopeSpacing + 0.5));
+            if (bin < nPeaks_) {
+                e[bin] += i->ab;
+            }
+        }
+        const Double max = *std::max_element(e.begin(), e.end());
+        if (max > 0.0) {
+            for (Size j = 0; j < nPeaks_; ++j) {
+                storage_[k * nPeaks_ + j] = static_cast<float> (e[j] / max);
+            }
+        }
+    }
+    envelopes_ = &storage_[0];
+}
+
+AveragineTable::AveragineTable(const String& filename) :
+    massStep_(0.0), nMasses_(0), nPeaks_(0), envelopes_(0)
+{
+    open(filename);
+}
+
+AveragineTable::AveragineTable(AveragineTable&& rhs) noexcept :
+    massStep_(rhs.massStep_), nMasses_(rhs.nMasses_), nPeaks_(rhs.nPeaks_),
+            storage_(std::move(rhs.storage_)), file_(std::move(rhs.file_)),
+            envelopes_(rhs.envelopes_)
+{
+    // moving the vector and the mapping keeps the data in place
+    rhs.nMasses_ = 0;
+    rhs.envelopes_ = 0;
+}
+
+AveragineTable& AveragineTable::operator=(AveragineTable&& rhs) noexcept
+{
+    if (this != &rhs) {
+        massStep_ = rhs.massStep_;
+        nMasses_ = rhs.nMasses_;
+        nPeaks_ = rhs.nPeaks_;
+        storage_ = std::move(rhs.storage_);
+        file_ = std::move(rhs.file_);
+        envelopes_ = rhs.envelopes_;
+        rhs.nMasses_ = 0;
+        rhs.envelopes_ = 0;
+    }
+    return *this;
+}
+
+void AveragineTable::open(const String& filename)
+{
+    if (!isLittleEndianHost()) {
+        throw mstk::RuntimeError(
+            "AveragineTable: mapping requires a little-endian host.");
+    }
+    MappedFile file(filename);
+    const char* buf = file.data();
+    if (file.size() < HEADER_SIZE || std::memcmp(buf, MAGIC, sizeof(MAGIC))
+            != 0) {
+        throw mstk::RuntimeError(
+            "AveragineTable: '" + filename + "' is not an averagine table.");
+    }
+    if (decodeLittleEndian(buf + 8, 4) != VERSION) {
+        throw mstk::RuntimeError("AveragineTable: unsupported version of '"
+                + filename + "'.");
+    }
+    const uint64_t nPeaks = decodeLittleEndian(buf + 12, 4);
+    const uint64_t nMasses = decodeLittleEndian(buf + 16, 8);
+    const uint64_t bits = decodeLittleEndian(buf + 24, 8);
+    Double massStep;
+    std::memcpy(&massStep, &bits, sizeof(massStep));
+    if (nPeaks == 0 || nMasses == 0 || !(massStep > 0.0) || nMasses
+            > (file.size() - HEADER_SIZE) / sizeof(float) / nPeaks) {
+        throw mstk::RuntimeError("AveragineTable: truncated or corrupt '"
+                + filename + "'.");
+    }
+    massStep_ = massStep;
+    nMasses_ = static_cast<Size> (nMasses);
+    nPeaks_ = static_cast<Size> (nPeaks);
+    std::vector<float>().swap(storage_);
+    file_ = std::move(file);
+    envelopes_ = reinterpret_cast<const float*> (file_.data() + HEADER_SIZE);
+    MSTK_LOG(logDEBUG) << "AveragineTable: mapped '" << filename << "' with "
+            << nMasses_ << " envelopes of " << nPeaks_ << " peaks.";
+}
+
+void AveragineTable::save(const String& filename) const
+{
+    std::ofstream os(filename.c_str(), std::ios::out | std::ios::binary
+            | std::ios::trunc);
+    if (!os) {
+        throw mstk::RuntimeError(
+            "AveragineTable: cannot open '" + filename + "'.");
+    }
+    std::vector<char> buf(HEADER_SIZE + nMasses_ * nPeaks_ * sizeof(float),
+        0);
+    std::memcpy(&buf[0], MAGIC, sizeof(MAGIC));
+    encodeLittleEndian(VERSION, 4, &buf[8]);
+    encodeLittleEndian(nPeaks_, 4, &buf[12]);
+    encodeLittleEndian(nMasses_, 8, &buf[16]);
+    uint64_t bits;
+    std::memcpy(&bits, &massStep_, sizeof(bits));
+    encodeLittleEndian(bits, 8, &buf[24]);
+    for (Size i = 0; i < nMasses_ * nPeaks_; ++i) {
+        uint32_t v;
+        std::memcpy(&v, &envelopes_[i], sizeof(v));
+        encodeLittleEndian(v, 4, &buf[HEADER_SIZE + i * sizeof(float)]);
+    }
+    os.write(&buf[0], buf.size());
+    os.close();
+    if (!os) {
+        throw mstk::RuntimeError(
+            "AveragineTable: cannot write '" + filename + "'.");
+    }
+}
+
+Size AveragineTable::getEnvelope(const Double mass, Double* abundances,
+    const Size n) const
+{
+    if (nMasses_ == 0) {
+        return 0;
+    }
+    // the k-th grid mass is (k + 1) * massStep_
+    Double x = mass / massStep_ - 1.0;
+    x = std::max(0.0, std::min(x, static_cast<Double> (nMasses_ - 1)));
+    const Size k = std::min(static_cast<Size> (x), nMasses_ - 1);
+    const Size m = std::min(n, nPeaks_);
+    const float* lo = envelopes_ + k * nPeaks_;
+    if (k + 1 == nMasses_) {
+        std::copy(lo, lo + m, abundances);
+        return m;
+    }
+    const float* hi = lo + nPeaks_;
+    const Double w = x - k;
+    for (Size j = 0; j < m; ++j) {
+        abundances[j] = (1.0 - w) * lo[j] + w * hi[j];
+    }
+    return m;
+}
+
+Size AveragineTable::getEnvelope(const Double mz, const Int charge,
+    Double* abundances, const Size n) const
+{
+    const Double mass = charge == 0 ? mz : std::abs(charge) * mz + charge
+            * detail::getElectronMass();
+    return getEnvelope(mass, abundances, n);
+}
+
+Double AveragineTable::getNeutralMass(const Double mz, const Int charge,
+    const Particle particle)
+{
+    if (charge == 0) {
+        return mz;
+    }
+    Double mass = std::abs(charge) * mz + charge * detail::getElectronMass();
+    if (particle == PROTON) {
+        mass -= charge * detail::getHydrogens(1).isotopes[0].mz;
+    }
+    return mass;
+}
+
+Double AveragineTable::getMaxMass() const
+{
+    return nMasses_ * massStep_;
+}
+
+Double AveragineTable::getMassStep() const
+{
+    return massStep_;
+}
+
+Size AveragineTable::getNumberOfPeaks() const
+{
+    return nPeaks_;
+}
+
+bool AveragineTable::isMapped() const
+{
+    return file_.isOpen();
+}
+
+} // namespace ipaca
+
+} // namespace mstk
@@ -30,6 +30,7 @@
  */
 #include <MSTK/ipaca/Mercury7Impl.hpp>
 #include <MSTK/common/Error.hpp>
+#include <MSTK/common/Instrumentation.hpp>
 #include <cmath>
 
 using namespace mstk::ipaca;
@@ -38,6 +39,7 @@ using namespace mstk;
 void detail::Mercury7Impl::convolve(const detail::Spectrum& s1,
     const detail::Spectrum& s2, detail::Spectrum& result) const
 {
+    MSTK_INSTRUMENT_TIMER("ipaca.Mercury7.convolve");
     // Check if the input is non-empty. We use size() instead of
     // empty() because we need the values later.
     Size n1 = s1.size();
@@ -85,6 +87,7 @@ void detail::Mercury7Impl::convolve(const detail::Spectrum& s1,
 
 void detail::Mercury7Impl::prune(detail::Spectrum& s, const double limit) const
 {
+    MSTK_INSTRUMENT_TIMER("ipaca.Mercury7.prune");
     // This is a private function, hence any call to prune with
     // a non-positve limit is a programming error. Parameter validity
     // must be checked in operator() (which is where it comes in).
@@ -196,6 +199,7 @@ void detail::Mercury7Impl::fractionalMercury(const detail::Stoichiometry& s,
 detail::Spectrum detail::Mercury7Impl::operator()(
     const detail::Stoichiometry& stoichiometry, const double limit) const
 {
+    MSTK_INSTRUMENT_TIMER("ipaca.Mercury7");
     // check the parameters
     mstk_precondition(limit > 0.0, "require positive pruning limit.");
     // split the stoichiometry into integer and fractional parts
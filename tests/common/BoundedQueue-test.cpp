@@ -0,0 +1,150 @@
+/*
+ * BoundedQueue-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/BoundedQueue.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Types.hpp>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mstk;
+
+struct BoundedQueueTestSuite : vigra::test_suite
+{
+    BoundedQueueTestSuite() :
+            vigra::test_suite("BoundedQueue")
+    {
+        add(testCase(&BoundedQueueTestSuite::testConstruction));
+        add(testCase(&BoundedQueueTestSuite::testFifo));
+        add(testCase(&BoundedQueueTestSuite::testClose));
+        add(testCase(&BoundedQueueTestSuite::testCancel));
+        add(testCase(&BoundedQueueTestSuite::testProducerConsumer));
+    }
+
+    void testConstruction()
+    {
+        BoundedQueue<int> q(3);
+        shouldEqual(q.getCapacity(), static_cast<Size> (3));
+        shouldEqual(q.size(), static_cast<Size> (0));
+        shouldEqual(q.isClosed(), false);
+        bool thrown = false;
+        try {
+            BoundedQueue<int> r(0);
+        } catch (PreconditionViolation&) {
+            thrown = true;
+        }
+        shouldEqual(thrown, true);
+    }
+
+    void testFifo()
+    {
+        BoundedQueue<std::unique_ptr<int> > q(3);
+        for (int i = 0; i < 3; ++i) {
+            should(q.push(std::unique_ptr<int>(new int(i))));
+        }
+        shouldEqual(q.size(), static_cast<Size> (3));
+        std::unique_ptr<int> v;
+        for (int i = 0; i < 3; ++i) {
+            should(q.pop(v));
+            shouldEqual(*v, i);
+        }
+        shouldEqual(q.size(), static_cast<Size> (0));
+    }
+
+    /** A closed queue rejects pushes but is drained by its consumer.
+     */
+    void testClose()
+    {
+        BoundedQueue<int> q(2);
+        should(q.push(1));
+        should(q.push(2));
+        q.close();
+        should(q.isClosed());
+        shouldEqual(q.push(3), false);
+        int v = 0;
+        should(q.pop(v));
+        shouldEqual(v, 1);
+        should(q.pop(v));
+        shouldEqual(v, 2);
+        shouldEqual(q.pop(v), false);
+    }
+
+    /** Cancelling discards the queued elements and wakes up a blocked
+     * producer.
+     */
+    void testCancel()
+    {
+        BoundedQueue<int> q(1);
+        should(q.push(1));
+        bool pushed = true;
+        std::thread producer([&q, &pushed]() {pushed = q.push(2);});
+        q.cancel();
+        producer.join();
+        shouldEqual(pushed, false);
+        shouldEqual(q.size(), static_cast<Size> (0));
+        int v = 0;
+        shouldEqual(q.pop(v), false);
+    }
+
+    /** A fast producer is throttled to the queue capacity; all elements
+     * arrive in order.
+     */
+    void testProducerConsumer()
+    {
+        const int n = 10000;
+        BoundedQueue<int> q(4);
+        bool overfull = false;
+        std::thread producer([&q, &overfull]() {
+            for (int i = 0; i < n; ++i) {
+                q.push(int(i));
+                overfull = overfull || q.size() > q.getCapacity();
+            }
+            q.close();
+        });
+        std::vector<int> received;
+        int v = 0;
+        while (q.pop(v)) {
+            received.push_back(v);
+        }
+        producer.join();
+        shouldEqual(overfull, false);
+        shouldEqual(received.size(),
+            static_cast<std::vector<int>::size_type> (n));
+        for (int i = 0; i < n; ++i) {
+            shouldEqual(received[i], i);
+        }
+    }
+};
+
+int main()
+{
+    BoundedQueueTestSuite test;
+    int failed = test.run();
+    std::cout << test.report() << std::endl;
+    return failed;
+}
@@ -0,0 +1,101 @@
+/*
+ * ConcurrentUnionFind-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/ConcurrentUnionFind.hpp>
+#include <MSTK/common/parallelFor.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace mstk;
+
+struct ConcurrentUnionFindTestSuite : vigra::test_suite
+{
+    ConcurrentUnionFindTestSuite() :
+            vigra::test_suite("ConcurrentUnionFind")
+    {
+        add(testCase(&ConcurrentUnionFindTestSuite::testSerial));
+        add(testCase(&ConcurrentUnionFindTestSuite::testConcurrent));
+    }
+
+    void testSerial()
+    {
+        ConcurrentUnionFind uf(6);
+        shouldEqual(uf.size(), static_cast<Size>(6));
+        for (Size i = 0; i < 6; ++i) {
+            shouldEqual(uf.find(i), i);
+        }
+        uf.unite(5, 3);
+        uf.unite(3, 4);
+        uf.unite(1, 2);
+        // representatives are the smallest elements
+        shouldEqual(uf.find(4), static_cast<Size>(3));
+        shouldEqual(uf.find(5), static_cast<Size>(3));
+        shouldEqual(uf.find(2), static_cast<Size>(1));
+        shouldEqual(uf.find(0), static_cast<Size>(0));
+        uf.unite(4, 2);
+        shouldEqual(uf.find(5), static_cast<Size>(1));
+    }
+
+    void testConcurrent()
+    {
+        // random edges; compare against a serial run
+        const Size n = 20000;
+        const Size nEdges = 15000;
+        std::vector<std::pair<Size, Size> > edges;
+        std::srand(42);
+        for (Size i = 0; i < nEdges; ++i) {
+            edges.push_back(std::make_pair(std::rand() % n, std::rand() % n));
+        }
+        ConcurrentUnionFind ref(n);
+        for (Size i = 0; i < nEdges; ++i) {
+            ref.unite(edges[i].first, edges[i].second);
+        }
+        for (UnsignedInt nt = 2; nt <= 8; nt *= 2) {
+            ConcurrentUnionFind uf(n);
+            parallelFor(0, nEdges, [&](const Size i, const UnsignedInt) {
+                uf.unite(edges[i].first, edges[i].second);
+            }, nt, 64);
+            Size mismatches = 0;
+            for (Size i = 0; i < n; ++i) {
+                if (uf.find(i) != ref.find(i)) {
+                    ++mismatches;
+                }
+            }
+            shouldEqual(mismatches, static_cast<Size>(0));
+        }
+    }
+};
+
+int main()
+{
+    ConcurrentUnionFindTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
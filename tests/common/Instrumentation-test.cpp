@@ -0,0 +1,199 @@
+/*
+ * Instrumentation-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+// the test exercises the macros, independent of the build configuration
+#ifndef MSTK_INSTRUMENTATION
+#define MSTK_INSTRUMENTATION
+#endif
+
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Instrumentation.hpp>
+#include <MSTK/common/parallelFor.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mstk;
+
+namespace {
+
+Instrumentation::Metric getMetric(const std::string& name)
+{
+    std::vector<Instrumentation::Metric> metrics = Instrumentation::snapshot();
+    for (Size i = 0; i < metrics.size(); ++i) {
+        if (metrics[i].name == name) {
+            return metrics[i];
+        }
+    }
+    Instrumentation::Metric m;
+    m.count = 0;
+    return m;
+}
+
+void countItem(const Size, const UnsignedInt)
+{
+    MSTK_INSTRUMENT_TIMER("test.parallel.item");
+    MSTK_INSTRUMENT_COUNT("test.parallel.items", 2);
+}
+
+}
+
+struct InstrumentationTestSuite : vigra::test_suite
+{
+    InstrumentationTestSuite() :
+            vigra::test_suite("Instrumentation")
+    {
+        add(testCase(&InstrumentationTestSuite::testCounter));
+        add(testCase(&InstrumentationTestSuite::testTimer));
+        add(testCase(&InstrumentationTestSuite::testHistogram));
+        add(testCase(&InstrumentationTestSuite::testThreads));
+        add(testCase(&InstrumentationTestSuite::testKind));
+        add(testCase(&InstrumentationTestSuite::testJson));
+        add(testCase(&InstrumentationTestSuite::testReset));
+    }
+
+    void testCounter()
+    {
+        for (int i = 0; i < 10; ++i) {
+            MSTK_INSTRUMENT_COUNT("test.counter", 3);
+        }
+        Instrumentation::Metric m = getMetric("test.counter");
+        shouldEqual(m.kind, Instrumentation::COUNTER);
+        shouldEqual(m.count, static_cast<Size>(10));
+        shouldEqual(m.sum, 30.0);
+        // same name, same metric
+        shouldEqual(Instrumentation::getId("test.counter",
+            Instrumentation::COUNTER), Instrumentation::getId("test.counter",
+            Instrumentation::COUNTER));
+    }
+
+    void testTimer()
+    {
+        for (int i = 0; i < 3; ++i) {
+            MSTK_INSTRUMENT_TIMER("test.timer");
+            volatile double x = 0.0;
+            for (int j = 0; j < 1000; ++j) {
+                x = x + j;
+            }
+        }
+        Instrumentation::Metric m = getMetric("test.timer");
+        shouldEqual(m.kind, Instrumentation::TIMER);
+        shouldEqual(m.count, static_cast<Size>(3));
+        should(m.sum > 0.0);
+        should(m.min > 0.0);
+        should(m.min <= m.max);
+        should(m.max <= m.sum);
+    }
+
+    void testHistogram()
+    {
+        const double values[] = { 0.5, 1.0, 1.5, 2.0, 3.0, 1000.0, 1e30 };
+        for (Size i = 0; i < 7; ++i) {
+            MSTK_INSTRUMENT_RECORD("test.histogram", values[i]);
+        }
+        Instrumentation::Metric m = getMetric("test.histogram");
+        shouldEqual(m.kind, Instrumentation::HISTOGRAM);
+        shouldEqual(m.count, static_cast<Size>(7));
+        shouldEqual(m.min, 0.5);
+        shouldEqual(m.max, 1e30);
+        shouldEqual(m.buckets.size(), Instrumentation::nBuckets);
+        shouldEqual(m.buckets[0], static_cast<Size>(1)); // [0, 1)
+        shouldEqual(m.buckets[1], static_cast<Size>(2)); // [1, 2)
+        shouldEqual(m.buckets[2], static_cast<Size>(2)); // [2, 4)
+        shouldEqual(m.buckets[10], static_cast<Size>(1)); // [512, 1024)
+        shouldEqual(m.buckets[Instrumentation::nBuckets - 1],
+            static_cast<Size>(1));
+    }
+
+    void testThreads()
+    {
+        // the values of terminated worker threads are retained
+        const Size n = 1000;
+        parallelFor(0, n, countItem, 4);
+        parallelFor(0, n, countItem, 3);
+        Instrumentation::Metric m = getMetric("test.parallel.items");
+        shouldEqual(m.count, 2 * n);
+        shouldEqual(m.sum, 4.0 * n);
+        shouldEqual(getMetric("test.parallel.item").count, 2 * n);
+    }
+
+    void testKind()
+    {
+        Instrumentation::getId("test.kind", Instrumentation::COUNTER);
+        try {
+            Instrumentation::getId("test.kind", Instrumentation::TIMER);
+            failTest("Instrumentation::getId() failed to throw.");
+        } catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+        }
+    }
+
+    void testJson()
+    {
+        std::string json = Instrumentation::toJson();
+        shouldEqual(json[0], '{');
+        should(json.find("\"test.counter\": {\"type\": \"counter\", "
+            "\"value\": 30}") != std::string::npos);
+        should(json.find("\"test.timer\": {\"type\": \"timer\", "
+            "\"count\": 3, ") != std::string::npos);
+        should(json.find("{\"lower\": 512, \"count\": 1}")
+                != std::string::npos);
+        // names are escaped
+        Instrumentation::count(Instrumentation::getId(
+            "test.\"json\"\n\t\x01\\", Instrumentation::COUNTER));
+        json = Instrumentation::toJson();
+        should(json.find("\"test.\\\"json\\\"\\n\\t\\u0001\\\\\": ")
+                != std::string::npos);
+        for (std::string::const_iterator i = json.begin(); i != json.end();
+                ++i) {
+            should(*i == '\n' || static_cast<unsigned char>(*i) >= 0x20);
+        }
+        // the escaper is also used directly, e.g. by the benchmarks
+        std::ostringstream os;
+        Instrumentation::writeJsonString(os, "a\"b\x1f");
+        shouldEqual(os.str(), std::string("\"a\\\"b\\u001f\""));
+    }
+
+    void testReset()
+    {
+        Instrumentation::reset();
+        shouldEqual(getMetric("test.counter").count, static_cast<Size>(0));
+        shouldEqual(getMetric("test.parallel.items").count,
+            static_cast<Size>(0));
+        MSTK_INSTRUMENT_COUNT("test.counter", 1);
+        shouldEqual(getMetric("test.counter").sum, 1.0);
+    }
+};
+
+int main()
+{
+    InstrumentationTestSuite test;
+    int failed = test.run();
+    std::cout << test.report() << std::endl;
+    return failed;
+}
@@ -34,12 +34,23 @@
 
 using namespace mstk;
 
+namespace {
+
+int evaluations = 0;
+
+int countEvaluation()
+{
+    return ++evaluations;
+}
+
+}
 
 struct LogTestSuite : vigra::test_suite {
     LogTestSuite() : vigra::test_suite("Logging") {
         add( testCase(&LogTestSuite::testFILELog) );
         add( testCase(&LogTestSuite::testOutput2FILE) );
         add( testCase(&LogTestSuite::testMacros) );
+        add( testCase(&LogTestSuite::testLazyEvaluation) );
         add( testCase(&LogTestSuite::testNowTime) );
     }
 
@@ -116,6 +127,51 @@ struct LogTestSuite : vigra::test_suite {
         MSTK_LOG(logDEBUG1) << "This should be logged again, since we reset to logDEBUG4.";
     }
 
+    void testLazyEvaluation() {
+        LogLevel reportingLevel = FILELog::getReportingLevel();
+
+        // disabled at compile time
+#pragma push_macro("MSTK_LOG_MAX_LEVEL")
+#undef MSTK_LOG_MAX_LEVEL
+#define MSTK_LOG_MAX_LEVEL logERROR
+        evaluations = 0;
+        should(!MSTK_LOG_ENABLED(logWARNING));
+        MSTK_LOG(logWARNING) << "This SHOULDN'T be logged: " << countEvaluation();
+        shouldEqual(evaluations, 0);
+#pragma pop_macro("MSTK_LOG_MAX_LEVEL")
+
+        // disabled at runtime
+        FILELog::getReportingLevel() = logNO_LOGGING;
+        should(!MSTK_LOG_ENABLED(logERROR));
+        MSTK_LOG(logERROR) << "This SHOULDN'T be logged: " << countEvaluation();
+        shouldEqual(evaluations, 0);
+        FILELog::getReportingLevel() = reportingLevel;
+
+        // no redirect
+        FILE* redirect = MSTK_LOG_OUTPUT::getRedirect();
+        MSTK_LOG_OUTPUT::getRedirect() = 0;
+        should(!MSTK_LOG_ENABLED(logERROR));
+        MSTK_LOG(logERROR) << "This SHOULDN'T be logged: " << countEvaluation();
+        shouldEqual(evaluations, 0);
+        MSTK_LOG_OUTPUT::getRedirect() = redirect;
+
+        // enabled: arguments are evaluated exactly once
+        if (MSTK_LOG_ENABLED(logERROR)) {
+            MSTK_LOG(logERROR) << "Evaluation count: " << countEvaluation();
+            shouldEqual(evaluations, 1);
+        }
+
+        // the macro must bind correctly in unbraced if/else statements
+        evaluations = 0;
+        FILELog::getReportingLevel() = logNO_LOGGING;
+        if (evaluations == 0)
+            MSTK_LOG(logERROR) << countEvaluation();
+        else
+            evaluations = 42;
+        shouldEqual(evaluations, 0);
+        FILELog::getReportingLevel() = reportingLevel;
+    }
+
     void testNowTime() {
         nowTime();
     }
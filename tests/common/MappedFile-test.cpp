@@ -0,0 +1,123 @@
+/*
+ * MappedFile-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/MappedFile.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+using namespace mstk;
+
+namespace {
+
+const char* FILENAME = "MappedFile-test.txt";
+const char* CONTENT = "The quick brown fox jumps over the lazy dog.";
+
+}
+
+struct MappedFileTestSuite : vigra::test_suite
+{
+    MappedFileTestSuite() :
+            vigra::test_suite("MappedFile")
+    {
+        add(testCase(&MappedFileTestSuite::testMap));
+        add(testCase(&MappedFileTestSuite::testMove));
+        add(testCase(&MappedFileTestSuite::testEmpty));
+        add(testCase(&MappedFileTestSuite::testMissing));
+    }
+
+    ~MappedFileTestSuite()
+    {
+        std::remove(FILENAME);
+    }
+
+    void write(const char* content)
+    {
+        std::ofstream ofs(FILENAME, std::ios::binary);
+        ofs << content;
+    }
+
+    void testMap()
+    {
+        write(CONTENT);
+        MappedFile f(FILENAME);
+        shouldEqual(f.isOpen(), true);
+        shouldEqual(f.size(), std::strlen(CONTENT));
+        shouldEqual(std::memcmp(f.data(), CONTENT, f.size()), 0);
+        f.close();
+        shouldEqual(f.isOpen(), false);
+        shouldEqual(f.size(), static_cast<Size>(0));
+        shouldEqual(f.data() == 0, true);
+    }
+
+    void testMove()
+    {
+        write(CONTENT);
+        MappedFile f(FILENAME);
+        const char* data = f.data();
+        MappedFile g(std::move(f));
+        shouldEqual(f.isOpen(), false);
+        shouldEqual(g.isOpen(), true);
+        shouldEqual(g.data() == data, true);
+        MappedFile h;
+        h = std::move(g);
+        shouldEqual(g.isOpen(), false);
+        shouldEqual(h.size(), std::strlen(CONTENT));
+        shouldEqual(std::memcmp(h.data(), CONTENT, h.size()), 0);
+    }
+
+    void testEmpty()
+    {
+        write("");
+        MappedFile f(FILENAME);
+        shouldEqual(f.isOpen(), true);
+        shouldEqual(f.size(), static_cast<Size>(0));
+    }
+
+    void testMissing()
+    {
+        MappedFile f;
+        try {
+            f.open("MappedFile-test-does-not-exist.txt");
+            failTest("MappedFile::open() failed to throw.");
+        } catch (const mstk::RuntimeError& e) {
+            MSTK_UNUSED(e);
+        }
+        shouldEqual(f.isOpen(), false);
+    }
+};
+
+int main()
+{
+    MappedFileTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -0,0 +1,189 @@
+/*
+ * Output2Async-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Log.hpp>
+#include <MSTK/common/Output2Async.hpp>
+#include <MSTK/common/parallelFor.hpp>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mstk;
+
+namespace {
+
+struct LogLine
+{
+    void operator()(const Size i, const UnsignedInt t) const
+    {
+        std::ostringstream os;
+        os << "record " << i << " from thread " << t << " end\n";
+        Output2Async::output(os.str());
+    }
+};
+
+/** Rewinds \c f and returns all lines.
+ */
+std::vector<std::string> readLines(FILE* f)
+{
+    std::vector<std::string> lines;
+    std::rewind(f);
+    char buffer[1024];
+    while (std::fgets(buffer, sizeof(buffer), f)) {
+        lines.push_back(buffer);
+    }
+    return lines;
+}
+
+}
+
+struct Output2AsyncTestSuite : vigra::test_suite
+{
+    Output2AsyncTestSuite() :
+            vigra::test_suite("Output2Async")
+    {
+        add(testCase(&Output2AsyncTestSuite::testBlock));
+        add(testCase(&Output2AsyncTestSuite::testDrop));
+        add(testCase(&Output2AsyncTestSuite::testLog));
+        add(testCase(&Output2AsyncTestSuite::testLazyStart));
+    }
+
+    void testBlock()
+    {
+        FILE* f = std::tmpfile();
+        should(f != 0);
+        Output2Async::getRedirect() = f;
+        Output2Async::start(8, Output2Async::BLOCK);
+        should(Output2Async::isRunning());
+
+        // records from parallel workers must arrive complete and unmixed
+        const Size n = 5000;
+        parallelFor(0, n, LogLine(), 4);
+        Output2Async::flush();
+        shouldEqual(Output2Async::getDroppedCount(), static_cast<Size>(0));
+        std::vector<std::string> lines = readLines(f);
+        shouldEqual(lines.size(), n);
+        std::vector<int> seen(n, 0);
+        for (Size k = 0; k < lines.size(); ++k) {
+            unsigned long i = n;
+            unsigned int t = 0;
+            char tail[8] = { 0 };
+            shouldEqual(std::sscanf(lines[k].c_str(),
+                "record %lu from thread %u %3s", &i, &t, tail), 3);
+            shouldEqual(std::string(tail), std::string("end"));
+            should(i < n);
+            ++seen[i];
+        }
+        for (Size i = 0; i < n; ++i) {
+            shouldEqual(seen[i], 1);
+        }
+
+        Output2Async::stop();
+        should(!Output2Async::isRunning());
+        Output2Async::getRedirect() = stderr;
+        std::fclose(f);
+    }
+
+    void testDrop()
+    {
+        FILE* f = std::tmpfile();
+        should(f != 0);
+        Output2Async::getRedirect() = f;
+        Output2Async::start(2, Output2Async::DROP);
+        const Size n = 20000;
+        parallelFor(0, n, LogLine(), 2);
+        Output2Async::flush();
+        const Size dropped = Output2Async::getDroppedCount();
+        Output2Async::stop();
+
+        // every record is either written or counted as dropped, and drops
+        // are reported in the log
+        std::vector<std::string> lines = readLines(f);
+        Size records = 0;
+        Size reported = 0;
+        for (Size k = 0; k < lines.size(); ++k) {
+            if (lines[k].compare(0, 7, "record ") == 0) {
+                ++records;
+            } else {
+                unsigned long d = 0;
+                should(lines[k].find("WARNING") != std::string::npos);
+                should(std::sscanf(lines[k].c_str() + lines[k].find(": ") + 2,
+                    "%lu", &d) == 1);
+                reported += d;
+            }
+        }
+        shouldEqual(records + dropped, n);
+        shouldEqual(reported, dropped);
+
+        Output2Async::getRedirect() = stderr;
+        std::fclose(f);
+    }
+
+    void testLog()
+    {
+        FILE* f = std::tmpfile();
+        should(f != 0);
+        Output2Async::getRedirect() = f;
+        Output2Async::start();
+        AsyncLog().get(logWARNING) << "asynchronous " << 42;
+        Output2Async::flush();
+        std::vector<std::string> lines = readLines(f);
+        shouldEqual(lines.size(), static_cast<Size>(1));
+        should(lines[0].find("WARNING: asynchronous 42\n")
+                != std::string::npos);
+        Output2Async::stop();
+        Output2Async::getRedirect() = stderr;
+        std::fclose(f);
+    }
+
+    void testLazyStart()
+    {
+        FILE* f = std::tmpfile();
+        should(f != 0);
+        Output2Async::getRedirect() = f;
+        should(!Output2Async::isRunning());
+        Output2Async::output("first\n");
+        should(Output2Async::isRunning());
+        Output2Async::stop();
+        // stop() drains the buffer
+        std::vector<std::string> lines = readLines(f);
+        shouldEqual(lines.size(), static_cast<Size>(1));
+        shouldEqual(lines[0], std::string("first\n"));
+        Output2Async::getRedirect() = stderr;
+        std::fclose(f);
+    }
+};
+
+int main()
+{
+    Output2AsyncTestSuite test;
+    int failed = test.run();
+    std::cout << test.report() << std::endl;
+    return failed;
+}
@@ -0,0 +1,169 @@
+/*
+ * StaticCollection-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <iostream>
+#include <vector>
+// expose the class
+#define private public
+#define protected public
+#include <MSTK/common/StaticCollection.hpp>
+#undef protected
+#undef private
+
+namespace {
+
+// StaticCollection is meant to be used as a CRTP base class.
+class IntCollection : public mstk::StaticCollection<IntCollection, int>
+{
+public:
+    IntCollection()
+    {
+    }
+    explicit IntCollection(size_type n, const int& value = 0) :
+        mstk::StaticCollection<IntCollection, int>(n, value)
+    {
+    }
+    template<class In> IntCollection(In begin, In end) :
+        mstk::StaticCollection<IntCollection, int>(begin, end)
+    {
+    }
+};
+
+}
+
+struct StaticCollectionTestSuite : vigra::test_suite {
+    StaticCollectionTestSuite() : vigra::test_suite("StaticCollection") {
+        add( testCase(&StaticCollectionTestSuite::testConstructors));
+        add( testCase(&StaticCollectionTestSuite::testOperators));
+        add( testCase(&StaticCollectionTestSuite::testListOperations));
+        add( testCase(&StaticCollectionTestSuite::testElementAccess));
+        add( testCase(&StaticCollectionTestSuite::testOther));
+    }
+
+    void testConstructors() {
+        IntCollection c;
+        should(c.c_.size() == 0);
+
+        IntCollection cPreinit(5);
+        should(cPreinit.c_.size() == 5);
+
+        int myints[] = {1,2,3,4};
+        IntCollection cFromSeq(myints, myints + sizeof(myints) / sizeof(int));
+        should(cFromSeq.size() == 4);
+        int i = 1;
+        for(IntCollection::iterator it = cFromSeq.begin(); it < cFromSeq.end(); ++it) {
+            should(*it == i);
+            ++i;
+        }
+
+        IntCollection c_copy = cFromSeq;
+        should(c_copy == cFromSeq);
+    }
+
+    void testOperators() {
+        IntCollection c1(2);
+        IntCollection c2(3);
+        should(!(c1 == c2));
+        c1 = c2;
+        should(c1 == c2);
+
+        IntCollection c3;
+        IntCollection c4;
+        should((c3.c_ < c4.c_) == (c3 < c4));
+    }
+
+    void testListOperations() {
+        IntCollection c;
+        int myints[] = {46,243,45};
+        c.assign(myints, myints + sizeof(myints) / sizeof(int));
+
+        IntCollection::iterator it_insert = c.insert(c.begin()+1, 23);
+        should(c.size() == 4);
+        should(*it_insert == 23);
+
+        c.insert(c.begin()+1, (IntCollection::size_type)2, 123);
+        should(c.size() == 6);
+        should(c[1] == 123 && c[2] == 123);
+
+        int toBeInserted[] = {823, 329, 198};
+        c.insert(c.begin()+1, toBeInserted, toBeInserted + 3);
+        should(c.size() == 9);
+        should(c[1] == 823 && c[2] == 329 && c[3] == 198);
+
+        IntCollection::iterator it_erase = c.erase(c.begin()+1);
+        should(c.size() == 8);
+        should(*it_erase == 329);
+
+        c.erase(c.begin()+1, c.begin()+4);
+        should(c.size() == 5);
+
+        c.push_back(17);
+        should(c.size() == 6);
+        should(c[5] == 17);
+        c.pop_back();
+        should(c.size() == 5);
+
+        c.clear();
+        should(c.empty());
+    }
+
+    void testElementAccess() {
+        IntCollection c(3, 7);
+        c[1] = 127;
+        should(*(c.begin() + 1) == 127);
+        c.at(2) = 259;
+        should(c.at(2) == 259);
+
+        const IntCollection c_const(c);
+        should(c_const[0] == 7 && c_const.at(1) == 127);
+        should(c_const.begin() == c_const.c_.begin());
+        should(c_const.end() == c_const.c_.end());
+
+        c.resize(10, 13);
+        should(c.size() == 10 && c.at(9) == 13);
+        c.reserve(1000);
+        should(c.capacity() >= 1000);
+    }
+
+    void testOther() {
+        IntCollection c1(2);
+        IntCollection c1_copy = c1;
+        IntCollection c2(3);
+        IntCollection c2_copy = c2;
+        c1.swap(c2);
+        should((c1_copy == c2) && (c2_copy == c1));
+
+        should(c1.get_allocator() == c1.c_.get_allocator());
+    }
+};
+
+int main()
+{
+    StaticCollectionTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -0,0 +1,124 @@
+/*
+ * parallelFor-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/parallelFor.hpp>
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace mstk;
+
+struct ParallelForTestSuite : vigra::test_suite
+{
+    ParallelForTestSuite() :
+            vigra::test_suite("parallelFor")
+    {
+        add(testCase(&ParallelForTestSuite::testNumberOfThreads));
+        add(testCase(&ParallelForTestSuite::testCoverage));
+        add(testCase(&ParallelForTestSuite::testThreadIndex));
+        add(testCase(&ParallelForTestSuite::testException));
+    }
+
+    void testNumberOfThreads()
+    {
+        shouldEqual(getNumberOfThreads(3), static_cast<UnsignedInt>(3));
+        shouldEqual(getNumberOfThreads() >= 1, true);
+    }
+
+    void testCoverage()
+    {
+        // every index must be visited exactly once, for all chunk sizes
+        const Size n = 1000;
+        for (Size chunk = 1; chunk < 20; chunk += 6) {
+            for (UnsignedInt nt = 1; nt <= 8; nt *= 2) {
+                std::vector<int> visits(n, 0);
+                parallelFor(0, n, [&](const Size i, const UnsignedInt) {
+                    ++visits[i];
+                }, nt, chunk);
+                shouldEqual(std::accumulate(visits.begin(), visits.end(), 0),
+                    static_cast<int>(n));
+                shouldEqual(*std::min_element(visits.begin(), visits.end()),
+                    1);
+            }
+        }
+        // empty range
+        int calls = 0;
+        parallelFor(5, 5, [&](const Size, const UnsignedInt) {
+            ++calls;
+        }, 4);
+        shouldEqual(calls, 0);
+    }
+
+    void testThreadIndex()
+    {
+        const UnsignedInt nt = 4;
+        std::vector<Size> counts(nt, 0);
+        std::vector<UnsignedInt> owner(100, nt);
+        parallelFor(0, 100, [&](const Size i, const UnsignedInt t) {
+            ++counts[t];
+            owner[i] = t;
+        }, nt);
+        shouldEqual(std::accumulate(counts.begin(), counts.end(),
+            static_cast<Size>(0)), static_cast<Size>(100));
+        shouldEqual(*std::max_element(owner.begin(), owner.end()) < nt,
+            true);
+        // a single thread runs in order on the calling thread
+        std::vector<Size> order;
+        parallelFor(0, 10, [&](const Size i, const UnsignedInt t) {
+            shouldEqual(t, static_cast<UnsignedInt>(0));
+            order.push_back(i);
+        }, 1);
+        shouldEqual(order.size(), static_cast<Size>(10));
+        for (Size i = 0; i < order.size(); ++i) {
+            shouldEqual(order[i], i);
+        }
+    }
+
+    void testException()
+    {
+        try {
+            parallelFor(0, 1000, [](const Size i, const UnsignedInt) {
+                if (i == 500) {
+                    throw std::runtime_error("parallelFor test");
+                }
+            }, 4);
+            failTest("parallelFor failed to rethrow.");
+        } catch (const std::runtime_error& e) {
+            shouldEqual(std::string(e.what()), std::string("parallelFor test"));
+        }
+    }
+};
+
+int main()
+{
+    ParallelForTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -0,0 +1,248 @@
+/*
+ * AveragineSplitter-test.cpp
+ *
+ * Copyright (C) 2011 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include "utilities.hpp"
+#include <MSTK/fe/AveragineSplitter.hpp>
+#include <MSTK/fe/IsotopePatternExtractor.hpp>
+#include <MSTK/fe/types/XicFbiTraits.hpp>
+#include <MSTK/fe/UncenteredCorrelation.hpp>
+#include <MSTK/fe/NopSplitter.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Types.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+/** A poor man's averagine: a Poisson distribution with one expected heavy
+ * isotope per 1800 Da.
+ */
+struct PoissonTable
+{
+    Size getEnvelope(const double mass, double* abundances, const Size n) const
+    {
+        const double lambda = mass / 1800.0;
+        double p = 1.0;
+        for (Size k = 0; k < n; ++k) {
+            abundances[k] = p;
+            p *= lambda / (k + 1);
+        }
+        return n;
+    }
+};
+
+/** Builds an XIC of five scans with a Gaussian elution profile.
+ */
+Xic makeScaledXic(const double mz, const double abundance)
+{
+    double mzs[5], rt[5], ab[5];
+    unsigned int sn[5];
+    for (int s = 0; s < 5; ++s) {
+        mzs[s] = mz;
+        sn[s] = 100 + s;
+        rt[s] = 2.0 * sn[s];
+        ab[s] = abundance * std::exp(-0.5 * (s - 2) * (s - 2));
+    }
+    return makeXic(5, mzs, rt, sn, ab);
+}
+
+/** Overlapping isotope patterns: z=1 at 600.0 and z=2 at 600.3343. The
+ * latter is a z=3 isotope distance away from the former, which links both
+ * patterns in \c IsotopePatternExtractor.
+ */
+std::vector<Xic> makeMixedXics()
+{
+    const double d = 1.00286864;
+    std::vector<Xic> xics;
+    xics.push_back(makeScaledXic(600.0, 500.0));
+    xics.push_back(makeScaledXic(600.0 + d, 166.0));
+    xics.push_back(makeScaledXic(600.0 + 2 * d, 28.0));
+    const double mz2 = 600.0 + d / 3;
+    xics.push_back(makeScaledXic(mz2, 1000.0));
+    xics.push_back(makeScaledXic(mz2 + d / 2, 666.0));
+    xics.push_back(makeScaledXic(mz2 + d, 222.0));
+    xics.push_back(makeScaledXic(mz2 + 3 * d / 2, 49.0));
+    return xics;
+}
+
+struct AveragineSplitterTestSuite : vigra::test_suite
+{
+    AveragineSplitterTestSuite() :
+            vigra::test_suite("AveragineSplitter")
+    {
+        add(testCase(&AveragineSplitterTestSuite::testAccessors));
+        add(testCase(&AveragineSplitterTestSuite::testSplit));
+        add(testCase(&AveragineSplitterTestSuite::testMinScore));
+        add(testCase(&AveragineSplitterTestSuite::testIsotopePatternSplit));
+        add(testCase(&AveragineSplitterTestSuite::testIsotopePatternExtractor));
+    }
+
+    void testAccessors()
+    {
+        PoissonTable table;
+        AveragineSplitter<PoissonTable> s;
+        shouldEqual(s.getEnvelopeTable(), static_cast<const PoissonTable*>(0));
+        shouldEqual(s.getMzTolerance(), 10.0);
+        shouldEqual(s.getMinScore(), 0.8);
+        shouldEqual(s.getMaxPeaks(), static_cast<Size>(8));
+        s.setEnvelopeTable(&table);
+        s.setMzTolerance(5.0);
+        s.setMinScore(0.9);
+        s.setMaxPeaks(4);
+        shouldEqual(s.getEnvelopeTable(), &table);
+        shouldEqual(s.getMzTolerance(), 5.0);
+        shouldEqual(s.getMinScore(), 0.9);
+        shouldEqual(s.getMaxPeaks(), static_cast<Size>(4));
+        bool thrown = false;
+        try {
+            s.setMaxPeaks(1);
+        } catch (PreconditionViolation& e) {
+            thrown = true;
+        }
+        shouldEqual(thrown, true);
+    }
+
+    void testSplit()
+    {
+        std::vector<Xic> xics = makeMixedXics();
+        std::vector<IsotopePattern> ips(1);
+        ips[0].insert(ips[0].end(), xics.begin(), xics.end());
+        PoissonTable table;
+        AveragineSplitter<PoissonTable> s;
+        s.setEnvelopeTable(&table);
+        s.split(ips);
+        shouldEqual(ips.size(), static_cast<size_t>(2));
+        // the z=2 pattern carries the larger abundance and comes first
+        shouldEqual(ips[0].size(), static_cast<size_t>(4));
+        shouldEqual(ips[0].getCharges().size(), static_cast<size_t>(1));
+        shouldEqual(*ips[0].getCharges().begin(), 2);
+        shouldEqualTolerance(ips[0][0].getMz(), 600.3343, 1e-4);
+        shouldEqual(ips[1].size(), static_cast<size_t>(3));
+        shouldEqual(ips[1].getCharges().size(), static_cast<size_t>(1));
+        shouldEqual(*ips[1].getCharges().begin(), 1);
+        shouldEqualTolerance(ips[1][0].getMz(), 600.0, 1e-6);
+    }
+
+    void testMinScore()
+    {
+        // the abundances increase with the isotope number, which does not
+        // match the envelope of a 600 Da molecule
+        const double d = 1.00286864;
+        std::vector<IsotopePattern> ips(1);
+        ips[0].push_back(makeScaledXic(600.0, 55.0));
+        ips[0].push_back(makeScaledXic(600.0 + d, 333.0));
+        ips[0].push_back(makeScaledXic(600.0 + 2 * d, 1000.0));
+        PoissonTable table;
+        AveragineSplitter<PoissonTable> s;
+        s.setEnvelopeTable(&table);
+        s.split(ips);
+        shouldEqual(ips.size(), static_cast<size_t>(1));
+        shouldEqual(ips[0].size(), static_cast<size_t>(3));
+        shouldEqual(ips[0].getCharges().empty(), true);
+        // without the minimum score, the best (but still poor) chain is
+        // accepted and the first XIC is left on its own
+        s.setMinScore(0.0);
+        s.split(ips);
+        shouldEqual(ips.size(), static_cast<size_t>(2));
+        shouldEqual(ips[0].size(), static_cast<size_t>(2));
+        shouldEqual(*ips[0].getCharges().begin(), 1);
+        shouldEqualTolerance(ips[0][0].getMz(), 600.0 + d, 1e-6);
+        shouldEqual(ips[1].size(), static_cast<size_t>(1));
+    }
+
+    void testIsotopePatternSplit()
+    {
+        // IsotopePattern::split with a table scores against the envelopes
+        const double d = 1.00286864;
+        IsotopePattern ip;
+        ip.push_back(makeScaledXic(600.0, 55.0));
+        ip.push_back(makeScaledXic(600.0 + d, 333.0));
+        ip.push_back(makeScaledXic(600.0 + 2 * d, 1000.0));
+        PoissonTable table;
+        std::vector<IsotopePattern> parts;
+        ip.split(parts, table);
+        shouldEqual(parts.size(), static_cast<size_t>(1));
+        shouldEqual(parts[0].size(), static_cast<size_t>(3));
+        shouldEqual(parts[0].getCharges().empty(), true);
+        // without a table, the chain is accepted on abundance alone
+        ip.split(parts);
+        shouldEqual(parts.size(), static_cast<size_t>(1));
+        shouldEqual(parts[0].size(), static_cast<size_t>(3));
+        shouldEqual(*parts[0].getCharges().begin(), 1);
+        // the mixed patterns are unmixed as by the splitter itself
+        IsotopePattern mixed;
+        std::vector<Xic> xics = makeMixedXics();
+        mixed.insert(mixed.end(), xics.begin(), xics.end());
+        mixed.split(parts, table);
+        shouldEqual(parts.size(), static_cast<size_t>(2));
+        shouldEqual(*parts[0].getCharges().begin(), 2);
+        shouldEqual(parts[0].size(), static_cast<size_t>(4));
+        shouldEqual(*parts[1].getCharges().begin(), 1);
+        shouldEqual(parts[1].size(), static_cast<size_t>(3));
+    }
+
+    void testIsotopePatternExtractor()
+    {
+        std::vector<Xic> xics = makeMixedXics();
+        // the first generator yields the unshifted XIC boxes
+        std::vector<XicBoxGenerator> boxGenerators;
+        boxGenerators.push_back(XicBoxGenerator(0.0,
+            std::make_pair(2.0, 20.0), std::make_pair(2.0, 10.0), 1));
+        for (int z = 1; z <= 3; ++z) {
+            boxGenerators.push_back(XicBoxGenerator(1.00286864,
+                std::make_pair(2.0, 20.0), std::make_pair(2.0, 10.0), z));
+        }
+        std::vector<IsotopePattern> ips;
+        {
+            IsotopePatternExtractor<UncenteredCorrelation, NopSplitter> ipe;
+            shouldEqual(ipe(xics, boxGenerators, 0.6, 2, ips),
+                static_cast<Size>(1));
+            shouldEqual(ips[0].size(), static_cast<size_t>(7));
+        }
+        {
+            PoissonTable table;
+            IsotopePatternExtractor<UncenteredCorrelation,
+                    AveragineSplitter<PoissonTable> > ipe;
+            ipe.setEnvelopeTable(&table);
+            shouldEqual(ipe(xics, boxGenerators, 0.6, 2, ips),
+                static_cast<Size>(2));
+            shouldEqual(*ips[0].getCharges().begin(), 2);
+            shouldEqual(ips[0].size(), static_cast<size_t>(4));
+            shouldEqual(*ips[1].getCharges().begin(), 1);
+            shouldEqual(ips[1].size(), static_cast<size_t>(3));
+        }
+    }
+};
+
+int main()
+{
+    AveragineSplitterTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
+
@@ -0,0 +1,308 @@
+/*
+ * BinaryStore-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include "utilities.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/fe/BinaryStore.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/CentroidTableView.hpp>
+#include <MSTK/fe/types/Xic.hpp>
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+struct CompactXic : public std::vector<CompactCentroid>
+{
+    typedef CompactCentroid::MzAccessor MzAccessor;
+    typedef CompactCentroid::AbundanceAccessor AbundanceAccessor;
+    typedef CompactCentroid::RtAccessor RtAccessor;
+    typedef CompactCentroid::LessThanRt LessThanRt;
+    typedef CompactCentroid::LessThanMz LessThanMz;
+
+    explicit CompactXic(std::vector<CompactCentroid>&& cs) :
+        std::vector<CompactCentroid>(std::move(cs))
+    {
+    }
+};
+
+const char* CENTROID_FILE = "BinaryStore-test-centroids.bin";
+const char* XIC_FILE = "BinaryStore-test-xics.bin";
+
+}
+
+struct BinaryStoreTestSuite : vigra::test_suite
+{
+    typedef std::vector<CompactCentroid> CompactCentroids;
+
+    BinaryStoreTestSuite() :
+            vigra::test_suite("BinaryStore")
+    {
+        add(testCase(&BinaryStoreTestSuite::testHeader));
+        add(testCase(&BinaryStoreTestSuite::testCentroidTable));
+        add(testCase(&BinaryStoreTestSuite::testXicTable));
+        add(testCase(&BinaryStoreTestSuite::testXicExtraction));
+        add(testCase(&BinaryStoreTestSuite::testInvalid));
+    }
+
+    ~BinaryStoreTestSuite()
+    {
+        std::remove(CENTROID_FILE);
+        std::remove(XIC_FILE);
+    }
+
+    CompactCentroids makeRandomCentroids(const Size n)
+    {
+        CompactCentroids cs;
+        std::srand(42);
+        for (Size i = 0; i < n; ++i) {
+            unsigned int sn = std::rand() % 200;
+            double mz = 400.0 + 0.0005 * (std::rand() % 8000);
+            double ab = 1.0 + std::rand() % 100;
+            cs.push_back(CompactCentroid(2.0 * sn, mz, sn, ab,
+                RawDataHandle(sn, i % 17, 3)));
+        }
+        return cs;
+    }
+
+    void testHeader()
+    {
+        BinaryStoreHeader h(BinaryStoreHeader::XIC_TABLE, 3, 2);
+        shouldEqual(h.version, BinaryStoreHeader::VERSION);
+        for (int c = 0; c < BinaryStoreHeader::N_COLUMNS; ++c) {
+            shouldEqual(h.columnOffsets[c] % BinaryStoreHeader::ALIGNMENT,
+                static_cast<uint64_t>(0));
+            shouldEqual(h.columnOffsets[c] >= BinaryStoreHeader::SIZE, true);
+        }
+        char buf[BinaryStoreHeader::SIZE];
+        h.encode(buf);
+        // little-endian, independent of the host
+        shouldEqual(buf[8], static_cast<char>(BinaryStoreHeader::VERSION));
+        shouldEqual(buf[12], static_cast<char>(BinaryStoreHeader::XIC_TABLE));
+        shouldEqual(buf[16], static_cast<char>(3));
+        BinaryStoreHeader d = BinaryStoreHeader::decode(buf,
+            h.getFileSize());
+        shouldEqual(d.tableType, h.tableType);
+        shouldEqual(d.nCentroids, h.nCentroids);
+        shouldEqual(d.nXics, h.nXics);
+        for (int c = 0; c < BinaryStoreHeader::N_COLUMNS; ++c) {
+            shouldEqual(d.columnOffsets[c], h.columnOffsets[c]);
+        }
+    }
+
+    void testCentroidTable()
+    {
+        CompactCentroids cs = makeRandomCentroids(1000);
+        writeCentroidTable(CENTROID_FILE, cs);
+        BinaryStoreReader reader(CENTROID_FILE);
+        shouldEqual(reader.isXicTable(), false);
+        const CentroidTableView& v = reader.getCentroids();
+        shouldEqual(v.size(), cs.size());
+        for (Size i = 0; i < cs.size(); ++i) {
+            shouldEqual(v[i] == cs[i], true);
+            shouldEqual(v[i].getRawDataHandle() == cs[i].getRawDataHandle(),
+                true);
+        }
+        shouldEqual(std::equal(v.begin(), v.end(), cs.begin()), true);
+        // the columns are accessed in place
+        shouldEqual(reinterpret_cast<size_t>(v.columns().mz) % 64,
+            static_cast<size_t>(0));
+
+        // Centroid does not have a raw data handle
+        const double mz[] = { 500.0, 501.0 };
+        const double rt[] = { 1.0, 2.0 };
+        const unsigned int sn[] = { 1, 2 };
+        const double ab[] = { 10.0, 20.0 };
+        std::vector<Centroid> ds = makeCentroids(2, mz, rt, sn, ab);
+        writeCentroidTable(CENTROID_FILE, ds);
+        reader.open(CENTROID_FILE);
+        shouldEqual(reader.getCentroids().size(), static_cast<Size>(2));
+        shouldEqual(reader.getCentroids()[1].getMz(), 501.0);
+        shouldEqual(reader.getCentroids()[1].getScanNumber(), 2u);
+        shouldEqual(reader.getCentroids()[1].getRawDataHandle().isValid(),
+            false);
+
+        // empty tables
+        writeCentroidTable(CENTROID_FILE, CompactCentroids());
+        reader.open(CENTROID_FILE);
+        shouldEqual(reader.getCentroids().empty(), true);
+    }
+
+    void testXicTable()
+    {
+        const double mz[] = { 500.0, 500.1, 500.0, 600.0, 600.0, 600.2 };
+        const double rt[] = { 1.0, 2.0, 3.0, 1.0, 2.0, 3.0 };
+        const unsigned int sn[] = { 1, 2, 3, 1, 2, 3 };
+        const double ab[] = { 10.0, 20.0, 10.0, 5.0, 7.0, 5.0 };
+        std::vector<Xic> xics;
+        xics.push_back(makeXic(3, mz, rt, sn, ab));
+        xics.push_back(makeXic(0, mz, rt, sn, ab));
+        xics.push_back(makeXic(3, mz + 3, rt + 3, sn + 3, ab + 3));
+        writeXicTable(XIC_FILE, xics);
+
+        BinaryStoreReader reader(XIC_FILE);
+        shouldEqual(reader.isXicTable(), true);
+        shouldEqual(reader.getCentroids().size(), static_cast<Size>(6));
+        const XicTableView& v = reader.getXics();
+        shouldEqual(v.size(), xics.size());
+        Size k = 0;
+        for (XicTableView::const_iterator i = v.begin(); i != v.end(); ++i, ++k) {
+            shouldEqual((*i).size(), xics[k].size());
+            for (Size j = 0; j < xics[k].size(); ++j) {
+                shouldEqual((*i)[j].getMz(), xics[k][j].getMz());
+                shouldEqual((*i)[j].getRetentionTime(),
+                    xics[k][j].getRetentionTime());
+                shouldEqual((*i)[j].getScanNumber(), xics[k][j].getScanNumber());
+                shouldEqual((*i)[j].getAbundance(), xics[k][j].getAbundance());
+            }
+        }
+
+        // iterators outlive the temporary XIC views they come from
+        CentroidTableView::const_iterator it = v[2].begin();
+        CentroidTableView::const_iterator end = v[2].end();
+        shouldEqual(end - it, static_cast<std::ptrdiff_t>(3));
+        shouldEqual((*it).getMz(), xics[2][0].getMz());
+        shouldEqual(it[2].getAbundance(), xics[2][2].getAbundance());
+
+        // views can be written back
+        writeXicTable(CENTROID_FILE, v);
+        BinaryStoreReader copy(CENTROID_FILE);
+        shouldEqual(copy.getXics().size(), v.size());
+        shouldEqual(copy.getXics()[2].size(), v[2].size());
+        shouldEqual(std::equal(copy.getCentroids().begin(),
+            copy.getCentroids().end(), v.getCentroids().begin()), true);
+    }
+
+    void testXicExtraction()
+    {
+        CompactCentroids cs = makeRandomCentroids(20000);
+        writeCentroidTable(CENTROID_FILE, cs);
+        BinaryStoreReader reader(CENTROID_FILE);
+
+        typedef XicExtractor<CentroidWeightedMeanDisambiguator,
+                RunningMeanSmoother, XicLocalMinSplitter<CompactXic> >
+                MyXicExtractor;
+        CentroidBoxGenerator bg(3, 5.0);
+        MyXicExtractor xe;
+        std::vector<CompactXic> ref;
+        xe(cs, bg, 3, 0.76, ref);
+        std::vector<CompactXic> xs;
+        xe(reader.getCentroids(), bg, 3, 0.76, xs);
+        shouldEqual(xs.size(), ref.size());
+        for (Size i = 0; i < xs.size(); ++i) {
+            shouldEqual(xs[i] == ref[i], true);
+        }
+    }
+
+    void testInvalid()
+    {
+        BinaryStoreReader reader;
+        try {
+            reader.open("BinaryStore-test-does-not-exist.bin");
+            failTest("BinaryStoreReader::open() failed to throw.");
+        } catch (const mstk::RuntimeError& e) {
+            MSTK_UNUSED(e);
+        }
+        // not a binary store
+        {
+            std::ofstream ofs(CENTROID_FILE, std::ios::binary);
+            ofs << "This is not a binary store, but it is long enough to "
+                "hold a header; still, the magic number does not match.\n"
+                "This is not a binary store, but it is long enough to";
+        }
+        try {
+            reader.open(CENTROID_FILE);
+            failTest("BinaryStoreReader::open() failed to throw.");
+        } catch (const mstk::RuntimeError& e) {
+            MSTK_UNUSED(e);
+        }
+        // truncated file
+        CompactCentroids cs = makeRandomCentroids(100);
+        writeCentroidTable(CENTROID_FILE, cs);
+        std::vector<char> data;
+        {
+            std::ifstream ifs(CENTROID_FILE, std::ios::binary);
+            data.assign(std::istreambuf_iterator<char>(ifs),
+                std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream ofs(CENTROID_FILE, std::ios::binary);
+            ofs.write(&data[0], data.size() / 2);
+        }
+        try {
+            reader.open(CENTROID_FILE);
+            failTest("BinaryStoreReader::open() failed to throw.");
+        } catch (const mstk::RuntimeError& e) {
+            MSTK_UNUSED(e);
+        }
+        // an XIC count that wraps around when adding the final offset
+        {
+            std::vector<Xic> xics;
+            writeXicTable(XIC_FILE, xics);
+            std::fstream fs(XIC_FILE, std::ios::in | std::ios::out
+                    | std::ios::binary);
+            fs.seekp(24);
+            const std::string ones(8, '\xff');
+            fs.write(ones.data(), ones.size());
+        }
+        try {
+            reader.open(XIC_FILE);
+            failTest("BinaryStoreReader::open() failed to throw.");
+        } catch (const mstk::RuntimeError& e) {
+            MSTK_UNUSED(e);
+        }
+        // centroid tables do not have XICs
+        writeCentroidTable(CENTROID_FILE, cs);
+        reader.open(CENTROID_FILE);
+        try {
+            reader.getXics();
+            failTest("BinaryStoreReader::getXics() failed to throw.");
+        } catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+        }
+    }
+};
+
+int main()
+{
+    BinaryStoreTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
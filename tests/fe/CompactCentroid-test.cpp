@@ -0,0 +1,229 @@
+/*
+ * CompactCentroid-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/Centroider.hpp>
+#include <MSTK/fe/CentroidTraits.hpp>
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
+#include <MSTK/fe/types/RawDataStore.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <fbi/fbi.h>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace {
+
+// A minimal XIC type for compact centroids.
+struct CompactXic : public std::vector<CompactCentroid>
+{
+    typedef CompactCentroid::MzAccessor MzAccessor;
+    typedef CompactCentroid::AbundanceAccessor AbundanceAccessor;
+    typedef CompactCentroid::RtAccessor RtAccessor;
+    typedef CompactCentroid::LessThanRt LessThanRt;
+    typedef CompactCentroid::LessThanMz LessThanMz;
+
+    explicit CompactXic(std::vector<CompactCentroid>&& cs) :
+        std::vector<CompactCentroid>(std::move(cs))
+    {
+    }
+};
+
+// Concrete class for testing.
+class Disambiguator : public CentroidWeightedMeanDisambiguator
+{
+public:
+    template<class IT>
+    IT run(IT first, IT last)
+    {
+        return disambiguate(first, last);
+    }
+};
+
+}
+
+struct CompactCentroidTestSuite : vigra::test_suite
+{
+    typedef Centroider<CompactCentroid, SimpleBumpFinder,
+            GaussianMeanAccumulator, SumAbundanceAccumulator> CompactCentroider;
+    typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+            SumAbundanceAccumulator> FullCentroider;
+
+    CompactCentroidTestSuite() :
+            vigra::test_suite("CompactCentroid")
+    {
+        add(testCase(&CompactCentroidTestSuite::test));
+        add(testCase(&CompactCentroidTestSuite::testCentroider));
+        add(testCase(&CompactCentroidTestSuite::testDisambiguator));
+        add(testCase(&CompactCentroidTestSuite::testXicExtractor));
+    }
+
+    void test()
+    {
+        CompactCentroid c;
+        c.setRetentionTime(c.getRetentionTime());
+        c.setMz(c.getMz());
+        c.setScanNumber(c.getScanNumber());
+        c.setAbundance(c.getAbundance());
+        c.setRawDataHandle(c.getRawDataHandle());
+        shouldEqual(c.getRawDataHandle().isValid(), false);
+
+        CompactCentroid k(10.0, 400.0, 5, 1e6, RawDataHandle(1, 2, 3));
+        shouldEqual(k.getRetentionTime(), 10.0);
+        shouldEqual(k.getMz(), 400.0);
+        shouldEqual(k.getScanNumber(), static_cast<UnsignedInt>(5));
+        shouldEqual(k.getAbundance(), 1e6);
+        shouldEqual(k.getRawDataHandle() == RawDataHandle(1, 2, 3), true);
+        shouldEqual(k == c, false);
+
+        // the compact variant must be much smaller than a full centroid,
+        // which also owns heap-allocated raw data
+        shouldEqual(sizeof(CompactCentroid) <= 48, true);
+        shouldEqual(sizeof(CompactCentroid) < sizeof(Centroid), true);
+    }
+
+    void testCentroider()
+    {
+        double mz[] = { 546.762451064, 546.764865768, 546.767280487,
+                        546.769695223, 546.772109974, 546.774524741,
+                        546.776939525, 546.779354324, 546.78176914,
+                        546.789013682, 546.791428561, 546.793843457,
+                        546.796258368, 546.798673295, 546.801088239,
+                        546.803503198, 546.805918173, 546.808333165,
+                        546.810748172, 546.813163196 };
+        double ab[] = { 8832.40136719, 54699.3867188, 143617.78125,
+                        236407.625, 272995.125, 227420.328125, 127339.40625,
+                        30389.2695312, 4973.97851562, 14187.8740234,
+                        71039.6640625, 358838.6875, 835839.375, 1241756,
+                        1284578.125, 930160.375, 440593.1875, 112644.351562,
+                        33855.8945312, 16687.5585938 };
+        Spectrum s(std::vector<double>(mz, mz + 20),
+            std::vector<double>(ab, ab + 20));
+
+        // full centroids as reference
+        std::vector<Centroid> cs;
+        FullCentroider fc;
+        fc(s.begin(), s.end(), 10.0, 3, std::back_inserter(cs));
+        shouldEqual(cs.size(), static_cast<Size>(2));
+
+        // compact centroids without a store
+        std::vector<CompactCentroid> ccs;
+        CompactCentroider nc;
+        nc(s.begin(), s.end(), 10.0, 3, std::back_inserter(ccs));
+        shouldEqual(ccs.size(), cs.size());
+        shouldEqual(ccs[0].getRawDataHandle().isValid(), false);
+
+        // compact centroids that reference the raw data store
+        RawDataStore store;
+        store.addScan(s.begin(), s.end()); // some other scan
+        UnsignedInt idx = store.addScan(s.begin(), s.end());
+        SpectrumView v = store.getScan(idx);
+        ccs.clear();
+        CompactCentroider::Creator creator(&store);
+        CompactCentroider cc(creator);
+        cc(v.begin(), v.end(), 10.0, 3, std::back_inserter(ccs));
+        shouldEqual(ccs.size(), cs.size());
+        for (Size i = 0; i < cs.size(); ++i) {
+            shouldEqual(ccs[i].getRetentionTime(), cs[i].getRetentionTime());
+            shouldEqual(ccs[i].getScanNumber(), cs[i].getScanNumber());
+            shouldEqualTolerance(ccs[i].getMz(), cs[i].getMz(), 1e-9);
+            shouldEqualTolerance(ccs[i].getAbundance(), cs[i].getAbundance(),
+                1e-6);
+            shouldEqual(ccs[i].getRawDataHandle().scanIndex, idx);
+            SpectrumView raw = ccs[i].getRawData(store);
+            const Spectrum& ref = cs[i].getRawData();
+            shouldEqual(raw.size(), ref.size());
+            for (Size j = 0; j < ref.size(); ++j) {
+                shouldEqual(raw[j] == ref[j], true);
+            }
+        }
+    }
+
+    void testDisambiguator()
+    {
+        std::vector<CompactCentroid> cs;
+        cs.push_back(CompactCentroid(1.0, 100.0, 1, 1.0));
+        cs.push_back(CompactCentroid(2.0, 100.0, 2, 1.0));
+        cs.push_back(CompactCentroid(2.0, 102.0, 2, 3.0));
+        cs.push_back(CompactCentroid(3.0, 100.0, 3, 1.0));
+        Disambiguator d;
+        std::vector<CompactCentroid>::iterator e = d.run(cs.begin(),
+            cs.end());
+        shouldEqual(std::distance(cs.begin(), e), 3);
+        shouldEqual(cs[1].getMz(), 101.5);
+        shouldEqual(cs[1].getAbundance(), 4.0);
+    }
+
+    void testXicExtractor()
+    {
+        // two traces, one of which is split in two
+        std::vector<CompactCentroid> cs;
+        double ab0[] = { 0.2, 0.6, 1.0, 0.6, 0.2 };
+        double ab1[] = { 0.2, 0.6, 1.0, 0.6, 0.1, 0.6, 1.0, 0.6, 0.2 };
+        for (UnsignedInt i = 0; i < 5; ++i) {
+            cs.push_back(CompactCentroid(350.0 + 2 * i, 100.0, 42 + i,
+                ab0[i]));
+        }
+        for (UnsignedInt i = 0; i < 9; ++i) {
+            cs.push_back(CompactCentroid(350.0 + 2 * i, 200.0, 42 + i,
+                ab1[i]));
+        }
+        typedef XicExtractor<CentroidWeightedMeanDisambiguator,
+                RunningMeanSmoother, XicLocalMinSplitter<CompactXic> > MyXicExtractor;
+        MyXicExtractor xe;
+        CentroidBoxGenerator bg(3, 10.0);
+        std::vector<CompactXic> xs;
+        Size n = xe(cs, bg, 3, 0.76, xs);
+        shouldEqual(xs.size(), n);
+        shouldEqual(n, static_cast<Size>(3));
+        Size total = 0;
+        for (Size i = 0; i < xs.size(); ++i) {
+            total += xs[i].size();
+        }
+        shouldEqual(total, cs.size());
+    }
+};
+
+int main()
+{
+    CompactCentroidTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -0,0 +1,185 @@
+/*
+ * DenseUncenteredCorrelation-test.hpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include "utilities.hpp"
+#include <MSTK/common/InstructionSet.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/DenseUncenteredCorrelation.hpp>
+#include <MSTK/fe/UncenteredCorrelation.hpp>
+#include <MSTK/fe/types/DenseXicProfile.hpp>
+#include <MSTK/fe/types/ProfileKernels.hpp>
+#include <MSTK/fe/types/Xic.hpp>
+#include <MSTK/fe/types/XicProfile.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+namespace { // local namespace
+
+// Concrete classes for testing.
+class DenseCorrelator : public DenseUncenteredCorrelation
+{
+public:
+    ThresholdType run(const DenseXicProfileArena& profiles, Size i, Size j)
+    {
+        return correlate(profiles, i, j);
+    }
+};
+
+class Correlator : public UncenteredCorrelation
+{
+public:
+    ThresholdType run(const XicProfileArena& profiles, Size i, Size j)
+    {
+        return correlate(profiles, i, j);
+    }
+};
+
+/** A XIC over scans [first, first + n) with random abundances and random
+ * gaps.
+ */
+Xic makeRandomXic(const unsigned int first, const size_t n)
+{
+    std::vector<double> mz, rt, ab;
+    std::vector<unsigned int> sn;
+    for (size_t k = 0; k < n; ++k) {
+        if (k > 0 && k + 1 < n && std::rand() % 4 == 0) {
+            continue;
+        }
+        sn.push_back(first + k);
+        rt.push_back(2.0 * (first + k));
+        mz.push_back(500.0);
+        ab.push_back(std::rand() / (RAND_MAX + 1.0) * 1e5);
+    }
+    return makeXic(sn.size(), &mz[0], &rt[0], &sn[0], &ab[0]);
+}
+
+}
+
+struct DenseUncenteredCorrelationTestSuite : vigra::test_suite
+{
+    DenseUncenteredCorrelationTestSuite() :
+            vigra::test_suite("DenseUncenteredCorrelation")
+    {
+        add(testCase(&DenseUncenteredCorrelationTestSuite::testArena));
+        add(testCase(&DenseUncenteredCorrelationTestSuite::testKernels));
+        add(testCase(&DenseUncenteredCorrelationTestSuite::testCorrelate));
+    }
+
+    void testArena()
+    {
+        double mz[] = { 100.0, 100.0, 100.0 };
+        double rt[] = { 350.0, 352.0, 358.0 };
+        unsigned int sn[] = { 42, 43, 46 };
+        double ab[] = { 1.0, 2.0, 3.0 };
+        std::vector<Xic> xics;
+        xics.push_back(makeXic(3, mz, rt, sn, ab));
+        xics.push_back(makeXic(1, mz + 2, rt + 2, sn + 2, ab + 2));
+        DenseXicProfileArena profiles;
+        profiles.assign(xics);
+        shouldEqual(profiles.size(), static_cast<Size> (2));
+        shouldEqual(profiles.getFirstScan(0), static_cast<UnsignedInt> (42));
+        shouldEqual(profiles.getLength(0), static_cast<Size> (5));
+        double expected[] = { 1.0, 2.0, 0.0, 0.0, 3.0 };
+        for (Size k = 0; k < 5; ++k) {
+            shouldEqual(profiles.data(0)[k], expected[k]);
+        }
+        shouldEqual(profiles.getSquaredNorm(0), 14.0);
+        shouldEqual(profiles.getFirstScan(1), static_cast<UnsignedInt> (46));
+        shouldEqual(profiles.getLength(1), static_cast<Size> (1));
+        shouldEqual(profiles.data(1)[0], 3.0);
+        // the profiles are cache line aligned
+        shouldEqual(reinterpret_cast<size_t> (profiles.data(0)) % 64,
+            static_cast<size_t> (0));
+    }
+
+    /** All kernel levels agree with a plain loop and with each other.
+     */
+    void testKernels()
+    {
+        std::vector<const ProfileKernels*> kernels;
+        const int supported = InstructionSet::getSupported();
+        for (int l = InstructionSet::SCALAR; l <= supported; ++l) {
+            kernels.push_back(&ProfileKernels::get(
+                static_cast<InstructionSet::Level> (l)));
+        }
+        shouldEqual(ProfileKernels::get(InstructionSet::SCALAR).level,
+            InstructionSet::SCALAR);
+        for (Size n = 0; n < 40; ++n) {
+            std::vector<double> l(n + 1), r(n + 1);
+            double ref = 0.0;
+            for (Size i = 0; i < n; ++i) {
+                l[i] = std::rand() / (RAND_MAX + 1.0);
+                r[i] = std::rand() / (RAND_MAX + 1.0);
+                ref += l[i] * r[i];
+            }
+            const double s = kernels[0]->dotProduct(&l[0], &r[0], n);
+            shouldEqualTolerance(s, ref, 1e-12);
+            for (Size k = 1; k < kernels.size(); ++k) {
+                shouldEqual(kernels[k]->dotProduct(&l[0], &r[0], n), s);
+            }
+        }
+    }
+
+    /** The dense correlation agrees with the rt-merging one.
+     */
+    void testCorrelate()
+    {
+        std::srand(3);
+        std::vector<Xic> xics;
+        for (int i = 0; i < 50; ++i) {
+            xics.push_back(makeRandomXic(100 + std::rand() % 30,
+                1 + std::rand() % 25));
+        }
+        DenseXicProfileArena dense;
+        dense.assign(xics);
+        XicProfileArena sparse;
+        sparse.assign(xics);
+        DenseCorrelator dc;
+        Correlator c;
+        Size nOverlapping = 0;
+        for (Size i = 0; i < xics.size(); ++i) {
+            for (Size j = 0; j < xics.size(); ++j) {
+                const double expected = c.run(sparse, i, j);
+                shouldEqualTolerance(dc.run(dense, i, j), expected, 1e-12);
+                nOverlapping += expected > 0.0 ? 1 : 0;
+            }
+            shouldEqualTolerance(dc.run(dense, i, i), 1.0, 1e-12);
+        }
+        should(nOverlapping > xics.size());
+    }
+};
+
+int main()
+{
+    DenseUncenteredCorrelationTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
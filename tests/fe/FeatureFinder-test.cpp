@@ -0,0 +1,301 @@
+/*
+ * FeatureFinder-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/Centroider.hpp>
+#include <MSTK/fe/FeatureFinder.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/IsotopePatternExtractor.hpp>
+#include <MSTK/fe/NopSplitter.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/StreamingXicExtractor.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/fe/UncenteredCorrelation.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/IsotopePattern.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/Xic.hpp>
+#include <MSTK/fe/types/XicFbiTraits.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct FeatureFinderTestSuite : vigra::test_suite
+{
+    typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+            SumAbundanceAccumulator> MyCentroider;
+    typedef XicExtractor<CentroidWeightedMeanDisambiguator,
+            RunningMeanSmoother, XicLocalMinSplitter<Xic> > MyXicExtractor;
+    typedef StreamingXicExtractor<CentroidWeightedMeanDisambiguator,
+            RunningMeanSmoother, XicLocalMinSplitter<Xic> , Xic,
+            CentroidBoxGenerator> MyStreamingXicExtractor;
+    typedef IsotopePatternExtractor<UncenteredCorrelation, NopSplitter>
+            MyIsotopePatternExtractor;
+    typedef FeatureFinder<MyCentroider, MyStreamingXicExtractor,
+            MyIsotopePatternExtractor, IsotopePattern, XicBoxGenerator>
+            MyFeatureFinder;
+
+    /** An isotope pattern, reduced to the (m/z, size) of its XICs.
+     */
+    typedef std::vector<std::pair<double, Size> > Signature;
+
+    FeatureFinderTestSuite() :
+            vigra::test_suite("FeatureFinder")
+    {
+        add(testCase(&FeatureFinderTestSuite::testEquivalence));
+        add(testCase(&FeatureFinderTestSuite::testReuse));
+        add(testCase(&FeatureFinderTestSuite::testException));
+    }
+
+    /** A synthetic profile mode run: overlapping isotope patterns in charge
+     * states 1-3 over 120 scans, plus random noise peaks.
+     */
+    std::vector<Spectrum> makeRun()
+    {
+        const UnsignedInt nScans = 120;
+        std::vector<Spectrum> run(nScans);
+        for (UnsignedInt sn = 0; sn < nScans; ++sn) {
+            run[sn].setRetentionTime(2.0 * sn);
+            run[sn].setScanNumber(sn);
+        }
+        std::vector<std::pair<double, double> > peaks;
+        std::srand(11);
+        for (Size f = 0; f < 40; ++f) {
+            const double mz = 400.0 + 800.0 * std::rand() / (RAND_MAX + 1.0);
+            const int z = 1 + std::rand() % 3;
+            const double apex = 10.0 + std::rand() % 100;
+            const double height = 1e4 + 1e5 * std::rand() / (RAND_MAX + 1.0);
+            for (UnsignedInt sn = 0; sn < nScans; ++sn) {
+                const double d = (sn - apex) / 4.0;
+                if (std::abs(d) > 3.0) {
+                    continue;
+                }
+                double iso = 1.0;
+                for (int k = 0; k < 4; ++k) {
+                    run[sn].push_back(SpectrumElement(mz + k * 1.00286864 / z,
+                        height * iso * std::exp(-0.5 * d * d)));
+                    iso *= 0.6;
+                }
+            }
+        }
+        for (UnsignedInt sn = 0; sn < nScans; ++sn) {
+            for (Size i = 0; i < 20; ++i) {
+                run[sn].push_back(SpectrumElement(
+                    400.0 + 800.0 * std::rand() / (RAND_MAX + 1.0),
+                    100.0 + std::rand() % 1000));
+            }
+        }
+        // sample every stick as a profile peak
+        for (UnsignedInt sn = 0; sn < nScans; ++sn) {
+            Spectrum profile;
+            profile.setRetentionTime(run[sn].getRetentionTime());
+            profile.setScanNumber(run[sn].getScanNumber());
+            for (Spectrum::const_iterator i = run[sn].begin(); i
+                    != run[sn].end(); ++i) {
+                for (int j = -3; j <= 3; ++j) {
+                    const double d = 0.003 * j;
+                    profile.push_back(SpectrumElement(i->mz + d,
+                        i->abundance * std::exp(-d * d / 5e-5)));
+                }
+            }
+            std::sort(profile.begin(), profile.end(),
+                Spectrum::LessThanMz<Spectrum::Element,
+                    Spectrum::Element>());
+            run[sn] = profile;
+        }
+        return run;
+    }
+
+    std::vector<XicBoxGenerator> makeBoxGenerators()
+    {
+        std::vector<XicBoxGenerator> bgs;
+        for (int z = 1; z <= 3; ++z) {
+            bgs.push_back(XicBoxGenerator(1.00286864,
+                std::make_pair(2.0, 20.0), std::make_pair(2.0, 10.0), z));
+        }
+        return bgs;
+    }
+
+    Signature sign(const IsotopePattern& ip)
+    {
+        Signature s;
+        for (IsotopePattern::const_iterator i = ip.begin(); i != ip.end(); ++i) {
+            Xic x = *i;
+            s.push_back(std::make_pair(x.getMz(), x.size()));
+        }
+        std::sort(s.begin(), s.end());
+        return s;
+    }
+
+    /** Hand-wired batch pipeline.
+     */
+    std::vector<Signature> batch(const std::vector<Spectrum>& run)
+    {
+        MyCentroider c;
+        std::vector<Centroid> cs;
+        for (std::vector<Spectrum>::const_iterator i = run.begin(); i
+                != run.end(); ++i) {
+            c(i->begin(), i->end(), i->getRetentionTime(), i->getScanNumber(),
+                std::back_inserter(cs));
+        }
+        MyXicExtractor xe;
+        std::vector<Xic> xics;
+        xe(cs, CentroidBoxGenerator(3, 5.0), 3, 0.76, xics);
+        MyIsotopePatternExtractor ipe;
+        std::vector<IsotopePattern> ips;
+        ipe(xics, makeBoxGenerators(), 0.6, 2, ips);
+        std::vector<Signature> sigs;
+        for (Size i = 0; i < ips.size(); ++i) {
+            sigs.push_back(sign(ips[i]));
+        }
+        std::sort(sigs.begin(), sigs.end());
+        return sigs;
+    }
+
+    std::vector<Signature> find(const std::vector<Spectrum>& run,
+        const MyFeatureFinder::Mode mode, const Size queueCapacity)
+    {
+        std::vector<Signature> sigs;
+        MyFeatureFinder ff(MyCentroider(), CentroidBoxGenerator(3, 5.0), 3,
+            0.76, makeBoxGenerators(), 0.6, 2,
+            [&](IsotopePattern&& ip) {sigs.push_back(sign(ip));}, mode,
+            queueCapacity);
+        shouldEqual(ff.getMode(), mode);
+        for (std::vector<Spectrum>::const_iterator i = run.begin(); i
+                != run.end(); ++i) {
+            ff.addScan(*i);
+        }
+        ff.flush();
+        std::sort(sigs.begin(), sigs.end());
+        return sigs;
+    }
+
+    void shouldEqualSignatures(const std::vector<Signature>& lhs,
+        const std::vector<Signature>& rhs)
+    {
+        shouldEqual(lhs.size(), rhs.size());
+        for (Size i = 0; i < lhs.size(); ++i) {
+            shouldEqual(lhs[i].size(), rhs[i].size());
+            for (Size j = 0; j < lhs[i].size(); ++j) {
+                shouldEqualTolerance(lhs[i][j].first, rhs[i][j].first, 1e-9);
+                shouldEqual(lhs[i][j].second, rhs[i][j].second);
+            }
+        }
+    }
+
+    /** The streamed pipeline must find the same isotope patterns as the
+     * hand-wired batch pipeline, in both execution modes and independent of
+     * the queue capacity.
+     */
+    void testEquivalence()
+    {
+        std::vector<Spectrum> run = makeRun();
+        std::vector<Signature> ref = batch(run);
+        shouldEqual(ref.size() >= 30, true);
+        shouldEqualSignatures(find(run, MyFeatureFinder::SEQUENTIAL, 1), ref);
+        shouldEqualSignatures(find(run, MyFeatureFinder::PIPELINED, 1), ref);
+        shouldEqualSignatures(find(run, MyFeatureFinder::PIPELINED, 64), ref);
+    }
+
+    /** Two consecutive runs through the same pipeline.
+     */
+    void testReuse()
+    {
+        std::vector<Spectrum> run = makeRun();
+        for (int m = 0; m < 2; ++m) {
+            MyFeatureFinder::Mode mode = m == 0 ? MyFeatureFinder::SEQUENTIAL
+                    : MyFeatureFinder::PIPELINED;
+            Size n = 0;
+            MyFeatureFinder ff(MyCentroider(), CentroidBoxGenerator(3, 5.0), 3,
+                0.76, makeBoxGenerators(), 0.6, 2,
+                [&n](IsotopePattern&&) {++n;}, mode);
+            Size counts[2];
+            for (int r = 0; r < 2; ++r) {
+                n = 0;
+                for (Size i = 0; i < run.size(); ++i) {
+                    ff.addScan(run[i]);
+                }
+                ff.flush();
+                counts[r] = n;
+            }
+            shouldEqual(counts[0] > 0, true);
+            shouldEqual(counts[0], counts[1]);
+        }
+    }
+
+    /** Exceptions raised on a stage thread are rethrown on the caller's
+     * thread; the pipeline can be reused afterwards.
+     */
+    void testException()
+    {
+        std::vector<Spectrum> run = makeRun();
+        bool fail = true;
+        Size n = 0;
+        MyFeatureFinder ff(MyCentroider(), CentroidBoxGenerator(3, 5.0), 3,
+            0.76, makeBoxGenerators(), 0.6, 2, [&](IsotopePattern&&) {
+                if (fail) {
+                    throw std::runtime_error("callback failed");
+                }
+                ++n;
+            }, MyFeatureFinder::PIPELINED, 2);
+        bool thrown = false;
+        try {
+            for (Size i = 0; i < run.size(); ++i) {
+                ff.addScan(run[i]);
+            }
+            ff.flush();
+        } catch (std::runtime_error&) {
+            thrown = true;
+        }
+        shouldEqual(thrown, true);
+        fail = false;
+        for (Size i = 0; i < run.size(); ++i) {
+            ff.addScan(run[i]);
+        }
+        ff.flush();
+        shouldEqual(n, batch(run).size());
+    }
+};
+
+int main()
+{
+    FeatureFinderTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -147,41 +147,54 @@ struct IsotopePatternTestSuite : vigra::test_suite
 
     void testSplit()
     {
-        // this is supposed to fail unless the split function
-        // gets implemented.
-        bool thrown = false;
-        try {
-            IsotopePattern ip;
-            std::vector<IsotopePattern> ips;
-            ip.split(ips);
-        } catch(RuntimeError& e) {
-            thrown = true;
-        }
-        shouldEqual(thrown, true);
- /*
         {
-            // generate a few patterns that cannot be split
+            // patterns that cannot be split are kept as they are
             IsotopePattern ip;
             std::vector<IsotopePattern> ips;
             ip.split(ips);
             shouldEqual(ips.size(), static_cast<size_t>(1));
-            shouldEqual(ips[0], ip);
+            shouldEqual(ips[0].size(), static_cast<size_t>(0));
             std::vector<double> mz;
             mz += 100.0;
             ip = makeIsotopePattern(mz, 1300.4, 2);
             ips.clear();
             ip.split(ips);
             shouldEqual(ips.size(), static_cast<size_t>(1));
-            shouldEqual(ips[0], ip);
+            shouldEqual(ips[0].size(), static_cast<size_t>(1));
+            shouldEqual(ips[0][0].getMz(), ip[0].getMz());
+            should(ips[0].getCharges() == ip.getCharges());
         }
         {
-
+            // a single z=2 pattern
             std::vector<double> mz;
-            // 13C distances
-            mz += 100.0, 101.0033, 102.0066;
-            IsotopePattern ip = makeIsotopePattern(mz, 1300.4, 2);
+            mz += 100.0, 100.50143, 101.00287;
+            IsotopePattern ip = makeIsotopePattern(mz, 1300.4, 1);
+            std::vector<IsotopePattern> ips;
+            ip.split(ips);
+            shouldEqual(ips.size(), static_cast<size_t>(1));
+            shouldEqual(ips[0].size(), static_cast<size_t>(3));
+            shouldEqual(ips[0].getCharges().size(), static_cast<size_t>(1));
+            shouldEqual(*ips[0].getCharges().begin(), 2);
+            // the original pattern remains untouched
+            shouldEqual(ip.size(), static_cast<size_t>(3));
+        }
+        {
+            // overlapping z=1 and z=2 patterns
+            std::vector<double> mz;
+            mz += 600.0, 600.3, 600.80143, 601.00287, 601.30287, 601.8043,
+                    602.00574;
+            IsotopePattern ip = makeIsotopePattern(mz, 1300.4, 1);
+            std::vector<IsotopePattern> ips;
+            ip.split(ips);
+            shouldEqual(ips.size(), static_cast<size_t>(2));
+            // the four peak z=2 pattern carries the larger abundance
+            shouldEqual(ips[0].size(), static_cast<size_t>(4));
+            shouldEqual(*ips[0].getCharges().begin(), 2);
+            shouldEqualTolerance(ips[0][0].getMz(), 600.3, 1e-6);
+            shouldEqual(ips[1].size(), static_cast<size_t>(3));
+            shouldEqual(*ips[1].getCharges().begin(), 1);
+            shouldEqualTolerance(ips[1][0].getMz(), 600.0, 1e-6);
         }
-*/
     }
 };
 
@@ -28,8 +28,11 @@
 #include <MSTK/fe/IsotopePatternExtractor.hpp>
 #include <MSTK/fe/types/XicFbiTraits.hpp>
 #include <MSTK/fe/UncenteredCorrelation.hpp>
+#include <MSTK/fe/DenseUncenteredCorrelation.hpp>
 #include <MSTK/fe/NopSplitter.hpp>
 #include <MSTK/common/Types.hpp>
+#include <cmath>
+#include <cstdlib>
 
 using namespace mstk::fe;
 using namespace mstk;
@@ -40,6 +43,7 @@ struct IsotopePatternExtractorTestSuite : vigra::test_suite
             vigra::test_suite("IsotopePatternExtractor")
     {
         add(testCase(&IsotopePatternExtractorTestSuite::testSingleXic));
+        add(testCase(&IsotopePatternExtractorTestSuite::testThreads));
     }
 
     void testSingleXic()
@@ -88,6 +92,69 @@ struct IsotopePatternExtractorTestSuite : vigra::test_suite
         // We do not expect to find anything.
         shouldEqual(ips.empty(), true);
     }
+
+    /** The parallel correlation filter must reproduce the serial results,
+     * including the order of the isotope patterns.
+     */
+    void testThreads()
+    {
+        // isotope patterns with partially shifted elution profiles, so that
+        // some of the candidate edges fail the correlation test
+        std::vector < Xic > xics;
+        std::srand(7);
+        for (int p = 0; p < 200; ++p) {
+            const double mz0 = 400.0 + 0.05 * p + 10.0 * (p % 20);
+            const int z = 1 + p % 3;
+            const double rt0 = 100.0 + 7.0 * (p % 13);
+            for (int k = 0; k < 4; ++k) {
+                double mz[9], rt[9], ab[9];
+                unsigned int sn[9];
+                const int shift = std::rand() % 5 == 0 ? 3 : 0;
+                for (int s = 0; s < 9; ++s) {
+                    mz[s] = mz0 + k * 1.00286864 / z;
+                    sn[s] = static_cast<unsigned int> (rt0 / 2.0) + s + shift;
+                    rt[s] = 2.0 * sn[s];
+                    ab[s] = 1000.0 * std::exp(-0.2 * (s - 4) * (s - 4));
+                }
+                xics.push_back(makeXic(9, mz, rt, sn, ab));
+            }
+        }
+        std::vector < XicBoxGenerator > boxGenerators;
+        for (int z = 1; z <= 3; ++z) {
+            boxGenerators.push_back(XicBoxGenerator(1.00286864,
+                std::make_pair(2.0, 20.0), std::make_pair(2.0, 10.0), z));
+        }
+        typedef IsotopePatternExtractor<UncenteredCorrelation,
+                NopSplitter> MyIsotopePatternExtractor;
+        MyIsotopePatternExtractor serial;
+        shouldEqual(serial.getNumberOfThreads(), static_cast<UnsignedInt> (1));
+        std::vector < IsotopePattern > expected;
+        serial(xics, boxGenerators, 0.9, 2, expected);
+        should(expected.size() > 0);
+        UnsignedInt nThreads[] = { 2, 3, 0 };
+        for (int t = 0; t < 3; ++t) {
+            MyIsotopePatternExtractor ipe(nThreads[t]);
+            shouldEqual(ipe.getNumberOfThreads(), nThreads[t]);
+            std::vector < IsotopePattern > ips;
+            ipe(xics, boxGenerators, 0.9, 2, ips);
+            shouldEqual(ips.size(), expected.size());
+            for (Size i = 0; i < ips.size(); ++i) {
+                shouldEqual(ips[i].size(), expected[i].size());
+                shouldEqual(ips[i].begin()->getMz(),
+                    expected[i].begin()->getMz());
+                shouldEqual(ips[i].getAbundance(), expected[i].getAbundance());
+            }
+        }
+        // the dense correlator is a drop-in replacement
+        IsotopePatternExtractor<DenseUncenteredCorrelation, NopSplitter> dense;
+        std::vector < IsotopePattern > ips;
+        dense(xics, boxGenerators, 0.9, 2, ips);
+        shouldEqual(ips.size(), expected.size());
+        for (Size i = 0; i < ips.size(); ++i) {
+            shouldEqual(ips[i].size(), expected[i].size());
+            shouldEqual(ips[i].getAbundance(), expected[i].getAbundance());
+        }
+    }
 }
 ;
 
@@ -0,0 +1,268 @@
+/*
+ * MoveSemantics-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include "utilities.hpp"
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/XicCreator.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/CentroidTraits.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/IsotopePattern.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/Xic.hpp>
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <fbi/fbi.h>
+
+//
+// allocation counting
+//
+// The test replaces the global operator new and counts all allocations of
+// exactly nRawBytes bytes, i.e. the allocations that happen whenever the raw
+// data of one of the test centroids is copied.
+static const std::size_t nRaw = 7;
+static const std::size_t nRawBytes = nRaw * sizeof(mstk::fe::SpectrumElement);
+static bool countAllocations = false;
+static std::size_t nAllocations = 0;
+static std::size_t nRawAllocations = 0;
+
+void* operator new(std::size_t n)
+{
+    if (countAllocations) {
+        ++nAllocations;
+        if (n == nRawBytes) {
+            ++nRawAllocations;
+        }
+    }
+    void* p = std::malloc(n == 0 ? 1 : n);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct MoveSemanticsTestSuite : vigra::test_suite
+{
+    typedef std::vector<Centroid> Centroids;
+    typedef std::vector<Xic> Xics;
+
+    MoveSemanticsTestSuite() :
+            vigra::test_suite("MoveSemantics")
+    {
+        add(testCase(&MoveSemanticsTestSuite::testSpectrum));
+        add(testCase(&MoveSemanticsTestSuite::testCentroid));
+        add(testCase(&MoveSemanticsTestSuite::testXic));
+        add(testCase(&MoveSemanticsTestSuite::testIsotopePattern));
+        add(testCase(&MoveSemanticsTestSuite::testXicCreator));
+        add(testCase(&MoveSemanticsTestSuite::testXicExtractor));
+    }
+
+    static Centroid makeCentroid(double rt, double mz, unsigned int sn,
+        double ab)
+    {
+        std::vector<SpectrumElement> raw;
+        raw.reserve(nRaw);
+        for (size_t i = 0; i < nRaw; ++i) {
+            raw.push_back(SpectrumElement(mz - 0.003 + 0.001 * i, ab));
+        }
+        return Centroid(rt, mz, sn, ab, raw.begin(), raw.end());
+    }
+
+    void startCounting()
+    {
+        nAllocations = 0;
+        nRawAllocations = 0;
+        countAllocations = true;
+    }
+
+    void stopCounting()
+    {
+        countAllocations = false;
+    }
+
+    void testSpectrum()
+    {
+        Spectrum s;
+        for (size_t i = 0; i < 100; ++i) {
+            s.push_back(SpectrumElement(100.0 + i, 1.0));
+        }
+        s.setRetentionTime(42.0);
+        s.setPrecursorMz(500.25);
+        s.setPrecursorCharge(2);
+        s.setPrecursorScanNumber(17);
+        s.setPrecursorAbundance(1000.0);
+        startCounting();
+        Spectrum t(std::move(s));
+        Spectrum u;
+        u = std::move(t);
+        stopCounting();
+        shouldEqual(nAllocations, static_cast<size_t>(0));
+        shouldEqual(u.size(), static_cast<size_t>(100));
+        shouldEqual(u.getRetentionTime(), 42.0);
+        shouldEqual(t.size(), static_cast<size_t>(0));
+        shouldEqual(s.size(), static_cast<size_t>(0));
+        // both moved-from spectra keep their metadata
+        shouldEqual(s.getRetentionTime(), 42.0);
+        shouldEqual(t.getRetentionTime(), 42.0);
+        shouldEqual(t.getPrecursorMz(), 500.25);
+        shouldEqual(t.getPrecursorCharge(), 2);
+        shouldEqual(t.getPrecursorScanNumber(), 17u);
+        shouldEqual(t.getPrecursorAbundance(), 1000.0);
+    }
+
+    void testCentroid()
+    {
+        Centroid c = makeCentroid(350.0, 100.0, 42, 1.0);
+        startCounting();
+        Centroid d(std::move(c));
+        Centroid e;
+        e = std::move(d);
+        stopCounting();
+        shouldEqual(nAllocations, static_cast<size_t>(0));
+        shouldEqual(e.getRawData().size(), nRaw);
+        shouldEqual(e.getMz(), 100.0);
+        // copies still copy
+        startCounting();
+        Centroid f(e);
+        stopCounting();
+        shouldEqual(nRawAllocations, static_cast<size_t>(1));
+        shouldEqual(f, e);
+    }
+
+    void testXic()
+    {
+        Centroids cs;
+        for (size_t i = 0; i < 10; ++i) {
+            cs.push_back(makeCentroid(350.0 + i, 100.0, 42 + i, 1.0));
+        }
+        startCounting();
+        Xic x(std::move(cs));
+        Xic y(std::move(x));
+        Xic z;
+        z = std::move(y);
+        stopCounting();
+        shouldEqual(nAllocations, static_cast<size_t>(0));
+        shouldEqual(z.size(), static_cast<size_t>(10));
+        shouldEqual(z.getRetentionTime(), 354.5);
+    }
+
+    void testIsotopePattern()
+    {
+        Xics xs;
+        for (size_t j = 0; j < 3; ++j) {
+            Centroids cs;
+            for (size_t i = 0; i < 5; ++i) {
+                cs.push_back(makeCentroid(350.0 + i, 100.0 + j, 42 + i, 1.0));
+            }
+            xs.push_back(Xic(std::move(cs)));
+        }
+        startCounting();
+        IsotopePattern ip(std::move(xs));
+        IsotopePattern jp(std::move(ip));
+        IsotopePattern kp;
+        kp = std::move(jp);
+        stopCounting();
+        shouldEqual(nAllocations, static_cast<size_t>(0));
+        shouldEqual(kp.size(), static_cast<size_t>(3));
+    }
+
+    void testXicCreator()
+    {
+        Centroids cs;
+        for (size_t i = 0; i < 10; ++i) {
+            cs.push_back(makeCentroid(350.0 + i, 100.0, 42 + i, 1.0));
+        }
+        XicCreator<Xic> creator;
+        // lvalues are copied...
+        startCounting();
+        Xic x = creator(cs);
+        stopCounting();
+        shouldEqual(nRawAllocations, static_cast<size_t>(10));
+        // ...rvalues are not
+        startCounting();
+        Xic y = creator(std::move(cs));
+        stopCounting();
+        shouldEqual(nAllocations, static_cast<size_t>(0));
+        shouldEqual(x, y);
+    }
+
+    void testXicExtractor()
+    {
+        // 10000 well-separated traces with 100 scans each
+        const size_t nTraces = 10000;
+        const size_t nScans = 100;
+        Centroids cs;
+        cs.reserve(nTraces * nScans);
+        for (size_t s = 0; s < nScans; ++s) {
+            for (size_t t = 0; t < nTraces; ++t) {
+                double ab = 1.0 + static_cast<double> (s < nScans / 2 ?
+                        s : nScans - s);
+                cs.push_back(makeCentroid(100.0 + 2.0 * s, 200.0 + 0.1 * t,
+                    s, ab));
+            }
+        }
+        typedef XicExtractor<CentroidWeightedMeanDisambiguator,
+                RunningMeanSmoother, XicLocalMinSplitter<Xic> > MyXicExtractor;
+        MyXicExtractor xe;
+        CentroidBoxGenerator bg(3, 0.01);
+        Xics xs;
+        startCounting();
+        Size n = xe(cs, bg, 3, 0.5, xs);
+        stopCounting();
+        shouldEqual(n, nTraces);
+        // The centroids are copied exactly once out of the (const) input;
+        // the smoothing buffer is reused and only allocates for the first
+        // XIC. All further stages move.
+        shouldEqual(nRawAllocations <= cs.size() + nScans, true);
+    }
+};
+
+int main()
+{
+    MoveSemanticsTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -0,0 +1,143 @@
+/*
+ * ParallelCentroider-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/Centroider.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/ParallelCentroider.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct ParallelCentroiderTestSuite : vigra::test_suite
+{
+    typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+            SumAbundanceAccumulator> MyCentroider;
+    typedef ParallelCentroider<Centroid, SimpleBumpFinder,
+            GaussianMeanAccumulator, SumAbundanceAccumulator> MyParallelCentroider;
+
+    ParallelCentroiderTestSuite() :
+            vigra::test_suite("ParallelCentroider")
+    {
+        add(testCase(&ParallelCentroiderTestSuite::testThreads));
+        add(testCase(&ParallelCentroiderTestSuite::testCompare));
+        add(testCase(&ParallelCentroiderTestSuite::testCompact));
+    }
+
+    // Creates a run of spectra with a varying number of Gaussian peaks.
+    std::vector<Spectrum> makeRun(const Size nSpectra)
+    {
+        std::vector<Spectrum> run(nSpectra);
+        for (Size k = 0; k < nSpectra; ++k) {
+            Spectrum& s = run[k];
+            s.setRetentionTime(1.0 * k);
+            s.setScanNumber(static_cast<unsigned int>(k + 1));
+            Size nPeaks = 1 + k % 7;
+            for (Size p = 0; p < nPeaks; ++p) {
+                double center = 400.0 + 10.0 * p + 0.01 * k;
+                for (int j = -5; j <= 5; ++j) {
+                    double d = 0.005 * j;
+                    s.push_back(SpectrumElement(center + d,
+                        1000.0 * (k + 1) * std::exp(-d * d / 1e-4)));
+                }
+            }
+        }
+        return run;
+    }
+
+    void testThreads()
+    {
+        MyParallelCentroider pc(3);
+        shouldEqual(pc.getNumberOfThreads(), static_cast<UnsignedInt>(3));
+        pc.setNumberOfThreads(0);
+        shouldEqual(pc.getNumberOfThreads(), static_cast<UnsignedInt>(0));
+        // empty input
+        std::vector<Spectrum> run;
+        std::vector<Centroid> cs;
+        shouldEqual(pc(run.begin(), run.end(), std::back_inserter(cs)),
+            static_cast<Size>(0));
+        shouldEqual(cs.empty(), true);
+    }
+
+    void testCompare()
+    {
+        std::vector<Spectrum> run = makeRun(500);
+        // serial reference
+        std::vector<Centroid> ref;
+        MyCentroider c;
+        for (std::vector<Spectrum>::iterator i = run.begin(); i != run.end();
+                ++i) {
+            c(i->begin(), i->end(), i->getRetentionTime(), i->getScanNumber(),
+                std::back_inserter(ref));
+        }
+        shouldEqual(ref.size() > run.size(), true);
+        // the result must not depend on the number of threads
+        for (UnsignedInt nt = 1; nt <= 16; nt *= 2) {
+            std::vector<Centroid> cs;
+            MyParallelCentroider pc(nt);
+            Size n = pc(run.begin(), run.end(), std::back_inserter(cs));
+            shouldEqual(n, ref.size());
+            shouldEqual(cs.size(), ref.size());
+            shouldEqual(cs == ref, true);
+        }
+    }
+
+    void testCompact()
+    {
+        std::vector<Spectrum> run = makeRun(100);
+        typedef ParallelCentroider<CompactCentroid, SimpleBumpFinder,
+                GaussianMeanAccumulator, SumAbundanceAccumulator> CompactParallelCentroider;
+        std::vector<Centroid> ref;
+        MyParallelCentroider pc(1);
+        pc(run.begin(), run.end(), std::back_inserter(ref));
+        std::vector<CompactCentroid> cs;
+        CompactParallelCentroider cpc(4);
+        cpc(run.begin(), run.end(), std::back_inserter(cs));
+        shouldEqual(cs.size(), ref.size());
+        for (Size i = 0; i < cs.size(); ++i) {
+            shouldEqual(cs[i].getScanNumber(), ref[i].getScanNumber());
+            shouldEqual(cs[i].getMz(), ref[i].getMz());
+            shouldEqual(cs[i].getAbundance(), ref[i].getAbundance());
+        }
+    }
+};
+
+int main()
+{
+    ParallelCentroiderTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -28,16 +28,26 @@
 #include <MSTK/fe/QuickCharge.hpp>
 #include <MSTK/fe/types/Xic.hpp>
 #include <MSTK/fe/XicTraits.hpp>
+#include <MSTK/common/Error.hpp>
 #include <MSTK/common/Types.hpp>
+#include <boost/assign.hpp>
 #include <iostream>
+#include <iterator>
 #include <set>
+#include <vector>
 
 using namespace mstk::fe;
 using namespace mstk;
+using namespace boost::assign;
 
 struct QuickChargeTestSuite : vigra::test_suite {
     QuickChargeTestSuite() : vigra::test_suite("QuickCharge") {
         add(testCase(&QuickChargeTestSuite::test));
+        add(testCase(&QuickChargeTestSuite::testChargeSet));
+        add(testCase(&QuickChargeTestSuite::testGetCharges));
+        add(testCase(&QuickChargeTestSuite::testTolerance));
+        add(testCase(&QuickChargeTestSuite::testMinSupport));
+        add(testCase(&QuickChargeTestSuite::testBatch));
     }
 
     void test() {
@@ -54,6 +64,127 @@ struct QuickChargeTestSuite : vigra::test_suite {
             shouldEqual(charges[k], expectedCharges[k]);
         }
     }
+
+    void testChargeSet()
+    {
+        ChargeSet cs;
+        shouldEqual(cs.empty(), true);
+        shouldEqual(cs.size(), static_cast<Size>(0));
+        shouldEqual(cs.insert(3), true);
+        shouldEqual(cs.insert(3), false);
+        shouldEqual(cs.insert(1), true);
+        shouldEqual(cs.insert(64), true);
+        // out of range charges are ignored
+        shouldEqual(cs.insert(0), false);
+        shouldEqual(cs.insert(65), false);
+        shouldEqual(cs.insert(-2), false);
+        shouldEqual(cs.size(), static_cast<Size>(3));
+        shouldEqual(cs.contains(3), true);
+        shouldEqual(cs.contains(2), false);
+        shouldEqual(cs.contains(65), false);
+        shouldEqual(cs.getBits(), (static_cast<uint64_t>(1) << 63) | 5u);
+        std::vector<int> charges;
+        cs.copy(std::back_inserter(charges));
+        shouldEqual(charges.size(), static_cast<Size>(3));
+        shouldEqual(charges[0], 1);
+        shouldEqual(charges[1], 3);
+        shouldEqual(charges[2], 64);
+        cs.clear();
+        shouldEqual(cs.empty(), true);
+    }
+
+    void testGetCharges()
+    {
+        double mzs[] = { 100.001, 100.2502, 100.33, 100.501, 101.001 };
+        std::vector<double> masses(&mzs[0], &mzs[5]);
+        IsotopePattern ip = makeIsotopePattern(masses, 3324.0, 1);
+        QuickCharge qc;
+        ChargeSet cs = qc.getCharges(ip.begin(), ip.end());
+        std::vector<int> charges;
+        qc(ip.begin(), ip.end(), std::back_inserter(charges));
+        shouldEqual(cs.size(), charges.size());
+        for (Size k = 0; k < charges.size(); ++k) {
+            shouldEqual(cs.contains(charges[k]), true);
+        }
+        // charges beyond ChargeSet::MAX_CHARGE are not reported
+        std::vector<double> close;
+        close += 100.0, 100.001, 100.5;
+        ip = makeIsotopePattern(close, 3324.0, 1);
+        cs = qc.getCharges(ip.begin(), ip.end());
+        shouldEqual(cs.size(), static_cast<Size>(1));
+        shouldEqual(cs.contains(2), true);
+        // empty and single peak sequences
+        cs = qc.getCharges(ip.begin(), ip.begin());
+        shouldEqual(cs.empty(), true);
+        cs = qc.getCharges(ip.begin(), ip.begin() + 1);
+        shouldEqual(cs.empty(), true);
+    }
+
+    void testTolerance()
+    {
+        // a z=2 pattern with a contaminant in between
+        std::vector<double> masses;
+        masses += 500.0, 500.27, 500.50143, 501.00287;
+        IsotopePattern ip = makeIsotopePattern(masses, 3324.0, 1);
+        QuickCharge qc;
+        ChargeSet all = qc.getCharges(ip.begin(), ip.end());
+        should(all.size() > 2);
+        qc.setTolerance(0.01);
+        shouldEqual(qc.getTolerance(), 0.01);
+        ChargeSet cs = qc.getCharges(ip.begin(), ip.end());
+        shouldEqual(cs.size(), static_cast<Size>(2));
+        shouldEqual(cs.contains(1), true);
+        shouldEqual(cs.contains(2), true);
+    }
+
+    void testMinSupport()
+    {
+        // four z=3 distances, one z=2 distance
+        std::vector<double> masses;
+        masses += 500.0, 500.33429, 500.66858, 501.00287, 501.33716,
+                501.83859;
+        IsotopePattern ip = makeIsotopePattern(masses, 3324.0, 1);
+        QuickCharge qc(0.01, 3);
+        shouldEqual(qc.getMinSupport(), static_cast<Size>(3));
+        ChargeSet cs = qc.getCharges(ip.begin(), ip.end());
+        shouldEqual(cs.contains(3), true);
+        shouldEqual(cs.contains(2), false);
+        qc.setMinSupport(1);
+        cs = qc.getCharges(ip.begin(), ip.end());
+        shouldEqual(cs.contains(2), true);
+        bool thrown = false;
+        try {
+            qc.setMinSupport(0);
+        } catch (PreconditionViolation& e) {
+            thrown = true;
+        }
+        shouldEqual(thrown, true);
+    }
+
+    void testBatch()
+    {
+        std::vector<IsotopePattern> ips;
+        for (int p = 0; p < 500; ++p) {
+            const int z = 1 + p % 5;
+            std::vector<double> masses;
+            for (int k = 0; k < 2 + p % 4; ++k) {
+                masses.push_back(300.0 + p + k * 1.00286864 / z);
+            }
+            ips.push_back(makeIsotopePattern(masses, 3324.0, z));
+        }
+        QuickCharge qc(0.01);
+        for (UnsignedInt nThreads = 1; nThreads <= 4; ++nThreads) {
+            std::vector<ChargeSet> charges;
+            qc.getCharges(ips, charges, nThreads);
+            shouldEqual(charges.size(), ips.size());
+            for (Size i = 0; i < ips.size(); ++i) {
+                shouldEqual(charges[i].getBits(),
+                    qc.getCharges(ips[i].begin(), ips[i].end()).getBits());
+                shouldEqual(charges[i].contains(*ips[i].getCharges().begin()),
+                    true);
+            }
+        }
+    }
 };
 
 int main()
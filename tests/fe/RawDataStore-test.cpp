@@ -0,0 +1,114 @@
+/*
+ * RawDataStore-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <iostream>
+#include <vector>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/RawDataStore.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumView.hpp>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct RawDataStoreTestSuite : vigra::test_suite
+{
+    RawDataStoreTestSuite() :
+            vigra::test_suite("RawDataStore")
+    {
+        add(testCase(&RawDataStoreTestSuite::testHandle));
+        add(testCase(&RawDataStoreTestSuite::testStore));
+    }
+
+    void testHandle()
+    {
+        RawDataHandle h;
+        shouldEqual(h.isValid(), false);
+        RawDataHandle k(0, 1, 2);
+        shouldEqual(k.isValid(), true);
+        shouldEqual(k == RawDataHandle(0, 1, 2), true);
+        shouldEqual(k == RawDataHandle(0, 1, 3), false);
+    }
+
+    void testStore()
+    {
+        RawDataStore store;
+        shouldEqual(store.empty(), true);
+        Spectrum s;
+        for (int i = 0; i < 5; ++i) {
+            s.push_back(SpectrumElement(100.0 + i, 10.0 * i));
+        }
+        Spectrum t;
+        for (int i = 0; i < 3; ++i) {
+            t.push_back(SpectrumElement(200.0 + i, 1.0 + i));
+        }
+        store.reserve(2, 8);
+        shouldEqual(store.addScan(s.begin(), s.end()),
+            static_cast<UnsignedInt>(0));
+        shouldEqual(store.addScan(t.begin(), t.end()),
+            static_cast<UnsignedInt>(1));
+        shouldEqual(store.size(), static_cast<Size>(2));
+        shouldEqual(store.getNumberOfPoints(), static_cast<Size>(8));
+
+        SpectrumView v = store.getScan(1);
+        shouldEqual(v.size(), t.size());
+        for (Size i = 0; i < t.size(); ++i) {
+            shouldEqual(v[i] == t[i], true);
+        }
+        SpectrumView w = store.get(RawDataHandle(0, 1, 3));
+        shouldEqual(w.size(), static_cast<Size>(3));
+        shouldEqual(w[0] == s[1], true);
+        shouldEqual(w[2] == s[3], true);
+        shouldEqual(store.get(RawDataHandle()).empty(), true);
+
+        // handles must not exceed their scan
+        try {
+            store.get(RawDataHandle(1, 2, 2));
+            failTest("RawDataStore::get() failed to throw.");
+        } catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+        }
+        try {
+            store.getScan(2);
+            failTest("RawDataStore::getScan() failed to throw.");
+        } catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+        }
+
+        store.clear();
+        shouldEqual(store.empty(), true);
+        shouldEqual(store.getNumberOfPoints(), static_cast<Size>(0));
+    }
+};
+
+int main()
+{
+    RawDataStoreTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -0,0 +1,220 @@
+/*
+ * ScanTable-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/fe/types/ScanTable.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct ScanTableTestSuite : vigra::test_suite
+{
+    ScanTableTestSuite() :
+            vigra::test_suite("ScanTable")
+    {
+        add(testCase(&ScanTableTestSuite::testAdd));
+        add(testCase(&ScanTableTestSuite::testScanNumberLookup));
+        add(testCase(&ScanTableTestSuite::testRetentionTimeRange));
+        add(testCase(&ScanTableTestSuite::testSort));
+        add(testCase(&ScanTableTestSuite::testPartition));
+    }
+
+    /** A DDA-like run: one MS1 scan followed by three MS2 scans.
+     */
+    std::vector<Spectrum> makeRun(const Size nScans)
+    {
+        std::vector<Spectrum> run;
+        for (Size i = 0; i < nScans; ++i) {
+            Spectrum s;
+            const unsigned int msLevel = i % 4 == 0 ? 1 : 2;
+            s.setScanNumber(1000 + i);
+            s.setRetentionTime(0.5 * i);
+            s.setMsLevel(msLevel);
+            if (msLevel == 2) {
+                s.setPrecursorScanNumber(1000 + i - i % 4);
+                s.setPrecursorMz(400.0 + i);
+                s.setPrecursorCharge(2);
+                s.setPrecursorAbundance(1e5 + i);
+            }
+            for (Size j = 0; j < i % 7; ++j) {
+                s.push_back(SpectrumElement(100.0 + j + i, 1.0 + j));
+            }
+            s.setTotalIonCurrent(s.getTotalAbundance());
+            run.push_back(s);
+        }
+        return run;
+    }
+
+    void shouldEqualSpectrum(const ScanTable::Row& r, const Spectrum& s)
+    {
+        shouldEqual(r.toSpectrum(), s);
+        shouldEqual(r.getNumberOfPeaks(), s.size());
+        SpectrumRange peaks = r.getPeaks();
+        shouldEqual(std::equal(peaks.first, peaks.second, s.begin()), true);
+    }
+
+    void testAdd()
+    {
+        std::vector<Spectrum> run = makeRun(50);
+        ScanTable table;
+        shouldEqual(table.empty(), true);
+        table.reserve(run.size(), 200);
+        Size nPeaks = 0;
+        for (Size i = 0; i < run.size(); ++i) {
+            shouldEqual(table.add(run[i]), i);
+            nPeaks += run[i].size();
+        }
+        shouldEqual(table.size(), run.size());
+        shouldEqual(table.getNumberOfPeaks(), nPeaks);
+        for (Size i = 0; i < run.size(); ++i) {
+            shouldEqual(table[i].getIndex(), i);
+            shouldEqualSpectrum(table[i], run[i]);
+        }
+        shouldEqual(table.getRetentionTimes()[3], 1.5);
+        shouldEqual(table.getMsLevels()[4], 1u);
+        shouldEqual(table.getScanNumbers()[5], 1005u);
+        table.clear();
+        shouldEqual(table.size(), (Size)0);
+        shouldEqual(table.getNumberOfPeaks(), (Size)0);
+        shouldEqual(table.findScanNumber(1005), ScanTable::npos);
+    }
+
+    void testScanNumberLookup()
+    {
+        std::vector<Spectrum> run = makeRun(50);
+        ScanTable table;
+        for (Size i = 0; i < run.size(); ++i) {
+            table.add(run[i]);
+        }
+        for (Size i = 0; i < run.size(); ++i) {
+            shouldEqual(table.findScanNumber(run[i].getScanNumber()), i);
+        }
+        shouldEqual(table.findScanNumber(1), ScanTable::npos);
+        // the precursor of an MS2 scan
+        Size ms2 = table.findScanNumber(1010);
+        Size ms1 = table.findScanNumber(
+            table[ms2].getPrecursorScanNumber());
+        shouldEqual(table[ms1].getScanNumber(), 1008u);
+        shouldEqual(table[ms1].getMsLevel(), 1u);
+        // duplicates: the first row wins
+        table.add(run[3]);
+        shouldEqual(table.findScanNumber(run[3].getScanNumber()), (Size)3);
+    }
+
+    void testRetentionTimeRange()
+    {
+        std::vector<Spectrum> run = makeRun(50);
+        ScanTable table;
+        for (Size i = 0; i < run.size(); ++i) {
+            table.add(run[i]);
+        }
+        shouldEqual(table.isSortedByRetentionTime(), true);
+        std::pair<Size, Size> r = table.findRetentionTimeRange(2.0, 5.0);
+        shouldEqual(r.first, (Size)4);
+        shouldEqual(r.second, (Size)11);
+        r = table.findRetentionTimeRange(2.1, 2.2);
+        shouldEqual(r.first, r.second);
+        r = table.findRetentionTimeRange(-10.0, 100.0);
+        shouldEqual(r.second - r.first, run.size());
+        // out of order
+        table.add(run[0]);
+        shouldEqual(table.isSortedByRetentionTime(), false);
+        try {
+            table.findRetentionTimeRange(2.0, 5.0);
+            failTest("ScanTable::findRetentionTimeRange() failed to throw.");
+        } catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+        }
+        table.sort(Spectrum::LessThanRt<ScanTable::Row, ScanTable::Row>());
+        shouldEqual(table.isSortedByRetentionTime(), true);
+        r = table.findRetentionTimeRange(0.0, 0.0);
+        shouldEqual(r.second - r.first, (Size)2);
+    }
+
+    void testSort()
+    {
+        std::vector<Spectrum> run = makeRun(50);
+        ScanTable table;
+        for (Size i = run.size(); i > 0; --i) {
+            table.add(run[i - 1]);
+        }
+        shouldEqual(table.isSortedByRetentionTime(), false);
+        table.sort(Spectrum::LessThanRt<ScanTable::Row, ScanTable::Row>());
+        for (Size i = 0; i < run.size(); ++i) {
+            shouldEqualSpectrum(table[i], run[i]);
+            shouldEqual(table.findScanNumber(run[i].getScanNumber()), i);
+        }
+        // the sort is stable and agrees with sorting the spectra
+        table.sort(Spectrum::LessThanMsLevel<ScanTable::Row,
+                ScanTable::Row>());
+        std::stable_sort(run.begin(), run.end(),
+            Spectrum::LessThanMsLevel<Spectrum, Spectrum>());
+        for (Size i = 0; i < run.size(); ++i) {
+            shouldEqualSpectrum(table[i], run[i]);
+        }
+        // MS2 scans start after the MS1 scans
+        std::vector<ScanTable::Row> rows;
+        for (Size i = 0; i < table.size(); ++i) {
+            rows.push_back(table[i]);
+        }
+        std::vector<ScanTable::Row>::iterator ms2 = std::lower_bound(
+            rows.begin(), rows.end(), 2.0, Spectrum::LessThanMsLevel<
+                    ScanTable::Row, double>());
+        shouldEqual(Size(ms2 - rows.begin()), (Size)13);
+    }
+
+    void testPartition()
+    {
+        std::vector<Spectrum> run = makeRun(50);
+        ScanTable table;
+        for (Size i = 0; i < run.size(); ++i) {
+            table.add(run[i]);
+        }
+        Size nMs1 = table.partition(Spectrum::EqualMsLevel(1));
+        shouldEqual(nMs1, (Size)13);
+        std::vector<Spectrum>::iterator mid = std::stable_partition(
+            run.begin(), run.end(), Spectrum::EqualMsLevel(1));
+        shouldEqual(Size(mid - run.begin()), nMs1);
+        for (Size i = 0; i < run.size(); ++i) {
+            shouldEqualSpectrum(table[i], run[i]);
+            shouldEqual(table.findScanNumber(run[i].getScanNumber()), i);
+        }
+        shouldEqual(table.isSortedByRetentionTime(), false);
+    }
+};
+
+int main()
+{
+    ScanTableTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
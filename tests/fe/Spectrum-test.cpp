@@ -28,6 +28,7 @@
 #include <fstream>
 #include <iostream>
 #include <numeric>
+#include <vector>
 // expose the class
 #define private public
 #define protected public
@@ -85,6 +86,165 @@ public:
         }
     }
     
+    void testMergingInterleaved() {
+        // interleaved spectra with a few shared m/z values
+        Spectrum s1, s2, ref;
+        for (int i = 0; i < 1000; ++i) {
+            s1.push_back(Spectrum::Element(2 * i, 1));
+            s2.push_back(Spectrum::Element(3 * i, 2));
+        }
+        for (int mz = 0; mz < 3000; ++mz) {
+            double ab = 0.0;
+            if (mz % 2 == 0 && mz < 2000) {
+                ab += 1;
+            }
+            if (mz % 3 == 0) {
+                ab += 2;
+            }
+            if (ab > 0.0) {
+                ref.push_back(Spectrum::Element(mz, ab));
+            }
+        }
+        s1.merge(s2);
+        shouldEqual(s1, ref);
+    }
+
+    void testMergeSpectra() {
+        std::vector<Spectrum> spectra(5);
+        for (int k = 0; k < 5; ++k) {
+            for (int i = 0; i < 100; ++i) {
+                // every spectrum is shifted by 0.001
+                spectra[k].push_back(Spectrum::Element(100.0 + i + 0.001 * k,
+                    1.0 + k));
+            }
+        }
+        spectra.push_back(Spectrum());
+        // without tolerance, the result equals pairwise merging
+        Spectrum pairwise;
+        for (size_t k = 0; k < spectra.size(); ++k) {
+            pairwise.merge(spectra[k]);
+        }
+        Spectrum merged = mergeSpectra(spectra.begin(), spectra.end());
+        shouldEqual(merged.size(), (unsigned int)500);
+        shouldEqual(merged, pairwise);
+        // with tolerance, all five peaks are combined
+        merged = mergeSpectra(spectra.begin(), spectra.end(), 0.01);
+        shouldEqual(merged.size(), (unsigned int)100);
+        for (int i = 0; i < 100; ++i) {
+            shouldEqualTolerance(merged[i].abundance, 15.0, 1E-12);
+            // weighted mean: (0*1 + 1*2 + 2*3 + 3*4 + 4*5) / 15 * 0.001
+            shouldEqualTolerance(merged[i].mz, 100.0 + i + 0.04 / 1.5 * 0.1,
+                1E-9);
+        }
+        // identical peaks keep their m/z exactly
+        std::vector<Spectrum> same(3, spectra[0]);
+        merged = mergeSpectra(same.begin(), same.end(), 0.5);
+        shouldEqual(merged.size(), (unsigned int)100);
+        for (int i = 0; i < 100; ++i) {
+            shouldEqual(merged[i].mz, spectra[0][i].mz);
+            shouldEqual(merged[i].abundance, 3.0);
+        }
+        // no spectra
+        merged = mergeSpectra(same.end(), same.end());
+        shouldEqual(merged.empty(), true);
+    }
+
+    void testRemoveDuplicates() {
+        Spectrum s;
+        s.setScanNumber(17);
+        s.setRetentionTime(12.5);
+        // groups: {100.0, 100.001, 100.0015}, {101.0}, {102.0, 102.0}
+        s.push_back(Spectrum::Element(100.0, 1.0));
+        s.push_back(Spectrum::Element(100.001, 2.0));
+        s.push_back(Spectrum::Element(100.0015, 1.0));
+        s.push_back(Spectrum::Element(101.0, 4.0));
+        s.push_back(Spectrum::Element(102.0, 1.0));
+        s.push_back(Spectrum::Element(102.0, 0.0));
+        Spectrum r = s.removeDuplicates(0.0016);
+        shouldEqual(s.size(), (unsigned int)6);
+        shouldEqual(r.size(), (unsigned int)3);
+        shouldEqual(r.getScanNumber(), 17u);
+        shouldEqual(r.getRetentionTime(), 12.5);
+        shouldEqualTolerance(r[0].mz, 100.0 + (0.002 + 0.0015) / 4.0, 1E-12);
+        shouldEqual(r[0].abundance, 4.0);
+        shouldEqual(r[1].mz, 101.0);
+        shouldEqual(r[2].mz, 102.0);
+        shouldEqual(r[2].abundance, 1.0);
+        // in place
+        const Spectrum::Element* data = &s[0];
+        shouldEqual(s.compactDuplicates(0.0016), (unsigned int)3);
+        shouldEqual(s, r);
+        shouldEqual(&s[0], data);
+        shouldEqual(s.getScanNumber(), 17u);
+        // the tolerance is measured from the first peak of a group
+        Spectrum chain;
+        for (int i = 0; i < 4; ++i) {
+            chain.push_back(Spectrum::Element(200.0 + 0.001 * i, 1.0));
+        }
+        chain.compactDuplicates(0.0016);
+        shouldEqual(chain.size(), (unsigned int)2);
+        // zero abundances keep the first m/z of the group
+        Spectrum zeros;
+        zeros.push_back(Spectrum::Element(300.0, 0.0));
+        zeros.push_back(Spectrum::Element(300.001, 0.0));
+        zeros.compactDuplicates(0.01);
+        shouldEqual(zeros.size(), (unsigned int)1);
+        shouldEqual(zeros[0].mz, 300.0);
+        // empty and single peak spectra
+        Spectrum empty;
+        shouldEqual(empty.compactDuplicates(), (unsigned int)0);
+        empty.push_back(Spectrum::Element(1.0, 1.0));
+        shouldEqual(empty.compactDuplicates(), (unsigned int)0);
+        shouldEqual(empty.size(), (unsigned int)1);
+    }
+
+    void testCompactDuplicatesPpm() {
+        // 10ppm at m/z 100 is 0.001, at m/z 1000 it is 0.01
+        Spectrum s;
+        s.push_back(Spectrum::Element(100.0, 1.0));
+        s.push_back(Spectrum::Element(100.005, 1.0));
+        s.push_back(Spectrum::Element(1000.0, 1.0));
+        s.push_back(Spectrum::Element(1000.005, 1.0));
+        Spectrum da(s);
+        shouldEqual(da.compactDuplicates(0.006, Spectrum::TOLERANCE_DA),
+            (unsigned int)2);
+        shouldEqual(s.compactDuplicates(10.0, Spectrum::TOLERANCE_PPM),
+            (unsigned int)1);
+        shouldEqual(s.size(), (unsigned int)3);
+        shouldEqual(s[1].mz, 100.005);
+        shouldEqualTolerance(s[2].mz, 1000.0025, 1E-9);
+        shouldEqual(s[2].abundance, 2.0);
+    }
+
+    void testCompactDuplicatesLong() {
+        // long spectra exercise the blocked search; duplicates at
+        // various positions relative to the block boundaries
+        for (int pos = 0; pos < 40; ++pos) {
+            Spectrum s;
+            for (int i = 0; i < 40; ++i) {
+                s.push_back(Spectrum::Element(100.0 + i, 1.0));
+                if (i == pos) {
+                    s.push_back(Spectrum::Element(100.0 + i + 0.001, 1.0));
+                }
+            }
+            Spectrum unique(s);
+            shouldEqual(unique.compactDuplicates(0.0016), (unsigned int)1);
+            shouldEqual(unique.size(), (unsigned int)40);
+            shouldEqual(unique[pos].abundance, 2.0);
+            // agrees with merging the spectrum on its own
+            std::vector<Spectrum> single(1, s);
+            shouldEqual(unique,
+                mergeSpectra(single.begin(), single.end(), 0.0016));
+        }
+        Spectrum none;
+        for (int i = 0; i < 1000; ++i) {
+            none.push_back(Spectrum::Element(100.0 + 0.01 * i, 1.0));
+        }
+        Spectrum copy(none);
+        shouldEqual(none.compactDuplicates(0.0016), (unsigned int)0);
+        shouldEqual(none, copy);
+    }
+
     void testShiftMz() {
         //test all spectrum shifting functions
 
@@ -256,6 +416,11 @@ public:
 struct SpectrumTestSuite : public vigra::test_suite {
     SpectrumTestSuite() : vigra::test_suite("Spectrum Tests") {
         add( testCase(&SpectrumTest::testMerging ));
+        add( testCase(&SpectrumTest::testMergingInterleaved ));
+        add( testCase(&SpectrumTest::testMergeSpectra ));
+        add( testCase(&SpectrumTest::testRemoveDuplicates ));
+        add( testCase(&SpectrumTest::testCompactDuplicatesPpm ));
+        add( testCase(&SpectrumTest::testCompactDuplicatesLong ));
         add( testCase(&SpectrumTest::testShiftMz ));
         add( testCase(&SpectrumTest::testMaxAbundance ));
         add( testCase(&SpectrumTest::test_LessThanMzScalar ));
@@ -0,0 +1,246 @@
+/*
+ * SpectrumKernels-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/InstructionSet.hpp>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumKernels.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct SpectrumKernelsTestSuite : vigra::test_suite
+{
+    SpectrumKernelsTestSuite() :
+            vigra::test_suite("SpectrumKernels")
+    {
+        add(testCase(&SpectrumKernelsTestSuite::testDispatch));
+        add(testCase(&SpectrumKernelsTestSuite::testSumAbundances));
+        add(testCase(&SpectrumKernelsTestSuite::testFindMaxAbundance));
+        add(testCase(&SpectrumKernelsTestSuite::testTransformMz));
+        add(testCase(&SpectrumKernelsTestSuite::testScaleAbundances));
+    }
+
+    std::vector<SpectrumElement> makeElements(const Size n)
+    {
+        std::vector<SpectrumElement> e;
+        for (Size i = 0; i < n; ++i) {
+            e.push_back(SpectrumElement(300.0 + 0.1 * i + std::rand()
+                    / (RAND_MAX + 1.0), std::rand() / (RAND_MAX + 1.0) * 1e6));
+        }
+        return e;
+    }
+
+    /** Element counts that cover all unrolled loop tails.
+     */
+    std::vector<Size> getSizes()
+    {
+        std::vector<Size> sizes;
+        for (Size n = 0; n < 40; ++n) {
+            sizes.push_back(n);
+        }
+        sizes.push_back(1000);
+        sizes.push_back(1003);
+        return sizes;
+    }
+
+    /** The kernels of all levels the host supports.
+     */
+    std::vector<const SpectrumKernels*> getKernels()
+    {
+        std::vector<const SpectrumKernels*> kernels;
+        const int supported = InstructionSet::getSupported();
+        for (int l = InstructionSet::SCALAR; l <= supported; ++l) {
+            kernels.push_back(&SpectrumKernels::get(
+                static_cast<InstructionSet::Level> (l)));
+        }
+        return kernels;
+    }
+
+    bool bitwiseEqual(const std::vector<SpectrumElement>& a,
+        const std::vector<SpectrumElement>& b)
+    {
+        return a.size() == b.size() && (a.empty() || std::memcmp(&a[0],
+            &b[0], a.size() * sizeof(SpectrumElement)) == 0);
+    }
+
+    void testDispatch()
+    {
+        shouldEqual(SpectrumKernels::get(InstructionSet::SCALAR).level,
+            InstructionSet::SCALAR);
+        shouldEqual(SpectrumKernels::get().level,
+            InstructionSet::getSupported());
+        // unsupported levels fall back to the best supported one
+        shouldEqual(SpectrumKernels::get(InstructionSet::AVX512).level,
+            InstructionSet::getSupported());
+        shouldEqual(std::string(InstructionSet::getName(
+            InstructionSet::SCALAR)), std::string("scalar"));
+        std::cout << "Using " << InstructionSet::getName(
+            InstructionSet::getSupported()) << " kernels" << std::endl;
+    }
+
+    void testSumAbundances()
+    {
+        std::vector<const SpectrumKernels*> kernels = getKernels();
+        std::vector<Size> sizes = getSizes();
+        for (Size j = 0; j < sizes.size(); ++j) {
+            std::vector<SpectrumElement> e = makeElements(sizes[j]);
+            const SpectrumElement* p = e.empty() ? 0 : &e[0];
+            double ref = std::accumulate(e.begin(), e.end(), 0.0,
+                Spectrum::SumAbundance());
+            double scalar = kernels[0]->sumAbundances(p, e.size());
+            shouldEqualTolerance(scalar, ref, 1e-9 * (1.0 + ref));
+            // all paths use the same summation order
+            for (Size k = 1; k < kernels.size(); ++k) {
+                shouldEqual(kernels[k]->sumAbundances(p, e.size()), scalar);
+            }
+        }
+        // integers are summed exactly
+        Spectrum s;
+        for (int i = 0; i < 100; ++i) {
+            s.push_back(SpectrumElement(100.0 + i, i));
+        }
+        shouldEqual(s.getTotalAbundance(), 4950.0);
+        shouldEqual(Spectrum().getTotalAbundance(), 0.0);
+    }
+
+    void testFindMaxAbundance()
+    {
+        std::vector<const SpectrumKernels*> kernels = getKernels();
+        std::vector<Size> sizes = getSizes();
+        for (Size j = 0; j < sizes.size(); ++j) {
+            std::vector<SpectrumElement> e = makeElements(sizes[j]);
+            // ties: the first maximum wins
+            if (e.size() > 5) {
+                e[e.size() - 1].abundance = 2e6;
+                e[e.size() / 2].abundance = 2e6;
+                e[e.size() / 2 + 1].abundance = 2e6;
+            }
+            const SpectrumElement* p = e.empty() ? 0 : &e[0];
+            Size ref = std::max_element(e.begin(), e.end(),
+                Spectrum::LessThanAbundance<SpectrumElement,
+                        SpectrumElement>()) - e.begin();
+            for (Size k = 0; k < kernels.size(); ++k) {
+                shouldEqual(kernels[k]->findMaxAbundance(p, e.size()), ref);
+            }
+        }
+        Spectrum s;
+        shouldEqual(s.getMaxAbundancePeak() == s.end(), true);
+        // all equal
+        s.assign(20, SpectrumElement(1.0, 3.0));
+        shouldEqual(s.getMaxAbundancePeak() == s.begin(), true);
+    }
+
+    void testTransformMz()
+    {
+        std::vector<const SpectrumKernels*> kernels = getKernels();
+        std::vector<Size> sizes = getSizes();
+        for (Size j = 0; j < sizes.size(); ++j) {
+            const std::vector<SpectrumElement> e = makeElements(sizes[j]);
+            SpectrumElement* p;
+            // a pure shift is exact
+            std::vector<SpectrumElement> ref(e);
+            for (Size i = 0; i < ref.size(); ++i) {
+                ref[i].mz += 0.25;
+            }
+            for (Size k = 0; k < kernels.size(); ++k) {
+                std::vector<SpectrumElement> t(e);
+                p = t.empty() ? 0 : &t[0];
+                kernels[k]->transformMz(p, t.size(), 1.0, 0.25);
+                shouldEqual(bitwiseEqual(t, ref), true);
+            }
+            // an affine transform leaves the abundances untouched
+            for (Size k = 0; k < kernels.size(); ++k) {
+                std::vector<SpectrumElement> t(e);
+                p = t.empty() ? 0 : &t[0];
+                kernels[k]->transformMz(p, t.size(), 1.0 + 2e-6, -0.001);
+                for (Size i = 0; i < t.size(); ++i) {
+                    shouldEqualTolerance(t[i].mz, e[i].mz * (1.0 + 2e-6)
+                            - 0.001, 1e-12);
+                    shouldEqual(t[i].abundance, e[i].abundance);
+                }
+            }
+        }
+        Spectrum s;
+        s.push_back(SpectrumElement(100.0, 1.0));
+        s.push_back(SpectrumElement(101.0, 5.0));
+        s.push_back(SpectrumElement(103.0, 2.0));
+        s.shiftTo(200.0);
+        shouldEqual(s[0].mz, 200.0);
+        shouldEqual(s[2].mz, 203.0);
+        s.shiftMaxToMonoisotopicMass();
+        shouldEqual(s[1].mz, 200.0);
+        shouldEqual(s[1].abundance, 5.0);
+    }
+
+    void testScaleAbundances()
+    {
+        std::vector<const SpectrumKernels*> kernels = getKernels();
+        std::vector<Size> sizes = getSizes();
+        for (Size j = 0; j < sizes.size(); ++j) {
+            const std::vector<SpectrumElement> e = makeElements(sizes[j]);
+            std::vector<SpectrumElement> ref(e);
+            for (Size i = 0; i < ref.size(); ++i) {
+                ref[i].abundance *= 0.3;
+            }
+            for (Size k = 0; k < kernels.size(); ++k) {
+                std::vector<SpectrumElement> t(e);
+                SpectrumElement* p = t.empty() ? 0 : &t[0];
+                kernels[k]->scaleAbundances(p, t.size(), 0.3);
+                shouldEqual(bitwiseEqual(t, ref), true);
+            }
+        }
+        Spectrum s;
+        s.normalizeAbundances();
+        shouldEqual(s.empty(), true);
+        s.push_back(SpectrumElement(100.0, 0.0));
+        s.normalizeAbundances();
+        shouldEqual(s[0].abundance, 0.0);
+        s.push_back(SpectrumElement(101.0, 4.0));
+        s.push_back(SpectrumElement(102.0, 2.0));
+        s.normalizeAbundances(100.0);
+        shouldEqual(s[1].abundance, 100.0);
+        shouldEqual(s[2].abundance, 50.0);
+        shouldEqual(s[2].mz, 102.0);
+        s.scaleAbundances(0.5);
+        shouldEqual(s.getTotalAbundance(), 75.0);
+    }
+};
+
+int main()
+{
+    SpectrumKernelsTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
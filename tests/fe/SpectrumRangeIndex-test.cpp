@@ -0,0 +1,178 @@
+/*
+ * SpectrumRangeIndex-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/SpectrumRangeIndex.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct SpectrumRangeIndexTestSuite : vigra::test_suite
+{
+    SpectrumRangeIndexTestSuite() :
+            vigra::test_suite("SpectrumRangeIndex")
+    {
+        add(testCase(&SpectrumRangeIndexTestSuite::testRange));
+        add(testCase(&SpectrumRangeIndexTestSuite::testAbundance));
+        add(testCase(&SpectrumRangeIndexTestSuite::testBatched));
+        add(testCase(&SpectrumRangeIndexTestSuite::testEmpty));
+    }
+
+    Spectrum makeSpectrum(const Size n)
+    {
+        Spectrum s;
+        std::srand(7);
+        double mz = 100.0;
+        for (Size i = 0; i < n; ++i) {
+            // include runs of identical m/z values
+            if (std::rand() % 4 != 0) {
+                mz += std::rand() / (RAND_MAX + 1.0);
+            }
+            s.push_back(Spectrum::Element(mz, 1.0 + std::rand() % 100));
+        }
+        return s;
+    }
+
+    /** Reference windows: random bounds, peak m/z values, and windows that
+     * lie outside of the spectrum.
+     */
+    std::vector<SpectrumRangeIndex::MzWindow> makeWindows(const Spectrum& s)
+    {
+        std::vector<SpectrumRangeIndex::MzWindow> windows;
+        const double lo = s[0].mz - 2.0;
+        const double hi = s[s.size() - 1].mz + 2.0;
+        for (int i = 0; i < 500; ++i) {
+            double a = lo + (hi - lo) * std::rand() / (RAND_MAX + 1.0);
+            double b = a + 10.0 * std::rand() / (RAND_MAX + 1.0);
+            windows.push_back(std::make_pair(a, b));
+        }
+        for (Size i = 0; i < s.size(); i += 7) {
+            windows.push_back(std::make_pair(s[i].mz, s[i].mz));
+            windows.push_back(std::make_pair(s[i].mz, s[i].mz + 1.0));
+        }
+        windows.push_back(std::make_pair(lo - 10.0, lo - 5.0));
+        windows.push_back(std::make_pair(hi + 5.0, hi + 10.0));
+        windows.push_back(std::make_pair(lo, hi));
+        // an inverted window is empty
+        windows.push_back(std::make_pair(s[10].mz, s[5].mz));
+        std::sort(windows.begin(), windows.end());
+        return windows;
+    }
+
+    void testRange()
+    {
+        Spectrum s = makeSpectrum(1000);
+        SpectrumRangeIndex index(s);
+        shouldEqual(&index.getSpectrum(), &s);
+        std::vector<SpectrumRangeIndex::MzWindow> windows = makeWindows(s);
+        for (Size i = 0; i < windows.size(); ++i) {
+            SpectrumRange r = index.getRange(windows[i].first,
+                windows[i].second);
+            Spectrum ref = s.subset(windows[i].first, windows[i].second);
+            shouldEqual(Size(r.second - r.first), ref.size());
+            shouldEqual(std::equal(r.first, r.second, ref.begin()), true);
+        }
+        // no abundance queries, no prefix sums
+        shouldEqual(index.hasAbundanceIndex(), false);
+    }
+
+    void testAbundance()
+    {
+        Spectrum s = makeSpectrum(1000);
+        SpectrumRangeIndex index(s);
+        std::vector<SpectrumRangeIndex::MzWindow> windows = makeWindows(s);
+        for (Size i = 0; i < windows.size(); ++i) {
+            Spectrum ref = s.subset(windows[i].first, windows[i].second);
+            shouldEqual(index.getAbundance(windows[i].first,
+                windows[i].second), ref.getTotalAbundance());
+            SpectrumRange r = index.getRange(windows[i].first,
+                windows[i].second);
+            shouldEqual(index.getAbundance(r), ref.getTotalAbundance());
+        }
+        shouldEqual(index.hasAbundanceIndex(), true);
+        shouldEqual(index.getAbundance(SpectrumRange(s.begin(), s.end())),
+            s.getTotalAbundance());
+    }
+
+    void testBatched()
+    {
+        Spectrum s = makeSpectrum(1000);
+        SpectrumRangeIndex index(s);
+        std::vector<SpectrumRangeIndex::MzWindow> windows = makeWindows(s);
+        std::vector<SpectrumRange> ranges;
+        index.getRanges(windows.begin(), windows.end(),
+            std::back_inserter(ranges));
+        std::vector<double> abundances(windows.size());
+        shouldEqual(index.getAbundances(windows.begin(), windows.end(),
+            abundances.begin()) == abundances.end(), true);
+        shouldEqual(ranges.size(), windows.size());
+        for (Size i = 0; i < windows.size(); ++i) {
+            SpectrumRange r = index.getRange(windows[i].first,
+                windows[i].second);
+            shouldEqual(ranges[i] == r, true);
+            shouldEqual(abundances[i], index.getAbundance(r));
+        }
+        // unsorted windows
+        std::swap(windows[0], windows[100]);
+        try {
+            index.getRanges(windows.begin(), windows.end(),
+                std::back_inserter(ranges));
+            failTest("SpectrumRangeIndex::getRanges() failed to throw.");
+        } catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+        }
+    }
+
+    void testEmpty()
+    {
+        Spectrum s;
+        SpectrumRangeIndex index(s);
+        SpectrumRange r = index.getRange(0.0, 1000.0);
+        shouldEqual(r.first == r.second, true);
+        shouldEqual(index.getAbundance(0.0, 1000.0), 0.0);
+        std::vector<SpectrumRangeIndex::MzWindow> windows(3,
+            std::make_pair(1.0, 2.0));
+        std::vector<double> abundances;
+        index.getAbundances(windows.begin(), windows.end(),
+            std::back_inserter(abundances));
+        shouldEqual(abundances == std::vector<double>(3, 0.0), true);
+    }
+};
+
+int main()
+{
+    SpectrumRangeIndexTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
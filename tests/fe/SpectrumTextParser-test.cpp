@@ -0,0 +1,214 @@
+/*
+ * SpectrumTextParser-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/fe/SpectrumTextParser.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct SpectrumTextParserTestSuite : vigra::test_suite
+{
+    SpectrumTextParserTestSuite() :
+            vigra::test_suite("SpectrumTextParser")
+    {
+        add(testCase(&SpectrumTextParserTestSuite::testParseDouble));
+        add(testCase(&SpectrumTextParserTestSuite::testSingleScan));
+        add(testCase(&SpectrumTextParserTestSuite::testMultipleScans));
+        add(testCase(&SpectrumTextParserTestSuite::testRoundTrip));
+        add(testCase(&SpectrumTextParserTestSuite::testMalformed));
+    }
+
+    Size parse(const std::string& text, std::vector<Spectrum>& spectra)
+    {
+        SpectrumTextParser parser;
+        return parser.parse(text.data(), text.data() + text.size(), spectra);
+    }
+
+    void testParseDouble()
+    {
+        const char* numbers[] = { "0", "1", "-1", "+2.5", "123.456",
+                                  "0.000123", "1e3", "1.5E-7", "-.5",
+                                  "400.123456789012", "3.14159265358979323846",
+                                  "12345678901234567890123", "1e-300",
+                                  "17.", "1E+22" };
+        const Size n = sizeof(numbers) / sizeof(numbers[0]);
+        for (Size i = 0; i < n; ++i) {
+            const char* p = numbers[i];
+            const char* end = p + std::strlen(p);
+            double v;
+            shouldEqual(SpectrumTextParser::parseDouble(p, end, v), true);
+            shouldEqual(p == end, true);
+            const double expected = std::strtod(numbers[i], 0);
+            shouldEqualTolerance(v, expected, std::abs(expected) * 1e-15);
+        }
+        // typical peak list numbers are exact
+        const char* s = "401.23456 1203.5";
+        const char* p = s;
+        double v;
+        shouldEqual(SpectrumTextParser::parseDouble(p, s + 16, v), true);
+        shouldEqual(v, 401.23456);
+        shouldEqual(*p, ' ');
+        // not a number
+        const char* bad[] = { "", "-", ".", "e5", "1e", "abc" };
+        for (Size i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+            const char* q = bad[i];
+            shouldEqual(SpectrumTextParser::parseDouble(q,
+                q + std::strlen(q), v), false);
+            shouldEqual(q == bad[i], true);
+        }
+    }
+
+    void testSingleScan()
+    {
+        // plain peak lists are read like operator>>
+        const std::string text = "100.0 1.0\n101.5\t2.5\r\n\n102.0 0.0\n"
+            "103.25 -1.0\n104.0 4.0";
+        std::vector<Spectrum> spectra;
+        shouldEqual(parse(text, spectra), static_cast<Size>(1));
+        Spectrum ref;
+        std::istringstream iss(text);
+        iss >> ref;
+        shouldEqual(spectra[0].size(), static_cast<Size>(3));
+        shouldEqual(spectra[0].size(), ref.size());
+        for (Size i = 0; i < ref.size(); ++i) {
+            shouldEqual(spectra[0][i].mz, ref[i].mz);
+            shouldEqual(spectra[0][i].abundance, ref[i].abundance);
+        }
+        spectra.clear();
+        shouldEqual(parse("", spectra), static_cast<Size>(0));
+        shouldEqual(parse("\n \n", spectra), static_cast<Size>(0));
+    }
+
+    void testMultipleScans()
+    {
+        const std::string text = "# scanNumber=12 rt=301.25 msLevel=1\n"
+            "400.1 10\n"
+            "400.2 20\n"
+            "# scanNumber=13 rt=302.5 msLevel=2 precursorScanNumber=12 "
+            "precursorMz=400.2 precursorCharge=2 precursorAbundance=20 "
+            "comment unknownKey=7\n"
+            "200.1 5\n"
+            "# scanNumber=14 rt=303.75 msLevel=1\n";
+        std::vector<Spectrum> spectra;
+        shouldEqual(parse(text, spectra), static_cast<Size>(3));
+        shouldEqual(spectra[0].getScanNumber(), 12u);
+        shouldEqual(spectra[0].getRetentionTime(), 301.25);
+        shouldEqual(spectra[0].getMsLevel(), 1u);
+        shouldEqual(spectra[0].size(), static_cast<Size>(2));
+        shouldEqual(spectra[0][1].mz, 400.2);
+        shouldEqual(spectra[1].getMsLevel(), 2u);
+        shouldEqual(spectra[1].getPrecursorScanNumber(), 12u);
+        shouldEqual(spectra[1].getPrecursorMz(), 400.2);
+        shouldEqual(spectra[1].getPrecursorCharge(), 2);
+        shouldEqual(spectra[1].getPrecursorAbundance(), 20.0);
+        shouldEqual(spectra[1].size(), static_cast<Size>(1));
+        shouldEqual(spectra[2].getScanNumber(), 14u);
+        shouldEqual(spectra[2].empty(), true);
+    }
+
+    void testRoundTrip()
+    {
+        std::ostringstream oss;
+        std::vector<Spectrum> ref;
+        std::srand(42);
+        for (unsigned int k = 0; k < 5; ++k) {
+            Spectrum s;
+            s.setScanNumber(k + 1);
+            s.setRetentionTime(0.1 * k + std::rand() / (RAND_MAX + 1.0));
+            s.setMsLevel(1 + k % 2);
+            s.setPrecursorMz(300.0 + std::rand() / (RAND_MAX + 1.0));
+            s.setPrecursorCharge(k % 3);
+            for (Size i = 0; i < 100; ++i) {
+                s.push_back(Spectrum::Element(300.0 + i + std::rand()
+                        / (RAND_MAX + 1.0), 1.0 + std::rand() % 1000));
+            }
+            writeSpectrumText(oss, s);
+            ref.push_back(s);
+        }
+        const char* filename = "SpectrumTextParser-test.txt";
+        {
+            std::ofstream ofs(filename, std::ios::binary);
+            ofs << oss.str();
+        }
+        std::vector<Spectrum> spectra;
+        SpectrumTextParser parser;
+        shouldEqual(parser.parseFile(filename, spectra), ref.size());
+        std::remove(filename);
+        for (Size k = 0; k < ref.size(); ++k) {
+            shouldEqual(spectra[k] == ref[k], true);
+            shouldEqual(spectra[k].getScanNumber(), ref[k].getScanNumber());
+            shouldEqual(spectra[k].getRetentionTime(),
+                ref[k].getRetentionTime());
+            shouldEqual(spectra[k].getMsLevel(), ref[k].getMsLevel());
+            shouldEqual(spectra[k].getPrecursorMz(), ref[k].getPrecursorMz());
+            shouldEqual(spectra[k].getPrecursorCharge(),
+                ref[k].getPrecursorCharge());
+        }
+    }
+
+    void testMalformed()
+    {
+        const char* bad[] = { "100.0\n", "100.0 1.0 2.0\n", "100.0 abc\n",
+                              "# rt=abc\n100.0 1.0\n", "100.0x 1.0\n" };
+        for (Size i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+            std::vector<Spectrum> spectra;
+            try {
+                parse(bad[i], spectra);
+                failTest("SpectrumTextParser::parse() failed to throw.");
+            } catch (const mstk::RuntimeError& e) {
+                MSTK_UNUSED(e);
+            }
+        }
+        // the line number is reported
+        std::vector<Spectrum> spectra;
+        try {
+            parse("# rt=1\n100.0 1.0\n\n100.0 x\n", spectra);
+            failTest("SpectrumTextParser::parse() failed to throw.");
+        } catch (const mstk::RuntimeError& e) {
+            shouldEqual(std::string(e.what()).find("line 4")
+                    != std::string::npos, true);
+        }
+    }
+};
+
+int main()
+{
+    SpectrumTextParserTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
@@ -0,0 +1,190 @@
+/*
+ * SpectrumView-test.cpp
+ *
+ * Copyright (c) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/fe/types/SpectrumView.hpp>
+#include <MSTK/fe/types/ColumnarSpectrum.hpp>
+#include <MSTK/fe/types/Spectrum.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/Centroider.hpp>
+#include <MSTK/fe/SimpleBumpFinder.hpp>
+#include <MSTK/fe/GaussianMeanAccumulator.hpp>
+#include <MSTK/fe/SumAbundanceAccumulator.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Types.hpp>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <boost/assign.hpp>
+#include "unittest.hxx"
+
+using namespace mstk::fe;
+using namespace mstk;
+using namespace boost::assign;
+
+struct SpectrumViewTestSuite : vigra::test_suite
+{
+    SpectrumViewTestSuite() :
+        vigra::test_suite("SpectrumView")
+    {
+        add(testCase(&SpectrumViewTestSuite::testView));
+        add(testCase(&SpectrumViewTestSuite::testColumnarSpectrum));
+        add(testCase(&SpectrumViewTestSuite::testCentroider));
+    }
+
+    void testView()
+    {
+        std::vector<Double> mz, ab;
+        mz += 100.0, 100.1, 100.2, 100.3, 100.4;
+        ab += 1.0, 3.0, 7.0, 7.0, 2.0;
+        SpectrumView empty;
+        shouldEqual(empty.size(), static_cast<Size>(0));
+        shouldEqual(empty.begin() == empty.end(), true);
+        shouldEqual(empty.getMaxAbundancePeak() == empty.end(), true);
+
+        SpectrumView v(&mz[0], &ab[0], mz.size());
+        shouldEqual(v.size(), static_cast<Size>(5));
+        shouldEqual(std::distance(v.begin(), v.end()),
+            static_cast<std::ptrdiff_t>(5));
+        shouldEqual(v[2].mz, 100.2);
+        shouldEqual(v.begin()[3].abundance, 7.0);
+        shouldEqual((*(v.begin() + 1)).abundance, 3.0);
+        shouldEqual((v.end() - 1).mz(), 100.4);
+        shouldEqual(v.getTotalAbundance(), 20.0);
+        // first occurrence of the maximum, like std::max_element
+        shouldEqual(v.getMaxAbundancePeak() - v.begin(),
+            static_cast<std::ptrdiff_t>(2));
+        // same semantics as Spectrum::subset
+        SpectrumView sub = v.subset(100.05, 100.3);
+        shouldEqual(sub.size(), static_cast<Size>(3));
+        shouldEqual(sub[0].mz, 100.1);
+        shouldEqual(sub[2].abundance, 7.0);
+        Spectrum s(mz, ab);
+        Spectrum ssub = s.subset(100.05, 100.3);
+        shouldEqual(ssub.size(), sub.size());
+        shouldEqual(v.subset(200.0, 300.0).empty(), true);
+
+        // psf-style extractors
+        SpectrumElement::AbundanceAccessor::result_type a =
+                SpectrumElement::AbundanceAccessor()(v[1]);
+        shouldEqual(a, 3.0);
+
+        // the blocked sum covers full blocks and the tail
+        std::vector<Double> mz21, ab21;
+        for (int i = 1; i <= 21; ++i) {
+            mz21.push_back(100.0 + i);
+            ab21.push_back(i);
+        }
+        SpectrumView v21(&mz21[0], &ab21[0], mz21.size());
+        shouldEqual(v21.getTotalAbundance(), 231.0);
+    }
+
+    void testColumnarSpectrum()
+    {
+        std::vector<Double> mz, ab;
+        mz += 100.0, 100.1, 100.2;
+        ab += 1.0, 3.0, 2.0;
+        Spectrum s(mz, ab);
+        s.setRetentionTime(12.5);
+        s.setMsLevel(2);
+        s.setScanNumber(42);
+        s.setPrecursorMz(555.5);
+        s.setPrecursorCharge(2);
+        ColumnarSpectrum cs(s);
+        shouldEqual(cs.size(), s.size());
+        shouldEqual(cs.getRetentionTime(), 12.5);
+        shouldEqual(cs.getScanNumber(), 42u);
+        shouldEqual(cs.getTotalAbundance(), 6.0);
+        // columns are aligned to cache line boundaries
+        shouldEqual(reinterpret_cast<std::size_t>(&cs.abundance()[0]) % 64,
+            static_cast<std::size_t>(0));
+        shouldEqual(reinterpret_cast<std::size_t>(&cs.mz()[0]) % 64,
+            static_cast<std::size_t>(0));
+        // values can be modified in place
+        cs.mzData()[1] += 0.05;
+        cs.abundanceData()[2] = 5.0;
+        shouldEqualTolerance(cs[1].mz, 100.15, 1e-9);
+        shouldEqual(cs[2].abundance, 5.0);
+        shouldEqual(cs.getTotalAbundance(), 9.0);
+        cs.mzData()[1] = 100.1;
+        cs.abundanceData()[2] = 2.0;
+        // round trip
+        shouldEqual(cs.toSpectrum() == s, true);
+        Spectrum::const_iterator j = s.begin();
+        for (ColumnarSpectrum::const_iterator i = cs.begin(); i != cs.end();
+                ++i, ++j) {
+            shouldEqual(*i == *j, true);
+        }
+        ColumnarSpectrum cs2(mz, ab);
+        shouldEqual(cs2.view().size(), static_cast<Size>(3));
+        cs2.push_back(SpectrumElement(100.3, 4.0));
+        shouldEqual(cs2.size(), static_cast<Size>(4));
+        shouldEqual(cs2[3].mz, 100.3);
+        cs2.clear();
+        shouldEqual(cs2.empty(), true);
+        ab.pop_back();
+        bool thrown = false;
+        try {
+            ColumnarSpectrum cs3(mz, ab);
+        }
+        catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+            thrown = true;
+        }
+        if (!thrown) failTest("PreconditionViolation not thrown");
+    }
+
+    void testCentroider()
+    {
+        std::vector<Double> mz;
+        mz += 559.786248544, 559.788750036, 559.791251544, 559.793753069, 559.796254611, 559.79875617, 559.801257745, 559.803759337, 560.286880736, 560.289385584, 560.291890449, 560.294395331, 560.296900229, 560.299405145, 560.301910077, 560.304415026;
+        std::vector<Double> ab;
+        ab += 2413.484375, 20380.2675781, 49355.7421875, 74698.1875, 77874.4375, 56932.3984375, 29339.2324219, 10459.6621094, 16606.1914062, 28976.7167969, 40484.2109375, 59069.78125, 76599.578125, 71999.65625, 43608.4375, 12770.8847656;
+        typedef Centroider<Centroid, SimpleBumpFinder, GaussianMeanAccumulator,
+                SumAbundanceAccumulator> MyCentroider;
+        MyCentroider c;
+        // array of structs
+        Spectrum s(mz, ab);
+        std::vector<Centroid> aos;
+        c(s.begin(), s.end(), 1.0, 1, std::back_inserter(aos));
+        // structure of arrays
+        ColumnarSpectrum cs(s);
+        std::vector<Centroid> soa;
+        c(cs.begin(), cs.end(), 1.0, 1, std::back_inserter(soa));
+        shouldEqual(soa.size(), static_cast<Size>(2));
+        shouldEqual(soa.size(), aos.size());
+        for (Size i = 0; i < soa.size(); ++i) {
+            shouldEqual(soa[i] == aos[i], true);
+        }
+    }
+};
+
+int main()
+{
+    SpectrumViewTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
+
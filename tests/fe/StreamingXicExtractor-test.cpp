@@ -0,0 +1,237 @@
+/*
+ * StreamingXicExtractor-test.cpp
+ *
+ * Copyright (c) 2011 Marc Kirchner
+ *
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unittest.hxx"
+#include <iostream>
+#include <vector>
+#include <MSTK/common/Types.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/fe/StreamingXicExtractor.hpp>
+#include <MSTK/fe/XicExtractor.hpp>
+#include <MSTK/fe/types/Centroid.hpp>
+#include <MSTK/fe/types/CentroidFbiTraits.hpp>
+#include <MSTK/fe/types/Xic.hpp>
+#include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
+#include <MSTK/fe/RunningMeanSmoother.hpp>
+#include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace mstk::fe;
+using namespace mstk;
+
+struct StreamingXicExtractorTestSuite : vigra::test_suite
+{
+    typedef std::vector<Xic> Xics;
+    typedef std::vector<Centroid> Centroids;
+    typedef StreamingXicExtractor<CentroidWeightedMeanDisambiguator,
+            RunningMeanSmoother, XicLocalMinSplitter<Xic> , Xic,
+            CentroidBoxGenerator> MyStreamingXicExtractor;
+    typedef XicExtractor<CentroidWeightedMeanDisambiguator,
+            RunningMeanSmoother, XicLocalMinSplitter<Xic> > MyXicExtractor;
+
+    StreamingXicExtractorTestSuite() :
+            vigra::test_suite("StreamingXicExtractor")
+    {
+        add(testCase(&StreamingXicExtractorTestSuite::testSingle));
+        add(testCase(&StreamingXicExtractorTestSuite::testEquivalence));
+        add(testCase(&StreamingXicExtractorTestSuite::testBoundedMemory));
+        add(testCase(&StreamingXicExtractorTestSuite::testOrder));
+    }
+
+    struct LessThanStart
+    {
+        bool operator()(const Xic& lhs, const Xic& rhs) const
+        {
+            if (lhs[0].getScanNumber() != rhs[0].getScanNumber()) {
+                return lhs[0].getScanNumber() < rhs[0].getScanNumber();
+            }
+            return lhs[0].getMz() < rhs[0].getMz();
+        }
+    };
+
+    struct LessThanScanNumber
+    {
+        bool operator()(const Centroid& lhs, const Centroid& rhs) const
+        {
+            return lhs.getScanNumber() < rhs.getScanNumber();
+        }
+    };
+
+    /** Feed centroids sorted by scan number scan by scan.
+     */
+    void stream(const Centroids& cs, MyStreamingXicExtractor& sxe)
+    {
+        Centroids::const_iterator first = cs.begin();
+        while (first != cs.end()) {
+            Centroids::const_iterator last = first;
+            while (last != cs.end() && last->getScanNumber()
+                    == first->getScanNumber()) {
+                ++last;
+            }
+            sxe.addScan(first, last);
+            first = last;
+        }
+    }
+
+    void testSingle()
+    {
+        Spectrum raw;
+        Centroids cs;
+        for (UnsignedInt sn = 0; sn < 9; ++sn) {
+            const double ab = 10.0 - std::abs(4.0 - sn);
+            cs.push_back(Centroid(2.0 * sn, 500.0, sn, ab, raw.begin(),
+                raw.end()));
+        }
+        Xics xs;
+        MyStreamingXicExtractor sxe(CentroidBoxGenerator(3, 5.0), 3, 0.76,
+            [&xs](Xic&& x) {xs.push_back(std::move(x));});
+        stream(cs, sxe);
+        shouldEqual(xs.size(), static_cast<Size>(0));
+        shouldEqual(sxe.getNumberOfOpenXics(), static_cast<Size>(1));
+        shouldEqual(sxe.getNumberOfBufferedCentroids(), cs.size());
+        sxe.flush();
+        shouldEqual(xs.size(), static_cast<Size>(1));
+        shouldEqual(xs[0].size(), cs.size());
+        shouldEqual(sxe.getNumberOfOpenXics(), static_cast<Size>(0));
+        shouldEqual(sxe.getNumberOfBufferedCentroids(), static_cast<Size>(0));
+    }
+
+    /** The streaming extractor must find the same XICs as the batch
+     * extractor, including split XICs.
+     */
+    void testEquivalence()
+    {
+        Spectrum raw;
+        Centroids cs;
+        std::srand(7);
+        for (Size i = 0; i < 20000; ++i) {
+            unsigned int sn = std::rand() % 200;
+            double mz = 400.0 + 0.0005 * (std::rand() % 8000);
+            double ab = 1.0 + std::rand() % 100;
+            cs.push_back(Centroid(2.0 * sn, mz, sn, ab, raw.begin(),
+                raw.end()));
+        }
+        for (UnsignedInt sn = 0; sn < 200; ++sn) {
+            const double a = (sn - 50.0) / 10.0;
+            const double b = (sn - 150.0) / 10.0;
+            const double ab = 1.0 + 1000.0 * std::exp(-a * a) + 800.0
+                    * std::exp(-b * b);
+            cs.push_back(Centroid(2.0 * sn, 700.0, sn, ab, raw.begin(),
+                raw.end()));
+        }
+        std::stable_sort(cs.begin(), cs.end(), LessThanScanNumber());
+
+        CentroidBoxGenerator bg(3, 5.0);
+        MyXicExtractor xe;
+        Xics ref;
+        xe(cs, bg, 3, 0.76, ref);
+        Xics xs;
+        MyStreamingXicExtractor sxe(bg, 3, 0.76,
+            [&xs](Xic&& x) {xs.push_back(std::move(x));});
+        stream(cs, sxe);
+        sxe.flush();
+
+        shouldEqual(xs.size(), ref.size());
+        std::sort(ref.begin(), ref.end(), LessThanStart());
+        std::sort(xs.begin(), xs.end(), LessThanStart());
+        for (Size i = 0; i < xs.size(); ++i) {
+            shouldEqual(xs[i].size(), ref[i].size());
+            for (Size j = 0; j < xs[i].size(); ++j) {
+                shouldEqual(xs[i][j].getScanNumber(), ref[i][j].getScanNumber());
+                shouldEqualTolerance(xs[i][j].getMz(), ref[i][j].getMz(), 1e-9);
+                shouldEqualTolerance(xs[i][j].getAbundance(),
+                    ref[i][j].getAbundance(), 1e-9);
+            }
+        }
+    }
+
+    /** A long run of short, staggered features: XICs are emitted while the
+     * run progresses and the buffer size does not grow with the run length.
+     */
+    void testBoundedMemory()
+    {
+        Spectrum raw;
+        Xics xs;
+        MyStreamingXicExtractor sxe(CentroidBoxGenerator(3, 5.0), 3, 0.76,
+            [&xs](Xic&& x) {xs.push_back(std::move(x));});
+        const UnsignedInt nScans = 5000;
+        const UnsignedInt length = 20;
+        Size maxBuffered = 0;
+        for (UnsignedInt sn = 0; sn < nScans; ++sn) {
+            Centroids scan;
+            // a new feature starts every other scan
+            for (UnsignedInt k = sn > length ? sn - length : 0; k <= sn; ++k) {
+                if (k % 2 == 0 && k + length < nScans) {
+                    const double x = (sn - k - length / 2.0) / 4.0;
+                    scan.push_back(Centroid(2.0 * sn, 400.0 + 0.1 * k, sn,
+                        1.0 + 100.0 * std::exp(-x * x), raw.begin(),
+                        raw.end()));
+                }
+            }
+            sxe.addScan(scan.begin(), scan.end());
+            maxBuffered = std::max(maxBuffered,
+                sxe.getNumberOfBufferedCentroids());
+        }
+        const Size nEmitted = xs.size();
+        sxe.flush();
+        shouldEqual(xs.size(), static_cast<Size>((nScans - length) / 2));
+        shouldEqual(nEmitted > xs.size() - 10, true);
+        // about 11 concurrent features with up to 21 centroids each
+        shouldEqual(maxBuffered <= 11 * (length + 1), true);
+        for (Size i = 0; i < xs.size(); ++i) {
+            shouldEqual(xs[i].size(), static_cast<Size>(length + 1));
+        }
+    }
+
+    void testOrder()
+    {
+        Spectrum raw;
+        MyStreamingXicExtractor sxe(CentroidBoxGenerator(3, 5.0), 3, 0.76,
+            [](Xic&&) {});
+        Centroid c1(2.0, 500.0, 1, 1.0, raw.begin(), raw.end());
+        Centroid c2(4.0, 500.0, 2, 1.0, raw.begin(), raw.end());
+        sxe.add(c2);
+        try {
+            sxe.add(c1);
+            failTest("StreamingXicExtractor::add() failed to throw.");
+        } catch (const mstk::PreconditionViolation& e) {
+            MSTK_UNUSED(e);
+        }
+        // a new run may start after flushing
+        sxe.flush();
+        sxe.add(c1);
+        shouldEqual(sxe.getNumberOfOpenXics(), static_cast<Size>(1));
+    }
+};
+
+int main()
+{
+    StreamingXicExtractorTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}
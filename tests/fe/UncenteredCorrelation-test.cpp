@@ -27,6 +27,8 @@
 #include "utilities.hpp"
 #include <MSTK/fe/UncenteredCorrelation.hpp>
 #include <MSTK/fe/types/Xic.hpp>
+#include <MSTK/fe/types/XicProfile.hpp>
+#include <vector>
 #include <iostream>
 
 using namespace mstk::fe;
@@ -53,6 +55,7 @@ struct UncenteredCorrelationTestSuite : vigra::test_suite
             vigra::test_suite("UncenteredCorrelation")
     {
         add(testCase(&UncenteredCorrelationTestSuite::testCorrelate));
+        add(testCase(&UncenteredCorrelationTestSuite::testProfileArena));
     }
 
     void testCorrelate()
@@ -78,6 +81,40 @@ struct UncenteredCorrelationTestSuite : vigra::test_suite
         shouldEqualTolerance(
             cor.run(x3.begin(), x3.end(), x1.begin(), x1.end()), 0.0, 1e-12);
     }
+
+    /** Correlating packed elution profiles gives the same result as
+     * correlating the XICs.
+     */
+    void testProfileArena()
+    {
+        double mz[] = { 100.0, 100.0, 100.0, 100.0 };
+        double rt1[] = { 350.0, 352.0, 354.0, 356.0 };
+        unsigned int sn1[] = { 42, 43, 44, 45 };
+        double ab1[] = { 1.0, 3.0, 2.0, 0.5 };
+        double rt2[] = { 352.0, 354.0, 356.0, 358.0 };
+        unsigned int sn2[] = { 43, 44, 45, 46 };
+        double ab2[] = { 2.0, 2.5, 1.0, 0.2 };
+        std::vector<Xic> xics;
+        xics.push_back(makeXic(4, mz, rt1, sn1, ab1));
+        xics.push_back(makeXic(3, mz, rt2, sn2, ab2));
+        xics.push_back(makeXic(4, mz, rt2, sn2, ab1));
+        XicProfileArena profiles;
+        profiles.assign(xics);
+        shouldEqual(profiles.size(), xics.size());
+        shouldEqual(profiles.end(1) - profiles.begin(1), 3);
+        shouldEqual(profiles.begin(2)->retentionTime, 352.0);
+        shouldEqual(profiles.begin(2)->abundance, 1.0);
+        Correlator cor;
+        for (size_t i = 0; i < xics.size(); ++i) {
+            for (size_t j = 0; j < xics.size(); ++j) {
+                double expected = cor.run(xics[i].begin(), xics[i].end(),
+                    xics[j].begin(), xics[j].end());
+                shouldEqualTolerance(cor.run(profiles.begin(i),
+                    profiles.end(i), profiles.begin(j), profiles.end(j)),
+                    expected, 1e-12);
+            }
+        }
+    }
 };
 
 int main()
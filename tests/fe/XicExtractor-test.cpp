@@ -36,7 +36,12 @@
 #include <MSTK/fe/CentroidWeightedMeanDisambiguator.hpp>
 #include <MSTK/fe/RunningMeanSmoother.hpp>
 #include <MSTK/fe/XicLocalMinSplitter.hpp>
+#include <MSTK/fe/parallelConnectedComponents.hpp>
+#include <MSTK/fe/types/CompactCentroid.hpp>
 #include <fbi/fbi.h>
+#include <fbi/connectedcomponents.h>
+#include <cmath>
+#include <cstdlib>
 
 using namespace mstk::fe;
 using namespace mstk;
@@ -54,6 +59,125 @@ struct XicExtractorTestSuite : vigra::test_suite
         add(testCase(&XicExtractorTestSuite::testRampUp));
         add(testCase(&XicExtractorTestSuite::testSplit));
         add(testCase(&XicExtractorTestSuite::testSplit2));
+        add(testCase(&XicExtractorTestSuite::testParallelComponents));
+        add(testCase(&XicExtractorTestSuite::testParallel));
+        add(testCase(&XicExtractorTestSuite::testParallelSplit));
+    }
+
+    // Random centroids on a dense m/z grid, so that components span
+    // slab boundaries.
+    template<class C>
+    std::vector<C> makeRandomCentroids(const Size n)
+    {
+        std::vector<C> cs;
+        std::srand(42);
+        for (Size i = 0; i < n; ++i) {
+            unsigned int sn = std::rand() % 200;
+            double mz = 400.0 + 0.0005 * (std::rand() % 8000);
+            double ab = 1.0 + std::rand() % 100;
+            cs.push_back(C(2.0 * sn, mz, sn, ab));
+        }
+        return cs;
+    }
+
+    void testParallelComponents()
+    {
+        typedef std::vector<CompactCentroid> CompactCentroids;
+        CompactCentroids cs = makeRandomCentroids<CompactCentroid>(20000);
+        CentroidBoxGenerator bg(3, 5.0);
+        auto adj = fbi::SetA<CompactCentroid, 0, 1>::intersect(cs, bg, bg);
+        std::vector<unsigned int> ref;
+        Size nRef = findConnectedComponents(adj, ref);
+        shouldEqual(nRef > 1, true);
+        for (UnsignedInt nt = 1; nt <= 16; nt *= 2) {
+            std::vector<unsigned int> labels;
+            Size n = parallelConnectedComponents(cs, bg, labels, nt);
+            shouldEqual(n, nRef);
+            shouldEqual(labels == ref, true);
+        }
+    }
+
+    void testParallel()
+    {
+        Centroids cs;
+        std::srand(7);
+        for (Size i = 0; i < 20000; ++i) {
+            unsigned int sn = std::rand() % 200;
+            double mz = 400.0 + 0.0005 * (std::rand() % 8000);
+            double ab = 1.0 + std::rand() % 100;
+            Spectrum raw;
+            cs.push_back(Centroid(2.0 * sn, mz, sn, ab, raw.begin(),
+                raw.end()));
+        }
+        typedef XicExtractor<CentroidWeightedMeanDisambiguator,
+                RunningMeanSmoother, XicLocalMinSplitter<Xic> > MyXicExtractor;
+        CentroidBoxGenerator bg(3, 5.0);
+        MyXicExtractor serial;
+        shouldEqual(serial.getNumberOfThreads(), static_cast<UnsignedInt>(1));
+        Xics ref;
+        Size nRef = serial(cs, bg, 3, 0.76, ref);
+        shouldEqual(nRef > 0, true);
+        for (UnsignedInt nt = 2; nt <= 16; nt *= 2) {
+            MyXicExtractor xe(nt);
+            shouldEqual(xe.getNumberOfThreads(), nt);
+            Xics xs;
+            Size n = xe(cs, bg, 3, 0.76, xs);
+            shouldEqual(n, nRef);
+            for (Size i = 0; i < n; ++i) {
+                shouldEqual(xs[i] == ref[i], true);
+                shouldEqual(xs[i].size(), ref[i].size());
+                shouldEqual(std::equal(xs[i].begin(), xs[i].end(),
+                    ref[i].begin()), true);
+            }
+        }
+    }
+
+    /** Skewed XIC sizes: a few long, bimodal XICs that need splitting among
+     * many short ones. The split parts must show up in the same order as in
+     * the serial path, independent of which thread split them.
+     */
+    void testParallelSplit()
+    {
+        Centroids cs;
+        Spectrum raw;
+        for (UnsignedInt k = 0; k < 4; ++k) {
+            const double mz = 500.0 + 10.0 * k;
+            for (UnsignedInt sn = 0; sn < 400; ++sn) {
+                const double a = (sn - 100.0) / 20.0;
+                const double b = (sn - 300.0) / 20.0;
+                const double ab = 1.0 + 1000.0 * std::exp(-a * a) + 800.0
+                        * std::exp(-b * b);
+                cs.push_back(Centroid(2.0 * sn, mz, sn, ab, raw.begin(),
+                    raw.end()));
+            }
+        }
+        for (UnsignedInt k = 0; k < 2000; ++k) {
+            const double mz = 600.0 + 0.1 * k;
+            const UnsignedInt first = k % 390;
+            for (UnsignedInt sn = first; sn < first + 5; ++sn) {
+                cs.push_back(Centroid(2.0 * sn, mz, sn, 10.0 + sn - first,
+                    raw.begin(), raw.end()));
+            }
+        }
+        typedef XicExtractor<CentroidWeightedMeanDisambiguator,
+                RunningMeanSmoother, XicLocalMinSplitter<Xic> > MyXicExtractor;
+        CentroidBoxGenerator bg(3, 5.0);
+        MyXicExtractor serial;
+        Xics ref;
+        Size nRef = serial(cs, bg, 3, 0.5, ref);
+        // every long XIC is split at least once
+        shouldEqual(nRef > 2004, true);
+        for (UnsignedInt nt = 2; nt <= 16; nt *= 2) {
+            MyXicExtractor xe(nt);
+            Xics xs;
+            Size n = xe(cs, bg, 3, 0.5, xs);
+            shouldEqual(n, nRef);
+            for (Size i = 0; i < n; ++i) {
+                shouldEqual(xs[i].size(), ref[i].size());
+                shouldEqual(std::equal(xs[i].begin(), xs[i].end(),
+                    ref[i].begin()), true);
+            }
+        }
     }
 
     void testNormalMax()
@@ -0,0 +1,238 @@
+/*
+ * AveragineTable-test.cpp
+ *
+ * Copyright (C) 2012 Marc Kirchner
+ * 
+ * This file is part of the Mass Spectrometry Toolkit (MSTK).
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <MSTK/ipaca/AveragineTable.hpp>
+#include <MSTK/ipaca/Mercury7Impl.hpp>
+#include <MSTK/ipaca/Traits.hpp>
+#include <MSTK/common/Error.hpp>
+#include <MSTK/common/Types.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include "unittest.hxx"
+
+using namespace mstk;
+using namespace mstk::ipaca;
+
+/** Test suite for the averagine envelope table.
+ */
+struct AveragineTableTestSuite : vigra::test_suite
+{
+    AveragineTableTestSuite() :
+        vigra::test_suite("AveragineTable")
+    {
+        add(testCase(&AveragineTableTestSuite::testConstruction));
+        add(testCase(&AveragineTableTestSuite::testEnvelopes));
+        add(testCase(&AveragineTableTestSuite::testMercury));
+        add(testCase(&AveragineTableTestSuite::testInterpolation));
+        add(testCase(&AveragineTableTestSuite::testCharge));
+        add(testCase(&AveragineTableTestSuite::testSerialization));
+    }
+
+    void testConstruction()
+    {
+        AveragineTable t(1000.0, 50.0, 6);
+        shouldEqual(t.getMaxMass(), 1000.0);
+        shouldEqual(t.getMassStep(), 50.0);
+        shouldEqual(t.getNumberOfPeaks(), static_cast<Size> (6));
+        bool thrown = false;
+        try {
+            AveragineTable u(1000.0, 0.0, 6);
+        } catch (PreconditionViolation&) {
+            thrown = true;
+        }
+        shouldEqual(thrown, true);
+    }
+
+    /** The envelopes are scaled to a maximum of 1 and the most abundant
+     * peak moves away from the monoisotopic peak with increasing mass.
+     */
+    void testEnvelopes()
+    {
+        AveragineTable t(6000.0, 100.0, 8);
+        Double e[10];
+        shouldEqual(t.getEnvelope(1000.0, e, 10), static_cast<Size> (8));
+        shouldEqual(*std::max_element(e, e + 8), 1.0);
+        shouldEqual(e[0], 1.0);
+        should(e[1] > 0.4 && e[1] < 0.7);
+        shouldEqual(t.getEnvelope(2500.0, e, 3), static_cast<Size> (3));
+        should(e[1] == 1.0);
+        t.getEnvelope(6000.0, e, 8);
+        should(e[0] < e[1] && e[1] < e[2] && e[2] < e[3] && e[4] < e[3]);
+        // out of range masses are clamped to the grid
+        Double f[8];
+        t.getEnvelope(1e6, f, 8);
+        should(std::equal(e, e + 8, f));
+        t.getEnvelope(-5.0, e, 8);
+        t.getEnvelope(100.0, f, 8);
+        should(std::equal(e, e + 8, f));
+    }
+
+    /** The table agrees with a direct Mercury7 calculation at grid masses.
+     */
+    void testMercury()
+    {
+        AveragineTable t(3000.0, 500.0, 5);
+        detail::Mercury7Impl mercury;
+        detail::Spectrum s = mercury(makeAveragine(2000.0));
+        Double expected[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+        for (detail::Spectrum::const_iterator i = s.begin(); i != s.end(); ++i) {
+            Size bin = static_cast<Size> ((i->mz - s.front().mz) + 0.5);
+            if (bin < 5) {
+                expected[bin] += i->ab;
+            }
+        }
+        Double max = *std::max_element(expected, expected + 5);
+        Double e[5];
+        t.getEnvelope(2000.0, e, 5);
+        for (Size k = 0; k < 5; ++k) {
+            // single precision storage
+            shouldEqualTolerance(e[k], expected[k] / max, 1e-6);
+        }
+    }
+
+    /** Masses between grid points are interpolated linearly.
+     */
+    void testInterpolation()
+    {
+        AveragineTable t(3000.0, 500.0, 5);
+        Double lo[5], hi[5], e[5];
+        t.getEnvelope(1500.0, lo, 5);
+        t.getEnvelope(2000.0, hi, 5);
+        t.getEnvelope(1600.0, e, 5);
+        for (Size k = 0; k < 5; ++k) {
+            shouldEqualTolerance(e[k], 0.8 * lo[k] + 0.2 * hi[k], 1e-12);
+        }
+        t.getEnvelope(1999.999, e, 5);
+        for (Size k = 0; k < 5; ++k) {
+            shouldEqualTolerance(e[k], hi[k], 1e-5);
+        }
+    }
+
+    /** Charged species follow the Mercury7 conventions.
+     */
+    void testCharge()
+    {
+        const Double e = detail::getElectronMass();
+        const Double h = 1.007825;
+        // a protonated 2000 Da molecule at charge 2 and 3
+        for (Int z = 2; z <= 3; ++z) {
+            const Double mz = (2000.0 + z * h - z * e) / z;
+            shouldEqualTolerance(AveragineTable::getNeutralMass(mz, z,
+                AveragineTable::PROTON), 2000.0, 1e-9);
+            shouldEqualTolerance(AveragineTable::getNeutralMass(mz, z,
+                AveragineTable::ELECTRON), 2000.0 + z * h, 1e-9);
+        }
+        shouldEqual(AveragineTable::getNeutralMass(1234.5, 0,
+            AveragineTable::PROTON), 1234.5);
+        // deprotonation
+        const Double mz = (2000.0 - h + e) / 1;
+        shouldEqualTolerance(AveragineTable::getNeutralMass(mz, -1,
+            AveragineTable::PROTON), 2000.0, 1e-9);
+        // the envelope is looked up at the stoichiometry mass
+        AveragineTable t(3000.0, 10.0, 5);
+        Double expected[5], actual[5];
+        t.getEnvelope(2000.0 + 2 * h, expected, 5);
+        t.getEnvelope((2000.0 + 2 * h - 2 * e) / 2, 2, actual, 5);
+        for (Size k = 0; k < 5; ++k) {
+            shouldEqualTolerance(actual[k], expected[k], 1e-12);
+        }
+        t.getEnvelope(2000.0, 0, actual, 5);
+        t.getEnvelope(2000.0, expected, 5);
+        should(std::equal(expected, expected + 5, actual));
+    }
+
+    /** Saved tables are mapped and yield identical envelopes.
+     */
+    void testSerialization()
+    {
+        const String filename = "AveragineTable-test.bin";
+        AveragineTable t(2000.0, 10.0, 6);
+        shouldEqual(t.isMapped(), false);
+        t.save(filename);
+        AveragineTable m(filename);
+        shouldEqual(m.isMapped(), true);
+        shouldEqual(m.getMaxMass(), t.getMaxMass());
+        shouldEqual(m.getMassStep(), t.getMassStep());
+        shouldEqual(m.getNumberOfPeaks(), t.getNumberOfPeaks());
+        Double e[6], f[6];
+        for (Double mass = 0.0; mass < 2100.0; mass += 3.7) {
+            t.getEnvelope(mass, e, 6);
+            m.getEnvelope(mass, f, 6);
+            should(std::equal(e, e + 6, f));
+        }
+        // the file holds the header and the single precision envelopes
+        std::ifstream is(filename.c_str(), std::ios::binary | std::ios::ate);
+        shouldEqual(static_cast<Size> (is.tellg()),
+            AveragineTable::HEADER_SIZE + 200 * 6 * sizeof(float));
+        is.close();
+        // moving keeps the mapping
+        AveragineTable moved(std::move(m));
+        shouldEqual(moved.isMapped(), true);
+        moved.getEnvelope(1234.0, f, 6);
+        t.getEnvelope(1234.0, e, 6);
+        should(std::equal(e, e + 6, f));
+        // a computed table can be replaced by a mapped one
+        AveragineTable u(100.0, 10.0, 2);
+        u.open(filename);
+        shouldEqual(u.getNumberOfPeaks(), static_cast<Size> (6));
+        u.getEnvelope(1234.0, f, 6);
+        should(std::equal(e, e + 6, f));
+        std::remove(filename.c_str());
+
+        // invalid files
+        const String bad = "AveragineTable-test.bad";
+        {
+            std::ofstream os(bad.c_str(), std::ios::binary);
+            os << "MSTKAVGT but not really";
+        }
+        bool thrown = false;
+        try {
+            AveragineTable v(bad);
+        } catch (RuntimeError&) {
+            thrown = true;
+        }
+        shouldEqual(thrown, true);
+        std::remove(bad.c_str());
+        thrown = false;
+        try {
+            AveragineTable v("AveragineTable-test.missing");
+        } catch (RuntimeError&) {
+            thrown = true;
+        }
+        shouldEqual(thrown, true);
+    }
+};
+
+int main()
+{
+    AveragineTableTestSuite test;
+    int success = test.run();
+    std::cout << test.report() << std::endl;
+    return success;
+}